@@ -110,6 +110,7 @@ namespace nissa
     std::vector<poly_corr_meas_pars_t> luppoli_meas;
     std::vector<watusso_meas_pars_t> watusso_meas;
     std::vector<all_rects_meas_pars_t> all_rects_meas;
+    std::vector<Wflow_scale_meas_pars_t> Wflow_scale_meas;
     
     //add
     void add_plaq_pol_meas(gauge_obs_meas_pars_t &m){plaq_pol_meas.push_back(m);}
@@ -117,6 +118,7 @@ namespace nissa
     void add_luppoli_meas(poly_corr_meas_pars_t &m){luppoli_meas.push_back(m);}
     void add_watusso_meas(watusso_meas_pars_t &m){watusso_meas.push_back(m);watusso_meas.back();}
     void add_all_rects_meas(all_rects_meas_pars_t &m){all_rects_meas.push_back(m);all_rects_meas.back();}
+    void add_Wflow_scale_meas(Wflow_scale_meas_pars_t &m){Wflow_scale_meas.push_back(m);}
     
     //mode of running
     enum run_mode_t{EVOLUTION_MODE,ANALYSIS_MODE};
@@ -198,6 +200,7 @@ namespace nissa
       os<<vector_get_str(plaq_pol_meas,full);
       os<<vector_get_str(top_meas,full);
       os<<vector_get_str(all_rects_meas,full);
+      os<<vector_get_str(Wflow_scale_meas,full);
       //walltime and seed
       os<<walltime_seed_get_str(full)<<"\n";
       
@@ -5,6 +5,9 @@
 */
 
 #include <math.h>
+#include <map>
+#include <set>
+#include <sstream>
 
 #include <nissa.hpp>
 #include "driver.hpp"
@@ -12,6 +15,7 @@
 using namespace nissa;
 
 double *top_meas_time;
+double smooth_meas_time=0;
 
 //new and old conf
 quad_su3 *new_conf[2];
@@ -28,6 +32,40 @@ int itraj;
 int conf_created;
 int stored_last_conf=0;
 
+#ifdef USE_MPI_IO
+//writes proceeding in background, at most two at the time
+const size_t nmax_pending_writes=2;
+std::vector<ILDG_async_write_t*> pending_writes;
+
+//finish the oldest pending write
+void finish_oldest_pending_write()
+{
+  ILDG_File_finish_async_write(*pending_writes.front());
+  delete pending_writes.front();
+  pending_writes.erase(pending_writes.begin());
+}
+
+//finish all writes which have been completed, or all of them if asked
+void finish_pending_writes(bool wait_all)
+{
+  while(pending_writes.size() and (wait_all or ILDG_File_async_write_completed(*pending_writes.front())))
+    finish_oldest_pending_write();
+}
+
+//wait for the buffer to be available and for the file not to be under write
+void wait_to_start_write(std::string path)
+{
+  bool path_in_use;
+  do
+    {
+      path_in_use=false;
+      for(size_t iwrite=0;iwrite<pending_writes.size();iwrite++) path_in_use|=(pending_writes[iwrite]->path==path);
+      if(path_in_use or pending_writes.size()>=nmax_pending_writes) finish_oldest_pending_write();
+    }
+  while(path_in_use or pending_writes.size()>=nmax_pending_writes);
+}
+#endif
+
 //write a conf adding info
 int nwrite_conf=0;
 double write_conf_time=0;
@@ -63,6 +101,14 @@ void write_conf(std::string path,quad_su3 **conf)
   //for(int iskip=0;iskip<10;iskip++) rnd_get_unif(&glb_rnd_gen,0,1);
   //#endif
   
+  //tuned number of steps of each level of the molecular dynamics
+  if(drv->hmc_evol_pars.md_tune_ntraj)
+    {
+      std::ostringstream os;
+      for(int ilev=0;ilev<=drv->hmc_evol_pars.nferm_levels();ilev++) os<<" "<<drv->hmc_evol_pars.nsteps_of_level(ilev);
+      ILDG_string_message_append_to_last(&mess,"MD_tuned_nsteps",os.str().c_str());
+    }
+  
   //topology history
   if(drv->sea_theory().topotential_pars.flag==2)
     drv->sea_theory().topotential_pars.grid.append_to_message_with_name(mess,"TopoGrid");
@@ -71,8 +117,18 @@ void write_conf(std::string path,quad_su3 **conf)
   convert_rnd_gen_to_text(text,&glb_rnd_gen,1024);
   ILDG_string_message_append_to_last(&mess,"RND_gen_status",text);
   
-  //write the conf
-  paste_eo_parts_and_write_ildg_gauge_conf(path,conf,64,&mess);
+  //write the conf, possibly in background
+#ifdef USE_MPI_IO
+  if(drv->conf_pars.async_write)
+    {
+      wait_to_start_write(path);
+      ILDG_async_write_t *w=new ILDG_async_write_t;
+      start_async_paste_eo_parts_and_write_ildg_gauge_conf(*w,path,conf,64,&mess);
+      pending_writes.push_back(w);
+    }
+  else
+#endif
+    paste_eo_parts_and_write_ildg_gauge_conf(path,conf,64,&mess);
   
   //free messages
   ILDG_message_free_all(&mess);
@@ -112,6 +168,21 @@ void read_conf(quad_su3 **conf,const char *path)
       if(drv->sea_theory().topotential_pars.flag==2 and strcasecmp(cur_mess->name,"TopoGrid")==0)
 	drv->sea_theory().topotential_pars.grid.convert_from_message(*cur_mess);
       
+      //resume the tuned number of steps
+      if(drv->hmc_evol_pars.md_tune_ntraj and strcasecmp(cur_mess->name,"MD_tuned_nsteps")==0)
+	{
+	  std::istringstream is(cur_mess->data);
+	  std::vector<int> nsteps;
+	  int n;
+	  while(is>>n) nsteps.push_back(n);
+	  if((int)nsteps.size()==drv->hmc_evol_pars.nferm_levels()+1)
+	    {
+	      for(size_t ilev=0;ilev<nsteps.size();ilev++) drv->hmc_evol_pars.nsteps_of_level(ilev)=nsteps[ilev];
+	      master_printf("Resuming the tuned number of steps of the molecular dynamics:\n%s",drv->hmc_evol_pars.get_nsteps_str().c_str());
+	    }
+	  else master_printf("WARNING: ignoring the tuned number of steps of %d levels, %d in use\n",(int)nsteps.size(),drv->hmc_evol_pars.nferm_levels()+1);
+	}
+      
       //check for rational approximation
       if(strcasecmp(cur_mess->name,"RAT_approx")==0)
 	{
@@ -232,6 +303,9 @@ void init_simulation(char *path)
   drv=new driver_t(input_global);
   parser_parse(drv);
   if(drv->theories.size()==0) crash("need to specify a theory");
+#ifndef USE_MPI_IO
+  if(drv->conf_pars.async_write) master_printf("WARNING: writing in background needs MPI I/O, confs will be written synchronously\n");
+#endif
   
   //geometry
   glb_size[0]=drv->T;
@@ -273,6 +347,14 @@ void close_simulation()
   master_printf("store: %d %d\n",stored_last_conf,ntraj_prod);
   if(!stored_last_conf and ntraj_prod>0) write_conf(drv->conf_pars.path,conf);
   
+#ifdef USE_MPI_IO
+  //wait for all writes to be finished and report the achieved bandwidth
+  finish_pending_writes(true);
+  if(nbytes_written_async)
+    master_printf("written in background %lg MB in %lg s, %lg MB/s\n",nbytes_written_async*1e-6,time_writing_async,
+		  nbytes_written_async*1e-6/time_writing_async);
+#endif
+  
   //destroy topo pars
   nissa_free(top_meas_time);
   
@@ -323,6 +405,9 @@ int generate_new_conf(int itraj)
 	}
       else master_printf("rejected.\n");
       
+      //tune the number of steps during thermalization
+      if(itraj<drv->hmc_evol_pars.md_tune_ntraj) tune_md_steps(drv->hmc_evol_pars,diff_act);
+      
       //store the topological charge if needed
       drv->sea_theory().topotential_pars.store_if_needed(conf,itraj);
     }
@@ -350,7 +435,8 @@ int generate_new_conf(int itraj)
   return acc;
 }
 
-void measure_gauge_obs_internal(FILE *file,quad_su3 *conf,gauge_obs_meas_pars_t &pars,gauge_action_name_t gauge_action_name)
+//if passed, the clover-shape paths are used to compute the energy
+void measure_gauge_obs_internal(FILE *file,quad_su3 *conf,gauge_obs_meas_pars_t &pars,gauge_action_name_t gauge_action_name,as2t_su3 *leaves=NULL)
 {
   //plaq
   if(pars.meas_plaq)
@@ -364,7 +450,9 @@ void measure_gauge_obs_internal(FILE *file,quad_su3 *conf,gauge_obs_meas_pars_t
   //energy
   if(pars.meas_energy)
     {
-      double energy=average_gauge_energy(conf);
+      double energy;
+      if(leaves) average_gauge_energy_from_leaves(&energy,leaves);
+      else energy=average_gauge_energy(conf);
       master_fprintf(file,"\t%16.16lg",energy);
     }
   
@@ -382,45 +470,20 @@ void measure_gauge_obs_internal(FILE *file,quad_su3 *conf,gauge_obs_meas_pars_t
 //measure plaquette and polyakov loop, writing also acceptance
 void measure_gauge_obs(gauge_obs_meas_pars_t &pars,quad_su3 **conf,int iconf,int acc,gauge_action_name_t gauge_action_name)
 {
-  const std::string path=pars.path;
+  if(pars.use_smooth) crash("smoothed gauge obs must be measured through smoothed_gauge_measurements");
   
   //open creating or appending
-  FILE *file=open_file(path,conf_created?"w":"a");
+  FILE *file=open_file(pars.path,conf_created?"w":"a");
   
   //paste into a temporary
-  quad_su3 *temp_conf=nissa_malloc("smoothed_conf",loc_vol+bord_vol+edge_vol,quad_su3);
+  quad_su3 *temp_conf=nissa_malloc("temp_conf",loc_vol+bord_vol+edge_vol,quad_su3);
   paste_eo_parts_into_lx_vector(temp_conf,conf);
   
-  if(not pars.use_smooth)
-    {
-      //header
-      verbosity_lv1_master_printf("Measuring gauge obs\n");
-      master_fprintf(file,"%d\t%d",iconf,acc);
-      
-      measure_gauge_obs_internal(file,temp_conf,pars,gauge_action_name);
-    }
-  else
-    {
-      int nsmooth=0;
-      bool finished;
-      
-      do
-	{
-	  //header
-	  verbosity_lv1_master_printf("Measuring gauge obs, nsmooth=%d/%d\n",nsmooth,pars.smooth_pars.nsmooth());
-	  master_fprintf(file,"%d\t%d\t%d",iconf,acc,nsmooth);
-	  
-	  measure_gauge_obs_internal(file,temp_conf,pars,gauge_action_name);
-	  
-	  //get internal parameters
-	  smooth_pars_t::space_or_time_t &space_or_time=pars.smooth_pars.space_or_time;
-	  bool* dirs=smooth_pars_t::get_dirs(space_or_time);
-	  int staple_min_dir=smooth_pars_t::get_staple_min_dir(space_or_time);
-	  
-	  finished=smooth_lx_conf_until_next_meas(temp_conf,pars.smooth_pars,nsmooth,dirs,staple_min_dir);
-	}
-      while(not finished);
-    }
+  //header
+  verbosity_lv1_master_printf("Measuring gauge obs\n");
+  master_fprintf(file,"%d\t%d",iconf,acc);
+  
+  measure_gauge_obs_internal(file,temp_conf,pars,gauge_action_name);
   
   nissa_free(temp_conf);
   
@@ -462,22 +525,159 @@ void measure_poly_corrs(poly_corr_meas_pars_t &pars,quad_su3 **eo_conf,bool conf
   for(size_t B=0;B<drv->A.size();B++)			\
     if(measure_is_due(drv->A[B],iconf))
 
+//measures performed along a common smoothing of the conf
+struct smoothed_meas_chain_t
+{
+  smooth_pars_t smooth_pars;
+  std::vector<size_t> top;
+  std::vector<size_t> plaq_pol;
+};
+
+//find the chain with the given smoothing, or add it: length and frequency of measures only tell where to stop
+smoothed_meas_chain_t &get_smoothed_meas_chain(std::vector<smoothed_meas_chain_t> &chains,std::map<std::string,size_t> &chain_id,smooth_pars_t sp)
+{
+  smooth_pars_t key_pars=sp;
+  key_pars.set_nsmooth(0);
+  key_pars.meas_each_nsmooth=key_pars.def_meas_each_nsmooth();
+  std::string key=key_pars.get_str(true);
+  
+  std::map<std::string,size_t>::iterator it=chain_id.find(key);
+  if(it==chain_id.end())
+    {
+      chain_id[key]=chains.size();
+      chains.push_back(smoothed_meas_chain_t());
+      chains.back().smooth_pars=sp;
+      return chains.back();
+    }
+  
+  //extend the chain to the longest smoothing
+  smoothed_meas_chain_t &chain=chains[it->second];
+  if(sp.nsmooth()>chain.smooth_pars.nsmooth()) chain.smooth_pars.set_nsmooth(sp.nsmooth());
+  
+  return chain;
+}
+
+//add the smoothing levels at which the measure is due
+void add_smoothed_meas_levels(std::set<int> &levels,smooth_pars_t &sp)
+{for(int nsmooth=0;nsmooth<=sp.nsmooth();nsmooth+=sp.meas_each_nsmooth) levels.insert(nsmooth);}
+
+//check if the measure is due at the given smoothing level
+bool smoothed_meas_is_due(smooth_pars_t &sp,int nsmooth)
+{return nsmooth%sp.meas_each_nsmooth==0 and nsmooth<=sp.nsmooth();}
+
+//perform the measures on smoothed confs, smoothing once for all the measures sharing the smoothing
+void smoothed_gauge_measurements(quad_su3 **conf,int iconf,int acc,gauge_action_name_t gauge_action_name)
+{
+  //group the measures due according to the smoothing
+  std::vector<smoothed_meas_chain_t> chains;
+  std::map<std::string,size_t> chain_id;
+  RANGE_GAUGE_MEAS(top_meas,i)
+    {
+      //topology is always smoothed in all directions
+      smooth_pars_t sp=drv->top_meas[i].smooth_pars;
+      sp.space_or_time=smooth_pars_t::SPACETIME;
+      get_smoothed_meas_chain(chains,chain_id,sp).top.push_back(i);
+    }
+  RANGE_GAUGE_MEAS(plaq_pol_meas,i)
+    if(drv->plaq_pol_meas[i].use_smooth)
+      get_smoothed_meas_chain(chains,chain_id,drv->plaq_pol_meas[i].smooth_pars).plaq_pol.push_back(i);
+  
+  if(chains.size()==0) return;
+  
+  quad_su3 *smoothed_conf=nissa_malloc("smoothed_conf",loc_vol+bord_vol+edge_vol,quad_su3);
+  as2t_su3 *leaves=nissa_malloc("leaves",loc_vol,as2t_su3);
+  
+  for(size_t ichain=0;ichain<chains.size();ichain++)
+    {
+      smoothed_meas_chain_t &chain=chains[ichain];
+      verbosity_lv1_master_printf("Smoothing with %s for %d topology and %d gauge obs measures\n",chain.smooth_pars.get_method_name().c_str(),
+				  (int)chain.top.size(),(int)chain.plaq_pol.size());
+      
+      //open the files and collect the levels at which to measure
+      std::set<int> levels;
+      std::vector<topology_meas_t*> top(chain.top.size());
+      for(size_t j=0;j<chain.top.size();j++)
+	{
+	  top_meas_pars_t &pars=drv->top_meas[chain.top[j]];
+	  top[j]=new topology_meas_t(pars,iconf,conf_created);
+	  add_smoothed_meas_levels(levels,pars.smooth_pars);
+	}
+      std::vector<FILE*> plaq_pol_file(chain.plaq_pol.size());
+      for(size_t j=0;j<chain.plaq_pol.size();j++)
+	{
+	  gauge_obs_meas_pars_t &pars=drv->plaq_pol_meas[chain.plaq_pol[j]];
+	  plaq_pol_file[j]=open_file(pars.path,conf_created?"w":"a");
+	  add_smoothed_meas_levels(levels,pars.smooth_pars);
+	}
+      
+      //advance the smoothing monotonically through all levels
+      paste_eo_parts_into_lx_vector(smoothed_conf,conf);
+      bool *dirs=smooth_pars_t::get_dirs(chain.smooth_pars.space_or_time);
+      int staple_min_dir=smooth_pars_t::get_staple_min_dir(chain.smooth_pars.space_or_time);
+      int nsmooth=0;
+      for(std::set<int>::iterator it=levels.begin();it!=levels.end();it++)
+	{
+	  smooth_meas_time-=take_time();
+	  smooth_lx_conf_until(smoothed_conf,chain.smooth_pars,nsmooth,*it,dirs,staple_min_dir);
+	  smooth_meas_time+=take_time();
+	  
+	  //clover-shape paths and plaquette are computed once for all measures
+	  bool leaves_computed=false,plaq_computed=false;
+	  double plaq=0;
+	  
+	  for(size_t j=0;j<chain.top.size();j++)
+	    if(smoothed_meas_is_due(top[j]->pars.smooth_pars,nsmooth))
+	      {
+		top_meas_time[chain.top[j]]-=take_time();
+		if(not leaves_computed) four_leaves(leaves,smoothed_conf);
+		if(not plaq_computed) plaq=global_plaquette_lx_conf(smoothed_conf);
+		leaves_computed=plaq_computed=true;
+		top[j]->measure(leaves,nsmooth,plaq);
+		top_meas_time[chain.top[j]]+=take_time();
+	      }
+	  
+	  for(size_t j=0;j<chain.plaq_pol.size();j++)
+	    {
+	      gauge_obs_meas_pars_t &pars=drv->plaq_pol_meas[chain.plaq_pol[j]];
+	      if(smoothed_meas_is_due(pars.smooth_pars,nsmooth))
+		{
+		  verbosity_lv1_master_printf("Measuring gauge obs, nsmooth=%d/%d\n",nsmooth,pars.smooth_pars.nsmooth());
+		  master_fprintf(plaq_pol_file[j],"%d\t%d\t%d",iconf,acc,nsmooth);
+		  
+		  if(pars.meas_energy and not leaves_computed)
+		    {
+		      four_leaves(leaves,smoothed_conf);
+		      leaves_computed=true;
+		    }
+		  measure_gauge_obs_internal(plaq_pol_file[j],smoothed_conf,pars,gauge_action_name,leaves_computed?leaves:NULL);
+		}
+	    }
+	}
+      
+      for(size_t j=0;j<top.size();j++) delete top[j];
+      for(size_t j=0;j<plaq_pol_file.size();j++) close_file(plaq_pol_file[j]);
+    }
+  
+  nissa_free(leaves);
+  nissa_free(smoothed_conf);
+}
+
 //measures
 void measurements(quad_su3 **temp,quad_su3 **conf,int iconf,int acc,gauge_action_name_t gauge_action_name)
 {
   double meas_time=-take_time();
   
-  RANGE_GAUGE_MEAS(plaq_pol_meas,i) measure_gauge_obs(drv->plaq_pol_meas[i],conf,iconf,acc,gauge_action_name);
+  RANGE_GAUGE_MEAS(plaq_pol_meas,i)
+    if(not drv->plaq_pol_meas[i].use_smooth)
+      measure_gauge_obs(drv->plaq_pol_meas[i],conf,iconf,acc,gauge_action_name);
   RANGE_GAUGE_MEAS(luppoli_meas,i) measure_poly_corrs(drv->luppoli_meas[i],conf,conf_created);
-  RANGE_GAUGE_MEAS(top_meas,i)
-    {
-      top_meas_time[i]-=take_time();
-      measure_topology_eo_conf(drv->top_meas[i],conf,iconf,conf_created);
-      top_meas_time[i]+=take_time();
-    }
+  
+  //topology and smoothed gauge obs
+  smoothed_gauge_measurements(conf,iconf,acc,gauge_action_name);
   
   RANGE_GAUGE_MEAS(all_rects_meas,i) measure_all_rectangular_paths(&drv->all_rects_meas[i],conf,iconf,conf_created);
   RANGE_GAUGE_MEAS(watusso_meas,i) measure_watusso(&drv->watusso_meas[i],conf,iconf,conf_created);
+  RANGE_GAUGE_MEAS(Wflow_scale_meas,i) measure_Wflow_scale(drv->Wflow_scale_meas[i],conf,iconf,conf_created);
   
   for(int itheory=0;itheory<drv->ntheories();itheory++)
     if(drv->any_fermionic_measure_is_due(itheory,iconf))
@@ -498,6 +698,9 @@ void measurements(quad_su3 **temp,quad_su3 **conf,int iconf,int acc,gauge_action
 	RANGE_FERMIONIC_MEAS(drv,nucleon_corr);
 	RANGE_FERMIONIC_MEAS(drv,meson_corr);
 	RANGE_FERMIONIC_MEAS(drv,spectral_proj);
+	
+	//the low modes are specific of this conf and theory
+	stag::invalidate_deflation();
       }
   
   meas_time+=take_time();
@@ -610,7 +813,12 @@ void run_program_for_production()
       // 4) if conf is multiple of drv->conf_pars.store_each copy it
       store_conf_if_necessary();
       
-      // 5) spacing between output
+#ifdef USE_MPI_IO
+      // 5) close the background writes already finished
+      finish_pending_writes(false);
+#endif
+      
+      // 6) spacing between output
       master_printf("\n");
       
       //surely now we have created conf
@@ -630,6 +838,10 @@ void run_program_for_analysis()
   do
     {
       read_conf(conf,it->c_str());
+      
+      //start reading the next conf while measuring
+      if(it+1!=drv->an_conf_list.end()) start_prefetching_ildg_gauge_conf(*(it+1));
+      
       measurements(new_conf,conf,itraj,0,drv->sea_theory().gauge_action_name);
       
       nconf_analyzed++;
@@ -637,6 +849,9 @@ void run_program_for_analysis()
     }
   while(it!=drv->an_conf_list.end() and !file_exists("stop") and enough_time());
   
+  //discard the conf prefetched if stopped earlier
+  drop_prefetched_ildg_gauge_conf();
+  
   master_printf("Analyzed %d configurations\n\n",nconf_analyzed);
 }
 
@@ -683,6 +898,8 @@ void in_main(int narg,char **arg)
   for(size_t i=0;i<drv->top_meas.size();i++)
     master_printf("time to perform the %d topo meas (%s): %lg (%2.2g %c tot)\n",i,drv->top_meas[i].path.c_str(),top_meas_time[i],
 		  top_meas_time[i]*100/(take_time()-init_time),'%');
+  master_printf("time to smooth the conf for the gauge meas: %lg (%2.2g %c tot)\n",smooth_meas_time,
+		smooth_meas_time*100/(take_time()-init_time),'%');
   
   close_simulation();
 }
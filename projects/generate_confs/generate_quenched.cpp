@@ -46,6 +46,7 @@ int x_corr_nr;
 double x_corr_kappa;
 double x_corr_mass;
 double x_corr_residue;
+int x_corr_ndefl_eig;
 
 //bench
 double initial_time;
@@ -288,6 +289,19 @@ void append_corr(const char *path,double *corr,int r,bool conf_created)
   ILDG_File_close(file);
 }
 
+//invert for the x space correlation, deflating if the low modes have been computed
+void x_corr_invert(spincolor *sol,quad_su3 *conf,int r,deflation_subspace_t &def,spincolor *source)
+{
+  if(def.is_computed()) inv_tmD_cg_eoprec_deflated(sol,def,conf,x_corr_kappa,tau3[r]*x_corr_mass,100000,x_corr_residue,source);
+  else inv_tmD_cg_eoprec(sol,NULL,conf,x_corr_kappa,tau3[r]*x_corr_mass,100000,x_corr_residue,source);
+}
+
+//compute the low modes used for all the inversions of the x space correlation with given r, if asked
+void x_corr_find_deflation_subspace(deflation_subspace_t &def,quad_su3 *conf,int r)
+{
+  if(x_corr_ndefl_eig) find_deflation_subspace_tmD_eoprec(def,x_corr_ndefl_eig,conf,x_corr_kappa,tau3[r]*x_corr_mass,x_corr_residue);
+}
+
 //measure the correlation space
 void meas_x_corr(const char *path,quad_su3 *conf,bool conf_created)
 {
@@ -300,6 +314,9 @@ void meas_x_corr(const char *path,quad_su3 *conf,bool conf_created)
   
   for(int r=0;r<x_corr_nr;r++)
     {
+      deflation_subspace_t def;
+      x_corr_find_deflation_subspace(def,conf,r);
+      
       for(int ic=0;ic<NCOL;ic++)
 	for(int id=0;id<4;id++)
 	  { 
@@ -311,7 +328,7 @@ void meas_x_corr(const char *path,quad_su3 *conf,bool conf_created)
 	    safe_dirac_prod_spincolor(source,(tau3[r]==-1)?&Pminus:&Pplus,source);
 	    
 	    //invert
-	    inv_tmD_cg_eoprec(temp_solution,NULL,conf,x_corr_kappa,tau3[r]*x_corr_mass,100000,x_corr_residue,source);
+	    x_corr_invert(temp_solution,conf,r,def,source);
 	    
 	    //rotate the sink index
 	    safe_dirac_prod_spincolor(temp_solution,(tau3[r]==-1)?&Pminus:&Pplus,temp_solution);
@@ -320,6 +337,8 @@ void meas_x_corr(const char *path,quad_su3 *conf,bool conf_created)
 	    put_spincolor_into_su3spinspin(P,temp_solution,id,ic);
 	  }
       
+      def.destroy();
+      
       //compute the correlation function
       compute_corr(corr,P);
       append_corr(path,corr,r,conf_created);
@@ -351,6 +370,9 @@ void meas_x_corr_stoch(const char *path,quad_su3 *conf,bool conf_created)
   
   for(int r=0;r<x_corr_nr;r++)
     {
+      deflation_subspace_t def;
+      x_corr_find_deflation_subspace(def,conf,r);
+      
       for(int iso=0;iso<2;iso++)
 	for(int id=0;id<4;id++)
 	  for(int ic=0;ic<NCOL;ic++)
@@ -360,7 +382,7 @@ void meas_x_corr_stoch(const char *path,quad_su3 *conf,bool conf_created)
 	      safe_dirac_prod_spincolor(source,(tau3[r]==-1)?&Pminus:&Pplus,source);
 	      
 	      //invert
-	      inv_tmD_cg_eoprec(temp_solution,NULL,conf,x_corr_kappa,tau3[r]*x_corr_mass,100000,x_corr_residue,source);
+	      x_corr_invert(temp_solution,conf,r,def,source);
 	      
 	      //rotate the sink index
 	      safe_dirac_prod_spincolor(temp_solution,(tau3[r]==-1)?&Pminus:&Pplus,temp_solution);
@@ -369,6 +391,8 @@ void meas_x_corr_stoch(const char *path,quad_su3 *conf,bool conf_created)
 	      put_spincolor_into_su3spinspin(phi[iso],temp_solution,id,ic);
 	    }
       
+      def.destroy();
+      
       //compute the correlation function
       compute_corr_stoch(corr,phi,eta);
       append_corr(combine("%s_stoch",path).c_str(),corr,r,conf_created);
@@ -543,6 +567,7 @@ void init_simulation(char *path)
       read_str_double("Kappa",&x_corr_kappa);
       read_str_int("Nr",&x_corr_nr);
       read_str_double("Residue",&x_corr_residue);
+      read_str_int("NDeflEig",&x_corr_ndefl_eig);
     }
   
   close_input();
@@ -656,7 +681,7 @@ void close_simulation()
   if(!evol_pars.use_hmc)
     {
       master_printf("Communicators initialization time: %lg sec\n",sweeper->comm_init_time);
-      master_printf("Communication time: %lg sec\n",sweeper->comm_time);
+      master_printf("Communication time (not overlapped): %lg sec\n",sweeper->comm_time);
       master_printf("Link update time: %lg sec\n",sweeper->comp_time);
     }
   master_printf("Reunitarization time: %lg sec\n",unitarize_time);
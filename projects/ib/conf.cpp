@@ -53,8 +53,9 @@ namespace nissa
 	master_printf("Smeared plaquette: %+16.16lg\n",global_plaquette_lx_conf(ape_smeared_conf));
       }
     
-    //invalidate internal conf
+    //invalidate internal conf and the multigrid setup
     inner_conf_valid=false;
+    mg::invalidate_setup();
   }
   
   //take a set of theta, charge and photon field, and update the conf
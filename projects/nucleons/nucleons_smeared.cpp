@@ -26,7 +26,7 @@ clover_term_t *Cl;
 
 //source
 coords source_pos;
-spincolor *source,*temp_source;
+spincolor *source;
 su3spinspin *original_source;
 su3spinspin *seq_source;
 
@@ -187,7 +187,6 @@ void initialize_nucleons(char *input_path)
   original_source=nissa_malloc("original_source",loc_vol,su3spinspin);
   
   source=nissa_malloc("source",loc_vol+bord_vol,spincolor);
-  temp_source=nissa_malloc("temp_source",loc_vol+bord_vol,spincolor);
   
   //S0 and similars
   solDD=(spincolor**)malloc(sizeof(spincolor*)*nmass);
@@ -242,6 +241,15 @@ THREADABLE_FUNCTION_0ARG(calculate_S0)
 {
   GET_THREAD_ID();
   
+  //smear all the components of the source together
+  su3spinspin *smeared_source=nissa_malloc("smeared_source",loc_vol,su3spinspin);
+  gaussian_smearing(smeared_source,original_source,smea_conf,Gauss_kappa,Gauss_niter);
+  master_printf(" -> source smeared\n");
+  
+  //sinks of all masses and r, smeared together
+  spincolor *sink[2*nmass];
+  for(int isink=0;isink<2*nmass;isink++) sink[isink]=nissa_malloc("sink",loc_vol+bord_vol,spincolor);
+  
   for(int ic_sour=0;ic_sour<NCOL;ic_sour++)
     for(int id_sour=0;id_sour<4;id_sour++)
       {
@@ -249,11 +257,9 @@ THREADABLE_FUNCTION_0ARG(calculate_S0)
 	
 	// 1) prepare the source
 	master_printf("\n(S0) source index: id=%d, ic=%d\n",id_sour,ic_sour);
-	get_spincolor_from_su3spinspin(temp_source,original_source,id_sour,ic_sour);
-	
-	//smear the source
-	gaussian_smearing(source,temp_source,smea_conf,Gauss_kappa,Gauss_niter);
-	master_printf(" -> source smeared\n");
+	NISSA_PARALLEL_LOOP(ivol,0,loc_vol)
+	  get_spincolor_from_su3spinspin(source[ivol],smeared_source[ivol],id_sour,ic_sour);
+	set_borders_invalid(source);
 	
 	//============================================================================
 	
@@ -281,20 +287,28 @@ THREADABLE_FUNCTION_0ARG(calculate_S0)
 		    double arg=M_PI*dt/glb_size[0];
 		    complex phase={cos(arg),sin(arg)};
 		    
-		    unsafe_spincolor_prod_complex(temp_source[ivol],sol_reco[r][ivol],phase);
-		    put_spincolor_into_su3spinspin(S0_SL[imass][r][ivol],temp_source[ivol],id_sour,ic_sour);
+		    unsafe_spincolor_prod_complex(sink[imass*2+r][ivol],sol_reco[r][ivol],phase);
+		    put_spincolor_into_su3spinspin(S0_SL[imass][r][ivol],sink[imass*2+r][ivol],id_sour,ic_sour);
 		  }
 		set_borders_invalid(S0_SL[imass][r]);
-		
-		//smear the sink
-		gaussian_smearing(source,temp_source,smea_conf,Gauss_kappa,Gauss_niter);
-		NISSA_PARALLEL_LOOP(ivol,0,loc_vol)
-		  put_spincolor_into_su3spinspin(S0_SS[imass][r][ivol],source[ivol],id_sour,ic_sour);
-		set_borders_invalid(S0_SS[imass][r]);
+		set_borders_invalid(sink[imass*2+r]);
 	      }
 	  }
+	
+	//smear the sinks
+	gaussian_smearing(sink,sink,2*nmass,smea_conf,Gauss_kappa,Gauss_niter);
+	for(int imass=0;imass<nmass;imass++)
+	  for(int r=0;r<2;r++)
+	    {
+	      NISSA_PARALLEL_LOOP(ivol,0,loc_vol)
+		put_spincolor_into_su3spinspin(S0_SS[imass][r][ivol],sink[imass*2+r][ivol],id_sour,ic_sour);
+	      set_borders_invalid(S0_SS[imass][r]);
+	    }
       }
   
+  for(int isink=0;isink<2*nmass;isink++) nissa_free(sink[isink]);
+  nissa_free(smeared_source);
+  
   //put the (1+ig5)/sqrt(2) factor
   for(int imass=0;imass<nmass;imass++)
     for(int r=0;r<2;r++) //remember that D^-1 rotate opposite than D!
@@ -877,7 +891,7 @@ void close_nucleons()
 {
   nissa_free(conf);nissa_free(smea_conf);nissa_free(Cl);
   nissa_free(original_source);nissa_free(source);
-  nissa_free(temp_source);nissa_free(seq_source);
+  nissa_free(seq_source);
   for(int imass=0;imass<nmass;imass++)
     {
       nissa_free(solDD[imass]);
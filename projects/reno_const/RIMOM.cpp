@@ -50,6 +50,7 @@ su3spinspin **S0[2];
 //cgm inverter parameters
 int use_cgm;
 double *stopping_residues;
+int ndefl_eig;
 int niter_max=1000000;
 
 //two points contractions
@@ -158,6 +159,8 @@ void initialize_Zcomputation(char *input_path)
   //Read the masses
   read_list_of_double_pairs("MassResidues",&nmass,&mass,&stopping_residues);
   read_str_int("UseCGM",&use_cgm);
+  //number of low modes to deflate, 0 to switch off
+  read_str_int("NDeflEig",&ndefl_eig);
   
   // 4) Boundary condition
   char time_bc_tag[1024];
@@ -246,6 +249,9 @@ void load_gauge_conf()
   //compute Pmunu
   if(cSW!=0) clover_term(Cl,cSW,conf);
   
+  //the multigrid setup must be recomputed
+  mg::invalidate_setup();
+  
   //write conf is asked
   if(write_fixed_conf)
     {
@@ -309,7 +315,48 @@ void close_Zcomputation()
 void calculate_S0()
 {
   inv_time-=take_time();
-  if(not use_cgm)
+  if(ndefl_eig)
+    {
+      //the low modes of Q2 serve all the sources and masses of this conf
+      deflation_subspace_t def;
+      if(cSW==0) find_deflation_subspace_tmQ2(def,ndefl_eig,conf,kappa,mass[0],stopping_residues[0]);
+      else       find_deflation_subspace_tmclovQ2(def,ndefl_eig,conf,kappa,Cl,mass[0],stopping_residues[0]);
+      
+      spincolor *temp_source=nissa_malloc("temp_source",loc_vol+bord_vol,spincolor);
+      spincolor *temp_sol=nissa_malloc("temp_sol",loc_vol+bord_vol,spincolor);
+      spincolor *temp_vec[2];
+      temp_vec[0]=nissa_malloc("temp_vec[0]",loc_vol+bord_vol,spincolor);
+      temp_vec[1]=nissa_malloc("temp_vec[1]",loc_vol+bord_vol,spincolor);
+      for(int id=0;id<NDIRAC;id++)
+	for(int ic=0;ic<NCOL;ic++)
+	  {
+	    //put the g5, then invert Q2 and reconstruct the doublet as in the cgm case
+	    get_spincolor_from_su3spinspin(temp_source,original_source,id,ic);
+	    safe_dirac_prod_spincolor(temp_source,base_gamma+5,temp_source);
+	    for(int im=0;im<nmass;im++)
+	      {
+		double res=stopping_residues[im];
+		if(cSW==0)
+		  {
+		    inv_tmQ2_cg_deflated(temp_sol,def,conf,kappa,mass[im],1000000,res,temp_source);
+		    reconstruct_tm_doublet(temp_vec[0],temp_vec[1],conf,kappa,mass[im],temp_sol);
+		  }
+		else
+		  {
+		    inv_tmclovQ2_cg_deflated(temp_sol,def,conf,kappa,Cl,mass[im],1000000,res,temp_source);
+		    reconstruct_tmclov_doublet(temp_vec[0],temp_vec[1],conf,kappa,Cl,mass[im],temp_sol);
+		  }
+		
+		for(int r=0;r<2;r++) put_spincolor_into_su3spinspin(S0[r][im],temp_vec[r],id,ic);
+	      }
+	  }
+      nissa_free(temp_vec[1]);
+      nissa_free(temp_vec[0]);
+      nissa_free(temp_source);
+      nissa_free(temp_sol);
+      def.destroy();
+    }
+  else if(not use_cgm)
     {
       spincolor *temp_source=nissa_malloc("temp_source",loc_vol+bord_vol,spincolor);
       spincolor *temp_sol=nissa_malloc("temp_sol",loc_vol+bord_vol,spincolor);
@@ -100,6 +100,9 @@ coords source_coord;
 spincolor *source;
 PROP_TYPE *original_source;
 
+//temporaries for the smearing, allocated once
+PROP_TYPE *smear_temp[2];
+
 //smearing parameters
 enum conf_smearing_t{no_conf_smearing,ape_conf_smearing,stout_conf_smearing};
 conf_smearing_t conf_smearing;
@@ -507,6 +510,9 @@ void initialize_semileptonic(char *input_path)
   source=nissa_malloc("source",loc_vol+bord_vol,spincolor);
   original_source=nissa_malloc("original_source",loc_vol,PROP_TYPE);
   
+  //Allocate the smearing temporaries
+  for(int i=0;i<2;i++) smear_temp[i]=nissa_malloc("smear_temp",loc_vol+bord_vol,PROP_TYPE);
+  
   //Allocate one PROP_TYPE for the chromo-contractions
   if(nch_contr_2pts!=0 or nch_contr_3pts!=0) ch_prop=nissa_malloc("chromo-prop",loc_vol,PROP_TYPE);
   
@@ -661,38 +667,16 @@ void close_semileptonic()
   for(int imass=0;imass<ncgm_solution;imass++) nissa_free(cgm_solution[imass]);
   nissa_free(cgm_solution);
   nissa_free(source);nissa_free(original_source);
+  nissa_free(smear_temp[0]);nissa_free(smear_temp[1]);
 }
 
-//smear addditivily a propagator
+//smear addditivily a propagator, all the spincolor components together
 void smear_additive_propagator(PROP_TYPE *out,PROP_TYPE *in,int ism_lev,int *gaussian_niter)
 {
-  spincolor *temp=nissa_malloc("temp",loc_vol+bord_vol,spincolor);
-  
   int nsme=gaussian_niter[ism_lev];
   if(ism_lev>0) nsme-=gaussian_niter[ism_lev-1];
   
-  //loop over dirac index
-#ifdef POINT_SOURCE_VERSION
-  for(int ic=0;ic<NCOL;ic++)
-#endif
-    for(int id=0;id<4;id++)
-      {
-#ifdef POINT_SOURCE_VERSION
-	get_spincolor_from_su3spinspin(temp,in,id,ic);
-#else
-	get_spincolor_from_colorspinspin(temp,in,id);
-#endif
-	
-	gaussian_smearing(temp,temp,sme_conf,gaussian_kappa,nsme);
-	
-#ifdef POINT_SOURCE_VERSION
-	put_spincolor_into_su3spinspin(out,temp,id,ic);
-#else
-	put_spincolor_into_colorspinspin(out,temp,id);
-#endif
-      }
-  
-  nissa_free(temp);
+  gaussian_smearing(out,in,sme_conf,gaussian_kappa,nsme,smear_temp[0],smear_temp[1]);
 }
 
 //calculate the standard propagators
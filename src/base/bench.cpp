@@ -144,4 +144,16 @@ namespace nissa
 	  master_printf("Communication benchmark, packet size %d (%lg, stddev %lg) Mb/s (%lg s total)\n",size,speed_ave,speed_stddev,tot_time);
 	}
   }
+  
+  //print how much of the halo exchange of an operator was left exposed after the bulk computation
+  void print_overlap_bench(const char *name,overlap_bench_t &bench)
+  {
+    if(bench.napp)
+      {
+	//the communication hidden behind the bulk cannot be measured directly: the bulk time is an upper bound
+	master_printf("%s: %d applications overlapping communications, %lg s of bulk computation, %lg s of exposed communication "
+		      "(waiting inside finish_communicating, %lg s per application)\n",
+		      name,bench.napp,bench.bulk_time,bench.exposed_comm_time,bench.exposed_comm_time/bench.napp);
+      }
+  }
 }
@@ -44,6 +44,15 @@ namespace nissa
   EXTERN_BENCH int nbgq_stdD_app EQUAL_ZERO;
 #endif
   
+  //timings of the operators overlapping communications and computation
+  struct overlap_bench_t
+  {
+    double bulk_time;         //time spent on the bulk while the halo is in flight
+    double exposed_comm_time; //time spent blocked inside finish_communicating, waiting the halo
+    int napp;
+  };
+  EXTERN_BENCH overlap_bench_t tmQ_overlap_bench,tmclovQ_overlap_bench,stDoe_overlap_bench;
+  
 #define UNPAUSE_TIMING(TIME) if(IS_MASTER_THREAD) TIME-=take_time()
 #define RESET_TIMING(TIME,COUNTER) do{if(IS_MASTER_THREAD){TIME=0;COUNTER=0;}}while(0)
 #define START_TIMING(TIME,COUNTER) do{if(IS_MASTER_THREAD){TIME-=take_time();COUNTER++;}}while(0)
@@ -52,6 +61,7 @@ namespace nissa
   void bench_memory_bandwidth(int mem_size);
   void bench_memory_copy(double *out,double *in,int size);
   void bench_net_speed();
+  void print_overlap_bench(const char *name,overlap_bench_t &bench);
   
   const int flops_per_complex_summ=2;
   const int flops_per_complex_prod=6;
@@ -18,6 +18,8 @@
 #endif
 #include "hmc/gauge/Symanzik_force.hpp"
 #include "hmc/gauge/Symanzik_action.hpp"
+#include "inverters/twisted_clover/mg_invert_tmclovD.hpp"
+#include "operations/fft.hpp"
 #include "operations/remap_vector.hpp"
 #include "routines/ios.hpp"
 #include "routines/thread.hpp"
@@ -39,6 +41,12 @@ namespace nissa
 	if(remap_locd_to_lx[mu]) delete remap_locd_to_lx[mu];
       }
     
+    //free the multigrid setup
+    mg::finalize();
+    
+    //destroy the fft plans, saving the wisdom
+    destroy_fft_plans();
+    
     //unset lx geometry
     if(lx_geom_inited) unset_lx_geometry();
     
@@ -68,12 +76,19 @@ namespace nissa
 	print_all_vect_content();
 	printf("For a total of %zu bytes\n",compute_vect_memory_usage());
       }
+    print_vect_pool_stats();
+    
+    //release the memory kept by the pool
+    vect_pool_release();
     
     tot_time+=take_time();
     master_printf("Total time: %lg s\n",tot_time);
 #ifdef COMM_BENCH
     master_printf("Total communication time: %lg s\n",tot_comm_time);
 #endif
+    print_overlap_bench("apply_tmQ",tmQ_overlap_bench);
+    print_overlap_bench("apply_tmclovQ",tmclovQ_overlap_bench);
+    print_overlap_bench("apply_stDoe",stDoe_overlap_bench);
     
     //free thread delays pattern
 #if THREAD_DEBUG>=2
@@ -40,6 +40,7 @@
 #endif
 #include "new_types/dirac.hpp"
 #include "new_types/high_prec.hpp"
+#include "operations/fft.hpp"
 #include "routines/ios.hpp"
 #include "routines/math_routines.hpp"
 #include "routines/mpi_routines.hpp"
@@ -206,15 +207,25 @@ namespace nissa
     use_hugepages=NISSA_DEFAULT_USE_HUGEPAGES;
 #endif
     
+#if FFT_TYPE == FFTW_FFT
+    fftw_planning_rigor=NISSA_DEFAULT_FFTW_PLANNING_RIGOR;
+    fftw_wisdom_path[0]='\0';
+#endif
+    
     //set default value for parameters
     perform_benchmark=NISSA_DEFAULT_PERFORM_BENCHMARK;
     verbosity_lv=NISSA_DEFAULT_VERBOSITY_LV;
     use_128_bit_precision=NISSA_DEFAULT_USE_128_BIT_PRECISION;
+    use_mixed_precision=NISSA_DEFAULT_USE_MIXED_PRECISION;
+    use_pipelined_cg=NISSA_DEFAULT_USE_PIPELINED_CG;
+    pipelined_cg_replace_each=NISSA_DEFAULT_PIPELINED_CG_REPLACE_EACH;
     use_eo_geom=NISSA_DEFAULT_USE_EO_GEOM;
     use_Leb_geom=NISSA_DEFAULT_USE_LEB_GEOM;
     warn_if_not_disallocated=NISSA_DEFAULT_WARN_IF_NOT_DISALLOCATED;
+    use_vect_pool=NISSA_DEFAULT_USE_VECT_POOL;
     warn_if_not_communicated=NISSA_DEFAULT_WARN_IF_NOT_COMMUNICATED;
     use_async_communications=NISSA_DEFAULT_USE_ASYNC_COMMUNICATIONS;
+    overlap_comm_and_comp=NISSA_DEFAULT_OVERLAP_COMM_AND_COMP;
     for(int mu=0;mu<NDIM;mu++) fix_nranks[mu]=0;
 #ifdef USE_VNODES
     vnode_paral_dir=NISSA_DEFAULT_VNODE_PARAL_DIR;
@@ -251,6 +262,9 @@ namespace nissa
     //read the configuration file, if present
     read_nissa_config_file();
     
+    //load the fft wisdom
+    init_fft_plans();
+    
     //setup the high precision
     init_high_precision();
     
@@ -820,11 +834,13 @@ namespace nissa
     set_lx_comm(lx_spin1field_comm,sizeof(spin1field));
     set_lx_comm(lx_spincolor_comm,sizeof(spincolor));
     set_lx_comm(lx_single_halfspincolor_comm,sizeof(single_halfspincolor));
+    set_lx_comm(lx_single_spincolor_comm,sizeof(single_spincolor));
     set_lx_comm(lx_spincolor_128_comm,sizeof(spincolor_128));
     set_lx_comm(lx_halfspincolor_comm,sizeof(halfspincolor));
     set_lx_comm(lx_colorspinspin_comm,sizeof(colorspinspin));
     set_lx_comm(lx_su3spinspin_comm,sizeof(su3spinspin));
     set_lx_comm(lx_oct_su3_comm,sizeof(oct_su3));
+    for(int nrhs=1;nrhs<=NISSA_MAX_NRHS;nrhs++) set_lx_comm(lx_multi_spincolor_comm[nrhs-1],nrhs*sizeof(spincolor));
     
     //setup all lx edges communicators
 #ifdef USE_MPI
@@ -842,6 +858,7 @@ namespace nissa
 	set_eo_comm(eo_single_color_comm,sizeof(single_color));
 	set_eo_comm(eo_halfspincolor_comm,sizeof(halfspincolor));
 	set_eo_comm(eo_single_halfspincolor_comm,sizeof(single_halfspincolor));
+	set_eo_comm(eo_single_spincolor_comm,sizeof(single_spincolor));
 	set_eo_comm(eo_quad_su3_comm,sizeof(quad_su3));
 	set_eo_comm(eo_su3_comm,sizeof(su3));
 	
@@ -849,6 +866,7 @@ namespace nissa
 	
 #ifdef USE_MPI
 	set_eo_edge_senders_and_receivers(MPI_EO_QUAD_SU3_EDGES_SEND,MPI_EO_QUAD_SU3_EDGES_RECE,&MPI_QUAD_SU3);
+	set_eo_edge_senders_and_receivers(MPI_EO_AS2T_SU3_EDGES_SEND,MPI_EO_AS2T_SU3_EDGES_RECE,&MPI_AS2T_SU3);
 #endif
       }
     
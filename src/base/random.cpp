@@ -24,7 +24,7 @@ namespace nissa
 {
   rnd_gen glb_rnd_gen;
   bool glb_rnd_gen_inited;
-  rnd_gen *loc_rnd_gen;
+  philox_rnd_gen *loc_rnd_gen;
   bool loc_rnd_gen_inited;
   
   double rnd_get_unif(rnd_gen *gen,double min,double max);
@@ -69,6 +69,13 @@ namespace nissa
     if(strlen(text)==1024) crash("use larger text");
   }
   
+  //print the key and counters of a counter-based generator into a string
+  void convert_rnd_gen_to_text(char *text,philox_rnd_gen *gen,int size)
+  {
+    int len=snprintf(text,size,"%u %u %u %u %lu",gen->key[0],gen->key[1],gen->site,gen->stream,(unsigned long)gen->ndraws);
+    if(len>=size) crash("use larger text");
+  }
+  
   //read all the entries of the random generator from a string
   void convert_text_to_rnd_gen(rnd_gen *gen,const char *text)
   {
@@ -83,6 +90,15 @@ namespace nissa
       }
   }
   
+  //read the key and counters of a counter-based generator from a string
+  void convert_text_to_rnd_gen(philox_rnd_gen *gen,const char *text)
+  {
+    unsigned long ndraws;
+    if(sscanf(text,"%u %u %u %u %lu",&gen->key[0],&gen->key[1],&gen->site,&gen->stream,&ndraws)!=PHILOX_RND_GEN_NWORDS-1)
+      crash("while reading counter-based generator from %s",text);
+    gen->ndraws=ndraws;
+  }
+  
   //initialize the global random generator
   void start_glb_rnd_gen(int seed)
   {
@@ -115,14 +131,9 @@ namespace nissa
     if(glb_rnd_gen_inited==0) start_glb_rnd_gen(seed);
     int internal_seed=(int)rnd_get_unif(&glb_rnd_gen,0,RAND_MAX-glb_vol);
     
-    //allocate the grid of random generator, one for site
-    loc_rnd_gen=nissa_malloc("Loc_rnd_gen",loc_vol,rnd_gen);
-    for(int ivol=0;ivol<loc_vol;ivol++)
-      {
-	int loc_seed=internal_seed+glblx_of_loclx[ivol];
-	if(loc_seed<0) crash("something went wrong with local seed: %d + %d = %d",internal_seed,glblx_of_loclx[ivol],loc_seed);
-	start_rnd_gen(&(loc_rnd_gen[ivol]),loc_seed);
-      }
+    //allocate the grid of random generator, one for site, all sharing the same key
+    loc_rnd_gen=nissa_malloc("Loc_rnd_gen",loc_vol,philox_rnd_gen);
+    for(int ivol=0;ivol<loc_vol;ivol++) start_rnd_gen(&(loc_rnd_gen[ivol]),internal_seed,glblx_of_loclx[ivol]);
     loc_rnd_gen_inited=1;
     master_printf("Grid of local random generators initialized with internal seed: %d\n",internal_seed);
   }
@@ -184,7 +195,7 @@ namespace nissa
   }
   
   //return a numer between 0 and 1
-  int rnd_get_pm_one(rnd_gen *gen)
+  template <class G> int rnd_get_pm_one(G *gen)
   {
     double r=rnd_get_unif(gen,0,1);
     if(r>0.5) return 1;
@@ -192,25 +203,25 @@ namespace nissa
   }
   
   //return a Z2 complex
-  void rnd_get_Z2(complex out,rnd_gen *gen)
+  template <class G> void rnd_get_Z2(complex out,G *gen)
   {
     out[0]=rnd_get_pm_one(gen);
     out[1]=0;
   }
   
   //return a Z4 complex
-  void rnd_get_Z4(complex out,rnd_gen *gen)
+  template <class G> void rnd_get_Z4(complex out,G *gen)
   {
     out[0]=rnd_get_pm_one(gen)/RAD2;
     out[1]=rnd_get_pm_one(gen)/RAD2;
   }
   
   //return a ZN complex
-  void rnd_get_ZN(complex out,rnd_gen *gen,int N)
+  template <class G> void rnd_get_ZN(complex out,G *gen,int N)
   {complex_iexp(out,2*M_PI*(int)rnd_get_unif(gen,0,N)/N);}
   
   //return a gaussian double
-  double rnd_get_gauss_double(rnd_gen *gen,double ave,double sig)
+  template <class G> double rnd_get_gauss_double(G *gen,double ave,double sig)
   {
     double q,r;
     
@@ -221,7 +232,7 @@ namespace nissa
   }
   
   //return a gaussian complex with sigma=sig/sqrt(2)
-  void rnd_get_gauss_complex(complex out,rnd_gen *gen,complex ave,double sig)
+  template <class G> void rnd_get_gauss_complex(complex out,G *gen,complex ave,double sig)
   {
     const double one_by_sqrt2=0.707106781186547;
     double norm=sig*one_by_sqrt2;
@@ -235,7 +246,7 @@ namespace nissa
   }
   
   //return a complex number of appropriate type
-  void comp_get_rnd(complex out,rnd_gen *gen,enum rnd_t rtype)
+  template <class G> void comp_get_rnd(complex out,G *gen,enum rnd_t rtype)
   {
     complex z={0,0};
     switch(rtype)
@@ -447,7 +458,7 @@ namespace nissa
   
     //Taken from M.D'Elia
 #if NCOL == 3
-  void herm_put_to_gauss(su3 H,rnd_gen *gen,double sigma)
+  template <class G> void herm_put_to_gauss(su3 H,G *gen,double sigma)
   {
     const double one_by_sqrt3=0.577350269189626;
     const double two_by_sqrt3=1.15470053837925;
@@ -483,14 +494,14 @@ namespace nissa
   
   // A gauss vector has complex components z which are gaussian distributed
   // with <z~ z> = sigma
-  void color_put_to_gauss(color H,rnd_gen *gen,double sigma)
+  template <class G> void color_put_to_gauss(color H,G *gen,double sigma)
   {
     complex ave={0,0};
     for(size_t ic=0;ic<NCOL;ic++) rnd_get_gauss_complex(H[ic],gen,ave,sigma);
   }
   
   //put a matrix to random used passed random generator
-  void su3_put_to_rnd(su3 u_ran,rnd_gen &rnd)
+  template <class G> void su3_put_to_rnd(su3 u_ran,G &rnd)
   {
     su3_put_to_id(u_ran);
     
@@ -527,7 +538,7 @@ namespace nissa
   
   //return a single link after the heatbath procedure
   //routines to be shrunk!
-  void su3_find_heatbath(su3 out,su3 in,su3 staple,double beta,int nhb_hits,rnd_gen *gen)
+  template <class G> void su3_find_heatbath(su3 out,su3 in,su3 staple,double beta,int nhb_hits,G *gen)
   {
     //compute the original contribution to the action due to the given link 
     su3 prod;
@@ -580,4 +591,97 @@ namespace nissa
 	  su2_prodassign_su3(x0,x1,x2,x3,isub_gr,out);
 	}
   }
+  
+  //same of the above on a batch of links, each lane using its own generator; only the first nlanes are updated
+  template <class G> void batch_su3_find_heatbath(batch_su3 out,const batch_su3 staple,double beta,int nhb_hits,G **gen,int nlanes)
+  {
+    //compute the original contribution to the action due to the given link
+    batch_su3 prod;
+    unsafe_batch_su3_prod_batch_su3_dag(prod,out,staple);
+    
+    //iterate over heatbath hits
+    for(int ihit=0;ihit<nhb_hits;ihit++)
+      //scan all the three possible subgroups
+      for(int isub_gr=0;isub_gr<3;isub_gr++)
+	{
+	  //take the part of the su3 matrix
+	  batch_double smod,r0,r1,r2,r3;
+	  batch_su2_part_of_su3(smod,r0,r1,r2,r3,prod,isub_gr);
+	  
+	  //omega is the coefficient of the plaquette, divided by the module of the su2 submatrix for normalization
+	  batch_double omega_f,z_norm;
+	  BATCH_LANE_LOOP(l)
+	    {
+	      omega_f[l]=beta/(3*smod[l]);
+	      z_norm[l]=exp(-2*omega_f[l]);
+	      omega_f[l]=1/omega_f[l];
+	    }
+	  
+	  //extract the random numbers lane by lane, as the rejection steps differ
+	  batch_double a0,x_rat,fi,cteta;
+	  BATCH_LANE_LOOP(l)
+	    if(l<nlanes)
+	      {
+		double temp_f,z_f;
+		do
+		  {
+		    double z_temp=(z_norm[l]-1)*rnd_get_unif(gen[l],0,1)+1;
+		    a0[l]  = 1+omega_f[l]*log(z_temp);
+		    z_f    = 1-a0[l]*a0[l];
+		    temp_f = sqr(rnd_get_unif(gen[l],0,1))-z_f;
+		  }
+		while(temp_f>0);
+		
+		x_rat[l]=sqrt(z_f);
+		fi[l]=rnd_get_unif(gen[l],0,2*M_PI);
+		cteta[l]=rnd_get_unif(gen[l],-1,1);
+	      }
+	    else
+	      {
+		a0[l]=1;
+		x_rat[l]=fi[l]=cteta[l]=0;
+	      }
+	  
+	  //generate an su2 matrix
+	  batch_double x0,x1,x2,x3;
+	  BATCH_LANE_LOOP(l)
+	    {
+	      double steta=sqrt(1-cteta[l]*cteta[l]);
+	      
+	      double a1=steta*cos(fi[l])*x_rat[l];
+	      double a2=steta*sin(fi[l])*x_rat[l];
+	      double a3=cteta[l]*x_rat[l];
+	      
+	      x0[l] = a0[l]*r0[l] + a1*r1[l] + a2*r2[l] + a3*r3[l];
+	      x1[l] = r0[l]*a1 - a0[l]*r1[l] + a2*r3[l] - r2[l]*a3;
+	      x2[l] = r0[l]*a2 - a0[l]*r2[l] + a3*r1[l] - r3[l]*a1;
+	      x3[l] = r0[l]*a3 - a0[l]*r3[l] + a1*r2[l] - r1[l]*a2;
+	    }
+	  
+	  batch_su2_prodassign_su3(x0,x1,x2,x3,isub_gr,prod);
+	  batch_su2_prodassign_su3(x0,x1,x2,x3,isub_gr,out);
+	}
+  }
+  
+  //instantiate the functions for the two kind of generators
+#define INSTANTIATE_RND_GEN_FUNCTIONS(G)					\
+  template int rnd_get_pm_one(G *gen);					\
+  template void rnd_get_Z2(complex out,G *gen);				\
+  template void rnd_get_Z4(complex out,G *gen);				\
+  template void rnd_get_ZN(complex out,G *gen,int N);			\
+  template double rnd_get_gauss_double(G *gen,double ave,double sig);	\
+  template void rnd_get_gauss_complex(complex out,G *gen,complex ave,double sig); \
+  template void comp_get_rnd(complex out,G *gen,enum rnd_t rtype);	\
+  template void color_put_to_gauss(color H,G *gen,double sigma);	\
+  template void su3_put_to_rnd(su3 u_ran,G &rnd);			\
+  template void su3_find_heatbath(su3 out,su3 in,su3 staple,double beta,int nhb_hits,G *gen); \
+  template void batch_su3_find_heatbath(batch_su3 out,const batch_su3 staple,double beta,int nhb_hits,G **gen,int nlanes)
+  
+  INSTANTIATE_RND_GEN_FUNCTIONS(rnd_gen);
+  INSTANTIATE_RND_GEN_FUNCTIONS(philox_rnd_gen);
+  
+#if NCOL == 3
+  template void herm_put_to_gauss(su3 H,rnd_gen *gen,double sigma);
+  template void herm_put_to_gauss(su3 H,philox_rnd_gen *gen,double sigma);
+#endif
 }
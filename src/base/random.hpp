@@ -2,14 +2,19 @@
 #define _RANDOM_HPP
 
 #include <fcntl.h>
+#include <stdint.h>
 #include <unistd.h>
 
 #include "geometry/geometry_lx.hpp"
 #include "new_types/su3.hpp"
+#include "new_types/su3_batch.hpp"
 
 //random number generator table length
 #define RAN2_NTAB 32
 
+//number of words needed to store a counter-based generator
+#define PHILOX_RND_GEN_NWORDS 6
+
 namespace nissa
 {
   //Random types
@@ -29,19 +34,84 @@ namespace nissa
     int iy;
   };
   
+  //counter-based generator: the numbers are obtained by encrypting the counter (draw,site,stream) with the key (seed)
+  //so no state other than the number of draws is needed, and any site can be generated independently
+  struct philox_rnd_gen
+  {
+    uint32_t key[2];
+    uint32_t site;
+    uint32_t stream;
+    uint64_t ndraws;
+  };
+  
   //random generator stuff
   extern rnd_gen glb_rnd_gen;
   extern bool glb_rnd_gen_inited;
-  extern rnd_gen *loc_rnd_gen;
+  extern philox_rnd_gen *loc_rnd_gen;
   extern bool loc_rnd_gen_inited;
   
+  //one round of Philox4x32
+  inline void philox4x32_round(uint32_t *ctr,const uint32_t *key)
+  {
+    const uint64_t p0=(uint64_t)0xD2511F53*ctr[0];
+    const uint64_t p1=(uint64_t)0xCD9E8D57*ctr[2];
+    const uint32_t c1=ctr[1],c3=ctr[3];
+    ctr[0]=(uint32_t)(p1>>32)^c1^key[0];
+    ctr[1]=(uint32_t)p1;
+    ctr[2]=(uint32_t)(p0>>32)^c3^key[1];
+    ctr[3]=(uint32_t)p0;
+  }
+  
+  //Philox4x32-10 by Salmon et al., encrypting in place the counter with the key
+  inline void philox4x32_10(uint32_t *ctr,const uint32_t *ext_key)
+  {
+    uint32_t key[2]={ext_key[0],ext_key[1]};
+    for(int iround=0;iround<10;iround++)
+      {
+	if(iround)
+	  {
+	    key[0]+=0x9E3779B9;
+	    key[1]+=0xBB67AE85;
+	  }
+	philox4x32_round(ctr,key);
+      }
+  }
+  
+  //return the idraw-th number uniformly distributed in [0,1), keyed by seed, site and stream
+  //two 53 bits numbers are obtained from each block, the function has no state and can be vectorized over sites
+  inline double philox_get_unif(const uint32_t *key,uint32_t site,uint32_t stream,uint64_t idraw)
+  {
+    uint32_t ctr[4]={(uint32_t)(idraw>>1),(uint32_t)(idraw>>33),site,stream};
+    philox4x32_10(ctr,key);
+    const int i=2*(idraw&1);
+    const uint64_t r=((uint64_t)ctr[i]<<32)|ctr[i+1];
+    
+    return (r>>11)*(1.0/9007199254740992.0);
+  }
+  
+  //initialize a counter-based generator
+  inline void start_rnd_gen(philox_rnd_gen *out,uint32_t seed,uint32_t site,uint32_t stream=0)
+  {
+    out->key[0]=seed;
+    out->key[1]=0;
+    out->site=site;
+    out->stream=stream;
+    out->ndraws=0;
+  }
+  
+  //draw the next number from a counter-based generator
+  inline double rnd_get_unif(philox_rnd_gen *gen,double min,double max)
+  {return philox_get_unif(gen->key,gen->site,gen->stream,gen->ndraws++)*(max-min)+min;}
+  
   rnd_t convert_str_to_rnd_t(const char *str);
-  void color_put_to_gauss(color H,rnd_gen *gen,double sigma);
+  template <class G> void color_put_to_gauss(color H,G *gen,double sigma);
   void convert_text_to_rnd_gen(rnd_gen *gen,const char *text);
+  void convert_text_to_rnd_gen(philox_rnd_gen *gen,const char *text);
   void convert_rnd_gen_to_text(char *text,rnd_gen *gen,int size);
+  void convert_rnd_gen_to_text(char *text,philox_rnd_gen *gen,int size);
   double rnd_get_unif(rnd_gen *gen,double min,double max);
-  int rnd_get_pm_one(rnd_gen *gen);
-  void comp_get_rnd(complex out,rnd_gen *gen,enum rnd_t rtype);
+  template <class G> int rnd_get_pm_one(G *gen);
+  template <class G> void comp_get_rnd(complex out,G *gen,enum rnd_t rtype);
   void generate_delta_eo_source(su3 **source,int *x);
   void generate_delta_source(su3spinspin *source,int *x);
   void generate_colorspindiluted_source(su3spinspin *source,enum rnd_t rtype,int twall);
@@ -54,25 +124,26 @@ namespace nissa
   void generate_fully_undiluted_eo_source(color **source,enum rnd_t rtype,int twall,int dir=0);
   void generate_fully_undiluted_eo_source(spincolor *source,enum rnd_t rtype,int twall,int par,int dir=0);
   void generate_fully_undiluted_eo_source(spincolor **source,enum rnd_t rtype,int twall,int dir=0);
-  void herm_put_to_gauss(su3 H,rnd_gen *gen,double sigma);
+  template <class G> void herm_put_to_gauss(su3 H,G *gen,double sigma);
   void rnd_fill_pm_one_loc_vector(double *v,int nps);
   void rnd_fill_unif_loc_vector(double *v,int dps,double min,double max);
   void generate_random_coord(coords c);
-  void rnd_get_Z2(complex out,rnd_gen *gen);
-  void rnd_get_Z4(complex out,rnd_gen *gen);
-  void rnd_get_ZN(complex out,rnd_gen *gen,int N);
-  inline void rnd_get_Z3(complex out,rnd_gen *gen)
+  template <class G> void rnd_get_Z2(complex out,G *gen);
+  template <class G> void rnd_get_Z4(complex out,G *gen);
+  template <class G> void rnd_get_ZN(complex out,G *gen,int N);
+  template <class G> void rnd_get_Z3(complex out,G *gen)
   {rnd_get_ZN(out,gen,3);}
-  double rnd_get_gauss_double(rnd_gen *gen,double ave=0,double sig=1);
-  void rnd_get_gauss_complex(complex out,rnd_gen *gen,complex ave,double sig);
+  template <class G> double rnd_get_gauss_double(G *gen,double ave=0,double sig=1);
+  template <class G> void rnd_get_gauss_complex(complex out,G *gen,complex ave,double sig);
   void start_glb_rnd_gen(const char *text);
   void start_glb_rnd_gen(int seed);
   void start_loc_rnd_gen(int seed);
   void start_loc_rnd_gen(const char *mess);
   void start_rnd_gen(rnd_gen *out,int seed);
   void stop_loc_rnd_gen();
-  void su3_find_heatbath(su3 out,su3 in,su3 staple,double beta,int nhb_hits,rnd_gen *gen);
-  void su3_put_to_rnd(su3 u_ran,rnd_gen &rnd);
+  template <class G> void su3_find_heatbath(su3 out,su3 in,su3 staple,double beta,int nhb_hits,G *gen);
+  template <class G> void batch_su3_find_heatbath(batch_su3 out,const batch_su3 staple,double beta,int nhb_hits,G **gen,int nlanes);
+  template <class G> void su3_put_to_rnd(su3 u_ran,G &rnd);
   
   //read from /dev/urandom
   template <typename T>
@@ -7,6 +7,9 @@
 #include <string.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <map>
+#include <utility>
+#include <vector>
 
 #include "communicate/communicate.hpp"
 #include "geometry/geometry_lx.hpp"
@@ -48,6 +51,153 @@ namespace nissa
   };
 #endif
   
+  namespace
+  {
+    //released blocks, indexed by size and by hugepage backing
+    std::map<std::pair<int64_t,bool>,std::vector<nissa_vect*> > vect_pool;
+    
+    //memory currently taken from the system
+    int64_t vect_pool_resident_memory=0;
+  }
+  
+  //size of the block needed to hold a vector of given size, or zero if not to be pooled
+  int64_t vect_pool_block_size(int64_t size,bool hugepages)
+  {
+    if(not use_vect_pool or size<NISSA_VECT_POOL_MIN_SIZE) return 0;
+    
+    const int64_t gran=hugepages?NISSA_HUGEPAGE_SIZE:NISSA_VECT_POOL_GRANULARITY;
+    return (size+(int64_t)sizeof(nissa_vect)+gran-1)/gran*gran;
+  }
+  
+  //get a block from the system
+  nissa_vect *vect_pool_system_alloc(int64_t size,bool hugepages)
+  {
+    void *ptr=NULL;
+#ifdef USE_HUGEPAGES
+    if(hugepages)
+      {
+	ptr=mmap(NULL,size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB,-1,0);
+	if(ptr==MAP_FAILED) ptr=NULL;
+      }
+    else
+#endif
+      if(posix_memalign(&ptr,NISSA_VECT_ALIGNMENT,size)) ptr=NULL;
+    
+    return (nissa_vect*)ptr;
+  }
+  
+  //give back a block to the system
+  void vect_pool_system_free(nissa_vect *vect,int64_t size,bool hugepages)
+  {
+#ifdef USE_HUGEPAGES
+    if(hugepages)
+      {
+	if(munmap(vect,size)!=0)
+	  {
+	    perror("Unmapping error: ");
+	    crash("freeing a block of %ld bytes",size);
+	  }
+      }
+    else
+#endif
+      free(vect);
+    
+    vect_pool_resident_memory-=size;
+  }
+  
+  //release all the cached blocks
+  void vect_pool_release()
+  {
+    for(std::map<std::pair<int64_t,bool>,std::vector<nissa_vect*> >::iterator it=vect_pool.begin();it!=vect_pool.end();it++)
+      {
+	for(size_t i=0;i<it->second.size();i++) vect_pool_system_free(it->second[i],it->first.first,it->first.second);
+	vect_pool_cached_memory-=it->first.first*it->second.size();
+      }
+    vect_pool.clear();
+  }
+  
+  //allocate a block of given size, first searching in the pool
+  nissa_vect *vect_pool_get(int64_t size)
+  {
+    //hugepages are used only if asked
+    bool hugepages=false;
+#ifdef USE_HUGEPAGES
+    hugepages=use_hugepages;
+#endif
+    
+    //hugepages are used only for pooled blocks, whose size is rounded up to the hugepage size
+    int64_t block_size=vect_pool_block_size(size,hugepages);
+    if(block_size==0) hugepages=false;
+    
+    //search in the pool
+    nissa_vect *vect=NULL;
+    if(block_size)
+      {
+	std::vector<nissa_vect*> &list=vect_pool[std::make_pair(block_size,hugepages)];
+	if(list.size())
+	  {
+	    vect=list.back();
+	    list.pop_back();
+	    vect_pool_cached_memory-=block_size;
+	    vect_pool_nhits++;
+	  }
+	else vect_pool_nmisses++;
+      }
+    
+    if(vect==NULL)
+      {
+	//fall back to ordinary pages if hugepages are not available
+	if(hugepages)
+	  {
+	    vect=vect_pool_system_alloc(block_size,true);
+	    if(vect==NULL)
+	      {
+		hugepages=false;
+		block_size=vect_pool_block_size(size,false);
+	      }
+	  }
+	
+	//if it fails, release the pool and retry
+	const int64_t alloc_size=block_size?block_size:(size+sizeof(nissa_vect));
+	if(vect==NULL) vect=vect_pool_system_alloc(alloc_size,hugepages);
+	if(vect==NULL and vect_pool_cached_memory)
+	  {
+	    vect_pool_release();
+	    vect=vect_pool_system_alloc(alloc_size,hugepages);
+	  }
+	if(vect==NULL) return NULL;
+	
+	vect_pool_resident_memory+=alloc_size;
+	vect_pool_max_resident_memory=std::max(vect_pool_max_resident_memory,vect_pool_resident_memory);
+      }
+    
+    vect->block_size=block_size;
+    vect->block_on_hugepages=hugepages;
+    
+    return vect;
+  }
+  
+  //put a block back in the pool, or release it
+  void vect_pool_put(nissa_vect *vect)
+  {
+    const int64_t block_size=vect->block_size;
+    const bool hugepages=vect->block_on_hugepages;
+    
+    if(block_size and use_vect_pool)
+      {
+	vect_pool[std::make_pair(block_size,hugepages)].push_back(vect);
+	vect_pool_cached_memory+=block_size;
+      }
+    else vect_pool_system_free(vect,block_size?block_size:(vect->nel*vect->size_per_el+sizeof(nissa_vect)),hugepages);
+  }
+  
+  //print the statistics of the pool
+  void print_vect_pool_stats()
+  {
+    master_printf("Vector pool: %ld hits, %ld misses, %ld bytes cached, peak resident memory %ld bytes\n",
+		  vect_pool_nhits,vect_pool_nmisses,vect_pool_cached_memory,vect_pool_max_resident_memory);
+  }
+  
   //return the pointer to the nissa vect
   nissa_vect* get_vect(void *v)
   {return (nissa_vect*)v-1;}
@@ -235,6 +385,9 @@ namespace nissa
 	main_vect.line=__LINE__;
 	main_arr=(char*)last_vect+sizeof(nissa_vect);
 	
+	vect_pool_nhits=vect_pool_nmisses=0;
+	vect_pool_cached_memory=vect_pool_max_resident_memory=0;
+	
 	master_printf("Vector memory manager started\n");
       }
   }
@@ -255,7 +408,7 @@ namespace nissa
 	
 	int64_t size=nel*size_per_el;
 	//try to allocate the new vector
-	nissa_vect *nv=(nissa_vect*)malloc(size+sizeof(nissa_vect));
+	nissa_vect *nv=vect_pool_get(size);
 	if(nv==NULL)
 	  crash("could not allocate vector named \"%s\" of %d elements of type %s (total size: %d bytes) "
 		"request on line %d of file %s",tag,nel,type,size,line,file);
@@ -403,8 +556,8 @@ namespace nissa
 	    //update the required memory
 	    required_memory-=(vect->size_per_el*vect->nel);
 	    
-	    //really free
-	    free(vect);
+	    //give back to the pool
+	    vect_pool_put(vect);
 	  }
 	else crash("Error, trying to delocate a NULL vector on line: %d of file: %s\n",line,file);
 	
@@ -432,5 +585,5 @@ namespace nissa
     nissa_free(buf);
   }
   THREADABLE_FUNCTION_END
-  
+
 }
@@ -27,9 +27,18 @@
 #define SEND_FORWARD_BORD 2
 
 #define NISSA_DEFAULT_WARN_IF_NOT_DISALLOCATED 1
+#define NISSA_DEFAULT_USE_VECT_POOL 1
+
+//vectors smaller than this are not recycled through the pool
+#define NISSA_VECT_POOL_MIN_SIZE 65536
+//granularity of the size classes of the pool, and of hugepages
+#define NISSA_VECT_POOL_GRANULARITY 4096
+#define NISSA_HUGEPAGE_SIZE 2097152
 
 #define NISSA_VECT_STRING_LENGTH 20
-#if defined(BGQ) && !defined(BGQ_EMU)
+#if defined(USE_AVX512)
+ #define NISSA_VECT_ALIGNMENT 64
+#elif (defined(BGQ) && !defined(BGQ_EMU)) || defined(USE_AVX2)
  #define NISSA_VECT_ALIGNMENT 32
 #else
  #define NISSA_VECT_ALIGNMENT 16
@@ -64,8 +73,12 @@ namespace nissa
     
     uint32_t flag;
     
+    //hugepage backing, and size of the block (including this header) if taken from the pool, zero otherwise
+    uint32_t block_on_hugepages;
+    int64_t block_size;
+    
     //padding to keep memory alignment
-    char pad[(NISSA_VECT_ALIGNMENT-(2*sizeof(int64_t)+3*NISSA_VECT_STRING_LENGTH+sizeof(int)+2*sizeof(nissa_vect*)+sizeof(uint32_t))%NISSA_VECT_ALIGNMENT)%
+    char pad[(NISSA_VECT_ALIGNMENT-(3*sizeof(int64_t)+3*NISSA_VECT_STRING_LENGTH+sizeof(int)+2*sizeof(nissa_vect*)+2*sizeof(uint32_t))%NISSA_VECT_ALIGNMENT)%
 	      NISSA_VECT_ALIGNMENT];
   };
   
@@ -78,6 +91,13 @@ namespace nissa
   EXTERN_VECTORS nissa_vect *last_vect;
   EXTERN_VECTORS void *return_malloc_ptr;
   
+  //pool of released blocks, recycled by size
+  EXTERN_VECTORS int use_vect_pool;
+  EXTERN_VECTORS int64_t vect_pool_nhits;
+  EXTERN_VECTORS int64_t vect_pool_nmisses;
+  EXTERN_VECTORS int64_t vect_pool_cached_memory;
+  EXTERN_VECTORS int64_t vect_pool_max_resident_memory;
+  
   char *get_vect_name(void *v);
   int check_borders_allocated(void *data,int min_size);
   int check_borders_communicated_at_least_once(void *data);
@@ -99,6 +119,8 @@ namespace nissa
   void vect_content_fprintf(FILE *fout,nissa_vect *vect);
   void vect_content_printf(nissa_vect *vect);
   void print_all_vect_content();
+  void print_vect_pool_stats();
+  void vect_pool_release();
   void reorder_vector(char *vect,int *order,int nel,int sel);
   void set_borders_invalid(void *data);
   void set_borders_valid(void *data);
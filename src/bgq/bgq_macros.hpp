@@ -10,12 +10,16 @@
 
 ////////////////////////////// convert normal complex to BI //////////////////////////
 
-#ifdef BGQ_EMU
+#if defined BGQ_EMU && !defined USE_AVX2
  #define DECLARE_REG_VIR_COMPLEX(A) vir_complex A
+#else
+ #define DECLARE_REG_VIR_COMPLEX(A) reg_vir_complex A
+#endif
+
+#ifdef BGQ_EMU
  #define COMPLEX_TO_VIR_COMPLEX(A,B,VN) complex_copy(A[VN],B)
  #define COMPLEX_TO_VIR_SINGLE_COMPLEX(A,B,VN) single_complex_copy_from_complex(A[VN],B)
 #else
-#define DECLARE_REG_VIR_COMPLEX(A) reg_vir_complex A
  #define COMPLEX_TO_VIR_COMPLEX(A,B,VN) vec_st2(vec_ld2(0,B),0,A[VN])
  #define COMPLEX_TO_VIR_SINGLE_COMPLEX(A,B,VN) vec_st2(vec_ld2(0,B),0,A[VN])
 #endif
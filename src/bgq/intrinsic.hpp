@@ -1,12 +1,23 @@
 #ifndef _BGQ_INTRINSIC_HPP
 #define _BGQ_INTRINSIC_HPP
 
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#ifdef USE_AVX2
+ #include <immintrin.h>
+#endif
+
 #include "new_types/complex.hpp"
 
 namespace nissa
 {
 #if (defined BGQ) && (!defined BGQ_EMU)
   typedef vector4double reg_vir_complex;
+#elif defined USE_AVX2
+  //the two virtual nodes fill exactly one 256 bit register: (re0,im0,re1,im1)
+  typedef __m256d reg_vir_complex;
 #else
   typedef vir_complex reg_vir_complex;
 #endif //BGQ_EMU
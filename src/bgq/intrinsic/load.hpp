@@ -308,7 +308,9 @@
 
 //////////////////////////////////// loading //////////////////////////////////
 
-#ifdef BGQ_EMU
+#if defined USE_AVX2
+ #define REG_SPLAT_VIR_COMPLEX(out,in) out=_mm256_set1_pd(in)
+#elif defined BGQ_EMU
  #define REG_SPLAT_VIR_COMPLEX(out,in) VIR_COMPLEX_SPLAT(out,in)
 #else
  #define REG_SPLAT_VIR_COMPLEX(out,in) out=vec_splats(in)
@@ -341,14 +343,38 @@
     REG_SPLAT_VIR_COLOR(NAME2(out,s3),in);		\
   }
 
-#ifdef BGQ_EMU
+#if defined USE_AVX2
+ #define REG_LOAD_VIR_COMPLEX(out,in) out=_mm256_loadu_pd((double*)(in))
+#elif defined BGQ_EMU
  #define REG_LOAD_VIR_COMPLEX(out,in) VIR_COMPLEX_COPY(out,in)
 #else
  #define REG_LOAD_VIR_COMPLEX(out,in) out=vec_ld(0,(double*)(in))
 #endif
 
 //load *after* increment the address of a certain amount
-#ifdef BGQ_EMU
+#if defined USE_AVX2
+ #define BGQ_QVLFDUXA(dest,addr,offset)					\
+   do									\
+     {									\
+       (addr)=(double*)((uintptr_t)(addr)+(offset));			\
+       (dest)=_mm256_loadu_pd((double*)(addr));				\
+     }									\
+   while(0)
+ #define BGQ_QVLFSUXA(dest,addr,offset)					\
+   do									\
+     {									\
+       (addr)=(float*)((uintptr_t)(addr)+(offset));			\
+       (dest)=_mm256_cvtps_pd(_mm_loadu_ps((float*)(addr)));		\
+     }									\
+   while(0)
+ #define BGQ_QVLFCDUXA(dest,addr,offset)				\
+   do									\
+     {									\
+       (addr)=(double*)((uintptr_t)(addr)+(offset));			\
+       (dest)=_mm256_broadcast_pd((__m128d*)(addr));			\
+     }									\
+   while(0)
+#elif defined BGQ_EMU
  #define BGQ_QVLFDUXA(dest,addr,offset)					\
    do									\
      {									\
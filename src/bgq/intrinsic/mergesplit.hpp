@@ -23,7 +23,11 @@
  #define V_TRANSPOSE 2301
 #endif
 
-#ifdef BGQ_EMU
+#if defined USE_AVX2
+ //all the permutations we need move whole complex (128 bit lanes), so we can compute the immediate of permute2f128
+ #define VEC_PERM2F128_IMM(how) ((((how)/1000)/2)|(((((how)/10)%10)/2)<<4))
+ #define REG_VIR_COMPLEX_PERM(out,in1,in2,how) (out)=_mm256_permute2f128_pd(in1,in2,VEC_PERM2F128_IMM(how))
+#elif defined BGQ_EMU
  #define vec_perm_el(out,in1,in2,a,b) ((double*)(out))[(a)]=((b)>=4)?((double*)(in2))[(b)-4]:((double*)(in1))[(b)]
  #define REG_VIR_COMPLEX_PERM(out,in1,in2,how)				\
    {									\
@@ -20,6 +20,28 @@
 #define REG_VIR_COMPLEX_SUMM_THE_CONJ1_PROD(out,op1,op2)       out=vec_xxcpnmadd(op2,op1,vec_xmadd(op1,op2,out))
 #define REG_VIR_COMPLEX_SUBT_THE_CONJ1_PROD(out,op1,op2)       out=vec_xxnpmadd(op2,op1,vec_sub(out,vec_xmul(op1,op2)))
 
+#elif defined USE_AVX2
+
+//register layout is (re0,im0,re1,im1): real and imaginary parts are duplicated or swapped inside each 128 bit lane
+#define REG_VIR_COMPLEX_DUP_RE(op)                             _mm256_movedup_pd(op)
+#define REG_VIR_COMPLEX_DUP_IM(op)                             _mm256_permute_pd(op,15)
+#define REG_VIR_COMPLEX_SWAP_RE_IM(op)                         _mm256_permute_pd(op,5)
+#define REG_VIR_COMPLEX_PROD_NOSUMM(op1,op2)                   _mm256_fmaddsub_pd(REG_VIR_COMPLEX_DUP_RE(op1),op2,_mm256_mul_pd(REG_VIR_COMPLEX_DUP_IM(op1),REG_VIR_COMPLEX_SWAP_RE_IM(op2)))
+#define REG_VIR_COMPLEX_CONJ1_PROD_NOSUMM(op1,op2)             _mm256_fmsubadd_pd(REG_VIR_COMPLEX_DUP_RE(op1),op2,_mm256_mul_pd(REG_VIR_COMPLEX_DUP_IM(op1),REG_VIR_COMPLEX_SWAP_RE_IM(op2)))
+
+#define REG_VIR_COMPLEX_SUMM(out,op1,op2)                      out=_mm256_add_pd(op1,op2)
+#define REG_VIR_COMPLEX_SUBT(out,op1,op2)                      out=_mm256_sub_pd(op1,op2)
+#define REG_VIR_COMPLEX_ISUMM(out,op1,op2)                     out=_mm256_addsub_pd(op1,REG_VIR_COMPLEX_SWAP_RE_IM(op2))
+#define REG_VIR_COMPLEX_ISUBT(out,op1,op2)                     out=_mm256_fmsubadd_pd(op1,_mm256_set1_pd(1),REG_VIR_COMPLEX_SWAP_RE_IM(op2))
+#define REG_VIR_COMPLEX_PROD(out,op1,op2)                      out=REG_VIR_COMPLEX_PROD_NOSUMM(op1,op2)
+#define REG_VIR_COMPLEX_PROD_4DOUBLE(out,op1,op2)              out=_mm256_mul_pd(op1,op2)
+#define REG_VIR_COMPLEX_SUMM_THE_PROD_4DOUBLE(out,add,op1,op2) out=_mm256_fmadd_pd(op1,op2,add)
+#define REG_VIR_COMPLEX_CONJ1_PROD(out,op1,op2)                out=REG_VIR_COMPLEX_CONJ1_PROD_NOSUMM(op1,op2)
+#define REG_VIR_COMPLEX_SUMM_THE_PROD(out,op1,op2)             out=_mm256_add_pd(out,REG_VIR_COMPLEX_PROD_NOSUMM(op1,op2))
+#define REG_VIR_COMPLEX_SUBT_THE_PROD(out,op1,op2)             out=_mm256_sub_pd(out,REG_VIR_COMPLEX_PROD_NOSUMM(op1,op2))
+#define REG_VIR_COMPLEX_SUMM_THE_CONJ1_PROD(out,op1,op2)       out=_mm256_add_pd(out,REG_VIR_COMPLEX_CONJ1_PROD_NOSUMM(op1,op2))
+#define REG_VIR_COMPLEX_SUBT_THE_CONJ1_PROD(out,op1,op2)       out=_mm256_sub_pd(out,REG_VIR_COMPLEX_CONJ1_PROD_NOSUMM(op1,op2))
+
 #else
 
 #define REG_VIR_COMPLEX_SUMM(out,op1,op2)                      VIR_COMPLEX_SUMM(out,op1,op2)
@@ -22,7 +22,29 @@
 #endif
 
 //store *after* increment the address of a certain amount
-#ifdef BGQ_EMU
+#if defined USE_AVX2
+#define BGQ_QVSTFDUXA(addr,data,offset)					\
+  do									\
+  {									\
+    (addr)=(double*)((uintptr_t)(addr)+(offset));			\
+    _mm256_storeu_pd((double*)(addr),data);				\
+  }									\
+  while(0)
+#define BGQ_QVSTFSUXA(addr,data,offset)					\
+  do									\
+  {									\
+    (addr)=(float*)((uintptr_t)(addr)+(offset));			\
+    _mm_storeu_ps((float*)(addr),_mm256_cvtpd_ps(data));		\
+  }									\
+  while(0)
+#define BGQ_QVSTFCDUXA(addr,data,offset)				\
+  do									\
+  {									\
+    (addr)=(double*)((uintptr_t)(addr)+(offset));			\
+    _mm_storeu_pd((double*)(addr),_mm256_castpd256_pd128(data));	\
+  }									\
+  while(0)
+#elif defined BGQ_EMU
 #define BGQ_QVSTFDUXA(addr,data,offset)					\
   do									\
   {									\
@@ -53,7 +75,9 @@
   asm ("qvstfcduxa %[v4d],%[ptr],%[off]  \n" : [ptr] "+b" (addr) : [v4d] "v" (data), [off] "r" (offset) )
 #endif
 
-#ifdef BGQ_EMU
+#if defined USE_AVX2
+ #define STORE_REG_VIR_COMPLEX(addr,in) _mm256_storeu_pd((double*)(addr),in)
+#elif defined BGQ_EMU
  #define STORE_REG_VIR_COMPLEX(addr,in) VIR_COMPLEX_COPY((*((vir_complex*)(addr))),in)
 #else
  #define STORE_REG_VIR_COMPLEX(addr,in) vec_st(in,0,(double*)addr)
@@ -267,11 +267,13 @@ namespace nissa
     nissa_free(out_buf_source_expl);
   }
   
-  //perform the remapping
-  void all_to_all_comm_t::communicate(void *out,void *in,size_t bps,void *ext_out_buf,void *ext_in_buf,int tag)
+  //start the remapping: fill the out-going buffer and post sends and receives, without waiting
+  void all_to_all_comm_t::start_communication(void *in,size_t bps,void *ext_out_buf,void *ext_in_buf,int tag)
   {
     GET_THREAD_ID();
     
+    if(pending) crash("a communication is already pending on this communicator");
+    
     //allocate a buffer where to repack data
     char *out_buf=(ext_out_buf==NULL)?nissa_malloc("out_buf",nel_out*bps,char):(char*)ext_out_buf;
     char *in_buf=(ext_in_buf==NULL)?nissa_malloc("in_buf",nel_in*bps,char):(char*)ext_in_buf;
@@ -283,27 +285,70 @@ namespace nissa
     
     if(IS_MASTER_THREAD)
       {
-	MPI_Request req_list[nranks_to+nranks_fr];
+	if(tag<0) tag=909;
+	req_list.resize(nranks_to+nranks_fr);
 	int ireq=0;
 	for(int irank_fr=0;irank_fr<nranks_fr;irank_fr++)
 	  MPI_Irecv(in_buf+in_buf_off_per_rank[irank_fr]*bps,nper_rank_fr[irank_fr]*bps,MPI_CHAR,
-		    list_ranks_fr[irank_fr],909,cart_comm,&req_list[ireq++]);
+		    list_ranks_fr[irank_fr],tag,cart_comm,&req_list[ireq++]);
 	for(int irank_to=0;irank_to<nranks_to;irank_to++)
 	  MPI_Isend(out_buf+out_buf_off_per_rank[irank_to]*bps,nper_rank_to[irank_to]*bps,MPI_CHAR,
-		    list_ranks_to[irank_to],909,cart_comm,&req_list[ireq++]);
+		    list_ranks_to[irank_to],tag,cart_comm,&req_list[ireq++]);
       	if(ireq!=nranks_to+nranks_fr) crash("expected %d request, obtained %d",nranks_to+nranks_fr,ireq);
-	MPI_Waitall(ireq,req_list,MPI_STATUS_IGNORE);
+	
+	//store what is needed to finish
+	pending=true;
+	own_out_buf=(ext_out_buf==NULL);
+	own_in_buf=(ext_in_buf==NULL);
+	pending_bps=bps;
+	pending_out_buf=out_buf;
+	pending_in_buf=in_buf;
+      }
+    THREAD_BARRIER();
+  }
+  
+  //let the pending communication progress, to be called from time to time while computing
+  void all_to_all_comm_t::test_communication()
+  {
+    GET_THREAD_ID();
+    
+    if(IS_MASTER_THREAD and pending)
+      {
+	int flag;
+	MPI_Testall(req_list.size(),req_list.data(),&flag,MPI_STATUSES_IGNORE);
       }
+  }
+  
+  //wait the end of the pending communication and sort out the data
+  void all_to_all_comm_t::finish_communication(void *out)
+  {
+    GET_THREAD_ID();
+    
+    if(not pending) crash("no communication pending on this communicator");
+    
+    if(IS_MASTER_THREAD) MPI_Waitall(req_list.size(),req_list.data(),MPI_STATUSES_IGNORE);
     THREAD_BARRIER();
     
     //sort out data from the incoming buffer
+    size_t bps=pending_bps;
+    char *in_buf=pending_in_buf;
     NISSA_PARALLEL_LOOP(iel_in,0,nel_in)
       memcpy((char*)out+in_buf_dest[iel_in]*bps,in_buf+iel_in*bps,bps);
     
     set_borders_invalid(out);
     
-    if(ext_out_buf==NULL) nissa_free(out_buf);
-    if(ext_in_buf==NULL) nissa_free(in_buf);
+    if(own_out_buf) nissa_free(pending_out_buf);
+    if(own_in_buf) nissa_free(pending_in_buf);
+    
+    if(IS_MASTER_THREAD) pending=false;
+    THREAD_BARRIER();
+  }
+  
+  //perform the remapping
+  void all_to_all_comm_t::communicate(void *out,void *in,size_t bps,void *ext_out_buf,void *ext_in_buf,int tag)
+  {
+    start_communication(in,bps,ext_out_buf,ext_in_buf,tag);
+    finish_communication(out);
   }
   
   //add links to the buffer of the conf if needed
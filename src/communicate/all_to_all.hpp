@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <map>
+#include <mpi.h>
 #include <vector>
 
 #include "base/vectors.hpp"
@@ -38,6 +39,12 @@ namespace nissa
     int nranks_fr{0},*list_ranks_fr{nullptr},*in_buf_dest{nullptr},*nper_rank_fr{nullptr},*in_buf_off_per_rank{nullptr};
     int nranks_to{0},*list_ranks_to{nullptr},*out_buf_source{nullptr},*nper_rank_to{nullptr},*out_buf_off_per_rank{nullptr};
     
+    //state of the pending non-blocking communication
+    bool pending{false},own_out_buf{false},own_in_buf{false};
+    size_t pending_bps{0};
+    char *pending_out_buf{nullptr},*pending_in_buf{nullptr};
+    std::vector<MPI_Request> req_list;
+    
     all_to_all_comm_t(const all_to_all_gathering_list_t &gl);
     all_to_all_comm_t(const all_to_all_scattering_list_t &sl);
     all_to_all_comm_t(all_to_all_comm_t &&oth)
@@ -55,6 +62,13 @@ namespace nissa
       std::swap(out_buf_source,oth.out_buf_source);
       std::swap(nper_rank_to,oth.nper_rank_to);
       std::swap(out_buf_off_per_rank,oth.out_buf_off_per_rank);
+      std::swap(pending,oth.pending);
+      std::swap(own_out_buf,oth.own_out_buf);
+      std::swap(own_in_buf,oth.own_in_buf);
+      std::swap(pending_bps,oth.pending_bps);
+      std::swap(pending_out_buf,oth.pending_out_buf);
+      std::swap(pending_in_buf,oth.pending_in_buf);
+      std::swap(req_list,oth.req_list);
     }
     
     ~all_to_all_comm_t(){destroy();}
@@ -75,6 +89,9 @@ namespace nissa
 	}
     }
     void communicate(void *out,void *in,size_t bps,void *buf_out=NULL,void *buf_in=NULL,int tag=-1);
+    void start_communication(void *in,size_t bps,void *buf_out=NULL,void *buf_in=NULL,int tag=-1);
+    void test_communication();
+    void finish_communication(void *out);
     
     void setup_knowing_where_to_send(const all_to_all_scattering_list_t &sl);
     void setup_knowing_what_to_ask(const all_to_all_gathering_list_t &gl);
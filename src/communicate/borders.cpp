@@ -154,12 +154,14 @@ namespace nissa
 	
 	if(comm.comm_in_prog)
 	  {
+	    comm.wait_time-=take_time();
 #ifdef SPI
 	    spi_comm_wait(comm);
 #else
 	    verbosity_lv3_master_printf("Waiting for %d MPI request\n",comm.nrequest);
 	    MPI_Waitall(comm.nrequest,comm.requests,MPI_STATUS_IGNORE);
 #endif
+	    comm.wait_time+=take_time();
 	  }
 	else verbosity_lv3_master_printf("Did not have to wait for any buffered comm\n");
       }
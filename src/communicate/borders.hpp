@@ -110,6 +110,15 @@ namespace nissa
   DEFINE_BORDERS_ROUTINES(single_color)
   DEFINE_BORDERS_ROUTINES(single_quad_su3)
   DEFINE_BORDERS_ROUTINES(single_halfspincolor)
+  DEFINE_BORDERS_ROUTINES(single_spincolor)
+  
+  //communicate the borders of a vector with nrhs interleaved spincolor per site
+  inline void communicate_lx_multi_spincolor_borders(spincolor *s,int nrhs)
+  {communicate_lx_borders(s,lx_multi_spincolor_comm[nrhs-1]);}
+  inline void start_communicating_lx_multi_spincolor_borders(spincolor *s,int nrhs)
+  {start_communicating_lx_borders(lx_multi_spincolor_comm[nrhs-1],s);}
+  inline void finish_communicating_lx_multi_spincolor_borders(spincolor *s,int nrhs)
+  {finish_communicating_lx_borders(s,lx_multi_spincolor_comm[nrhs-1]);}
 }
 
 #endif
@@ -11,6 +11,10 @@
 
 #define NISSA_DEFAULT_WARN_IF_NOT_COMMUNICATED 0
 #define NISSA_DEFAULT_USE_ASYNC_COMMUNICATIONS 1
+#define NISSA_DEFAULT_OVERLAP_COMM_AND_COMP 0
+
+//maximal number of spincolor interleaved in a multi right hand side vector, one per spin-color source
+#define NISSA_MAX_NRHS (4*NCOL)
 
 /*
   Order in memory of borders for a 3^4 lattice.
@@ -99,6 +103,8 @@ namespace nissa
     
     //communication in progress
     int comm_in_prog;
+    //time spent by the master thread blocked waiting for the communication to finish
+    double wait_time;
     //local size
     uint64_t nbytes_per_site;
     //size of the message
@@ -108,7 +114,7 @@ namespace nissa
     
     //constructor
     bool initialized;
-    comm_t(){initialized=false;}
+    comm_t(){initialized=false;wait_time=0;}
   };
 #endif
   
@@ -116,6 +122,7 @@ namespace nissa
   EXTERN_COMMUNICATE int comm_in_prog;
   EXTERN_COMMUNICATE int warn_if_not_communicated;
   EXTERN_COMMUNICATE int use_async_communications;
+  EXTERN_COMMUNICATE int overlap_comm_and_comp;
   
   //buffers
   EXTERN_COMMUNICATE uint64_t recv_buf_size,send_buf_size;
@@ -138,7 +145,11 @@ namespace nissa
   DEFINE_COMM(oct_su3);
   DEFINE_COMM(single_color);
   DEFINE_COMM(single_halfspincolor);
+  DEFINE_COMM(single_spincolor);
   DEFINE_COMM(single_quad_su3);
+  
+  //communicators for vectors with nrhs interleaved spincolor per site, indexed by nrhs-1
+  EXTERN_COMMUNICATE comm_t lx_multi_spincolor_comm[NISSA_MAX_NRHS];
 }
 
 #undef EXTERN_COMMUNICATE
@@ -183,4 +183,8 @@ namespace nissa
   //Send the edges of the gauge configuration
   void communicate_eo_quad_su3_edges(quad_su3 **conf)
   {communicate_eo_edges((char**)conf,lx_quad_su3_comm,MPI_EO_QUAD_SU3_EDGES_SEND,MPI_EO_QUAD_SU3_EDGES_RECE,sizeof(quad_su3));}
+  
+  //Send the edges of the e/o as2t_su3 field (for topological staples)
+  void communicate_eo_as2t_su3_edges(as2t_su3 **a)
+  {communicate_eo_edges((char**)a,lx_as2t_su3_comm,MPI_EO_AS2T_SU3_EDGES_SEND,MPI_EO_AS2T_SU3_EDGES_RECE,sizeof(as2t_su3));}
 }
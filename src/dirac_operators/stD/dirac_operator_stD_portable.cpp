@@ -2,6 +2,8 @@
  #include "config.hpp"
 #endif
 
+#include "base/bench.hpp"
+#include "base/debug.hpp"
 #include "base/thread_macros.hpp"
 #include "base/vectors.hpp"
 #include "communicate/borders.hpp"
@@ -13,32 +15,53 @@
 
 namespace nissa
 {
+  //apply Doe on a single odd site
+  inline void apply_st2Doe_site(color *out,quad_su3 **conf,color *in,int io)
+  {
+    //neighbours search
+    int evup0=loceo_neighup[ODD][io][0];
+    int evdw0=loceo_neighdw[ODD][io][0];
+    
+    //derivative in the time direction - without self-summ
+    unsafe_su3_prod_color(      out[io],conf[ODD][io   ][0],in[evup0]);
+    su3_dag_subt_the_prod_color(out[io],conf[EVN][evdw0][0],in[evdw0]);
+    
+    //derivatives in the spatial direction - with self summ
+    for(int mu=1;mu<4;mu++)
+      {
+	int evup=loceo_neighup[ODD][io][mu];
+	int evdw=loceo_neighdw[ODD][io][mu];
+	
+	su3_summ_the_prod_color(    out[io],conf[ODD][io  ][mu],in[evup]);
+	su3_dag_subt_the_prod_color(out[io],conf[EVN][evdw][mu],in[evdw]);
+      }
+  }
+  
+  //if asked, the bulk is computed while the halo of in is being exchanged
   THREADABLE_FUNCTION_3ARG(apply_st2Doe, color*,out, quad_su3**,conf, color*,in)
   {
     if(!check_borders_valid(conf[EVN])||!check_borders_valid(conf[ODD]))
       communicate_ev_and_od_quad_su3_borders(conf);
-    if(!check_borders_valid(in)) communicate_ev_color_borders(in);
     
     GET_THREAD_ID();
-    NISSA_PARALLEL_LOOP(io,0,loc_volh)
+    if(overlap_comm_and_comp)
       {
-	//neighbours search
-	int evup0=loceo_neighup[ODD][io][0];
-	int evdw0=loceo_neighdw[ODD][io][0];
+	//start the halo exchange and compute the sites not needing it
+	start_communicating_ev_or_od_color_borders(in,EVN);
+	START_TIMING(stDoe_overlap_bench.bulk_time,stDoe_overlap_bench.napp);
+	NISSA_PARALLEL_LOOP(ibulk,0,bulk_volh) apply_st2Doe_site(out,conf,in,loceo_of_bulkeo[ODD][ibulk]);
+	STOP_TIMING(stDoe_overlap_bench.bulk_time);
 	
-	//derivative in the time direction - without self-summ
-	unsafe_su3_prod_color(      out[io],conf[ODD][io   ][0],in[evup0]);
-	su3_dag_subt_the_prod_color(out[io],conf[EVN][evdw0][0],in[evdw0]);
-	
-	//derivatives in the spatial direction - with self summ
-	for(int mu=1;mu<4;mu++)
-	  {
-	    int evup=loceo_neighup[ODD][io][mu];
-	    int evdw=loceo_neighdw[ODD][io][mu];
-	    
-	    su3_summ_the_prod_color(    out[io],conf[ODD][io  ][mu],in[evup]);
-	    su3_dag_subt_the_prod_color(out[io],conf[EVN][evdw][mu],in[evdw]);
-	  }
+	//wait the halo, accounting only the time blocked in the wait as exposed, and finish with the surface
+	double wait_time=eo_color_comm.wait_time;
+	finish_communicating_ev_or_od_color_borders(in);
+	if(IS_MASTER_THREAD) stDoe_overlap_bench.exposed_comm_time+=eo_color_comm.wait_time-wait_time;
+	NISSA_PARALLEL_LOOP(isurf,0,surf_volh) apply_st2Doe_site(out,conf,in,loceo_of_surfeo[ODD][isurf]);
+      }
+    else
+      {
+	if(!check_borders_valid(in)) communicate_ev_color_borders(in);
+	NISSA_PARALLEL_LOOP(io,0,loc_volh) apply_st2Doe_site(out,conf,in,io);
       }
     
     set_borders_invalid(out);
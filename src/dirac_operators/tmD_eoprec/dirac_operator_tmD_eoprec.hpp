@@ -1,10 +1,104 @@
 #ifndef _DIRAC_OPERATOR_TMD_EOIMPR_HPP
 #define _DIRAC_OPERATOR_TMD_EOIMPR_HPP
 
-#include "new_types/su3.hpp"
+#include "geometry/geometry_eo.hpp"
+#include "new_types/su3_op.hpp"
 
 namespace nissa
 {
+  //apply even-odd or odd-even part of tmD, multiplied by -2, to a single site
+  inline void tmn2Deo_or_tmn2Doe_site(spincolor out,quad_su3 **conf,int eooe,int X,spincolor *in)
+  {
+    int Xup,Xdw;
+    color temp_c0,temp_c1,temp_c2,temp_c3;
+    
+    //Forward 0
+    Xup=loceo_neighup[eooe][X][0];
+    color_summ(temp_c0,in[Xup][0],in[Xup][2]);
+    color_summ(temp_c1,in[Xup][1],in[Xup][3]);
+    unsafe_su3_prod_color(out[0],conf[eooe][X][0],temp_c0);
+    unsafe_su3_prod_color(out[1],conf[eooe][X][0],temp_c1);
+    color_copy(out[2],out[0]);
+    color_copy(out[3],out[1]);
+    
+    //Backward 0
+    Xdw=loceo_neighdw[eooe][X][0];
+    color_subt(temp_c0,in[Xdw][0],in[Xdw][2]);
+    color_subt(temp_c1,in[Xdw][1],in[Xdw][3]);
+    unsafe_su3_dag_prod_color(temp_c2,conf[!eooe][Xdw][0],temp_c0);
+    unsafe_su3_dag_prod_color(temp_c3,conf[!eooe][Xdw][0],temp_c1);
+    color_summassign(out[0],temp_c2);
+    color_summassign(out[1],temp_c3);
+    color_subtassign(out[2],temp_c2);
+    color_subtassign(out[3],temp_c3);
+    
+    //Forward 1
+    Xup=loceo_neighup[eooe][X][1];
+    color_isumm(temp_c0,in[Xup][0],in[Xup][3]);
+    color_isumm(temp_c1,in[Xup][1],in[Xup][2]);
+    unsafe_su3_prod_color(temp_c2,conf[eooe][X][1],temp_c0);
+    unsafe_su3_prod_color(temp_c3,conf[eooe][X][1],temp_c1);
+    color_summassign(out[0],temp_c2);
+    color_summassign(out[1],temp_c3);
+    color_isubtassign(out[2],temp_c3);
+    color_isubtassign(out[3],temp_c2);
+    
+    //Backward 1
+    Xdw=loceo_neighdw[eooe][X][1];
+    color_isubt(temp_c0,in[Xdw][0],in[Xdw][3]);
+    color_isubt(temp_c1,in[Xdw][1],in[Xdw][2]);
+    unsafe_su3_dag_prod_color(temp_c2,conf[!eooe][Xdw][1],temp_c0);
+    unsafe_su3_dag_prod_color(temp_c3,conf[!eooe][Xdw][1],temp_c1);
+    color_summassign(out[0],temp_c2);
+    color_summassign(out[1],temp_c3);
+    color_isummassign(out[2],temp_c3);
+    color_isummassign(out[3],temp_c2);
+    
+    //Forward 2
+    Xup=loceo_neighup[eooe][X][2];
+    color_summ(temp_c0,in[Xup][0],in[Xup][3]);
+    color_subt(temp_c1,in[Xup][1],in[Xup][2]);
+    unsafe_su3_prod_color(temp_c2,conf[eooe][X][2],temp_c0);
+    unsafe_su3_prod_color(temp_c3,conf[eooe][X][2],temp_c1);
+    color_summassign(out[0],temp_c2);
+    color_summassign(out[1],temp_c3);
+    color_subtassign(out[2],temp_c3);
+    color_summassign(out[3],temp_c2);
+    
+    //Backward 2
+    Xdw=loceo_neighdw[eooe][X][2];
+    color_subt(temp_c0,in[Xdw][0],in[Xdw][3]);
+    color_summ(temp_c1,in[Xdw][1],in[Xdw][2]);
+    unsafe_su3_dag_prod_color(temp_c2,conf[!eooe][Xdw][2],temp_c0);
+    unsafe_su3_dag_prod_color(temp_c3,conf[!eooe][Xdw][2],temp_c1);
+    color_summassign(out[0],temp_c2);
+    color_summassign(out[1],temp_c3);
+    color_summassign(out[2],temp_c3);
+    color_subtassign(out[3],temp_c2);
+    
+    //Forward 3
+    Xup=loceo_neighup[eooe][X][3];
+    color_isumm(temp_c0,in[Xup][0],in[Xup][2]);
+    color_isubt(temp_c1,in[Xup][1],in[Xup][3]);
+    unsafe_su3_prod_color(temp_c2,conf[eooe][X][3],temp_c0);
+    unsafe_su3_prod_color(temp_c3,conf[eooe][X][3],temp_c1);
+    color_summassign(out[0],temp_c2);
+    color_summassign(out[1],temp_c3);
+    color_isubtassign(out[2],temp_c2);
+    color_isummassign(out[3],temp_c3);
+    
+    //Backward 3
+    Xdw=loceo_neighdw[eooe][X][3];
+    color_isubt(temp_c0,in[Xdw][0],in[Xdw][2]);
+    color_isumm(temp_c1,in[Xdw][1],in[Xdw][3]);
+    unsafe_su3_dag_prod_color(temp_c2,conf[!eooe][Xdw][3],temp_c0);
+    unsafe_su3_dag_prod_color(temp_c3,conf[!eooe][Xdw][3],temp_c1);
+    color_summassign(out[0],temp_c2);
+    color_summassign(out[1],temp_c3);
+    color_isummassign(out[2],temp_c2);
+    color_isubtassign(out[3],temp_c3);
+  }
+  
   void inv_tmDee_or_oo_eos(spincolor *out,double kappa,double mu,spincolor *in);
   void tmDee_or_oo_eos(spincolor *out,double kappa,double mu,spincolor *in);
   void tmDkern_eoprec_eos(spincolor *out,spincolor *temp,quad_su3** conf,double kappa,double mu,spincolor *in);
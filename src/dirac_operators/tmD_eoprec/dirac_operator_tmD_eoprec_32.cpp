@@ -0,0 +1,201 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include "base/debug.hpp"
+#include "base/thread_macros.hpp"
+#include "base/vectors.hpp"
+#include "communicate/borders.hpp"
+#include "dirac_operators/tmD_eoprec/dirac_operator_tmD_eoprec_32.hpp"
+#include "geometry/geometry_eo.hpp"
+#include "new_types/complex.hpp"
+#include "new_types/su3_op.hpp"
+#ifdef USE_THREADS
+ #include "routines/thread.hpp"
+#endif
+
+namespace nissa
+{
+  //Refers to the doc: "doc/eo_inverter.lyx" for explenations
+  
+  //apply even-odd or odd-even part of tmD, multiplied by -2
+  THREADABLE_FUNCTION_4ARG(tmn2Deo_or_tmn2Doe_eos_32, single_spincolor*,out, single_quad_su3**,conf, int,eooe, single_spincolor*,in)
+  {
+    communicate_ev_and_od_single_quad_su3_borders(conf);
+    
+    if(eooe==0) communicate_od_single_spincolor_borders(in);
+    else        communicate_ev_single_spincolor_borders(in);
+    
+    GET_THREAD_ID();
+    NISSA_PARALLEL_LOOP(X,0,loc_volh)
+      {
+	int Xup,Xdw;
+	single_color temp_c0,temp_c1,temp_c2,temp_c3;
+	
+	//Forward 0
+	Xup=loceo_neighup[eooe][X][0];
+	single_color_summ(temp_c0,in[Xup][0],in[Xup][2]);
+	single_color_summ(temp_c1,in[Xup][1],in[Xup][3]);
+	unsafe_single_su3_prod_single_color(out[X][0],conf[eooe][X][0],temp_c0);
+	unsafe_single_su3_prod_single_color(out[X][1],conf[eooe][X][0],temp_c1);
+	single_color_copy(out[X][2],out[X][0]);
+	single_color_copy(out[X][3],out[X][1]);
+	
+	//Backward 0
+	Xdw=loceo_neighdw[eooe][X][0];
+	single_color_subt(temp_c0,in[Xdw][0],in[Xdw][2]);
+	single_color_subt(temp_c1,in[Xdw][1],in[Xdw][3]);
+	unsafe_single_su3_dag_prod_single_color(temp_c2,conf[!eooe][Xdw][0],temp_c0);
+	unsafe_single_su3_dag_prod_single_color(temp_c3,conf[!eooe][Xdw][0],temp_c1);
+	single_color_summassign(out[X][0],temp_c2);
+	single_color_summassign(out[X][1],temp_c3);
+	single_color_subtassign(out[X][2],temp_c2);
+	single_color_subtassign(out[X][3],temp_c3);
+	
+	//Forward 1
+	Xup=loceo_neighup[eooe][X][1];
+	single_color_isumm(temp_c0,in[Xup][0],in[Xup][3]);
+	single_color_isumm(temp_c1,in[Xup][1],in[Xup][2]);
+	unsafe_single_su3_prod_single_color(temp_c2,conf[eooe][X][1],temp_c0);
+	unsafe_single_su3_prod_single_color(temp_c3,conf[eooe][X][1],temp_c1);
+	single_color_summassign(out[X][0],temp_c2);
+	single_color_summassign(out[X][1],temp_c3);
+	single_color_isubtassign(out[X][2],temp_c3);
+	single_color_isubtassign(out[X][3],temp_c2);
+	
+	//Backward 1
+	Xdw=loceo_neighdw[eooe][X][1];
+	single_color_isubt(temp_c0,in[Xdw][0],in[Xdw][3]);
+	single_color_isubt(temp_c1,in[Xdw][1],in[Xdw][2]);
+	unsafe_single_su3_dag_prod_single_color(temp_c2,conf[!eooe][Xdw][1],temp_c0);
+	unsafe_single_su3_dag_prod_single_color(temp_c3,conf[!eooe][Xdw][1],temp_c1);
+	single_color_summassign(out[X][0],temp_c2);
+	single_color_summassign(out[X][1],temp_c3);
+	single_color_isummassign(out[X][2],temp_c3);
+	single_color_isummassign(out[X][3],temp_c2);
+	
+	//Forward 2
+	Xup=loceo_neighup[eooe][X][2];
+	single_color_summ(temp_c0,in[Xup][0],in[Xup][3]);
+	single_color_subt(temp_c1,in[Xup][1],in[Xup][2]);
+	unsafe_single_su3_prod_single_color(temp_c2,conf[eooe][X][2],temp_c0);
+	unsafe_single_su3_prod_single_color(temp_c3,conf[eooe][X][2],temp_c1);
+	single_color_summassign(out[X][0],temp_c2);
+	single_color_summassign(out[X][1],temp_c3);
+	single_color_subtassign(out[X][2],temp_c3);
+	single_color_summassign(out[X][3],temp_c2);
+	
+	//Backward 2
+	Xdw=loceo_neighdw[eooe][X][2];
+	single_color_subt(temp_c0,in[Xdw][0],in[Xdw][3]);
+	single_color_summ(temp_c1,in[Xdw][1],in[Xdw][2]);
+	unsafe_single_su3_dag_prod_single_color(temp_c2,conf[!eooe][Xdw][2],temp_c0);
+	unsafe_single_su3_dag_prod_single_color(temp_c3,conf[!eooe][Xdw][2],temp_c1);
+	single_color_summassign(out[X][0],temp_c2);
+	single_color_summassign(out[X][1],temp_c3);
+	single_color_summassign(out[X][2],temp_c3);
+	single_color_subtassign(out[X][3],temp_c2);
+	
+	//Forward 3
+	Xup=loceo_neighup[eooe][X][3];
+	single_color_isumm(temp_c0,in[Xup][0],in[Xup][2]);
+	single_color_isubt(temp_c1,in[Xup][1],in[Xup][3]);
+	unsafe_single_su3_prod_single_color(temp_c2,conf[eooe][X][3],temp_c0);
+	unsafe_single_su3_prod_single_color(temp_c3,conf[eooe][X][3],temp_c1);
+	single_color_summassign(out[X][0],temp_c2);
+	single_color_summassign(out[X][1],temp_c3);
+	single_color_isubtassign(out[X][2],temp_c2);
+	single_color_isummassign(out[X][3],temp_c3);
+	
+	//Backward 3
+	Xdw=loceo_neighdw[eooe][X][3];
+	single_color_isubt(temp_c0,in[Xdw][0],in[Xdw][2]);
+	single_color_isumm(temp_c1,in[Xdw][1],in[Xdw][3]);
+	unsafe_single_su3_dag_prod_single_color(temp_c2,conf[!eooe][Xdw][3],temp_c0);
+	unsafe_single_su3_dag_prod_single_color(temp_c3,conf[!eooe][Xdw][3],temp_c1);
+	single_color_summassign(out[X][0],temp_c2);
+	single_color_summassign(out[X][1],temp_c3);
+	single_color_isummassign(out[X][2],temp_c2);
+	single_color_isubtassign(out[X][3],temp_c3);
+      }
+    
+    set_borders_invalid(out);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //implement ee or oo part of Dirac operator, equation(3)
+  THREADABLE_FUNCTION_4ARG(tmDee_or_oo_eos_32, single_spincolor*,out, double,kappa, double,mu, single_spincolor*,in)
+  {
+    single_complex z={(float)(1/(2*kappa)),(float)mu};
+    
+    if(in==out) crash("in==out!");
+    
+    GET_THREAD_ID();
+    NISSA_PARALLEL_LOOP(X,0,loc_volh)
+      for(int ic=0;ic<NCOL;ic++)
+	{
+	  for(int id=0;id<2;id++) unsafe_single_complex_prod(out[X][id][ic],z,in[X][id][ic]);
+	  for(int id=2;id<4;id++) unsafe_single_complex_conj1_prod(out[X][id][ic],z,in[X][id][ic]);
+	}
+    
+    set_borders_invalid(out);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //inverse
+  THREADABLE_FUNCTION_4ARG(inv_tmDee_or_oo_eos_32, single_spincolor*,out, double,kappa, double,mu, single_spincolor*,in)
+  {
+    double a=1/(2*kappa),b=mu,nrm=a*a+b*b;
+    single_complex z={(float)(+a/nrm),(float)(-b/nrm)};
+    
+    if(in==out) crash("in==out!");
+    
+    GET_THREAD_ID();
+    NISSA_PARALLEL_LOOP(X,0,loc_volh)
+      for(int ic=0;ic<NCOL;ic++)
+	{
+	  for(int id=0;id<2;id++) unsafe_single_complex_prod(out[X][id][ic],z,in[X][id][ic]);
+	  for(int id=2;id<4;id++) unsafe_single_complex_conj1_prod(out[X][id][ic],z,in[X][id][ic]);
+	}
+    
+    set_borders_invalid(out);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //put g5
+  THREADABLE_FUNCTION_2ARG(tmDkern_eoprec_eos_put_together_and_include_gamma5_32, single_spincolor*,out, single_spincolor*,temp)
+  {
+    GET_THREAD_ID();
+    NISSA_PARALLEL_LOOP(ivol,0,loc_volh)
+      for(int id=0;id<2;id++)
+	for(int ic=0;ic<NCOL;ic++)
+	  for(int ri=0;ri<2;ri++)
+	    { //gamma5 is explicitely implemented
+	      out[ivol][id  ][ic][ri]=+temp[ivol][id  ][ic][ri]-out[ivol][id  ][ic][ri]*0.25f;
+	      out[ivol][id+2][ic][ri]=-temp[ivol][id+2][ic][ri]+out[ivol][id+2][ic][ri]*0.25f;
+	    }
+    
+    set_borders_invalid(out);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //implement Koo defined in equation (7)
+  THREADABLE_FUNCTION_6ARG(tmDkern_eoprec_eos_32, single_spincolor*,out, single_spincolor*,temp, single_quad_su3**,conf, double,kappa, double,mu, single_spincolor*,in)
+  {
+    tmn2Deo_eos_32(out,conf,in);
+    inv_tmDee_or_oo_eos_32(temp,kappa,mu,out);
+    tmn2Doe_eos_32(out,conf,temp);
+    
+    tmDee_or_oo_eos_32(temp,kappa,mu,in);
+    
+    tmDkern_eoprec_eos_put_together_and_include_gamma5_32(out,temp);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //square of Koo
+  void tmDkern_eoprec_square_eos_32(single_spincolor *out,single_spincolor *temp1,single_spincolor *temp2,single_quad_su3 **conf,double kappa,double mu,single_spincolor *in)
+  {
+    tmDkern_eoprec_eos_32(temp1,temp2,conf,kappa,-mu, in   );
+    tmDkern_eoprec_eos_32(out,  temp2,conf,kappa,+mu, temp1);
+  }
+}
@@ -0,0 +1,20 @@
+#ifndef _DIRAC_OPERATOR_TMDEOIMPR_32_HPP
+#define _DIRAC_OPERATOR_TMDEOIMPR_32_HPP
+
+#include "new_types/su3.hpp"
+
+namespace nissa
+{
+  void tmn2Deo_or_tmn2Doe_eos_32(single_spincolor *out,single_quad_su3 **conf,int eooe,single_spincolor *in);
+  //wrappers
+  inline void tmn2Doe_eos_32(single_spincolor *out,single_quad_su3 **conf,single_spincolor *in){tmn2Deo_or_tmn2Doe_eos_32(out,conf,1,in);}
+  inline void tmn2Deo_eos_32(single_spincolor *out,single_quad_su3 **conf,single_spincolor *in){tmn2Deo_or_tmn2Doe_eos_32(out,conf,0,in);}
+  
+  void inv_tmDee_or_oo_eos_32(single_spincolor *out,double kappa,double mu,single_spincolor *in);
+  void tmDee_or_oo_eos_32(single_spincolor *out,double kappa,double mu,single_spincolor *in);
+  void tmDkern_eoprec_eos_32(single_spincolor *out,single_spincolor *temp,single_quad_su3** conf,double kappa,double mu,single_spincolor *in);
+  void tmDkern_eoprec_square_eos_32(single_spincolor *out,single_spincolor *temp1,single_spincolor *temp2,single_quad_su3 **conf,double kappa,double mu,single_spincolor *in);
+  void tmDkern_eoprec_eos_put_together_and_include_gamma5_32(single_spincolor *out,single_spincolor *temp);
+}
+
+#endif
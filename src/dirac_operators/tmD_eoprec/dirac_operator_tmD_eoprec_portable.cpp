@@ -3,6 +3,7 @@
 #include "base/thread_macros.hpp"
 #include "base/vectors.hpp"
 #include "communicate/borders.hpp"
+#include "dirac_operators/tmD_eoprec/dirac_operator_tmD_eoprec.hpp"
 #include "new_types/su3_op.hpp"
 
 namespace nissa
@@ -18,97 +19,7 @@ namespace nissa
     else        communicate_ev_spincolor_borders(in);
     
     GET_THREAD_ID();
-    NISSA_PARALLEL_LOOP(X,0,loc_volh)
-      {
-	int Xup,Xdw;
-	color temp_c0,temp_c1,temp_c2,temp_c3;
-	
-	//Forward 0
-	Xup=loceo_neighup[eooe][X][0];
-	color_summ(temp_c0,in[Xup][0],in[Xup][2]);
-	color_summ(temp_c1,in[Xup][1],in[Xup][3]);
-	unsafe_su3_prod_color(out[X][0],conf[eooe][X][0],temp_c0);
-	unsafe_su3_prod_color(out[X][1],conf[eooe][X][0],temp_c1);
-	color_copy(out[X][2],out[X][0]);
-	color_copy(out[X][3],out[X][1]);
-	
-	//Backward 0
-	Xdw=loceo_neighdw[eooe][X][0];
-	color_subt(temp_c0,in[Xdw][0],in[Xdw][2]);
-	color_subt(temp_c1,in[Xdw][1],in[Xdw][3]);
-	unsafe_su3_dag_prod_color(temp_c2,conf[!eooe][Xdw][0],temp_c0);
-	unsafe_su3_dag_prod_color(temp_c3,conf[!eooe][Xdw][0],temp_c1);
-	color_summassign(out[X][0],temp_c2);
-	color_summassign(out[X][1],temp_c3);
-	color_subtassign(out[X][2],temp_c2);
-	color_subtassign(out[X][3],temp_c3);
-	
-	//Forward 1
-	Xup=loceo_neighup[eooe][X][1];
-	color_isumm(temp_c0,in[Xup][0],in[Xup][3]);
-	color_isumm(temp_c1,in[Xup][1],in[Xup][2]);
-	unsafe_su3_prod_color(temp_c2,conf[eooe][X][1],temp_c0);
-	unsafe_su3_prod_color(temp_c3,conf[eooe][X][1],temp_c1);
-	color_summassign(out[X][0],temp_c2);
-	color_summassign(out[X][1],temp_c3);
-	color_isubtassign(out[X][2],temp_c3);
-	color_isubtassign(out[X][3],temp_c2);
-	
-	//Backward 1
-	Xdw=loceo_neighdw[eooe][X][1];
-	color_isubt(temp_c0,in[Xdw][0],in[Xdw][3]);
-	color_isubt(temp_c1,in[Xdw][1],in[Xdw][2]);
-	unsafe_su3_dag_prod_color(temp_c2,conf[!eooe][Xdw][1],temp_c0);
-	unsafe_su3_dag_prod_color(temp_c3,conf[!eooe][Xdw][1],temp_c1);
-	color_summassign(out[X][0],temp_c2);
-	color_summassign(out[X][1],temp_c3);
-	color_isummassign(out[X][2],temp_c3);
-	color_isummassign(out[X][3],temp_c2);
-	
-	//Forward 2
-	Xup=loceo_neighup[eooe][X][2];
-	color_summ(temp_c0,in[Xup][0],in[Xup][3]);
-	color_subt(temp_c1,in[Xup][1],in[Xup][2]);
-	unsafe_su3_prod_color(temp_c2,conf[eooe][X][2],temp_c0);
-	unsafe_su3_prod_color(temp_c3,conf[eooe][X][2],temp_c1);
-	color_summassign(out[X][0],temp_c2);
-	color_summassign(out[X][1],temp_c3);
-	color_subtassign(out[X][2],temp_c3);
-	color_summassign(out[X][3],temp_c2);
-	
-	//Backward 2
-	Xdw=loceo_neighdw[eooe][X][2];
-	color_subt(temp_c0,in[Xdw][0],in[Xdw][3]);
-	color_summ(temp_c1,in[Xdw][1],in[Xdw][2]);
-	unsafe_su3_dag_prod_color(temp_c2,conf[!eooe][Xdw][2],temp_c0);
-	unsafe_su3_dag_prod_color(temp_c3,conf[!eooe][Xdw][2],temp_c1);
-	color_summassign(out[X][0],temp_c2);
-	color_summassign(out[X][1],temp_c3);
-	color_summassign(out[X][2],temp_c3);
-	color_subtassign(out[X][3],temp_c2);
-	
-	//Forward 3
-	Xup=loceo_neighup[eooe][X][3];
-	color_isumm(temp_c0,in[Xup][0],in[Xup][2]);
-	color_isubt(temp_c1,in[Xup][1],in[Xup][3]);
-	unsafe_su3_prod_color(temp_c2,conf[eooe][X][3],temp_c0);
-	unsafe_su3_prod_color(temp_c3,conf[eooe][X][3],temp_c1);
-	color_summassign(out[X][0],temp_c2);
-	color_summassign(out[X][1],temp_c3);
-	color_isubtassign(out[X][2],temp_c2);
-	color_isummassign(out[X][3],temp_c3);
-	
-	//Backward 3
-	Xdw=loceo_neighdw[eooe][X][3];
-	color_isubt(temp_c0,in[Xdw][0],in[Xdw][2]);
-	color_isumm(temp_c1,in[Xdw][1],in[Xdw][3]);
-	unsafe_su3_dag_prod_color(temp_c2,conf[!eooe][Xdw][3],temp_c0);
-	unsafe_su3_dag_prod_color(temp_c3,conf[!eooe][Xdw][3],temp_c1);
-	color_summassign(out[X][0],temp_c2);
-	color_summassign(out[X][1],temp_c3);
-	color_isummassign(out[X][2],temp_c2);
-	color_isubtassign(out[X][3],temp_c3);
-      }
+    NISSA_PARALLEL_LOOP(X,0,loc_volh) tmn2Deo_or_tmn2Doe_site(out[X],conf,eooe,X,in);
     
     set_borders_invalid(out);
   }
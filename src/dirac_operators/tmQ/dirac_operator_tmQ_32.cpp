@@ -0,0 +1,131 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include "base/thread_macros.hpp"
+#include "base/vectors.hpp"
+#include "communicate/borders.hpp"
+#include "geometry/geometry_lx.hpp"
+#include "new_types/su3_op.hpp"
+#ifdef USE_THREADS
+ #include "routines/thread.hpp"
+#endif
+
+//Apply the Q=D*g5 operator to a spincolor
+namespace nissa
+{
+  THREADABLE_FUNCTION_5ARG(apply_tmQ_32, single_spincolor*,out, single_quad_su3*,conf, double,kappa, double,mu, single_spincolor*,in)
+  {
+    communicate_lx_single_spincolor_borders(in);
+    communicate_lx_single_quad_su3_borders(conf);
+    
+    const float kcf=1/(2*kappa),fmu=mu;
+    
+    GET_THREAD_ID();
+    NISSA_PARALLEL_LOOP(X,0,loc_vol)
+      {
+	int Xup,Xdw;
+	single_color temp_c0,temp_c1,temp_c2,temp_c3;
+	
+	//Forward 0
+	Xup=loclx_neighup[X][0];
+	single_color_summ(temp_c0,in[Xup][0],in[Xup][2]);
+	single_color_summ(temp_c1,in[Xup][1],in[Xup][3]);
+	unsafe_single_su3_prod_single_color(out[X][0],conf[X][0],temp_c0);
+	unsafe_single_su3_prod_single_color(out[X][1],conf[X][0],temp_c1);
+	single_color_copy(out[X][2],out[X][0]);
+	single_color_copy(out[X][3],out[X][1]);
+	
+	//Backward 0
+	Xdw=loclx_neighdw[X][0];
+	single_color_subt(temp_c0,in[Xdw][0],in[Xdw][2]);
+	single_color_subt(temp_c1,in[Xdw][1],in[Xdw][3]);
+	unsafe_single_su3_dag_prod_single_color(temp_c2,conf[Xdw][0],temp_c0);
+	unsafe_single_su3_dag_prod_single_color(temp_c3,conf[Xdw][0],temp_c1);
+	single_color_summassign(out[X][0],temp_c2);
+	single_color_summassign(out[X][1],temp_c3);
+	single_color_subtassign(out[X][2],temp_c2);
+	single_color_subtassign(out[X][3],temp_c3);
+	
+	//Forward 1
+	Xup=loclx_neighup[X][1];
+	single_color_isumm(temp_c0,in[Xup][0],in[Xup][3]);
+	single_color_isumm(temp_c1,in[Xup][1],in[Xup][2]);
+	unsafe_single_su3_prod_single_color(temp_c2,conf[X][1],temp_c0);
+	unsafe_single_su3_prod_single_color(temp_c3,conf[X][1],temp_c1);
+	single_color_summassign(out[X][0],temp_c2);
+	single_color_summassign(out[X][1],temp_c3);
+	single_color_isubtassign(out[X][2],temp_c3);
+	single_color_isubtassign(out[X][3],temp_c2);
+	
+	//Backward 1
+	Xdw=loclx_neighdw[X][1];
+	single_color_isubt(temp_c0,in[Xdw][0],in[Xdw][3]);
+	single_color_isubt(temp_c1,in[Xdw][1],in[Xdw][2]);
+	unsafe_single_su3_dag_prod_single_color(temp_c2,conf[Xdw][1],temp_c0);
+	unsafe_single_su3_dag_prod_single_color(temp_c3,conf[Xdw][1],temp_c1);
+	single_color_summassign(out[X][0],temp_c2);
+	single_color_summassign(out[X][1],temp_c3);
+	single_color_isummassign(out[X][2],temp_c3);
+	single_color_isummassign(out[X][3],temp_c2);
+	
+	//Forward 2
+	Xup=loclx_neighup[X][2];
+	single_color_summ(temp_c0,in[Xup][0],in[Xup][3]);
+	single_color_subt(temp_c1,in[Xup][1],in[Xup][2]);
+	unsafe_single_su3_prod_single_color(temp_c2,conf[X][2],temp_c0);
+	unsafe_single_su3_prod_single_color(temp_c3,conf[X][2],temp_c1);
+	single_color_summassign(out[X][0],temp_c2);
+	single_color_summassign(out[X][1],temp_c3);
+	single_color_subtassign(out[X][2],temp_c3);
+	single_color_summassign(out[X][3],temp_c2);
+	
+	//Backward 2
+	Xdw=loclx_neighdw[X][2];
+	single_color_subt(temp_c0,in[Xdw][0],in[Xdw][3]);
+	single_color_summ(temp_c1,in[Xdw][1],in[Xdw][2]);
+	unsafe_single_su3_dag_prod_single_color(temp_c2,conf[Xdw][2],temp_c0);
+	unsafe_single_su3_dag_prod_single_color(temp_c3,conf[Xdw][2],temp_c1);
+	single_color_summassign(out[X][0],temp_c2);
+	single_color_summassign(out[X][1],temp_c3);
+	single_color_summassign(out[X][2],temp_c3);
+	single_color_subtassign(out[X][3],temp_c2);
+	
+	//Forward 3
+	Xup=loclx_neighup[X][3];
+	single_color_isumm(temp_c0,in[Xup][0],in[Xup][2]);
+	single_color_isubt(temp_c1,in[Xup][1],in[Xup][3]);
+	unsafe_single_su3_prod_single_color(temp_c2,conf[X][3],temp_c0);
+	unsafe_single_su3_prod_single_color(temp_c3,conf[X][3],temp_c1);
+	single_color_summassign(out[X][0],temp_c2);
+	single_color_summassign(out[X][1],temp_c3);
+	single_color_isubtassign(out[X][2],temp_c2);
+	single_color_isummassign(out[X][3],temp_c3);
+	
+	//Backward 3
+	Xdw=loclx_neighdw[X][3];
+	single_color_isubt(temp_c0,in[Xdw][0],in[Xdw][2]);
+	single_color_isumm(temp_c1,in[Xdw][1],in[Xdw][3]);
+	unsafe_single_su3_dag_prod_single_color(temp_c2,conf[Xdw][3],temp_c0);
+	unsafe_single_su3_dag_prod_single_color(temp_c3,conf[Xdw][3],temp_c1);
+	single_color_summassign(out[X][0],temp_c2);
+	single_color_summassign(out[X][1],temp_c3);
+	single_color_isummassign(out[X][2],temp_c2);
+	single_color_isubtassign(out[X][3],temp_c3);
+	
+	//Put the -1/2 factor on derivative, the gamma5, and the imu
+	for(int c=0;c<NCOL;c++)
+	  for(int id=0;id<NDIRAC;id++)
+	    {
+	      const float sign=(id<NDIRAC/2)?+1:-1;
+	      const float re=sign*(-0.5f*out[X][id][c][RE]+kcf*in[X][id][c][RE])-fmu*in[X][id][c][IM];
+	      const float im=sign*(-0.5f*out[X][id][c][IM]+kcf*in[X][id][c][IM])+fmu*in[X][id][c][RE];
+	      out[X][id][c][RE]=re;
+	      out[X][id][c][IM]=im;
+	    }
+      }
+    
+    set_borders_invalid(out);
+  }
+  THREADABLE_FUNCTION_END
+}
@@ -0,0 +1,11 @@
+#ifndef _DIRAC_OPERATOR_TMQ_32_HPP
+#define _DIRAC_OPERATOR_TMQ_32_HPP
+
+#include "new_types/su3.hpp"
+
+namespace nissa
+{
+  void apply_tmQ_32(single_spincolor *out,single_quad_su3 *conf,double kappa,double mu,single_spincolor *in);
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef _DIRAC_OPERATOR_TMQ_MULTI_HPP
+#define _DIRAC_OPERATOR_TMQ_MULTI_HPP
+
+#include "geometry/geometry_lx.hpp"
+#include "new_types/su3_op.hpp"
+
+namespace nissa
+{
+  //compute the Wilson hopping term of site X for the right hand side irhs of an interleaved vector
+  //the links of the site are passed from outside, so that they are loaded once for all the rhs
+  inline void apply_point_Wilson_hopping_multi(spincolor out,su3 **Ufw,su3 **Ubw,int X,int nrhs,int irhs,spincolor *in)
+  {
+    int Xup,Xdw;
+    color temp_c0,temp_c1,temp_c2,temp_c3;
+    
+    //Forward 0
+    Xup=loclx_neighup[X][0]*nrhs+irhs;
+    color_summ(temp_c0,in[Xup][0],in[Xup][2]);
+    color_summ(temp_c1,in[Xup][1],in[Xup][3]);
+    unsafe_su3_prod_color(out[0],*Ufw[0],temp_c0);
+    unsafe_su3_prod_color(out[1],*Ufw[0],temp_c1);
+    color_copy(out[2],out[0]);
+    color_copy(out[3],out[1]);
+    
+    //Backward 0
+    Xdw=loclx_neighdw[X][0]*nrhs+irhs;
+    color_subt(temp_c0,in[Xdw][0],in[Xdw][2]);
+    color_subt(temp_c1,in[Xdw][1],in[Xdw][3]);
+    unsafe_su3_dag_prod_color(temp_c2,*Ubw[0],temp_c0);
+    unsafe_su3_dag_prod_color(temp_c3,*Ubw[0],temp_c1);
+    color_summassign(out[0],temp_c2);
+    color_summassign(out[1],temp_c3);
+    color_subtassign(out[2],temp_c2);
+    color_subtassign(out[3],temp_c3);
+    
+    //Forward 1
+    Xup=loclx_neighup[X][1]*nrhs+irhs;
+    color_isumm(temp_c0,in[Xup][0],in[Xup][3]);
+    color_isumm(temp_c1,in[Xup][1],in[Xup][2]);
+    unsafe_su3_prod_color(temp_c2,*Ufw[1],temp_c0);
+    unsafe_su3_prod_color(temp_c3,*Ufw[1],temp_c1);
+    color_summassign(out[0],temp_c2);
+    color_summassign(out[1],temp_c3);
+    color_isubtassign(out[2],temp_c3);
+    color_isubtassign(out[3],temp_c2);
+    
+    //Backward 1
+    Xdw=loclx_neighdw[X][1]*nrhs+irhs;
+    color_isubt(temp_c0,in[Xdw][0],in[Xdw][3]);
+    color_isubt(temp_c1,in[Xdw][1],in[Xdw][2]);
+    unsafe_su3_dag_prod_color(temp_c2,*Ubw[1],temp_c0);
+    unsafe_su3_dag_prod_color(temp_c3,*Ubw[1],temp_c1);
+    color_summassign(out[0],temp_c2);
+    color_summassign(out[1],temp_c3);
+    color_isummassign(out[2],temp_c3);
+    color_isummassign(out[3],temp_c2);
+    
+    //Forward 2
+    Xup=loclx_neighup[X][2]*nrhs+irhs;
+    color_summ(temp_c0,in[Xup][0],in[Xup][3]);
+    color_subt(temp_c1,in[Xup][1],in[Xup][2]);
+    unsafe_su3_prod_color(temp_c2,*Ufw[2],temp_c0);
+    unsafe_su3_prod_color(temp_c3,*Ufw[2],temp_c1);
+    color_summassign(out[0],temp_c2);
+    color_summassign(out[1],temp_c3);
+    color_subtassign(out[2],temp_c3);
+    color_summassign(out[3],temp_c2);
+    
+    //Backward 2
+    Xdw=loclx_neighdw[X][2]*nrhs+irhs;
+    color_subt(temp_c0,in[Xdw][0],in[Xdw][3]);
+    color_summ(temp_c1,in[Xdw][1],in[Xdw][2]);
+    unsafe_su3_dag_prod_color(temp_c2,*Ubw[2],temp_c0);
+    unsafe_su3_dag_prod_color(temp_c3,*Ubw[2],temp_c1);
+    color_summassign(out[0],temp_c2);
+    color_summassign(out[1],temp_c3);
+    color_summassign(out[2],temp_c3);
+    color_subtassign(out[3],temp_c2);
+    
+    //Forward 3
+    Xup=loclx_neighup[X][3]*nrhs+irhs;
+    color_isumm(temp_c0,in[Xup][0],in[Xup][2]);
+    color_isubt(temp_c1,in[Xup][1],in[Xup][3]);
+    unsafe_su3_prod_color(temp_c2,*Ufw[3],temp_c0);
+    unsafe_su3_prod_color(temp_c3,*Ufw[3],temp_c1);
+    color_summassign(out[0],temp_c2);
+    color_summassign(out[1],temp_c3);
+    color_isubtassign(out[2],temp_c2);
+    color_isummassign(out[3],temp_c3);
+    
+    //Backward 3
+    Xdw=loclx_neighdw[X][3]*nrhs+irhs;
+    color_isubt(temp_c0,in[Xdw][0],in[Xdw][2]);
+    color_isumm(temp_c1,in[Xdw][1],in[Xdw][3]);
+    unsafe_su3_dag_prod_color(temp_c2,*Ubw[3],temp_c0);
+    unsafe_su3_dag_prod_color(temp_c3,*Ubw[3],temp_c1);
+    color_summassign(out[0],temp_c2);
+    color_summassign(out[1],temp_c3);
+    color_isummassign(out[2],temp_c2);
+    color_isubtassign(out[3],temp_c3);
+  }
+  
+  void apply_tmQ_multi(spincolor *out,quad_su3 *conf,double kappa,double mu,int nrhs,spincolor *in);
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include "base/debug.hpp"
+#include "base/vectors.hpp"
+#include "communicate/communicate.hpp"
+#include "geometry/geometry_lx.hpp"
+
+#include "../tmQ/dirac_operator_tmQ_32.hpp"
+
+namespace nissa
+{
+  void apply_tmQ2_RL_32(single_spincolor *out,single_quad_su3 *conf,double kappa,single_spincolor *ext_temp,int RL,double mu,single_spincolor *in)
+  {
+    single_spincolor *temp=ext_temp;
+    if(ext_temp==NULL) temp=nissa_malloc("tempQ",loc_vol+bord_vol,single_spincolor);
+    
+    if(RL==1) crash("left not implmented");
+    
+    apply_tmQ_32(temp,conf,kappa,+mu,in);
+    apply_tmQ_32(out,conf,kappa,-mu,temp);
+    
+    if(ext_temp==NULL) nissa_free(temp);
+  }
+}
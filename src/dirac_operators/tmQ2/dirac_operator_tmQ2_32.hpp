@@ -0,0 +1,11 @@
+#ifndef _DIRAC_OPERATOR_TMQ2_32_HPP
+#define _DIRAC_OPERATOR_TMQ2_32_HPP
+
+#include "new_types/su3.hpp"
+
+namespace nissa
+{
+  void apply_tmQ2_RL_32(single_spincolor *out,single_quad_su3 *conf,double kappa,single_spincolor *temp,int RL,double mu,single_spincolor *in);
+}
+
+#endif
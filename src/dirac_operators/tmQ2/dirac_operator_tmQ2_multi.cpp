@@ -0,0 +1,24 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include "base/vectors.hpp"
+#include "geometry/geometry_lx.hpp"
+
+#include "../tmQ/dirac_operator_tmQ_multi.hpp"
+
+//Apply the Q+Q- operator to nrhs interleaved spincolor
+
+namespace nissa
+{
+  void apply_tmQ2_multi(spincolor *out,quad_su3 *conf,double kappa,spincolor *ext_temp,double mu,int nrhs,spincolor *in)
+  {
+    spincolor *temp=ext_temp;
+    if(ext_temp==NULL) temp=nissa_malloc("tempQ",(loc_vol+bord_vol)*nrhs,spincolor);
+    
+    apply_tmQ_multi(temp,conf,kappa,+mu,nrhs,in);
+    apply_tmQ_multi(out,conf,kappa,-mu,nrhs,temp);
+    
+    if(ext_temp==NULL) nissa_free(temp);
+  }
+}
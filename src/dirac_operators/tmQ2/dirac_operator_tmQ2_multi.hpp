@@ -0,0 +1,11 @@
+#ifndef _DIRAC_OPERATOR_TMQ2_MULTI_HPP
+#define _DIRAC_OPERATOR_TMQ2_MULTI_HPP
+
+#include "new_types/su3.hpp"
+
+namespace nissa
+{
+  void apply_tmQ2_multi(spincolor *out,quad_su3 *conf,double kappa,spincolor *temp,double mu,int nrhs,spincolor *in);
+}
+
+#endif
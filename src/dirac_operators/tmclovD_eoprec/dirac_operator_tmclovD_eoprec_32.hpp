@@ -0,0 +1,11 @@
+#ifndef _DIRAC_OPERATOR_TMCLOVD_EOPREC_32_HPP
+#define _DIRAC_OPERATOR_TMCLOVD_EOPREC_32_HPP
+
+#include "new_types/su3.hpp"
+
+namespace nissa
+{
+  void tmclovDkern_eoprec_square_eos_32(single_spincolor *out,single_spincolor *temp1,single_spincolor *temp2,single_quad_su3 **conf,double kappa,single_clover_term_t *Cl_odd,single_inv_clover_term_t *invCl_evn,double mu,single_spincolor *in);
+}
+
+#endif
@@ -49,16 +49,52 @@ namespace nissa
   }
   THREADABLE_FUNCTION_END
   
-  //implement Koo defined in equation (7)
+  //implement Koo defined in equation (7), in two sweeps: the even hopping is multiplied by the inverse clover term
+  //site by site, then the odd hopping is put together with the diagonal term and gamma5 while writing the output
   THREADABLE_FUNCTION_9ARG(tmclovDkern_eoprec_eos, spincolor*,out, spincolor*,temp, quad_su3**,conf, double,kappa, clover_term_t*,Cl_odd, inv_clover_term_t*,invCl_evn, bool,dag, double,mu, spincolor*,in)
   {
-    tmn2Deo_eos(out,conf,in);
-    inv_tmclovDee_or_oo_eos(temp,invCl_evn,dag,out);
-    tmn2Doe_eos(out,conf,temp);
+    if(in==out) crash("in==out!");
+    
+    //if dagger, swaps the sign of mu, which means taking the hermitian of the inverse
+    int high=0,low=1;
+    if(dag)
+      {
+	std::swap(low,high);
+	mu=-mu;
+      }
+    
+    communicate_ev_and_od_quad_su3_borders(conf);
+    communicate_od_spincolor_borders(in);
+    
+    GET_THREAD_ID();
+    NISSA_PARALLEL_LOOP(X,0,loc_volh)
+      {
+	spincolor hop;
+	tmn2Deo_or_tmn2Doe_site(hop,conf,EVN,X,in);
+	unsafe_halfspincolor_halfspincolor_times_halfspincolor(&(temp[X][2*high]),invCl_evn[X][high],&(hop[2*high]));
+	unsafe_halfspincolor_halfspincolor_dag_times_halfspincolor(&(temp[X][2*low]),invCl_evn[X][low],&(hop[2*low]));
+      }
+    set_borders_invalid(temp);
     
-    tmclovDee_or_oo_eos(temp,kappa,Cl_odd,dag,mu,in);
+    communicate_ev_spincolor_borders(temp);
+    NISSA_PARALLEL_LOOP(X,0,loc_volh)
+      {
+	spincolor hop,diag;
+	tmn2Deo_or_tmn2Doe_site(hop,conf,ODD,X,temp);
+	apply_point_twisted_clover_term_to_halfspincolor(&(diag[0*NDIRAC/2]),+mu,kappa,&(Cl_odd[X][0*NDIRAC/2]),&(in[X][0*NDIRAC/2]));
+	apply_point_twisted_clover_term_to_halfspincolor(&(diag[1*NDIRAC/2]),-mu,kappa,&(Cl_odd[X][1*NDIRAC/2]),&(in[X][1*NDIRAC/2]));
+	
+	//gamma5 is explicitely implemented
+	for(int id=0;id<NDIRAC/2;id++)
+	  for(int ic=0;ic<NCOL;ic++)
+	    for(int ri=0;ri<2;ri++)
+	      {
+		out[X][id  ][ic][ri]=+diag[id  ][ic][ri]-hop[id  ][ic][ri]*0.25;
+		out[X][id+NDIRAC/2][ic][ri]=-diag[id+NDIRAC/2][ic][ri]+hop[id+NDIRAC/2][ic][ri]*0.25;
+	      }
+      }
     
-    tmDkern_eoprec_eos_put_together_and_include_gamma5(out,temp);
+    set_borders_invalid(out);
   }
   THREADABLE_FUNCTION_END
   
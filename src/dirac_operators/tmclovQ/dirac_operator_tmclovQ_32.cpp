@@ -0,0 +1,134 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include "base/thread_macros.hpp"
+#include "base/vectors.hpp"
+#include "communicate/borders.hpp"
+#include "new_types/su3_op.hpp"
+#include "operations/su3_paths/clover_term.hpp"
+#ifdef USE_THREADS
+ #include "routines/thread.hpp"
+#endif
+
+//Apply the Q=D*g5 operator to a spincolor
+namespace nissa
+{
+  THREADABLE_FUNCTION_6ARG(apply_tmclovQ_32, single_spincolor*,out, single_quad_su3*,conf, double,kappa, single_clover_term_t*,Cl, double,mu, single_spincolor*,in)
+  {
+    communicate_lx_single_spincolor_borders(in);
+    communicate_lx_single_quad_su3_borders(conf);
+    
+    const float kcf=1/(2*kappa),fmu=mu;
+    
+    GET_THREAD_ID();
+    NISSA_PARALLEL_LOOP(X,0,loc_vol)
+      {
+	int Xup,Xdw;
+	single_color temp_c0,temp_c1,temp_c2,temp_c3;
+	
+	//Clover term
+	unsafe_apply_point_chromo_operator_to_single_spincolor(out[X],Cl[X],in[X]);
+	
+	single_spincolor temp;
+	
+	//Forward 0
+	Xup=loclx_neighup[X][0];
+	single_color_summ(temp_c0,in[Xup][0],in[Xup][2]);
+	single_color_summ(temp_c1,in[Xup][1],in[Xup][3]);
+	unsafe_single_su3_prod_single_color(temp[2],conf[X][0],temp_c0);
+	unsafe_single_su3_prod_single_color(temp[3],conf[X][0],temp_c1);
+	single_color_copy(temp[0],temp[2]);
+	single_color_copy(temp[1],temp[3]);
+	
+	//Backward 0
+	Xdw=loclx_neighdw[X][0];
+	single_color_subt(temp_c0,in[Xdw][0],in[Xdw][2]);
+	single_color_subt(temp_c1,in[Xdw][1],in[Xdw][3]);
+	unsafe_single_su3_dag_prod_single_color(temp_c2,conf[Xdw][0],temp_c0);
+	unsafe_single_su3_dag_prod_single_color(temp_c3,conf[Xdw][0],temp_c1);
+	single_color_summassign(temp[0],temp_c2);
+	single_color_summassign(temp[1],temp_c3);
+	single_color_subtassign(temp[2],temp_c2);
+	single_color_subtassign(temp[3],temp_c3);
+	
+	//Forward 1
+	Xup=loclx_neighup[X][1];
+	single_color_isumm(temp_c0,in[Xup][0],in[Xup][3]);
+	single_color_isumm(temp_c1,in[Xup][1],in[Xup][2]);
+	unsafe_single_su3_prod_single_color(temp_c2,conf[X][1],temp_c0);
+	unsafe_single_su3_prod_single_color(temp_c3,conf[X][1],temp_c1);
+	single_color_summassign(temp[0],temp_c2);
+	single_color_summassign(temp[1],temp_c3);
+	single_color_isubtassign(temp[2],temp_c3);
+	single_color_isubtassign(temp[3],temp_c2);
+	
+	//Backward 1
+	Xdw=loclx_neighdw[X][1];
+	single_color_isubt(temp_c0,in[Xdw][0],in[Xdw][3]);
+	single_color_isubt(temp_c1,in[Xdw][1],in[Xdw][2]);
+	unsafe_single_su3_dag_prod_single_color(temp_c2,conf[Xdw][1],temp_c0);
+	unsafe_single_su3_dag_prod_single_color(temp_c3,conf[Xdw][1],temp_c1);
+	single_color_summassign(temp[0],temp_c2);
+	single_color_summassign(temp[1],temp_c3);
+	single_color_isummassign(temp[2],temp_c3);
+	single_color_isummassign(temp[3],temp_c2);
+	
+	//Forward 2
+	Xup=loclx_neighup[X][2];
+	single_color_summ(temp_c0,in[Xup][0],in[Xup][3]);
+	single_color_subt(temp_c1,in[Xup][1],in[Xup][2]);
+	unsafe_single_su3_prod_single_color(temp_c2,conf[X][2],temp_c0);
+	unsafe_single_su3_prod_single_color(temp_c3,conf[X][2],temp_c1);
+	single_color_summassign(temp[0],temp_c2);
+	single_color_summassign(temp[1],temp_c3);
+	single_color_subtassign(temp[2],temp_c3);
+	single_color_summassign(temp[3],temp_c2);
+	
+	//Backward 2
+	Xdw=loclx_neighdw[X][2];
+	single_color_subt(temp_c0,in[Xdw][0],in[Xdw][3]);
+	single_color_summ(temp_c1,in[Xdw][1],in[Xdw][2]);
+	unsafe_single_su3_dag_prod_single_color(temp_c2,conf[Xdw][2],temp_c0);
+	unsafe_single_su3_dag_prod_single_color(temp_c3,conf[Xdw][2],temp_c1);
+	single_color_summassign(temp[0],temp_c2);
+	single_color_summassign(temp[1],temp_c3);
+	single_color_summassign(temp[2],temp_c3);
+	single_color_subtassign(temp[3],temp_c2);
+	
+	//Forward 3
+	Xup=loclx_neighup[X][3];
+	single_color_isumm(temp_c0,in[Xup][0],in[Xup][2]);
+	single_color_isubt(temp_c1,in[Xup][1],in[Xup][3]);
+	unsafe_single_su3_prod_single_color(temp_c2,conf[X][3],temp_c0);
+	unsafe_single_su3_prod_single_color(temp_c3,conf[X][3],temp_c1);
+	single_color_summassign(temp[0],temp_c2);
+	single_color_summassign(temp[1],temp_c3);
+	single_color_isubtassign(temp[2],temp_c2);
+	single_color_isummassign(temp[3],temp_c3);
+	
+	//Backward 3
+	Xdw=loclx_neighdw[X][3];
+	single_color_isubt(temp_c0,in[Xdw][0],in[Xdw][2]);
+	single_color_isumm(temp_c1,in[Xdw][1],in[Xdw][3]);
+	unsafe_single_su3_dag_prod_single_color(temp_c2,conf[Xdw][3],temp_c0);
+	unsafe_single_su3_dag_prod_single_color(temp_c3,conf[Xdw][3],temp_c1);
+	single_color_summassign(temp[0],temp_c2);
+	single_color_summassign(temp[1],temp_c3);
+	single_color_isummassign(temp[2],temp_c2);
+	single_color_isubtassign(temp[3],temp_c3);
+	
+	//Put the -1/2 factor on derivative, the gamma5, and the imu
+	for(int c=0;c<NCOL;c++)
+	  for(int id=0;id<NDIRAC;id++)
+	    {
+	      const float sign=(id<NDIRAC/2)?+1:-1;
+	      out[X][id][c][RE]=sign*(out[X][id][c][RE]-0.5f*temp[id][c][RE]+kcf*in[X][id][c][RE])-fmu*in[X][id][c][IM];
+	      out[X][id][c][IM]=sign*(out[X][id][c][IM]-0.5f*temp[id][c][IM]+kcf*in[X][id][c][IM])+fmu*in[X][id][c][RE];
+	    }
+      }
+    
+    set_borders_invalid(out);
+  }
+  THREADABLE_FUNCTION_END
+}
@@ -0,0 +1,63 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include "base/debug.hpp"
+#include "base/thread_macros.hpp"
+#include "base/vectors.hpp"
+#include "communicate/borders.hpp"
+#include "dirac_operators/tmQ/dirac_operator_tmQ_multi.hpp"
+#include "new_types/su3_op.hpp"
+#include "operations/su3_paths/clover_term.hpp"
+#ifdef USE_THREADS
+ #include "routines/thread.hpp"
+#endif
+
+//Apply the Q=D*g5 operator to nrhs spincolor stored interleaved: in[X*nrhs+irhs]
+//links and clover term of each site are loaded once and reused for all the rhs
+namespace nissa
+{
+  THREADABLE_FUNCTION_7ARG(apply_tmclovQ_multi, spincolor*,out, quad_su3*,conf, double,kappa, clover_term_t*,Cl, double,mu, int,nrhs, spincolor*,in)
+  {
+    if(nrhs<1 || nrhs>NISSA_MAX_NRHS) crash("nrhs %d not in the range [1,%d]",nrhs,NISSA_MAX_NRHS);
+    
+    communicate_lx_multi_spincolor_borders(in,nrhs);
+    communicate_lx_quad_su3_borders(conf);
+    
+    const double kcf=1/(2*kappa);
+    
+    GET_THREAD_ID();
+    NISSA_PARALLEL_LOOP(X,0,loc_vol)
+      {
+	su3 *Ufw[NDIM],*Ubw[NDIM];
+	for(int idir=0;idir<NDIM;idir++)
+	  {
+	    Ufw[idir]=conf[X]+idir;
+	    Ubw[idir]=conf[loclx_neighdw[X][idir]]+idir;
+	  }
+	
+	for(int irhs=0;irhs<nrhs;irhs++)
+	  {
+	    const int Xr=X*nrhs+irhs;
+	    
+	    //Clover term
+	    unsafe_apply_point_chromo_operator_to_spincolor(out[Xr],Cl[X],in[Xr]);
+	    
+	    spincolor temp;
+	    apply_point_Wilson_hopping_multi(temp,Ufw,Ubw,X,nrhs,irhs,in);
+	    
+	    //Put the -1/2 factor on derivative, the gamma5, and the imu
+	    for(int c=0;c<NCOL;c++)
+	      for(int id=0;id<NDIRAC;id++)
+		{
+		  const double sign=(id<NDIRAC/2)?+1:-1;
+		  out[Xr][id][c][RE]=sign*(out[Xr][id][c][RE]-0.5*temp[id][c][RE]+kcf*in[Xr][id][c][RE])-mu*in[Xr][id][c][IM];
+		  out[Xr][id][c][IM]=sign*(out[Xr][id][c][IM]-0.5*temp[id][c][IM]+kcf*in[Xr][id][c][IM])+mu*in[Xr][id][c][RE];
+		}
+	  }
+      }
+    
+    set_borders_invalid(out);
+  }
+  THREADABLE_FUNCTION_END
+}
@@ -0,0 +1,11 @@
+#ifndef _DIRAC_OPERATOR_TMCLOVQ_MULTI_HPP
+#define _DIRAC_OPERATOR_TMCLOVQ_MULTI_HPP
+
+#include "new_types/su3.hpp"
+
+namespace nissa
+{
+  void apply_tmclovQ_multi(spincolor *out,quad_su3 *conf,double kappa,clover_term_t *Cl,double mu,int nrhs,spincolor *in);
+}
+
+#endif
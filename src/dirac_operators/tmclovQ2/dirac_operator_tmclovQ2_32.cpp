@@ -0,0 +1,16 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include "dirac_operators/tmclovQ/dirac_operator_tmclovQ_32.hpp"
+
+//Apply the Q+Q- operator to a spincolor
+
+namespace nissa
+{
+  void apply_tmclovQ2_32(single_spincolor *out,single_quad_su3 *conf,double kappa,single_clover_term_t *Cl,single_spincolor *temp,double mu,single_spincolor *in)
+  {
+    apply_tmclovQ_32(temp,conf,kappa,Cl,+mu,in);
+    apply_tmclovQ_32(out,conf,kappa,Cl,-mu,temp);
+  }
+}
@@ -0,0 +1,16 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include "dirac_operators/tmclovQ/dirac_operator_tmclovQ_multi.hpp"
+
+//Apply the Q+Q- operator to nrhs interleaved spincolor
+
+namespace nissa
+{
+  void apply_tmclovQ2_multi(spincolor *out,quad_su3 *conf,double kappa,clover_term_t *Cl,spincolor *temp,double mu,int nrhs,spincolor *in)
+  {
+    apply_tmclovQ_multi(temp,conf,kappa,Cl,+mu,nrhs,in);
+    apply_tmclovQ_multi(out,conf,kappa,Cl,-mu,nrhs,temp);
+  }
+}
@@ -46,6 +46,24 @@ namespace nissa
       }
 #endif
   }
+  
+  //same of eigenvalues_find, for hermitean matrices, for which the autarchic implementation can be used
+  template <class Fmat,class Filler>
+  void eigenvalues_find_hermitean(complex **eig_vec,complex *eig_val,int neig,bool min_max,
+				  const int mat_size,const int mat_size_to_allocate,const Fmat &imp_mat,
+				  const double target_precision,const int niter_max,
+				  const Filler &filler,int wspace_size=DEFAULT_EIGPROB_WSPACE_SIZE)
+  {
+#ifdef USE_PARPACK
+    if(use_parpack) eigenvalues_find(eig_vec,eig_val,neig,min_max,mat_size,mat_size_to_allocate,imp_mat,target_precision,niter_max,filler,wspace_size);
+    else
+#endif
+      {
+	master_printf("Solving hermitean eigenproblem for %d %s eigenvalues with autarchic implementation,\n",neig,min_max?"max":"min");
+	master_printf(" target precision: %lg\n",target_precision);
+	eigenvalues_find_autarchic(eig_vec,eig_val,neig,min_max,mat_size,mat_size_to_allocate,imp_mat,target_precision,niter_max,filler);
+      }
+  }
 }
 
 #endif
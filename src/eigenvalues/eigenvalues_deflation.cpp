@@ -0,0 +1,55 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include "base/debug.hpp"
+#include "base/thread_macros.hpp"
+#include "base/vectors.hpp"
+#include "eigenvalues/eigenvalues_deflation.hpp"
+#include "linalgs/linalgs.hpp"
+
+#ifdef USE_THREADS
+ #include "routines/thread.hpp"
+#endif
+
+namespace nissa
+{
+  //allocate the room for the eigenvectors and eigenvalues
+  void deflation_subspace_t::alloc(int ext_neig,int ext_vect_size,int vect_size_to_allocate)
+  {
+    //sync so that all threads have checked the subspace before marking it as computed
+    THREAD_BARRIER();
+    
+    neig=ext_neig;
+    vect_size=ext_vect_size;
+    eigval=nissa_malloc("def_eigval",neig,double);
+    eigvec=nissa_malloc("def_eigvec*",neig,complex*);
+    for(int ieig=0;ieig<neig;ieig++) eigvec[ieig]=nissa_malloc("def_eigvec",vect_size_to_allocate,complex);
+  }
+  
+  //free the subspace, if computed
+  void deflation_subspace_t::destroy()
+  {
+    if(not is_computed()) return;
+    
+    for(int ieig=0;ieig<neig;ieig++) nissa_free(eigvec[ieig]);
+    nissa_free(eigvec);
+    nissa_free(eigval);
+    neig=0;
+  }
+  
+  //the eigenvalues are shifted by the difference of mass2 w.r.t the one used to compute them
+  void deflation_subspace_t::get_guess(complex *guess,double ext_mass2,complex *source) const
+  {
+    if(not is_computed()) crash("deflation subspace not computed");
+    
+    vector_reset(guess);
+    for(int ieig=0;ieig<neig;ieig++)
+      {
+	complex c;
+	complex_vector_glb_scalar_prod(c,eigvec[ieig],source,vect_size);
+	complex_prodassign_double(c,1/(eigval[ieig]-mass2+ext_mass2));
+	complex_vector_summassign_complex_vector_prod_complex(guess,eigvec[ieig],c,vect_size);
+      }
+  }
+}
@@ -0,0 +1,60 @@
+#ifndef _EIGENVALUES_DEFLATION_HPP
+#define _EIGENVALUES_DEFLATION_HPP
+
+#include <math.h>
+
+#include "eigenvalues/eigenvalues.hpp"
+#include "new_types/complex.hpp"
+
+namespace nissa
+{
+  //low modes of a hermitean operator of the form H^2+mass2, stored to be reused across sources and masses
+  struct deflation_subspace_t
+  {
+    int neig;
+    int vect_size;
+    double mass2;
+    complex **eigvec;
+    double *eigval;
+    
+    deflation_subspace_t() : neig(0),vect_size(0),mass2(0),eigvec(NULL),eigval(NULL) {}
+    
+    void alloc(int ext_neig,int ext_vect_size,int vect_size_to_allocate);
+    void destroy();
+    
+    //check that the subspace has been computed
+    bool is_computed() const
+    {return neig>0;}
+    
+    //return the solution of (H^2+ext_mass2)guess=source, restricted to the subspace
+    void get_guess(complex *guess,double ext_mass2,complex *source) const;
+  };
+  
+  //search the lowest neig eigenvectors of imp_mat, which must be hermitean and include the mass2 shift
+  template <class Fmat,class Filler>
+  void find_deflation_subspace(deflation_subspace_t &def,int neig,int vect_size,int vect_size_to_allocate,double mass2,
+			       const Fmat &imp_mat,const Filler &filler,double residue)
+  {
+    def.destroy();
+    def.alloc(neig,vect_size,vect_size_to_allocate);
+    def.mass2=mass2;
+    
+    //precision of the eigenvalues
+    const double maxerr=sqrt(residue);
+    const int niter_max=100000000;
+    
+    verbosity_lv1_master_printf("Searching for %d low modes to deflate, with a precision of %lg\n",neig,maxerr);
+    
+    complex *eigval=nissa_malloc("eigval",neig,complex);
+    eigenvalues_find_hermitean(def.eigvec,eigval,neig,0,vect_size,vect_size_to_allocate,imp_mat,maxerr,niter_max,filler);
+    
+    for(int ieig=0;ieig<neig;ieig++)
+      {
+	def.eigval[ieig]=eigval[ieig][RE];
+	verbosity_lv2_master_printf(" low mode %d: %.16lg\n",ieig,def.eigval[ieig]);
+      }
+    nissa_free(eigval);
+  }
+}
+
+#endif
@@ -110,6 +110,33 @@ namespace nissa
 	surfeo_of_bordeo[loclx_parity[surflx]][loceo_of_loclx[bordlx+loc_vol]-loc_volh]=loceo_of_loclx[surflx];
       }
     
+    //split bulk and surface of each parity, needed to overlap communications and computation
+    bulk_volh=bulk_vol/2;
+    surf_volh=surf_vol/2;
+    for(int par=0;par<2;par++)
+      {
+	loceo_of_bulkeo[par]=nissa_malloc("loceo_of_bulkeo",bulk_volh,int);
+	loceo_of_surfeo[par]=nissa_malloc("loceo_of_surfeo",surf_volh,int);
+      }
+    int ibulk_eo[2]={0,0},isurf_eo[2]={0,0};
+    for(int ibulk=0;ibulk<bulk_vol;ibulk++)
+      {
+	int loclx=loclx_of_bulklx[ibulk];
+	int par=loclx_parity[loclx];
+	loceo_of_bulkeo[par][ibulk_eo[par]++]=loceo_of_loclx[loclx];
+      }
+    for(int isurf=0;isurf<surf_vol;isurf++)
+      {
+	int loclx=loclx_of_surflx[isurf];
+	int par=loclx_parity[loclx];
+	loceo_of_surfeo[par][isurf_eo[par]++]=loceo_of_loclx[loclx];
+      }
+    for(int par=0;par<2;par++)
+      {
+	if(ibulk_eo[par]!=bulk_volh) crash("mismatch in bulk of parity %d, %d expected %d",par,ibulk_eo[par],(int)bulk_volh);
+	if(isurf_eo[par]!=surf_volh) crash("mismatch in surf of parity %d, %d expected %d",par,isurf_eo[par],(int)surf_volh);
+      }
+    
     master_printf("E/O Geometry intialized\n");
     
     eo_geom_inited=1;
@@ -184,6 +211,8 @@ namespace nissa
       {
 	nissa_free(loclx_of_loceo[par]);
 	nissa_free(surfeo_of_bordeo[par]);
+	nissa_free(loceo_of_bulkeo[par]);
+	nissa_free(loceo_of_surfeo[par]);
 	nissa_free(loceo_neighup[par]);
 	nissa_free(loceo_neighdw[par]);
       }
@@ -23,6 +23,9 @@ namespace nissa
   EXTERN_GEOMETRY_EO int *loceo_of_loclx;
   EXTERN_GEOMETRY_EO int *loclx_of_loceo[2];
   EXTERN_GEOMETRY_EO int *surfeo_of_bordeo[2];
+  EXTERN_GEOMETRY_EO int64_t bulk_volh,surf_volh;
+  EXTERN_GEOMETRY_EO int *loceo_of_bulkeo[2];
+  EXTERN_GEOMETRY_EO int *loceo_of_surfeo[2];
   EXTERN_GEOMETRY_EO coords *loceo_neighup[2];
   EXTERN_GEOMETRY_EO coords *loceo_neighdw[2];
   EXTERN_GEOMETRY_EO int eo_geom_inited;
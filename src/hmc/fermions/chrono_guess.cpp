@@ -0,0 +1,189 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include <algorithm>
+#include <math.h>
+
+#include "base/thread_macros.hpp"
+#include "base/vectors.hpp"
+#include "dirac_operators/stD/dirac_operator_stD.hpp"
+#include "geometry/geometry_eo.hpp"
+#include "inverters/staggered/cg_invert_stD2ee_m2.hpp"
+#include "inverters/staggered/cgm_invert_stD2ee_m2.hpp"
+#include "linalgs/linalgs.hpp"
+#include "routines/ios.hpp"
+#ifdef USE_THREADS
+ #include "routines/thread.hpp"
+#endif
+
+#include "chrono_guess.hpp"
+
+namespace nissa
+{
+  //add a solution to the store, recycling the oldest one if full
+  void chrono_guess_t::add(color *sol)
+  {
+    GET_THREAD_ID();
+    
+    if(not is_active()) return;
+    
+    color *dest=(nstored()<depth)?nissa_malloc("chrono_sol",loc_volh+bord_volh,color):sols.front();
+    THREAD_BARRIER();
+    if(IS_MASTER_THREAD)
+      {
+	if(nstored()==depth) sols.erase(sols.begin());
+	sols.push_back(dest);
+      }
+    THREAD_BARRIER();
+    
+    double_vector_copy((double*)dest,(double*)sol,loc_volh*sizeof(color)/sizeof(double));
+  }
+  
+  //free all stored solutions
+  void chrono_guess_t::reset()
+  {
+    GET_THREAD_ID();
+    
+    for(int i=0;i<nstored();i++) nissa_free(sols[i]);
+    if(IS_MASTER_THREAD) sols.clear();
+    THREAD_BARRIER();
+  }
+  
+  //minimal residual extrapolation: the guess is the solution of the system projected on the space of the stored
+  //solutions, obtained orthonormalizing them with respect to the operator, starting from the newest
+  void stD2ee_m2_chrono_guess(color *guess,chrono_guess_t *chrono,quad_su3 **eo_conf,double m2,color *source)
+  {
+    int nd=loc_volh*sizeof(color)/sizeof(double);
+    int n=chrono->nstored();
+    
+    double_vector_init_to_zero((double*)guess,nd);
+    
+    color *temp=nissa_malloc("temp",loc_volh+bord_volh,color);
+    color *q[n],*Aq[n];
+    int nq=0;
+    for(int i=n-1;i>=0;i--)
+      {
+	q[nq]=nissa_malloc("q",loc_volh+bord_volh,color);
+	Aq[nq]=nissa_malloc("Aq",loc_volh+bord_volh,color);
+	double_vector_copy((double*)(q[nq]),(double*)(chrono->sols[i]),nd);
+	apply_stD2ee_m2(Aq[nq],eo_conf,temp,m2,q[nq]);
+	
+	double ori_norm;
+	double_vector_glb_scalar_prod(&ori_norm,(double*)(q[nq]),(double*)(Aq[nq]),nd);
+	
+	//remove the components along the previous vectors
+	for(int j=0;j<nq;j++)
+	  {
+	    double c;
+	    double_vector_glb_scalar_prod(&c,(double*)(q[j]),(double*)(Aq[nq]),nd);
+	    double_vector_summassign_double_vector_prod_double((double*)(q[nq]),(double*)(q[j]),-c,nd);
+	    double_vector_summassign_double_vector_prod_double((double*)(Aq[nq]),(double*)(Aq[j]),-c,nd);
+	  }
+	
+	//drop the vector if (numerically) linearly dependent from the previous ones
+	double norm;
+	double_vector_glb_scalar_prod(&norm,(double*)(q[nq]),(double*)(Aq[nq]),nd);
+	if(norm<=ori_norm*1e-12)
+	  {
+	    nissa_free(q[nq]);
+	    nissa_free(Aq[nq]);
+	  }
+	else
+	  {
+	    double_vector_prodassign_double((double*)(q[nq]),1/sqrt(norm),nd);
+	    double_vector_prodassign_double((double*)(Aq[nq]),1/sqrt(norm),nd);
+	    
+	    //add the projection
+	    double c;
+	    double_vector_glb_scalar_prod(&c,(double*)(q[nq]),(double*)source,nd);
+	    double_vector_summassign_double_vector_prod_double((double*)guess,(double*)(q[nq]),c,nd);
+	    
+	    nq++;
+	  }
+      }
+    
+    verbosity_lv2_master_printf("Chronological guess extrapolated from %d/%d stored solutions\n",nq,n);
+    
+    for(int j=0;j<nq;j++)
+      {
+	nissa_free(q[j]);
+	nissa_free(Aq[j]);
+      }
+    nissa_free(temp);
+  }
+  
+  namespace
+  {
+    //solve the lightest pole with cg starting from the extrapolated guess, the others with cgm
+    void inv_stD2ee_m2_cgm_chrono_internal(color **chi_e,quad_su3 **eo_conf,double *poles,int nterms,int niter_max,double residue,color *pf,chrono_guess_t *chrono,double guessed_residue,bool store)
+    {
+      //find the lightest pole, which is the most expensive to converge
+      int ilight=0;
+      for(int iterm=1;iterm<nterms;iterm++) if(poles[iterm]<poles[ilight]) ilight=iterm;
+      
+      if(chrono->nstored()==0) inv_stD2ee_m2_cgm_run_hm_up_to_comm_prec(chi_e,eo_conf,poles,nterms,niter_max,residue,pf);
+      else
+	{
+	  //all the other poles together
+	  if(nterms>1)
+	    {
+	      double heavy_poles[nterms-1];
+	      color *heavy_chi_e[nterms-1];
+	      for(int iterm=0,iheavy=0;iterm<nterms;iterm++)
+		if(iterm!=ilight)
+		  {
+		    heavy_poles[iheavy]=poles[iterm];
+		    heavy_chi_e[iheavy]=chi_e[iterm];
+		    iheavy++;
+		  }
+	      inv_stD2ee_m2_cgm_run_hm_up_to_comm_prec(heavy_chi_e,eo_conf,heavy_poles,nterms-1,niter_max,residue,pf);
+	    }
+	  
+	  //the lightest one
+	  color *guess=nissa_malloc("guess",loc_volh+bord_volh,color);
+	  stD2ee_m2_chrono_guess(guess,chrono,eo_conf,poles[ilight],pf);
+	  inv_stD2ee_m2_cg(chi_e[ilight],guess,eo_conf,poles[ilight],niter_max,guessed_residue,pf);
+	  nissa_free(guess);
+	}
+      
+      if(store) chrono->add(chi_e[ilight]);
+    }
+  }
+  
+  //multishift inversion used in the force, feeding the store - the solution seeded by the guess is converged
+  //to the tolerance of the store, which must be tight enough not to spoil the reversibility of the trajectory
+  void inv_stD2ee_m2_cgm_chrono_run_hm_up_to_comm_prec(color **chi_e,quad_su3 **eo_conf,double *poles,int nterms,int niter_max,double residue,color *pf,chrono_guess_t *chrono)
+  {
+    if(chrono==NULL or not chrono->is_active()) inv_stD2ee_m2_cgm_run_hm_up_to_comm_prec(chi_e,eo_conf,poles,nterms,niter_max,residue,pf);
+    else inv_stD2ee_m2_cgm_chrono_internal(chi_e,eo_conf,poles,nterms,niter_max,residue,pf,chrono,std::min(residue,chrono->residue),true);
+  }
+  
+  //sum of all the shifts for the action, using (but not feeding) the store
+  THREADABLE_FUNCTION_7ARG(summ_src_and_all_inv_stD2ee_m2_cgm_chrono, color*,chi_e, quad_su3**,eo_conf, rat_approx_t*,appr, int,niter_max, double,req_res, color*,source, chrono_guess_t*,chrono)
+  {
+    GET_THREAD_ID();
+    
+    if(chrono==NULL or chrono->nstored()==0) summ_src_and_all_inv_stD2ee_m2_cgm(chi_e,eo_conf,appr,niter_max,req_res,source);
+    else
+      {
+	//allocate temporary single solutions
+	color *temp[appr->degree()];
+	for(int iterm=0;iterm<appr->degree();iterm++) temp[iterm]=nissa_malloc("temp",loc_volh+bord_volh,color);
+	
+	inv_stD2ee_m2_cgm_chrono_internal(temp,eo_conf,appr->poles.data(),appr->degree(),niter_max,req_res,source,chrono,req_res,false);
+	
+	//summ all the shifts
+	NISSA_PARALLEL_LOOP(i,0,loc_volh*(int)(sizeof(color)/sizeof(double)))
+	  {
+	    ((double*)chi_e)[i]=appr->cons*((double*)source)[i];
+	    for(int iterm=0;iterm<appr->degree();iterm++)
+	      ((double*)chi_e)[i]+=appr->weights[iterm]*((double*)(temp[iterm]))[i];
+	  }
+	set_borders_invalid(chi_e);
+	
+	for(int iterm=0;iterm<appr->degree();iterm++) nissa_free(temp[iterm]);
+      }
+  }
+  THREADABLE_FUNCTION_END
+}
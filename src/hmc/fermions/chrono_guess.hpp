@@ -0,0 +1,53 @@
+#ifndef _CHRONO_GUESS_HPP
+#define _CHRONO_GUESS_HPP
+
+#include <utility>
+#include <vector>
+
+#include "new_types/rat_approx.hpp"
+#include "new_types/su3.hpp"
+
+namespace nissa
+{
+  //store the last solutions of the lightest shift along the molecular dynamics, to extrapolate a starting guess
+  struct chrono_guess_t
+  {
+    int depth;
+    double residue;
+    
+    //stored solutions, the newest is the last
+    std::vector<color*> sols;
+    
+    bool is_active(){return depth>0;}
+    int nstored(){return sols.size();}
+    
+    void add(color *sol);
+    void reset();
+    
+    chrono_guess_t() : depth(0),residue(0) {}
+    ~chrono_guess_t() {reset();}
+    
+    //the stored solutions are owned, so the store can be moved but not copied
+    chrono_guess_t(const chrono_guess_t&)=delete;
+    chrono_guess_t& operator=(const chrono_guess_t&)=delete;
+    chrono_guess_t(chrono_guess_t&& oth) : depth(oth.depth),residue(oth.residue),sols(std::move(oth.sols)) {oth.sols.clear();}
+    chrono_guess_t& operator=(chrono_guess_t&& oth)
+    {
+      if(this!=&oth)
+	{
+	  reset();
+	  depth=oth.depth;
+	  residue=oth.residue;
+	  sols=std::move(oth.sols);
+	  oth.sols.clear();
+	}
+      return *this;
+    }
+  };
+  
+  void stD2ee_m2_chrono_guess(color *guess,chrono_guess_t *chrono,quad_su3 **eo_conf,double m2,color *source);
+  void inv_stD2ee_m2_cgm_chrono_run_hm_up_to_comm_prec(color **chi_e,quad_su3 **eo_conf,double *poles,int nterms,int niter_max,double residue,color *pf,chrono_guess_t *chrono);
+  void summ_src_and_all_inv_stD2ee_m2_cgm_chrono(color *chi_e,quad_su3 **eo_conf,rat_approx_t *appr,int niter_max,double req_res,color *source,chrono_guess_t *chrono);
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include "communicate/borders.hpp"
 #include "dirac_operators/stD/dirac_operator_stD.hpp"
 #include "hmc/backfield.hpp"
+#include "hmc/fermions/chrono_guess.hpp"
 #include "inverters/staggered/cgm_invert_stD2ee_m2.hpp"
 #include "new_types/su3.hpp"
 #ifdef USE_THREADS
@@ -18,7 +19,7 @@ namespace nissa
   //Compute the fermionic force the rooted staggered eoprec improved theory.
   //Of the result still need to be taken the TA and product with U
   //The approximation need to be already scaled, and must contain physical mass term
-  THREADABLE_FUNCTION_8ARG(summ_the_rootst_eoimpr_quark_force, quad_su3**,F, double,charge, quad_su3**,eo_conf, color*,pf, int,quantization, quad_u1**,u1b, rat_approx_t*,appr, double,residue)
+  THREADABLE_FUNCTION_9ARG(summ_the_rootst_eoimpr_quark_force, quad_su3**,F, double,charge, quad_su3**,eo_conf, color*,pf, int,quantization, quad_u1**,u1b, rat_approx_t*,appr, double,residue, chrono_guess_t*,chrono)
   {
     GET_THREAD_ID();
     
@@ -35,9 +36,9 @@ namespace nissa
     //add the background fields
     add_backfield_with_stagphases_to_conf(eo_conf,u1b);
     
-    //invert the various terms
+    //invert the various terms, starting the lightest from the chronological guess if available
     STOP_TIMING(quark_force_over_time);
-    inv_stD2ee_m2_cgm_run_hm_up_to_comm_prec(chi_e,eo_conf,appr->poles.data(),appr->degree(),1000000,residue,pf);
+    inv_stD2ee_m2_cgm_chrono_run_hm_up_to_comm_prec(chi_e,eo_conf,appr->poles.data(),appr->degree(),1000000,residue,pf,chrono);
     UNPAUSE_TIMING(quark_force_over_time);
     
     ////////////////////
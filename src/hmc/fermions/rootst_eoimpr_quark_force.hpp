@@ -1,11 +1,12 @@
 #ifndef _ROOTST_EOIMPR_QUARK_FORCE_HPP
 #define _ROOTST_EOIMPR_QUARK_FORCE_HPP
 
+#include "hmc/fermions/chrono_guess.hpp"
 #include "new_types/rat_approx.hpp"
 
 namespace nissa
 {
-  void summ_the_rootst_eoimpr_quark_force(quad_su3 **F,double charge,quad_su3 **eo_conf,color *pf,int quantization,quad_u1 **u1b,rat_approx_t *appr,double residue);
+  void summ_the_rootst_eoimpr_quark_force(quad_su3 **F,double charge,quad_su3 **eo_conf,color *pf,int quantization,quad_u1 **u1b,rat_approx_t *appr,double residue,chrono_guess_t *chrono=NULL);
 }
 
 #endif
@@ -38,6 +38,23 @@ namespace nissa
   }
   THREADABLE_FUNCTION_END
   
+  //e/o version
+  THREADABLE_FUNCTION_2ARG(gluonic_force_finish_computation, quad_su3**,F, quad_su3**,conf)
+  {
+    GET_THREAD_ID();
+    
+    for(int par=0;par<2;par++)
+      NISSA_PARALLEL_LOOP(ieo,0,loc_volh)
+	for(int mu=0;mu<NDIM;mu++)
+	  {
+	    su3 temp;
+	    unsafe_su3_prod_su3(temp,conf[par][ieo][mu],F[par][ieo][mu]);
+	    unsafe_su3_traceless_anti_hermitian_part(F[par][ieo][mu],temp);
+	  }
+    THREAD_BARRIER();
+  }
+  THREADABLE_FUNCTION_END
+  
   //compute the gauge force
   void compute_gluonic_force_lx_conf_do_not_finish(quad_su3 *F,quad_su3 *conf,theory_pars_t *physics)
   {
@@ -4,6 +4,7 @@
 
 #include "base/thread_macros.hpp"
 #include "base/vectors.hpp"
+#include "geometry/geometry_eo.hpp"
 #include "geometry/geometry_lx.hpp"
 #include "hmc/theory_pars.hpp"
 #include "new_types/su3.hpp"
@@ -15,6 +16,7 @@
 #include "routines/ios.hpp"
 
 #include "gluonic_force.hpp"
+#include "topological_force.hpp"
 
 //#define DEBUG
 
@@ -145,4 +147,100 @@ namespace nissa
 #endif
   }
   THREADABLE_FUNCTION_END
+  
+  //allocate the stack of smeared confs (the unsmeared one is binded at each call), the leaves and the charge
+  THREADABLE_FUNCTION_2ARG(topological_force_eo_buffers_allocate, topological_force_eo_buffers_t*,buf, int,nlevels)
+  {
+    buf->nlevels=nlevels;
+    if(nlevels) stout_smear_conf_stack_allocate(&(buf->sme_conf),NULL,nlevels);
+    else buf->sme_conf=NULL;
+    for(int par=0;par<2;par++) buf->leaves[par]=nissa_malloc("leaves",loc_volh+bord_volh+edge_volh,as2t_su3);
+    buf->charge=nissa_malloc("charge",loc_vol,double);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //free the buffers
+  THREADABLE_FUNCTION_1ARG(topological_force_eo_buffers_free, topological_force_eo_buffers_t*,buf)
+  {
+    if(buf->nlevels) stout_smear_conf_stack_free(&(buf->sme_conf),buf->nlevels);
+    for(int par=0;par<2;par++) nissa_free(buf->leaves[par]);
+    nissa_free(buf->charge);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //common part of the e/o case: the charge needed by the potential is obtained from the same leaves of the staples
+  void compute_topological_force_eo_conf_internal(quad_su3 **F,quad_su3 **conf,topotential_pars_t *pars,topological_force_eo_buffers_t *buf)
+  {
+    GET_THREAD_ID();
+    
+    //compute the clover-shape paths
+    four_leaves(buf->leaves,conf);
+    
+    //compute the potential, before the leaves are overwritten
+    double pot=0;
+    switch(pars->flag)
+      {
+      case 1: pot=pars->theta;break;
+      case 2:
+	{
+	  double Q;
+	  total_topological_charge_from_leaves(&Q,buf->leaves,buf->charge);
+	  pot=pars->compute_pot_der(Q);
+	}
+	break;
+      default: crash("unknown way to compute topological potential %d",pars->flag);
+      }
+    
+    //compute the staples
+    topological_staples_from_leaves(F,conf,buf->leaves);
+    
+    //normalize
+    double norm=pot/(M_PI*M_PI*128);
+    for(int par=0;par<2;par++)
+      {
+	NISSA_PARALLEL_LOOP(ieo,0,loc_volh)
+	  for(int mu=0;mu<NDIM;mu++)
+	    safe_su3_hermitian_prod_double(F[par][ieo][mu],F[par][ieo][mu],norm);
+	set_borders_invalid(F[par]);
+      }
+  }
+  
+  //compute the topological force directly on the e/o conf, using buf if passed (or allocating it internally)
+  THREADABLE_FUNCTION_4ARG(compute_topological_force_eo_conf, quad_su3**,F, quad_su3**,conf, topotential_pars_t*,pars, topological_force_eo_buffers_t*,ext_buf)
+  {
+    verbosity_lv1_master_printf("Computing topological force\n");
+    
+    int nlevels=pars->stout_pars.nlevels;
+    
+    //take the buffers
+    topological_force_eo_buffers_t loc_buf,*buf=ext_buf;
+    if(buf==NULL)
+      {
+	topological_force_eo_buffers_allocate(&loc_buf,nlevels);
+	buf=&loc_buf;
+      }
+    else
+      if(buf->nlevels!=nlevels) crash("buffers allocated for %d stout levels, %d needed",buf->nlevels,nlevels);
+    
+    //compute the staples
+    if(nlevels==0) compute_topological_force_eo_conf_internal(F,conf,pars,buf);
+    else
+      {
+	//bind the conf to the stack and smear iteratively retaining all of it
+	buf->sme_conf[0]=conf;
+	stout_smear_whole_stack(buf->sme_conf,conf,&(pars->stout_pars));
+	
+	//compute the force in terms of the most smeared conf
+	compute_topological_force_eo_conf_internal(F,buf->sme_conf[nlevels],pars,buf);
+	
+	//remap the force backward
+	stouted_force_remap(F,buf->sme_conf,&(pars->stout_pars));
+      }
+    
+    //take TA
+    gluonic_force_finish_computation(F,conf);
+    
+    if(ext_buf==NULL) topological_force_eo_buffers_free(&loc_buf);
+  }
+  THREADABLE_FUNCTION_END
 }
@@ -6,7 +6,19 @@
 
 namespace nissa
 {
+  //buffers needed to compute the topological force on the e/o conf, to be kept across calls
+  struct topological_force_eo_buffers_t
+  {
+    int nlevels;
+    quad_su3 ***sme_conf;
+    as2t_su3 *leaves[2];
+    double *charge;
+  };
+  
+  void topological_force_eo_buffers_allocate(topological_force_eo_buffers_t *buf,int nlevels);
+  void topological_force_eo_buffers_free(topological_force_eo_buffers_t *buf);
   void compute_topological_force_lx_conf(quad_su3 *F,quad_su3 *conf,topotential_pars_t *pars);
+  void compute_topological_force_eo_conf(quad_su3 **F,quad_su3 **conf,topotential_pars_t *pars,topological_force_eo_buffers_t *buf=NULL);
 }
 
 #endif
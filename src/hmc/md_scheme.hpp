@@ -0,0 +1,94 @@
+#ifndef _MD_SCHEME_HPP
+#define _MD_SCHEME_HPP
+
+#include <string>
+
+#include "base/debug.hpp"
+#include "hmc/hmc.hpp"
+
+namespace nissa
+{
+  //symmetric schemes to integrate a level of the molecular dynamics, in the velocity version (starting and ending with a kick)
+  enum md_scheme_t{OMELYAN_MD_SCHEME,FORCE_GRADIENT_MD_SCHEME,MN4_5FV_MD_SCHEME};
+  
+  //coefficients of kicks and drifts, in units of the step; in the force gradient kicks the force is evaluated on the
+  //conf displaced along the force itself by grad*step^2
+  struct md_scheme_coeffs_t
+  {
+    int nkicks;
+    double kick[6];
+    double drift[5];
+    double grad[6];
+  };
+  
+  inline md_scheme_coeffs_t get_md_scheme_coeffs(md_scheme_t scheme)
+  {
+    const double l=omelyan_lambda;
+    //Omelyan, Mryglod, Folk, Comput. Phys. Commun. 151 (2003) 272
+    const double th=0.08398315262876693,rh=0.2539785108410595,la=0.6822365335719091,mu=-0.03230286765269967;
+    
+    md_scheme_coeffs_t c;
+    switch(scheme)
+      {
+      case OMELYAN_MD_SCHEME:
+	c={3,{l,1-2*l,l},{0.5,0.5},{0,0,0}};
+	break;
+      case FORCE_GRADIENT_MD_SCHEME:
+	c={3,{1.0/6,2.0/3,1.0/6},{0.5,0.5},{0,1.0/24,0}};
+	break;
+      case MN4_5FV_MD_SCHEME:
+	c={6,{th,la,0.5-la-th,0.5-la-th,la,th},{rh,mu,1-2*(rh+mu),mu,rh},{0,0,0,0,0,0}};
+	break;
+      default:
+	crash("unknown scheme %d",scheme);
+      }
+    
+    return c;
+  }
+  
+  //order of the scheme
+  inline int md_scheme_order(md_scheme_t scheme)
+  {return (scheme==OMELYAN_MD_SCHEME)?2:4;}
+  
+  inline std::string md_scheme_name(md_scheme_t scheme)
+  {
+    switch(scheme)
+      {
+      case OMELYAN_MD_SCHEME:return "Omelyan";break;
+      case FORCE_GRADIENT_MD_SCHEME:return "ForceGradient";break;
+      case MN4_5FV_MD_SCHEME:return "4MN5FV";break;
+      default:crash("unknown scheme %d",scheme);return "";
+      }
+  }
+  
+  inline md_scheme_t md_scheme_from_name(std::string name)
+  {
+    if(name=="Omelyan") return OMELYAN_MD_SCHEME;
+    if(name=="ForceGradient") return FORCE_GRADIENT_MD_SCHEME;
+    if(name=="4MN5FV") return MN4_5FV_MD_SCHEME;
+    crash("unknown md scheme \"%s\", use \"Omelyan\", \"ForceGradient\" or \"4MN5FV\"",name.c_str());
+    return OMELYAN_MD_SCHEME;
+  }
+  
+  //integrate a level for a time T in nsteps, merging the last kick of each step with the first of the following one;
+  //kick(dt,grad_dt2) evolves the momenta with the force of the level, drift(dt) the inner levels
+  template <class K,class D>
+  void integrate_md_level(md_scheme_t scheme,int nsteps,double T,K kick,D drift)
+  {
+    md_scheme_coeffs_t c=get_md_scheme_coeffs(scheme);
+    double h=T/nsteps;
+    
+    kick(c.kick[0]*h,c.grad[0]*h*h);
+    for(int istep=0;istep<nsteps;istep++)
+      for(int i=0;i<c.nkicks-1;i++)
+	{
+	  drift(c.drift[i]*h);
+	  
+	  double dt=c.kick[i+1]*h;
+	  if(i==c.nkicks-2 and istep<nsteps-1) dt+=c.kick[0]*h;
+	  kick(dt,c.grad[i+1]*h*h);
+	}
+  }
+}
+
+#endif
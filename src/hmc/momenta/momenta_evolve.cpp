@@ -60,6 +60,48 @@ namespace nissa
   }
   THREADABLE_FUNCTION_END
   
+  //evolve the e/o momenta with force
+  THREADABLE_FUNCTION_3ARG(evolve_eo_momenta_with_force, quad_su3**,H, quad_su3**,F, double,dt)
+  {
+    GET_THREAD_ID();
+    
+    for(int par=0;par<2;par++)
+      NISSA_PARALLEL_LOOP(ieo,0,loc_volh)
+	for(int mu=0;mu<NDIM;mu++)
+	  for(int ic1=0;ic1<NCOL;ic1++)
+	    for(int ic2=0;ic2<NCOL;ic2++)
+	      complex_subt_the_prod_idouble(H[par][ieo][mu][ic1][ic2],F[par][ieo][mu][ic1][ic2],dt);
+    THREAD_BARRIER();
+  }
+  THREADABLE_FUNCTION_END
+  
+  //evolve the e/o configuration with the momenta
+  THREADABLE_FUNCTION_3ARG(evolve_eo_conf_with_momenta, quad_su3**,eo_conf, quad_su3**,H, double,dt)
+  {
+    GET_THREAD_ID();
+    
+    verbosity_lv2_master_printf("Evolving e/o conf with momenta, dt=%lg\n",dt);
+    
+    START_TIMING(conf_evolve_time,nconf_evolve);
+    
+    for(int par=0;par<2;par++)
+      {
+	NISSA_PARALLEL_LOOP(ieo,0,loc_volh)
+	  for(int mu=0;mu<NDIM;mu++)
+	    {
+	      su3 t1,t2;
+	      su3_prod_double(t1,H[par][ieo][mu],dt);
+	      safe_hermitian_exact_i_exponentiate(t2,t1);
+	      
+	      safe_su3_prod_su3(eo_conf[par][ieo][mu],t2,eo_conf[par][ieo][mu]);
+	    }
+	set_borders_invalid(eo_conf[par]);
+      }
+    
+    STOP_TIMING(conf_evolve_time);
+  }
+  THREADABLE_FUNCTION_END
+  
   //accelerate and evolve
   void evolve_lx_conf_with_accelerated_momenta(quad_su3 *lx_conf,quad_su3 *acc_conf,quad_su3 *H,double kappa,int niter,double residue,double dt)
   {
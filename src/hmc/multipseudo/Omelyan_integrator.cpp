@@ -3,6 +3,7 @@
  #include "config.hpp"
 #endif
 
+#include <math.h>
 #include <stdint.h>
 
 #include "geometry/geometry_mix.hpp"
@@ -12,11 +13,13 @@
 #endif
 
 #include "hmc/hmc.hpp"
+#include "hmc/md_scheme.hpp"
 #include "hmc/theory_pars.hpp"
 #include "hmc/gauge/gluonic_force.hpp"
 #include "hmc/gauge/pure_gauge_Omelyan_integrator.hpp"
 #include "hmc/gauge/topological_force.hpp"
 #include "hmc/momenta/momenta_evolve.hpp"
+#include "linalgs/linalgs.hpp"
 
 #include "quark_force.hpp"
 #include "theory_action.hpp"
@@ -28,84 +31,115 @@
 
 namespace nissa
 {
-  //evolve the momenta with topological force
-  THREADABLE_FUNCTION_5ARG(evolve_lx_momenta_with_topological_force, quad_su3*,H, quad_su3*,conf, topotential_pars_t*,topars, double,dt, quad_su3*,ext_F)
+  namespace
   {
-    verbosity_lv2_master_printf("Evolving lx momenta with topological force, dt=%lg\n",dt);
+    //sum of the force norms measured at each level along the trajectory, and number of measures
+    std::vector<double> md_level_force_norm;
+    std::vector<int> md_level_nforce_norm;
+    //acceptance probabilities collected since the last change of the outermost number of steps
+    std::vector<double> md_tune_acc_prob;
+    //the force norms need global reductions, so they are measured only while tuning
+    bool md_measure_force_norm;
+    //topological force and buffers needed to compute it, kept along the whole trajectory
+    quad_su3 *topo_F[2];
+    topological_force_eo_buffers_t topo_buf;
     
-    //allocate force and compute it
-    quad_su3 *F=(ext_F==NULL)?nissa_malloc("F",loc_vol,quad_su3):ext_F;
-    compute_topological_force_lx_conf(F,conf,topars);
-    
-    //evolve
-    evolve_lx_momenta_with_force(H,F,dt);
-    if(ext_F==NULL) nissa_free(F);
+    //store the norm of the force of a level
+    void store_md_level_force_norm(int ilev,double norm)
+    {
+      GET_THREAD_ID();
+      
+      if(IS_MASTER_THREAD)
+	{
+	  if((int)md_level_force_norm.size()<=ilev)
+	    {
+	      md_level_force_norm.resize(ilev+1,0);
+	      md_level_nforce_norm.resize(ilev+1,0);
+	    }
+	  md_level_force_norm[ilev]+=norm;
+	  md_level_nforce_norm[ilev]++;
+	}
+      THREAD_BARRIER();
+    }
   }
-  THREADABLE_FUNCTION_END
   
-  //eo wrapper
-  THREADABLE_FUNCTION_4ARG(evolve_eo_momenta_with_topological_force, quad_su3**,eo_H, quad_su3**,eo_conf, topotential_pars_t*,topars, double,dt)
+  //displace the conf along the force by eps, to evaluate the force gradient: U=exp(eps*F)U
+  void displace_lx_conf_along_force(quad_su3 *lx_conf,quad_su3 *F,double eps)
   {
-    verbosity_lv2_master_printf("Evolving e/o momenta with topological force, dt=%lg\n",dt);
-    
-    //reorder
-    quad_su3 *lx_conf=nissa_malloc("lx_conf",loc_vol+bord_vol+edge_vol,quad_su3);
-    quad_su3 *lx_H=nissa_malloc("lx_H",loc_vol,quad_su3);
-    paste_eo_parts_into_lx_vector(lx_conf,eo_conf);
-    paste_eo_parts_into_lx_vector(lx_H,eo_H);
-    
-    evolve_lx_momenta_with_topological_force(lx_H,lx_conf,topars,dt,NULL);
-    
-    split_lx_vector_into_eo_parts(eo_H,lx_H);
-    nissa_free(lx_H);
-    nissa_free(lx_conf);
+    quad_su3 *G=nissa_malloc("G",loc_vol,quad_su3);
+    vector_reset(G);
+    evolve_lx_momenta_with_force(G,F,1);
+    evolve_lx_conf_with_momenta(lx_conf,G,eps);
+    nissa_free(G);
+  }
+  
+  //e/o version
+  void displace_eo_conf_along_force(quad_su3 **eo_conf,quad_su3 **F,double eps)
+  {
+    quad_su3 *G[2];
+    for(int par=0;par<2;par++)
+      {
+	G[par]=nissa_malloc("G",loc_volh,quad_su3);
+	vector_reset(G[par]);
+      }
+    evolve_eo_momenta_with_force(G,F,1);
+    evolve_eo_conf_with_momenta(eo_conf,G,eps);
+    for(int par=0;par<2;par++) nissa_free(G[par]);
+  }
+  
+  ////////////////////////////////////////////// GAUGE LEVEL ////////////////////////////////////////////////
+  
+  //compute the force of the gauge level, including the topological one if integrated at the micro level
+  THREADABLE_FUNCTION_4ARG(compute_gauge_level_force, quad_su3*,F, quad_su3*,lx_conf, theory_pars_t*,theory_pars, quad_su3*,aux_F)
+  {
+    compute_gluonic_force_lx_conf(F,lx_conf,theory_pars);
+    if(theory_pars->topotential_pars.flag and TOPO_EVOLUTION==TOPO_MICRO)
+      {
+	compute_topological_force_lx_conf(aux_F,lx_conf,&(theory_pars->topotential_pars));
+	double_vector_summassign((double*)F,(double*)aux_F,loc_vol*sizeof(quad_su3)/sizeof(double));
+      }
   }
   THREADABLE_FUNCTION_END
   
-  //evolve the configuration according to pure gauge - note that there is a similar routine in "pure_gage"
-  THREADABLE_FUNCTION_4ARG(Omelyan_pure_gauge_evolver_lx_conf, quad_su3*,H, quad_su3*,lx_conf, theory_pars_t*,theory_pars, hmc_evol_pars_t*,simul)
+  //evolve the configuration for a time T according to the gauge level - note that there is a similar routine in "pure_gage"
+  THREADABLE_FUNCTION_5ARG(pure_gauge_evolver_lx_conf, quad_su3*,H, quad_su3*,lx_conf, theory_pars_t*,theory_pars, hmc_evol_pars_t*,simul, double,T)
   {
-    //macro step or micro step
-    double dt=simul->traj_length/simul->nmd_steps/simul->ngauge_substeps/2,
-      dth=dt/2,ldt=dt*omelyan_lambda,l2dt=2*omelyan_lambda*dt,uml2dt=(1-2*omelyan_lambda)*dt;
-    int nsteps=simul->ngauge_substeps;
+    int ilev=simul->nferm_levels();
+    md_scheme_t scheme=simul->scheme_of_level(ilev);
+    quad_su3 *F=nissa_malloc("F",loc_vol,quad_su3);
     quad_su3 *aux_F=nissa_malloc("aux_F",loc_vol,quad_su3);
+    quad_su3 *sto_conf=(scheme==FORCE_GRADIENT_MD_SCHEME)?nissa_malloc("sto_conf",loc_vol+bord_vol+edge_vol,quad_su3):NULL;
     
-    topotential_pars_t *topars=&(theory_pars->topotential_pars);
-    
-    //     Compute H(t+lambda*dt) i.e. v1=v(t)+a[r(t)]*lambda*dt (first half step)
-    evolve_momenta_with_pure_gauge_force(H,lx_conf,theory_pars,ldt,aux_F);
-    if(topars->flag and TOPO_EVOLUTION==TOPO_MICRO) evolve_lx_momenta_with_topological_force(H,lx_conf,topars,ldt,aux_F);
-    
-    //         Main loop
-    for(int istep=0;istep<nsteps;istep++)
-      {
-	verbosity_lv1_master_printf(" Omelyan gauge micro-step %d/%d\n",istep+1,nsteps);
-	
-	//decide if last step is final or not
-	double last_dt=(istep==(nsteps-1)) ? ldt : l2dt;
-	
-	//     Compute U(t+dt/2) i.e. r1=r(t)+v1*dt/2
-	evolve_lx_conf_with_momenta(lx_conf,H,dth);
-	//     Compute H(t+(1-2*lambda)*dt) i.e. v2=v1+a[r1]*(1-2*lambda)*dt
-	evolve_momenta_with_pure_gauge_force(H,lx_conf,theory_pars,uml2dt,aux_F);
-	if(topars->flag and TOPO_EVOLUTION==TOPO_MICRO) evolve_lx_momenta_with_topological_force(H,lx_conf,topars,uml2dt,aux_F);
-	//     Compute U(t+dt/2) i.e. r(t+dt)=r1+v2*dt/2
-	evolve_lx_conf_with_momenta(lx_conf,H,dth);
-	//     Compute H(t+dt) i.e. v(t+dt)=v2+a[r(t+dt)]*lambda*dt (at last step) or *2*lambda*dt
-	evolve_momenta_with_pure_gauge_force(H,lx_conf,theory_pars,last_dt,aux_F);
-	if(topars->flag and TOPO_EVOLUTION==TOPO_MICRO) evolve_lx_momenta_with_topological_force(H,lx_conf,topars,last_dt,aux_F);
-	
-	//normalize the configuration
-	//unitarize_lx_conf_maximal_trace_projecting(lx_conf);
-      }
+    integrate_md_level(scheme,simul->nsteps_of_level(ilev),T,
+		       [&](double dt,double grad_dt2)
+		       {
+			 verbosity_lv2_master_printf("Evolving momenta with pure gauge force, dt=%lg\n",dt);
+			 
+			 compute_gauge_level_force(F,lx_conf,theory_pars,aux_F);
+			 if(md_measure_force_norm) store_md_level_force_norm(ilev,sqrt(double_vector_glb_norm2(F,loc_vol)/glb_vol));
+			 
+			 //evaluate the force on the displaced conf
+			 if(grad_dt2!=0)
+			   {
+			     vector_copy(sto_conf,lx_conf);
+			     displace_lx_conf_along_force(lx_conf,F,grad_dt2);
+			     compute_gauge_level_force(F,lx_conf,theory_pars,aux_F);
+			     vector_copy(lx_conf,sto_conf);
+			   }
+			 
+			 evolve_lx_momenta_with_force(H,F,dt);
+		       },
+		       [&](double dt)
+		       {evolve_lx_conf_with_momenta(lx_conf,H,dt);});
     
+    nissa_free(F);
     nissa_free(aux_F);
+    if(sto_conf) nissa_free(sto_conf);
   }
   THREADABLE_FUNCTION_END
   
   //wrapper
-  void Omelyan_pure_gauge_evolver_eo_conf(quad_su3 **H_eo,quad_su3 **conf_eo,theory_pars_t *theory_pars,hmc_evol_pars_t *simul)
+  void pure_gauge_evolver_eo_conf(quad_su3 **H_eo,quad_su3 **conf_eo,theory_pars_t *theory_pars,hmc_evol_pars_t *simul,double T)
   {
     quad_su3 *H_lx=nissa_malloc("H_lx",loc_vol,quad_su3);
     quad_su3 *conf_lx=nissa_malloc("conf_lx",loc_vol+bord_vol+edge_vol,quad_su3);
@@ -113,7 +147,7 @@ namespace nissa
     paste_eo_parts_into_lx_vector(H_lx,H_eo);
     paste_eo_parts_into_lx_vector(conf_lx,conf_eo);
     
-    Omelyan_pure_gauge_evolver_lx_conf(H_lx,conf_lx,theory_pars,simul);
+    pure_gauge_evolver_lx_conf(H_lx,conf_lx,theory_pars,simul,T);
     
     split_lx_vector_into_eo_parts(H_eo,H_lx);
     split_lx_vector_into_eo_parts(conf_eo,conf_lx);
@@ -124,18 +158,58 @@ namespace nissa
   
   /////////////////////////////////////// QUARK E/O PART ////////////////////////////////////////////////
   
-  // Evolve momenta according to the rooted staggered force
-  THREADABLE_FUNCTION_7ARG(evolve_momenta_with_quark_force, quad_su3**,H, quad_su3**,conf, std::vector<std::vector<pseudofermion_t> >*,pf, theory_pars_t*,theory_pars, hmc_evol_pars_t*,simul_pars, std::vector<rat_approx_t>*,rat_appr, double,dt)
+  //compute the force of a fermionic level: the quark force of the pseudofermions integrated there, plus the
+  //topological force on the outermost level if integrated at the macro level
+  THREADABLE_FUNCTION_7ARG(compute_ferm_level_force, quad_su3**,F, quad_su3**,conf, std::vector<std::vector<pseudofermion_t> >*,pf, theory_pars_t*,theory_pars, hmc_evol_pars_t*,simul_pars, std::vector<rat_approx_t>*,rat_appr, int,ilev)
   {
-    GET_THREAD_ID();
+    //check if some pseudofermion is integrated here
+    bool has_pf=false;
+    for(size_t iflav=0;iflav<pf->size();iflav++)
+      for(size_t ipf=0;ipf<(*pf)[iflav].size();ipf++)
+	has_pf|=((*pf)[iflav][ipf].md_level==ilev);
     
-    verbosity_lv2_master_printf("Evolving momenta with quark force, dt=%lg\n",dt);
+    if(has_pf) compute_quark_force(F,conf,pf,theory_pars,rat_appr,simul_pars->md_residue,ilev);
+    else for(int par=0;par<2;par++) vector_reset(F[par]);
+    
+    topotential_pars_t *topars=&(theory_pars->topotential_pars);
+    if(ilev==0 and topars->flag and TOPO_EVOLUTION==TOPO_MACRO)
+      {
+	compute_topological_force_eo_conf(topo_F,conf,topars,&topo_buf);
+	for(int par=0;par<2;par++)
+	  double_vector_summassign((double*)(F[par]),(double*)(topo_F[par]),loc_volh*sizeof(quad_su3)/sizeof(double));
+      }
+  }
+  THREADABLE_FUNCTION_END
+  
+  // Evolve momenta according to the force of a fermionic level
+  THREADABLE_FUNCTION_9ARG(evolve_momenta_with_ferm_level_force, quad_su3**,H, quad_su3**,conf, std::vector<std::vector<pseudofermion_t> >*,pf, theory_pars_t*,theory_pars, hmc_evol_pars_t*,simul_pars, std::vector<rat_approx_t>*,rat_appr, int,ilev, double,dt, double,grad_dt2)
+  {
+    verbosity_lv2_master_printf("Evolving momenta with the force of level %d, dt=%lg\n",ilev,dt);
     
     //allocate forces
     quad_su3 *F[2]={nissa_malloc("F0",loc_volh,quad_su3),nissa_malloc("F1",loc_volh,quad_su3)};
     
     //compute the force
-    compute_quark_force(F,conf,pf,theory_pars,rat_appr,simul_pars->md_residue);
+    compute_ferm_level_force(F,conf,pf,theory_pars,simul_pars,rat_appr,ilev);
+    if(md_measure_force_norm) store_md_level_force_norm(ilev,sqrt((double_vector_glb_norm2(F[EVN],loc_volh)+double_vector_glb_norm2(F[ODD],loc_volh))/glb_vol));
+    
+    //evaluate the force on the displaced conf
+    if(grad_dt2!=0)
+      {
+	quad_su3 *sto_conf[2];
+	for(int par=0;par<2;par++)
+	  {
+	    sto_conf[par]=nissa_malloc("sto_conf",loc_volh+bord_volh+edge_volh,quad_su3);
+	    vector_copy(sto_conf[par],conf[par]);
+	  }
+	displace_eo_conf_along_force(conf,F,grad_dt2);
+	compute_ferm_level_force(F,conf,pf,theory_pars,simul_pars,rat_appr,ilev);
+	for(int par=0;par<2;par++)
+	  {
+	    vector_copy(conf[par],sto_conf[par]);
+	    nissa_free(sto_conf[par]);
+	  }
+      }
     
     //#define DEBUG
     
@@ -208,51 +282,62 @@ namespace nissa
     su3_print(nu_minus);
     //crash("anna");
 #endif
-    
     //evolve
-    for(int par=0;par<2;par++)
-      {
-	NISSA_PARALLEL_LOOP(ivol,0,loc_volh)
-	  for(int mu=0;mu<NDIM;mu++)
-	    for(int ic1=0;ic1<NCOL;ic1++)
-	      for(int ic2=0;ic2<NCOL;ic2++)
-		complex_subt_the_prod_idouble(H[par][ivol][mu][ic1][ic2],F[par][ivol][mu][ic1][ic2],dt);
-        nissa_free(F[par]);
-      }
+    evolve_eo_momenta_with_force(H,F,dt);
+    for(int par=0;par<2;par++) nissa_free(F[par]);
   }
   THREADABLE_FUNCTION_END
   
-  ////////////////////////////////////// MACRO OMELYAN ////////////////////////////////////////////////
+  //integrate the fermionic level ilev for a time T, nesting the inner levels down to the gauge one
+  void integrate_ferm_level(quad_su3 **H,quad_su3 **conf,std::vector<std::vector<pseudofermion_t> > *pf,theory_pars_t *theory_pars,hmc_evol_pars_t *simul_pars,std::vector<rat_approx_t> *rat_appr,int ilev,double T)
+  {
+    integrate_md_level(simul_pars->scheme_of_level(ilev),simul_pars->nsteps_of_level(ilev),T,
+		       [&](double dt,double grad_dt2)
+		       {evolve_momenta_with_ferm_level_force(H,conf,pf,theory_pars,simul_pars,rat_appr,ilev,dt,grad_dt2);},
+		       [&](double dt)
+		       {
+			 if(ilev+1<simul_pars->nferm_levels()) integrate_ferm_level(H,conf,pf,theory_pars,simul_pars,rat_appr,ilev+1,dt);
+			 else pure_gauge_evolver_eo_conf(H,conf,theory_pars,simul_pars,dt);
+		       });
+  }
+  
+  ////////////////////////////////////// MACRO INTEGRATOR ////////////////////////////////////////////////
   
-  THREADABLE_FUNCTION_6ARG(Omelyan_integrator, quad_su3**,H, quad_su3**,conf, std::vector<std::vector<pseudofermion_t> >*,pf, theory_pars_t*,theory_pars, hmc_evol_pars_t*,simul_pars, std::vector<rat_approx_t>*,rat_appr)
+  //nested integrator: by default the fermionic forces are integrated with Omelyan on the outermost level, and the
+  //gauge force on the inner one; the force norms needed by tune_md_steps are measured only if asked
+  THREADABLE_FUNCTION_7ARG(Omelyan_integrator, quad_su3**,H, quad_su3**,conf, std::vector<std::vector<pseudofermion_t> >*,pf, theory_pars_t*,theory_pars, hmc_evol_pars_t*,simul_pars, std::vector<rat_approx_t>*,rat_appr, int,measure_force_norm)
   {
-    int nsteps=simul_pars->nmd_steps;
-    if(nsteps)
+    GET_THREAD_ID();
+    
+    if(simul_pars->nmd_steps)
       {
-	//macro step or micro step
-	double dt=simul_pars->traj_length/simul_pars->nmd_steps,
-	  ldt=dt*omelyan_lambda,l2dt=2*omelyan_lambda*dt,uml2dt=(1-2*omelyan_lambda)*dt;
-	topotential_pars_t tp=theory_pars->topotential_pars;
+	//reset the force norms
+	if(IS_MASTER_THREAD)
+	  {
+	    md_measure_force_norm=measure_force_norm;
+	    md_level_force_norm.clear();
+	    md_level_nforce_norm.clear();
+	  }
+	THREAD_BARRIER();
 	
-	//     Compute H(t+lambda*dt) i.e. v1=v(t)+a[r(t)]*lambda*dt (first half step)
-	evolve_momenta_with_quark_force(H,conf,pf,theory_pars,simul_pars,rat_appr,ldt);
-	if(tp.flag and TOPO_EVOLUTION==TOPO_MACRO) evolve_eo_momenta_with_topological_force(H,conf,&tp,ldt);
+	for(int ilev=0;ilev<=simul_pars->nferm_levels();ilev++)
+	  verbosity_lv1_master_printf("Level %d of molecular dynamics: %d steps of %s\n",ilev,simul_pars->nsteps_of_level(ilev),md_scheme_name(simul_pars->scheme_of_level(ilev)).c_str());
 	
-	//         Main loop
-	for(int istep=0;istep<nsteps;istep++)
+	//allocate the buffers of the topological force, if integrated at the macro level
+	topotential_pars_t *topars=&(theory_pars->topotential_pars);
+	bool topo_macro=(topars->flag and TOPO_EVOLUTION==TOPO_MACRO);
+	if(topo_macro)
 	  {
-	    verbosity_lv1_master_printf("Omelyan macro-step %d/%d\n",istep+1,nsteps);
-	    
-	    //decide if last step is final or not
-	    double last_dt=(istep==(nsteps-1)) ? ldt : l2dt;
-	    
-	    Omelyan_pure_gauge_evolver_eo_conf(H,conf,theory_pars,simul_pars);
-	    evolve_momenta_with_quark_force(H,conf,pf,theory_pars,simul_pars,rat_appr,uml2dt);
-	    if(tp.flag and TOPO_EVOLUTION==TOPO_MACRO) evolve_eo_momenta_with_topological_force(H,conf,&tp,uml2dt);
-	    
-	    Omelyan_pure_gauge_evolver_eo_conf(H,conf,theory_pars,simul_pars);
-	    evolve_momenta_with_quark_force(H,conf,pf,theory_pars,simul_pars,rat_appr,last_dt);
-	    if(tp.flag and TOPO_EVOLUTION==TOPO_MACRO) evolve_eo_momenta_with_topological_force(H,conf,&tp,last_dt);
+	    for(int par=0;par<2;par++) topo_F[par]=nissa_malloc("topo_F",loc_volh,quad_su3);
+	    topological_force_eo_buffers_allocate(&topo_buf,topars->stout_pars.nlevels);
+	  }
+	
+	integrate_ferm_level(H,conf,pf,theory_pars,simul_pars,rat_appr,0,simul_pars->traj_length);
+	
+	if(topo_macro)
+	  {
+	    topological_force_eo_buffers_free(&topo_buf);
+	    for(int par=0;par<2;par++) nissa_free(topo_F[par]);
 	  }
 	
 	//normalize the configuration
@@ -260,4 +345,44 @@ namespace nissa
       }
   }
   THREADABLE_FUNCTION_END
+  
+  //tune the number of steps of the integrator: each inner level gets the number of steps making the force times the
+  //step to the order of the scheme equal to that of the enclosing level, the outermost one is adjusted to reach the
+  //target acceptance, estimated over a few trajectories
+  void tune_md_steps(hmc_evol_pars_t &simul_pars,double diff_act)
+  {
+    const int nwindow=5;
+    const double acc_tol=0.05;
+    
+    //average force norm of each level along the last trajectory
+    int nlevels=simul_pars.nferm_levels()+1;
+    std::vector<double> F(nlevels,0);
+    for(int ilev=0;ilev<std::min(nlevels,(int)md_level_nforce_norm.size());ilev++)
+      if(md_level_nforce_norm[ilev]) F[ilev]=md_level_force_norm[ilev]/md_level_nforce_norm[ilev];
+    
+    for(int ilev=1;ilev<nlevels;ilev++)
+      if(F[ilev-1]>0 and F[ilev]>0)
+	simul_pars.nsteps_of_level(ilev)=std::max(1,(int)ceil(pow(F[ilev]/F[ilev-1],1.0/md_scheme_order(simul_pars.scheme_of_level(ilev)))));
+    
+    //outermost level
+    md_tune_acc_prob.push_back(std::min(1.0,exp(-diff_act)));
+    if((int)md_tune_acc_prob.size()>=nwindow)
+      {
+	double acc=0;
+	for(size_t i=0;i<md_tune_acc_prob.size();i++) acc+=md_tune_acc_prob[i]/md_tune_acc_prob.size();
+	md_tune_acc_prob.clear();
+	
+	int &n=simul_pars.nmd_steps;
+	master_printf("MD tuning: average acceptance probability %lg, target %lg\n",acc,simul_pars.md_tune_acc);
+	if(acc<simul_pars.md_tune_acc-acc_tol) n+=std::max(1,n/10);
+	else
+	  if(acc>simul_pars.md_tune_acc+acc_tol and n>1) n--;
+      }
+    
+    for(int ilev=0;ilev<nlevels;ilev++)
+      master_printf("MD tuning: level %d, force norm %lg, %d steps\n",ilev,F[ilev],simul_pars.nsteps_of_level(ilev));
+    
+    //print the steps in the form of the input file
+    master_printf("MD tuning, current steps in input form:\n%s",simul_pars.get_nsteps_str().c_str());
+  }
 }
@@ -5,7 +5,8 @@
 
 namespace nissa
 {
-  void Omelyan_integrator(quad_su3 **H,quad_su3 **conf,std::vector<std::vector<pseudofermion_t> > *pf,theory_pars_t *theory_pars,hmc_evol_pars_t *simul,std::vector<rat_approx_t> *rat_appr);
+  void Omelyan_integrator(quad_su3 **H,quad_su3 **conf,std::vector<std::vector<pseudofermion_t> > *pf,theory_pars_t *theory_pars,hmc_evol_pars_t *simul,std::vector<rat_approx_t> *rat_appr,int measure_force_norm);
+  void tune_md_steps(hmc_evol_pars_t &simul_pars,double diff_act);
 }
 
 #endif
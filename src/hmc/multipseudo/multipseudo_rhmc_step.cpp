@@ -68,8 +68,14 @@ namespace nissa
     for(int iflav=0;iflav<theory_pars.nflavs();iflav++)
       {
 	int npf=simul_pars.npseudo_fs[iflav];
-	pf[iflav].resize(npf);
-	for(int ipf=0;ipf<npf;ipf++) pf[iflav][ipf].create(theory_pars.quarks[iflav].discretiz);
+	pf[iflav]=std::vector<pseudofermion_t>(npf);
+	for(int ipf=0;ipf<npf;ipf++)
+	  {
+	    pf[iflav][ipf].create(theory_pars.quarks[iflav].discretiz);
+	    pf[iflav][ipf].chrono.depth=simul_pars.chrono_depth;
+	    pf[iflav][ipf].chrono.residue=simul_pars.chrono_residue;
+	    pf[iflav][ipf].md_level=simul_pars.level_of_pf(iflav,ipf);
+	  }
       }
     
     //if needed smear the configuration for pseudo-fermions, approx generation and action computation
@@ -103,7 +109,7 @@ namespace nissa
     verbosity_lv2_master_printf("Initial action: %lg\n",init_action);
     
     //evolve
-    Omelyan_integrator(H,out_conf,&pf,&theory_pars,&simul_pars,&rat_appr);
+    Omelyan_integrator(H,out_conf,&pf,&theory_pars,&simul_pars,&rat_appr,itraj<simul_pars.md_tune_ntraj);
     
     //if needed, resmear the conf
     if(theory_pars.stout_pars.nlevels!=0)
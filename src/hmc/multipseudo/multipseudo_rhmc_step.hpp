@@ -1,6 +1,8 @@
 #ifndef _MULTIPSEUDO_RHMC_STEP_HPP
 #define _MULTIPSEUDO_RHMC_STEP_HPP
 
+#include "hmc/fermions/chrono_guess.hpp"
+#include "hmc/md_scheme.hpp"
 #include "hmc/theory_pars.hpp"
 #include "linalgs/linalgs.hpp"
 #include "new_types/rat_approx.hpp"
@@ -20,6 +22,10 @@ namespace nissa
     double md_residue;
     int nmd_steps;
     int ngauge_substeps;
+    int chrono_depth;
+    double chrono_residue;
+    int md_tune_ntraj;
+    double md_tune_acc;
     
     int def_id_sea_theory(){return 0;}
     int def_ntraj_tot(){return 100;}
@@ -29,9 +35,64 @@ namespace nissa
     double def_md_residue(){return 1e-8;}
     int def_nmd_steps(){return 11;}
     int def_ngauge_substeps(){return 5;}
+    int def_chrono_depth(){return 0;}
+    double def_chrono_residue(){return 1e-12;}
+    int def_md_tune_ntraj(){return 0;}
+    double def_md_tune_acc(){return 0.8;}
     
     std::vector<int> npseudo_fs;
     
+    //number of steps of the fermionic levels nested inside the outermost, for each step of the enclosing one
+    std::vector<int> ninner_steps;
+    //level at which each pseudofermion is integrated, flavour after flavour (outermost if not specified)
+    std::vector<int> pf_level;
+    //scheme of each fermionic level and, last, of the gauge one (Omelyan if not specified)
+    std::vector<md_scheme_t> md_schemes;
+    
+    //number of fermionic levels, the gauge one comes next
+    int nferm_levels()
+    {return ninner_steps.size()+1;}
+    
+    //number of steps of the level, per step of the enclosing one
+    int &nsteps_of_level(int ilev)
+    {
+      if(ilev==0) return nmd_steps;
+      if(ilev==nferm_levels()) return ngauge_substeps;
+      return ninner_steps[ilev-1];
+    }
+    
+    md_scheme_t scheme_of_level(int ilev)
+    {return (ilev<(int)md_schemes.size())?md_schemes[ilev]:OMELYAN_MD_SCHEME;}
+    
+    //level of the ipf pseudofermion of flavour iflav
+    int level_of_pf(int iflav,int ipf)
+    {
+      size_t i=ipf;
+      for(int jflav=0;jflav<iflav;jflav++) i+=npseudo_fs[jflav];
+      
+      int ilev=(i<pf_level.size())?pf_level[i]:0;
+      if(ilev<0 or ilev>=nferm_levels()) crash("pseudofermion %d of flavour %d assigned to level %d, must be in [0,%d)",ipf,iflav,ilev,nferm_levels());
+      
+      return ilev;
+    }
+    
+    //number of steps of all levels, in the form of the input file
+    std::string get_nsteps_str()
+    {
+      std::ostringstream os;
+      
+      os<<" NSteps\t\t=\t"<<nmd_steps<<"\n";
+      os<<" NSubSteps\t=\t"<<ngauge_substeps<<"\n";
+      if(ninner_steps.size())
+	{
+	  os<<" NInnerSteps\t=\t{"<<ninner_steps[0];
+	  for(size_t i=1;i<ninner_steps.size();i++) os<<","<<ninner_steps[i];
+	  os<<"}\n";
+	}
+      
+      return os.str();
+    }
+    
     int master_fprintf(FILE *fout,int full) {return nissa::master_fprintf(fout,"%s",get_str().c_str());}
     std::string get_str(int full=false)
     {
@@ -48,6 +109,28 @@ namespace nissa
 	  if(full||md_residue!=def_md_residue()) os<<" MdResidue\t=\t"<<md_residue<<"\n";
 	  if(full||nmd_steps!=def_nmd_steps()) os<<" NSteps\t\t=\t"<<nmd_steps<<"\n";
 	  if(full||ngauge_substeps!=def_ngauge_substeps()) os<<" NSubSteps\t=\t"<<ngauge_substeps<<"\n";
+	  if(full||chrono_depth!=def_chrono_depth()) os<<" ChronoDepth\t=\t"<<chrono_depth<<"\n";
+	  if(full||chrono_residue!=def_chrono_residue()) os<<" ChronoResidue\t=\t"<<chrono_residue<<"\n";
+	  if(full||md_tune_ntraj!=def_md_tune_ntraj()) os<<" MdTuneNTraj\t=\t"<<md_tune_ntraj<<"\n";
+	  if(full||md_tune_acc!=def_md_tune_acc()) os<<" MdTuneAcc\t=\t"<<md_tune_acc<<"\n";
+	  if(ninner_steps.size())
+	    {
+	      os<<" NInnerSteps\t=\t{"<<ninner_steps[0];
+	      for(size_t i=1;i<ninner_steps.size();i++) os<<","<<ninner_steps[i];
+	      os<<"}\n";
+	    }
+	  if(pf_level.size())
+	    {
+	      os<<" PseudoFermsLevel\t=\t{"<<pf_level[0];
+	      for(size_t i=1;i<pf_level.size();i++) os<<","<<pf_level[i];
+	      os<<"}\n";
+	    }
+	  if(md_schemes.size())
+	    {
+	      os<<" MdSchemes\t=\t{\""<<md_scheme_name(md_schemes[0])<<"\"";
+	      for(size_t i=1;i<md_schemes.size();i++) os<<",\""<<md_scheme_name(md_schemes[i])<<"\"";
+	      os<<"}\n";
+	    }
 	  if(full||npseudo_fs.size())
 	    {
 	      os<<" NPseudoFerms\t=\t{";
@@ -70,7 +153,14 @@ namespace nissa
 	pf_action_residue!=def_pf_action_residue()||
 	md_residue!=def_md_residue()||
 	nmd_steps!=def_nmd_steps()||
-	ngauge_substeps!=def_ngauge_substeps();
+	ngauge_substeps!=def_ngauge_substeps()||
+	chrono_depth!=def_chrono_depth()||
+	chrono_residue!=def_chrono_residue()||
+	md_tune_ntraj!=def_md_tune_ntraj()||
+	md_tune_acc!=def_md_tune_acc()||
+	ninner_steps.size()||
+	pf_level.size()||
+	md_schemes.size();
     }
     
     hmc_evol_pars_t() :
@@ -81,7 +171,11 @@ namespace nissa
       pf_action_residue(def_pf_action_residue()),
       md_residue(def_md_residue()),
       nmd_steps(def_nmd_steps()),
-      ngauge_substeps(def_ngauge_substeps()) {}
+      ngauge_substeps(def_ngauge_substeps()),
+      chrono_depth(def_chrono_depth()),
+      chrono_residue(def_chrono_residue()),
+      md_tune_ntraj(def_md_tune_ntraj()),
+      md_tune_acc(def_md_tune_acc()) {}
   };
   
   struct conf_pars_t
@@ -90,12 +184,14 @@ namespace nissa
     std::string store_path;
     int store_each;
     int store_running;
+    int async_write;
     start_conf_cond_t start_cond;
     
     std::string def_path(){return "conf";}
     std::string def_store_path(){return "stored_conf.%08d";}
     int def_store_each(){return 10;}
     int def_store_running(){return 1;}
+    int def_async_write(){return 0;}
     start_conf_cond_t def_start_cond(){return COLD_START_COND;}
     
     int master_fprintf(FILE *fout,int full) {return nissa::master_fprintf(fout,"%s",get_str().c_str());}
@@ -110,6 +206,7 @@ namespace nissa
 	  if(full||store_path!=def_store_path()) os<<" StorePath\t=\t\""<<store_path<<"\"\n";
 	  if(full||store_each!=def_store_each()) os<<" StoreEach\t=\t"<<store_each<<"\n";
 	  if(full||store_running!=def_store_running()) os<<" StoreRunning\t=\t"<<store_running<<"\n";
+	  if(full||async_write!=def_async_write()) os<<" AsyncWrite\t=\t"<<async_write<<"\n";
 	  if(full||start_cond!=def_start_cond())
 	    {
 	      os<<" StartCond\t=\t";
@@ -130,6 +227,7 @@ namespace nissa
 	store_path!=def_store_path()||
 	store_each!=def_store_each()||
 	store_running!=def_store_running()||
+	async_write!=def_async_write()||
 	start_cond!=def_start_cond();
     }
     
@@ -138,6 +236,7 @@ namespace nissa
       store_path(def_store_path()),
       store_each(def_store_each()),
       store_running(def_store_running()),
+      async_write(def_async_write()),
       start_cond(def_start_cond()) {}
   };
   
@@ -153,6 +252,11 @@ namespace nissa
     color *stag;
     spincolor *Wils;
     
+    //store of the previous solutions along the trajectory
+    chrono_guess_t chrono;
+    //level of the molecular dynamics at which it is integrated
+    int md_level;
+    
     //fill to random
     void fill(enum rnd_t rtype=RND_GAUSS,int twall=-1,int par=EVN,int dir=0)
     {
@@ -201,9 +305,9 @@ namespace nissa
 	  ndoubles=loc_volh*4*NCOL*2;
 	}
     }
-    pseudofermion_t(ferm_discretiz::name_t regul,const char *name="pf"){create(regul,name);}
+    pseudofermion_t(ferm_discretiz::name_t regul,const char *name="pf") : md_level(0) {create(regul,name);}
     
-    pseudofermion_t()
+    pseudofermion_t() : md_level(0)
     {double_ptr=NULL;}
     ~pseudofermion_t() {destroy();}
   private:
@@ -35,8 +35,8 @@ namespace nissa
   }
   THREADABLE_FUNCTION_END
   
-  //compute the quark force, without stouting reampping
-  THREADABLE_FUNCTION_6ARG(compute_quark_force_no_stout_remapping, quad_su3**,F, quad_su3**,conf, std::vector<std::vector<pseudofermion_t> >*,pf, theory_pars_t*,tp, std::vector<rat_approx_t>*,appr, double,residue)
+  //compute the quark force, without stouting reampping - only of the pseudofermions integrated at md_level, if not -1
+  THREADABLE_FUNCTION_7ARG(compute_quark_force_no_stout_remapping, quad_su3**,F, quad_su3**,conf, std::vector<std::vector<pseudofermion_t> >*,pf, theory_pars_t*,tp, std::vector<rat_approx_t>*,appr, double,residue, int,md_level)
   {
     //reset forces
     for(int eo=0;eo<2;eo++) vector_reset(F[eo]);
@@ -44,12 +44,15 @@ namespace nissa
     for(int iflav=0;iflav<tp->nflavs();iflav++)
       for(size_t ipf=0;ipf<(*pf)[iflav].size();ipf++)
 	{
+	  //skip the pseudofermions integrated at other levels
+	  if(md_level!=-1 and (*pf)[iflav][ipf].md_level!=md_level) continue;
+	  
 	  verbosity_lv2_master_printf("Computing quark force for flavour %d/%d, pseudofermion %d/%d\n",iflav+1,tp->nflavs(),ipf+1,(*pf)[iflav].size());
 	  
 	  switch(tp->quarks[iflav].discretiz)
 	    {
 	    case ferm_discretiz::ROOT_STAG:
-	      summ_the_rootst_eoimpr_quark_force(F,tp->quarks[iflav].charge,conf,(*pf)[iflav][ipf].stag,tp->em_field_pars.flag,tp->backfield[iflav],&((*appr)[iflav*nappr_per_quark+RAT_APPR_QUARK_FORCE]),residue);break;
+	      summ_the_rootst_eoimpr_quark_force(F,tp->quarks[iflav].charge,conf,(*pf)[iflav][ipf].stag,tp->em_field_pars.flag,tp->backfield[iflav],&((*appr)[iflav*nappr_per_quark+RAT_APPR_QUARK_FORCE]),residue,&((*pf)[iflav][ipf].chrono));break;
 	    default:
 	      crash("non staggered not yet implemented");
 	    }
@@ -59,12 +62,12 @@ namespace nissa
   THREADABLE_FUNCTION_END
   
   //take into account the stout remapping procedure
-  THREADABLE_FUNCTION_6ARG(compute_quark_force, quad_su3**,F, quad_su3**,conf, std::vector<std::vector<pseudofermion_t> >*,pf, theory_pars_t*,physics, std::vector<rat_approx_t>*,appr, double,residue)
+  THREADABLE_FUNCTION_7ARG(compute_quark_force, quad_su3**,F, quad_su3**,conf, std::vector<std::vector<pseudofermion_t> >*,pf, theory_pars_t*,physics, std::vector<rat_approx_t>*,appr, double,residue, int,md_level)
   {
     int nlevls=physics->stout_pars.nlevels;
     
     //first of all we take care of the trivial case
-    if(nlevls==0) compute_quark_force_no_stout_remapping(F,conf,pf,physics,appr,residue);
+    if(nlevls==0) compute_quark_force_no_stout_remapping(F,conf,pf,physics,appr,residue,md_level);
     else
       {
 	//allocate the stack of confs: conf is binded to sme_conf[0]
@@ -75,7 +78,7 @@ namespace nissa
 	stout_smear_whole_stack(sme_conf,conf,&(physics->stout_pars));
 	
 	//compute the force in terms of the most smeared conf
-	compute_quark_force_no_stout_remapping(F,sme_conf[nlevls],pf,physics,appr,residue);
+	compute_quark_force_no_stout_remapping(F,sme_conf[nlevls],pf,physics,appr,residue,md_level);
 	
 	//remap the force backward
 	stouted_force_remap(F,sme_conf,&(physics->stout_pars));
@@ -4,6 +4,7 @@
 
 #include "base/thread_macros.hpp"
 #include "hmc/backfield.hpp"
+#include "hmc/fermions/chrono_guess.hpp"
 #include "hmc/gauge/gluonic_action.hpp"
 #include "hmc/gauge/topological_action.hpp"
 #include "hmc/hmc.hpp"
@@ -67,7 +68,7 @@ namespace nissa
 	    switch(q.discretiz)
 	      {
 	      case ferm_discretiz::ROOT_STAG:
-		summ_src_and_all_inv_stD2ee_m2_cgm(chi_e.stag,eo_conf,r,1000000,res,p.stag);
+		summ_src_and_all_inv_stD2ee_m2_cgm_chrono(chi_e.stag,eo_conf,r,1000000,res,p.stag,&p.chrono);
 		break;
 	      case ferm_discretiz::ROOT_TM_CLOV:
 		summ_src_and_all_inv_tmclovDkern_eoprec_square_portable(chi_e.Wils,eo_conf,q.kappa,Cl[ODD],invCl_evn,q.mass,r,1000000,res,p.Wils);
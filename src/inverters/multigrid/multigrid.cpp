@@ -0,0 +1,308 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include <string.h>
+#include <vector>
+
+#define EXTERN_MULTIGRID
+ #include "multigrid.hpp"
+
+#include "base/thread_macros.hpp"
+#include "geometry/geometry_lx.hpp"
+#include "new_types/su3_op.hpp"
+#include "routines/mpi_routines.hpp"
+#ifdef USE_THREADS
+ #include "routines/thread.hpp"
+#endif
+
+namespace nissa
+{
+  namespace mg
+  {
+    //set the coarse geometry, grouping the local sites in blocks
+    void set_coarse_geom(coarse_geom_t &geom,coords ext_block_size)
+    {
+      geom.block_vol=geom.loc_vol=1;
+      for(int mu=0;mu<NDIM;mu++)
+	{
+	  geom.block_size[mu]=ext_block_size[mu];
+	  if(geom.block_size[mu]<=0 or loc_size[mu]%geom.block_size[mu])
+	    crash("block size %d in direction %d does not divide local size %d",geom.block_size[mu],mu,loc_size[mu]);
+	  geom.loc_size[mu]=loc_size[mu]/geom.block_size[mu];
+	  geom.block_vol*=geom.block_size[mu];
+	  geom.loc_vol*=geom.loc_size[mu];
+	}
+      verbosity_lv2_master_printf("MG: coarse local volume %d, block volume %d\n",geom.loc_vol,geom.block_vol);
+      
+      //borders exist only in parallelized directions
+      geom.bord_vol=0;
+      for(int mu=0;mu<NDIM;mu++)
+	{
+	  geom.face_vol[mu]=geom.loc_vol/geom.loc_size[mu];
+	  geom.bord_offset[mu]=geom.bord_vol;
+	  if(paral_dir[mu]) geom.bord_vol+=2*geom.face_vol[mu];
+	}
+      
+      //position of each fine site
+      geom.block_of_loclx=nissa_malloc("block_of_loclx",loc_vol,int);
+      geom.loclx_of_block=nissa_malloc("loclx_of_block",loc_vol,int);
+      for(int ivol=0;ivol<loc_vol;ivol++)
+	{
+	  coords c,b;
+	  for(int mu=0;mu<NDIM;mu++)
+	    {
+	      c[mu]=loc_coord_of_loclx[ivol][mu]/geom.block_size[mu];
+	      b[mu]=loc_coord_of_loclx[ivol][mu]%geom.block_size[mu];
+	    }
+	  int icg=lx_of_coord(c,geom.loc_size);
+	  geom.block_of_loclx[ivol]=icg;
+	  geom.loclx_of_block[icg*geom.block_vol+lx_of_coord(b,geom.block_size)]=ivol;
+	}
+      
+      //faces, ordered lexicographically so that they match the border of the neighbouring rank
+      std::vector<int> face_pos[NDIM][2];
+      for(int mu=0;mu<NDIM;mu++)
+	for(int bf=0;bf<2;bf++)
+	  {
+	    geom.face_site[mu][bf]=nissa_malloc("face_site",geom.face_vol[mu],int);
+	    face_pos[mu][bf].resize(geom.loc_vol);
+	    int iface=0;
+	    for(int icg=0;icg<geom.loc_vol;icg++)
+	      {
+		coords c;
+		coord_of_lx(c,icg,geom.loc_size);
+		if(c[mu]==(bf?geom.loc_size[mu]-1:0))
+		  {
+		    face_pos[mu][bf][icg]=iface;
+		    geom.face_site[mu][bf][iface++]=icg;
+		  }
+	      }
+	  }
+      
+      //neighbours: first NDIM forward, then NDIM backward
+      geom.neigh=nissa_malloc("neigh",geom.loc_vol*2*NDIM,int);
+      for(int icg=0;icg<geom.loc_vol;icg++)
+	{
+	  coords c;
+	  coord_of_lx(c,icg,geom.loc_size);
+	  for(int mu=0;mu<NDIM;mu++)
+	    {
+	      const int L=geom.loc_size[mu];
+	      coords n;
+	      
+	      //forward
+	      if(paral_dir[mu] and c[mu]==L-1) geom.neigh[icg*2*NDIM+mu]=geom.loc_vol+geom.bord_offset[mu]+geom.face_vol[mu]+face_pos[mu][1][icg];
+	      else
+		{
+		  for(int nu=0;nu<NDIM;nu++) n[nu]=c[nu];
+		  n[mu]=(c[mu]+1)%L;
+		  geom.neigh[icg*2*NDIM+mu]=lx_of_coord(n,geom.loc_size);
+		}
+	      
+	      //backward
+	      if(paral_dir[mu] and c[mu]==0) geom.neigh[icg*2*NDIM+NDIM+mu]=geom.loc_vol+geom.bord_offset[mu]+face_pos[mu][0][icg];
+	      else
+		{
+		  for(int nu=0;nu<NDIM;nu++) n[nu]=c[nu];
+		  n[mu]=(c[mu]+L-1)%L;
+		  geom.neigh[icg*2*NDIM+NDIM+mu]=lx_of_coord(n,geom.loc_size);
+		}
+	    }
+	}
+    }
+    
+    //free the coarse geometry
+    void unset_coarse_geom(coarse_geom_t &geom)
+    {
+      nissa_free(geom.block_of_loclx);
+      nissa_free(geom.loclx_of_block);
+      nissa_free(geom.neigh);
+      for(int mu=0;mu<NDIM;mu++)
+	for(int bf=0;bf<2;bf++)
+	  nissa_free(geom.face_site[mu][bf]);
+    }
+    
+    //exchange the faces of a coarse vector with the neighbouring ranks
+    void communicate_coarse_borders(complex *v,setup_t &s)
+    {
+      GET_THREAD_ID();
+      THREAD_BARRIER();
+      
+      const coarse_geom_t &geom=s.geom;
+      const int nc=s.ncdof;
+      if(IS_MASTER_THREAD)
+	for(int mu=0;mu<NDIM;mu++)
+	  if(paral_dir[mu])
+	    {
+	      const int n=geom.face_vol[mu]*nc*2;
+	      std::vector<double> buf(n);
+	      
+	      //the backward face goes to the forward border of the lower rank, and viceversa
+	      for(int bf=0;bf<2;bf++)
+		{
+		  for(int iface=0;iface<geom.face_vol[mu];iface++)
+		    memcpy(&buf[iface*nc*2],v+geom.face_site[mu][bf][iface]*nc,sizeof(complex)*nc);
+		  
+		  const int dest=bf?rank_neighup[mu]:rank_neighdw[mu];
+		  const int source=bf?rank_neighdw[mu]:rank_neighup[mu];
+		  complex *recv=v+(geom.loc_vol+geom.bord_offset[mu]+(bf?0:geom.face_vol[mu]))*nc;
+		  MPI_Sendrecv(&buf[0],n,MPI_DOUBLE,dest,2*mu+bf,recv,n,MPI_DOUBLE,source,2*mu+bf,cart_comm,MPI_STATUS_IGNORE);
+		}
+	    }
+      
+      THREAD_BARRIER();
+    }
+    
+    //allocate the near-null vectors and the coarse operator
+    void alloc_setup(setup_t &s,coords ext_block_size,int ext_nvec)
+    {
+      if(ext_nvec<1 or ext_nvec>MG_MAX_NVEC) crash("number of near-null vectors %d not in the range [1,%d]",ext_nvec,MG_MAX_NVEC);
+      
+      set_coarse_geom(s.geom,ext_block_size);
+      s.nvec=ext_nvec;
+      s.ncdof=2*s.nvec;
+      for(int ivec=0;ivec<s.nvec;ivec++) s.nullv[ivec]=nissa_malloc("nullv",loc_vol+bord_vol,spincolor);
+      s.self=nissa_malloc("self",s.geom.loc_vol*s.ncdof*s.ncdof,complex);
+      s.hop=nissa_malloc("hop",s.geom.loc_vol*2*NDIM*s.ncdof*s.ncdof,complex);
+      s.inited=true;
+      s.valid=false;
+    }
+    
+    //free the setup
+    void free_setup(setup_t &s)
+    {
+      if(not s.inited) return;
+      
+      unset_coarse_geom(s.geom);
+      for(int ivec=0;ivec<s.nvec;ivec++) nissa_free(s.nullv[ivec]);
+      nissa_free(s.self);
+      nissa_free(s.hop);
+      s.inited=false;
+    }
+    
+    //orthonormalize the near-null vectors inside each block, separately for the two chiralities
+    void orthonormalize_near_null_vectors(setup_t &s)
+    {
+      GET_THREAD_ID();
+      
+      const coarse_geom_t &geom=s.geom;
+      NISSA_PARALLEL_LOOP(icg,0,geom.loc_vol)
+	for(int chir=0;chir<2;chir++)
+	  for(int ivec=0;ivec<s.nvec;ivec++)
+	    {
+	      //remove the projection on the previous vectors
+	      for(int jvec=0;jvec<ivec;jvec++)
+		{
+		  complex p={0,0};
+		  for(int iblk=0;iblk<geom.block_vol;iblk++)
+		    {
+		      const int ivol=geom.loclx_of_block[icg*geom.block_vol+iblk];
+		      for(int id=chir*NDIRAC/2;id<(chir+1)*NDIRAC/2;id++)
+			for(int ic=0;ic<NCOL;ic++)
+			  complex_summ_the_conj1_prod(p,s.nullv[jvec][ivol][id][ic],s.nullv[ivec][ivol][id][ic]);
+		    }
+		  for(int iblk=0;iblk<geom.block_vol;iblk++)
+		    {
+		      const int ivol=geom.loclx_of_block[icg*geom.block_vol+iblk];
+		      for(int id=chir*NDIRAC/2;id<(chir+1)*NDIRAC/2;id++)
+			for(int ic=0;ic<NCOL;ic++)
+			  complex_subt_the_prod(s.nullv[ivec][ivol][id][ic],s.nullv[jvec][ivol][id][ic],p);
+		    }
+		}
+	      
+	      //normalize
+	      double norm2=0;
+	      for(int iblk=0;iblk<geom.block_vol;iblk++)
+		{
+		  const int ivol=geom.loclx_of_block[icg*geom.block_vol+iblk];
+		  for(int id=chir*NDIRAC/2;id<(chir+1)*NDIRAC/2;id++)
+		    for(int ic=0;ic<NCOL;ic++)
+		      norm2+=complex_norm2(s.nullv[ivec][ivol][id][ic]);
+		}
+	      const double inv_norm=1/sqrt(norm2);
+	      for(int iblk=0;iblk<geom.block_vol;iblk++)
+		{
+		  const int ivol=geom.loclx_of_block[icg*geom.block_vol+iblk];
+		  for(int id=chir*NDIRAC/2;id<(chir+1)*NDIRAC/2;id++)
+		    color_prod_double(s.nullv[ivec][ivol][id],s.nullv[ivec][ivol][id],inv_norm);
+		}
+	    }
+      for(int ivec=0;ivec<s.nvec;ivec++) set_borders_invalid(s.nullv[ivec]);
+    }
+    
+    //project a fine vector on the near-null vectors: out=P^+ in
+    void restrict_to_coarse(complex *out,setup_t &s,spincolor *in)
+    {
+      GET_THREAD_ID();
+      
+      const coarse_geom_t &geom=s.geom;
+      NISSA_PARALLEL_LOOP(icg,0,geom.loc_vol)
+	for(int chir=0;chir<2;chir++)
+	  for(int ivec=0;ivec<s.nvec;ivec++)
+	    {
+	      complex &o=out[icg*s.ncdof+chir*s.nvec+ivec];
+	      complex_put_to_zero(o);
+	      for(int iblk=0;iblk<geom.block_vol;iblk++)
+		{
+		  const int ivol=geom.loclx_of_block[icg*geom.block_vol+iblk];
+		  for(int id=chir*NDIRAC/2;id<(chir+1)*NDIRAC/2;id++)
+		    for(int ic=0;ic<NCOL;ic++)
+		      complex_summ_the_conj1_prod(o,s.nullv[ivec][ivol][id][ic],in[ivol][id][ic]);
+		}
+	    }
+      set_borders_invalid(out);
+    }
+    
+    //expand a coarse vector on the near-null vectors: out=P in
+    void prolongate_to_fine(spincolor *out,setup_t &s,complex *in)
+    {
+      GET_THREAD_ID();
+      
+      NISSA_PARALLEL_LOOP(ivol,0,loc_vol)
+	{
+	  const complex *c=in+s.geom.block_of_loclx[ivol]*s.ncdof;
+	  spincolor_put_to_zero(out[ivol]);
+	  for(int chir=0;chir<2;chir++)
+	    for(int ivec=0;ivec<s.nvec;ivec++)
+	      for(int id=chir*NDIRAC/2;id<(chir+1)*NDIRAC/2;id++)
+		color_summ_the_prod_complex(out[ivol][id],s.nullv[ivec][ivol][id],c[chir*s.nvec+ivec]);
+	}
+      set_borders_invalid(out);
+    }
+    
+    //apply the coarse operator: the twisted mass is diagonal, with opposite sign on the two chiralities
+    void apply_coarse_operator(complex *out,setup_t &s,double mu,complex *in)
+    {
+      GET_THREAD_ID();
+      
+      communicate_coarse_borders(in,s);
+      
+      const int nc=s.ncdof;
+      NISSA_PARALLEL_LOOP(icg,0,s.geom.loc_vol)
+	{
+	  complex *o=out+icg*nc;
+	  const complex *in_site=in+icg*nc;
+	  for(int r=0;r<nc;r++)
+	    {
+	      const double g5mu=(r<s.nvec)?mu:-mu;
+	      o[r][RE]=-g5mu*in_site[r][IM];
+	      o[r][IM]=+g5mu*in_site[r][RE];
+	      
+	      //local term
+	      const complex *self=s.self+(icg*nc+r)*nc;
+	      for(int c=0;c<nc;c++) complex_summ_the_prod(o[r],self[c],in_site[c]);
+	      
+	      //hopping terms
+	      for(int dir=0;dir<2*NDIM;dir++)
+		{
+		  const complex *n=in+s.geom.neigh[icg*2*NDIM+dir]*nc;
+		  const complex *hop=s.hop+((icg*2*NDIM+dir)*nc+r)*nc;
+		  for(int c=0;c<nc;c++) complex_summ_the_prod(o[r],hop[c],n[c]);
+		}
+	    }
+	}
+      set_borders_invalid(out);
+    }
+  }
+}
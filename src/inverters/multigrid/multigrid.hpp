@@ -0,0 +1,234 @@
+#ifndef _MULTIGRID_HPP
+#define _MULTIGRID_HPP
+
+#include <algorithm>
+#include <math.h>
+
+#include "base/debug.hpp"
+#include "base/thread_macros.hpp"
+#include "base/vectors.hpp"
+#include "geometry/geometry_lx.hpp"
+#include "linalgs/linalgs.hpp"
+#include "new_types/complex.hpp"
+#include "new_types/su3.hpp"
+#include "routines/ios.hpp"
+
+#ifndef EXTERN_MULTIGRID
+ #define EXTERN_MULTIGRID extern
+ #define INIT_MULTIGRID_TO(var)
+#else
+ #define INIT_MULTIGRID_TO(var) =var
+#endif
+
+//maximal number of near-null vectors and of Krylov vectors before restarting
+#define MG_MAX_NVEC 32
+#define MG_MAX_RESTART 32
+
+namespace nissa
+{
+  namespace mg
+  {
+    //parameters, which can be changed from the input file
+    EXTERN_MULTIGRID int use_multigrid INIT_MULTIGRID_TO(0);
+    EXTERN_MULTIGRID int nvec INIT_MULTIGRID_TO(12);
+    EXTERN_MULTIGRID int nsetup_iters INIT_MULTIGRID_TO(4);
+    EXTERN_MULTIGRID int nsetup_adaptive_iters INIT_MULTIGRID_TO(2);
+    EXTERN_MULTIGRID int nsmooth INIT_MULTIGRID_TO(4);
+    EXTERN_MULTIGRID int restart INIT_MULTIGRID_TO(16);
+    EXTERN_MULTIGRID int coarse_niter_max INIT_MULTIGRID_TO(200);
+    EXTERN_MULTIGRID double coarse_residue INIT_MULTIGRID_TO(1e-2);
+    EXTERN_MULTIGRID double max_mass INIT_MULTIGRID_TO(1e300);
+    EXTERN_MULTIGRID coords block_size;
+    
+    //geometry of the coarse lattice: each block is entirely contained in a rank
+    struct coarse_geom_t
+    {
+      coords block_size;
+      coords loc_size;
+      int block_vol;
+      int loc_vol;
+      int bord_vol;
+      int face_vol[NDIM];
+      int bord_offset[NDIM];
+      
+      int *block_of_loclx;
+      int *loclx_of_block;
+      int *neigh;
+      int *face_site[NDIM][2];
+    };
+    
+    //near-null vectors and coarse operator
+    struct setup_t
+    {
+      bool inited;
+      coarse_geom_t geom;
+      int nvec;
+      int ncdof;
+      spincolor *nullv[MG_MAX_NVEC];
+      complex *self;
+      complex *hop;
+      
+      //parameters used to compute it, the setup must be marked as invalid when the conf changes
+      bool valid;
+      double kappa;
+      
+      //size of coarse vectors
+      int coarse_vect_size() const
+      {return geom.loc_vol*ncdof;}
+      int coarse_vect_size_to_allocate() const
+      {return (geom.loc_vol+geom.bord_vol)*ncdof;}
+    };
+    
+    void set_coarse_geom(coarse_geom_t &geom,coords ext_block_size);
+    void unset_coarse_geom(coarse_geom_t &geom);
+    void communicate_coarse_borders(complex *v,setup_t &s);
+    void alloc_setup(setup_t &s,coords ext_block_size,int ext_nvec);
+    void free_setup(setup_t &s);
+    void orthonormalize_near_null_vectors(setup_t &s);
+    void restrict_to_coarse(complex *out,setup_t &s,spincolor *in);
+    void prolongate_to_fine(spincolor *out,setup_t &s,complex *in);
+    void apply_coarse_operator(complex *out,setup_t &s,double mu,complex *in);
+    
+    //flexible GMRES with right preconditioning, used both as outer solver and on the coarse grid
+    //residue is the target squared residual relative to the source, the number of iterations is returned
+    template <class Fop,class Fprec>
+    int fgmres(complex *x,complex *b,int n,int n_to_allocate,const Fop &op,const Fprec &prec,bool use_prec,
+	       int ext_restart,int niter_max,double residue,bool verbose)
+    {
+      const int m=std::min(ext_restart,MG_MAX_RESTART);
+      if(m<1) crash("restart %d must be at least 1",m);
+      
+      //Krylov space and preconditioned vectors
+      complex *V[MG_MAX_RESTART+1],*Z[MG_MAX_RESTART];
+      for(int i=0;i<=m;i++) V[i]=nissa_malloc("V",n_to_allocate,complex);
+      for(int i=0;i<m;i++) Z[i]=use_prec?nissa_malloc("Z",n_to_allocate,complex):V[i];
+      complex *w=nissa_malloc("w",n_to_allocate,complex);
+      
+      //Hessenberg matrix, Givens rotations and rhs of the least square problem
+      complex H[MG_MAX_RESTART+1][MG_MAX_RESTART];
+      double c[MG_MAX_RESTART];
+      complex s[MG_MAX_RESTART],g[MG_MAX_RESTART+1];
+      
+      const double source_norm2=double_vector_glb_norm2(b,n);
+      const double target_norm2=residue*source_norm2;
+      
+      //compute the starting residual
+      op(w,x);
+      double_vector_subt((double*)V[0],(double*)b,(double*)w,2*n);
+      double rnorm2=double_vector_glb_norm2(V[0],n);
+      
+      int iter=0;
+      bool converged=(rnorm2<=target_norm2);
+      while(not converged and iter<niter_max)
+	{
+	  //normalize the first vector
+	  const double beta=sqrt(rnorm2);
+	  double_vector_prod_double((double*)V[0],(double*)V[0],1/beta,2*n);
+	  complex_put_to_zero(g[0]);
+	  g[0][RE]=beta;
+	  
+	  int j=0;
+	  bool exit_cycle=false;
+	  do
+	    {
+	      //extend the space
+	      if(use_prec) prec(Z[j],V[j]);
+	      op(w,Z[j]);
+	      
+	      //orthogonalize with modified Gram-Schmidt
+	      for(int i=0;i<=j;i++)
+		{
+		  complex_vector_glb_scalar_prod(H[i][j],V[i],w,n);
+		  complex_vector_subtassign_complex_vector_prod_complex(w,V[i],H[i][j],n);
+		}
+	      const double hnorm=sqrt(double_vector_glb_norm2(w,n));
+	      complex_put_to_zero(H[j+1][j]);
+	      H[j+1][j][RE]=hnorm;
+	      if(hnorm>0) double_vector_prod_double((double*)V[j+1],(double*)w,1/hnorm,2*n);
+	      
+	      //apply previous rotations to the new column
+	      for(int i=0;i<j;i++)
+		{
+		  complex t,u;
+		  unsafe_complex_prod(t,s[i],H[i+1][j]);
+		  complex_summ_the_prod_double(t,H[i][j],c[i]);
+		  unsafe_complex_conj1_prod(u,s[i],H[i][j]);
+		  complex_prod_double(H[i+1][j],H[i+1][j],c[i]);
+		  complex_subtassign(H[i+1][j],u);
+		  complex_copy(H[i][j],t);
+		}
+	      
+	      //compute the new rotation, annihilating H[j+1][j]
+	      const double a=sqrt(complex_norm2(H[j][j]));
+	      const double bb=H[j+1][j][RE];
+	      const double nu=sqrt(a*a+bb*bb);
+	      if(a==0)
+		{
+		  c[j]=0;
+		  complex_put_to_zero(s[j]);
+		  s[j][RE]=1;
+		}
+	      else
+		{
+		  c[j]=a/nu;
+		  complex_prod_double(s[j],H[j][j],bb/(a*nu));
+		}
+	      complex_prod_double(H[j][j],H[j][j],nu/(a==0?1:a));
+	      if(a==0) H[j][j][RE]=nu;
+	      complex_put_to_zero(H[j+1][j]);
+	      
+	      //update the rhs
+	      unsafe_complex_conj1_prod(g[j+1],s[j],g[j]);
+	      complex_prodassign_double(g[j+1],-1);
+	      complex_prodassign_double(g[j],c[j]);
+	      
+	      rnorm2=complex_norm2(g[j+1]);
+	      iter++;
+	      j++;
+	      
+	      if(verbose) verbosity_lv3_master_printf("fgmres iter %d relative residue: %lg\n",iter,rnorm2/source_norm2);
+	      exit_cycle=(rnorm2<=target_norm2 or j==m or iter>=niter_max or hnorm==0);
+	    }
+	  while(not exit_cycle);
+	  
+	  //solve the triangular system and update the solution
+	  complex y[MG_MAX_RESTART];
+	  for(int i=j-1;i>=0;i--)
+	    {
+	      complex_copy(y[i],g[i]);
+	      for(int k=i+1;k<j;k++) complex_subt_the_prod(y[i],H[i][k],y[k]);
+	      complex t;
+	      complex_reciprocal(t,H[i][i]);
+	      safe_complex_prod(y[i],y[i],t);
+	    }
+	  for(int i=0;i<j;i++) complex_vector_summassign_complex_vector_prod_complex(x,Z[i],y[i],n);
+	  
+	  //compute the true residual
+	  op(w,x);
+	  double_vector_subt((double*)V[0],(double*)b,(double*)w,2*n);
+	  rnorm2=double_vector_glb_norm2(V[0],n);
+	  if(verbose) verbosity_lv2_master_printf("fgmres iter %d true relative residue: %lg\n",iter,rnorm2/source_norm2);
+	  
+	  converged=(rnorm2<=target_norm2);
+	}
+      
+      if(verbose)
+	{
+	  verbosity_lv1_master_printf("\n");
+	  verbosity_lv1_master_printf(" Total fgmres iterations: %d\n",iter);
+	  verbosity_lv1_master_printf(" Final relative residue: %lg\n",rnorm2/source_norm2);
+	}
+      
+      for(int i=0;i<=m;i++) nissa_free(V[i]);
+      if(use_prec) for(int i=0;i<m;i++) nissa_free(Z[i]);
+      nissa_free(w);
+      
+      return iter;
+    }
+  }
+}
+
+#undef EXTERN_MULTIGRID
+#undef INIT_MULTIGRID_TO
+
+#endif
@@ -0,0 +1,61 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include "base/random.hpp"
+#include "base/vectors.hpp"
+#include "dirac_operators/stD/dirac_operator_stD.hpp"
+#include "geometry/geometry_eo.hpp"
+#include "linalgs/linalgs.hpp"
+
+#include "cg_deflated_invert_stD2ee_m2.hpp"
+#include "cg_invert_stD2ee_m2.hpp"
+
+namespace nissa
+{
+  //compute the low modes of the even-projected D2, to be done once per configuration
+  void find_deflation_subspace_stD2ee_m2(deflation_subspace_t &def,int neig,quad_su3 **conf,double m2,double residue)
+  {
+    color *temp=nissa_malloc("temp",loc_volh+bord_volh,color);
+    
+    const auto imp_mat=[conf,m2,temp](complex *out_e,complex *in_e)
+      {
+	apply_stD2ee_m2((color*)out_e,conf,temp,m2,(color*)in_e);
+      };
+    
+    const auto filler=[](complex *out_e)
+      {
+	generate_fully_undiluted_eo_source((color*)out_e,RND_GAUSS,-1,EVN);
+      };
+    
+    const int vect_size=loc_volh*NCOL;
+    const int vect_size_to_allocate=(loc_volh+bord_volh)*NCOL;
+    find_deflation_subspace(def,neig,vect_size,vect_size_to_allocate,m2,imp_mat,filler,residue);
+    
+    nissa_free(temp);
+  }
+  
+  //solve starting from the guess obtained projecting the source on the low modes
+  void inv_stD2ee_m2_cg_deflated(color *sol,deflation_subspace_t &def,quad_su3 **conf,double m2,int niter,double residue,color *source)
+  {
+    if(def.vect_size!=loc_volh*NCOL) crash("deflation subspace of size %d not matching",def.vect_size);
+    
+    color *guess=nissa_malloc("guess",loc_volh+bord_volh,color);
+    def.get_guess((complex*)guess,m2,(complex*)source);
+    inv_stD2ee_m2_cg(sol,guess,conf,m2,niter,residue,source);
+    
+    nissa_free(guess);
+  }
+  
+  //invert the full D as in inv_stD_cg, using the deflated solver for the even part
+  void inv_stD_cg_deflated(color **sol,deflation_subspace_t &def,quad_su3 **conf,double m,int niter,double residue,color **source)
+  {
+    color *temp=nissa_malloc("temp",loc_volh+bord_volh,color);
+    evn_apply_stD_dag(temp,conf,m,source);
+    inv_stD2ee_m2_cg_deflated(sol[EVN],def,conf,m*m,niter,residue,temp);
+    nissa_free(temp);
+    
+    apply_st2Doe(sol[ODD],conf,sol[EVN]);
+    double_vector_linear_comb((double*)(sol[ODD]),(double*)(source[ODD]),1/m,(double*)(sol[ODD]),-0.5/m,loc_volh*6);
+  }
+}
@@ -0,0 +1,14 @@
+#ifndef _CG_DEFLATED_INVERT_STD2EE_M2_HPP
+#define _CG_DEFLATED_INVERT_STD2EE_M2_HPP
+
+#include "eigenvalues/eigenvalues_deflation.hpp"
+#include "new_types/su3.hpp"
+
+namespace nissa
+{
+  void find_deflation_subspace_stD2ee_m2(deflation_subspace_t &def,int neig,quad_su3 **conf,double m2,double residue);
+  void inv_stD2ee_m2_cg_deflated(color *sol,deflation_subspace_t &def,quad_su3 **conf,double m2,int niter,double residue,color *source);
+  void inv_stD_cg_deflated(color **sol,deflation_subspace_t &def,quad_su3 **conf,double m,int niter,double residue,color **source);
+}
+
+#endif
@@ -84,6 +84,9 @@ namespace nissa
     //main loop
     int iter=0;
     double alpha=1,omega=1,lambda,rho=1;
+    
+    //(rhat0,r) for the first iteration
+    double rho_next=delta;
     do
       {
 	//this is already iter 1
@@ -91,8 +94,8 @@ namespace nissa
 	
 	double rho_old=rho,omega_old=omega;
 	  
-	//compute (rhat0,r) and beta
-	double_vector_glb_scalar_prod(&rho,(double*)rhat0,(double*)r,BULK_VOL*NDOUBLES_PER_SITE);
+	//take (rhat0,r) and compute beta
+	rho=rho_next;
 	double beta=(rho/rho_old)*(alpha/omega_old);
 	
 	//compute p=r+beta*(p-omega_old*nu)
@@ -126,11 +129,11 @@ namespace nissa
 	double_vector_summ_double_vector_prod_double((double*)sol,(double*)sol,(double*)p,alpha,BULK_VOL*NDOUBLES_PER_SITE);
 	double_vector_summ_double_vector_prod_double((double*)sol,(double*)sol,(double*)s,omega,BULK_VOL*NDOUBLES_PER_SITE);
 	
-	//r=s-t*omega	
-	double_vector_summ_double_vector_prod_double((double*)r,(double*)s,(double*)t,-omega,BULK_VOL*NDOUBLES_PER_SITE);
-	
-	//lambda=(r,r)
-	double_vector_glb_scalar_prod(&lambda,(double*)r,(double*)r,BULK_VOL*NDOUBLES_PER_SITE);
+	//r=s-t*omega, lambda=(r,r) and (rhat0,r) for next iteration
+	double prods[2];
+	double_vector_summ_double_vector_prod_double_glb_scalar_prods(prods,(double*)r,(double*)s,(double*)t,-omega,(double*)rhat0,BULK_VOL*NDOUBLES_PER_SITE);
+	lambda=prods[0];
+	rho_next=prods[1];
 	
 	if(iter%each==0) verbosity_lv2_master_printf("iter %d relative residue: %lg\n",iter,lambda/source_norm);
       }
@@ -60,10 +60,9 @@ namespace nissa
     //calculate p0=r0=DD*sol_0 and delta_0=(p0,p0), performing global reduction and broadcast to all nodes
     APPLY_OPERATOR(s,CG_OPERATOR_PARAMETERS sol);
     
-    double_vector_subt((double*)r,(double*)source,(double*)s,BULK_VOL*NDOUBLES_PER_SITE);
-    double_vector_copy((double*)p,(double*)r,BULK_VOL*NDOUBLES_PER_SITE);
     double delta;
-    double_vector_glb_scalar_prod(&delta,(double*)r,(double*)r,BULK_VOL*NDOUBLES_PER_SITE);
+    double_vector_summ_double_vector_prod_double_glb_norm2(&delta,(double*)r,(double*)source,(double*)s,-1,BULK_VOL*NDOUBLES_PER_SITE);
+    double_vector_copy((double*)p,(double*)r,BULK_VOL*NDOUBLES_PER_SITE);
     
     verbosity_lv2_master_printf("Source norm: %lg\n",source_norm);
     if(source_norm==0 || std::isnan(source_norm)) crash("invalid norm: %lg",source_norm);
@@ -88,11 +87,9 @@ namespace nissa
 	omega=delta/alpha;
 	
 	//sol_(k+1)=x_k+omega*p_k
-	double_vector_summ_double_vector_prod_double((double*)sol,(double*)sol,(double*)p,omega,BULK_VOL*NDOUBLES_PER_SITE);
 	//r_(k+1)=x_k-omega*p_k
-	double_vector_summ_double_vector_prod_double((double*)r,(double*)r,(double*)s,-omega,BULK_VOL*NDOUBLES_PER_SITE);
 	//(r_(k+1),r_(k+1))
-	double_vector_glb_scalar_prod(&lambda,(double*)r,(double*)r,BULK_VOL*NDOUBLES_PER_SITE);
+	double_vector_cg_update_glb_norm2(&lambda,(double*)sol,(double*)r,(double*)p,(double*)s,omega,BULK_VOL*NDOUBLES_PER_SITE);
 	
 	//(r_(k+1),r_(k+1))/(r_k,r_k)
 	gammag=lambda/delta;
@@ -110,8 +107,7 @@ namespace nissa
     
     //last calculation of residual
     APPLY_OPERATOR(s,CG_OPERATOR_PARAMETERS sol);
-    double_vector_subt((double*)r,(double*)source,(double*)s,BULK_VOL*NDOUBLES_PER_SITE);
-    double_vector_glb_scalar_prod(&lambda,(double*)r,(double*)r,BULK_VOL*NDOUBLES_PER_SITE);
+    double_vector_summ_double_vector_prod_double_glb_norm2(&lambda,(double*)r,(double*)source,(double*)s,-1,BULK_VOL*NDOUBLES_PER_SITE);
     
     verbosity_lv2_master_printf("final relative residue (after %d iters): %lg where %lg was required\n",
 				final_iter,lambda/source_norm,residue);
@@ -0,0 +1,200 @@
+// Template to invert using c.g. in mixed single/double precision.
+// The iteration is carried out in single precision, while the solution
+// is accumulated in double precision. When the iterated residue has
+// decreased by a factor CG_MIXED_RELIABLE_DELTA with respect to the
+// last true one, a reliable update is performed: the partial solution
+// is added to the double precision one and the residue is recomputed
+// in double precision.
+// macro to be defined:
+//  -APPLY_OPERATOR, APPLY_OPERATOR_32
+//  -CG_OPERATOR_PARAMETERS, CG_OPERATOR_32_PARAMETERS
+//  -CG_MIXED_INVERT
+//  -BULK_VOL, BORD_VOL
+//  -BASETYPE, BASETYPE_32
+//  -NDOUBLES_PER_SITE
+
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include "base/bench.hpp"
+#include "base/thread_macros.hpp"
+#include "linalgs/linalgs.hpp"
+#include "routines/ios.hpp"
+#ifdef USE_THREADS
+ #include "routines/thread.hpp"
+#endif
+
+#if CG_NARG >= 6
+ #error not supported
+#endif
+
+#ifndef CG_MIXED_RELIABLE_DELTA
+ #define CG_MIXED_RELIABLE_DELTA 0.1
+#endif
+
+namespace nissa
+{
+#if CG_NARG == 0
+  THREADABLE_FUNCTION_5ARG(CG_MIXED_INVERT, BASETYPE*,sol, BASETYPE*,guess, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 1
+  THREADABLE_FUNCTION_6ARG(CG_MIXED_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 2
+  THREADABLE_FUNCTION_7ARG(CG_MIXED_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, AT2,A2, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 3
+  THREADABLE_FUNCTION_8ARG(CG_MIXED_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, AT2,A2, AT3,A3, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 4
+  THREADABLE_FUNCTION_9ARG(CG_MIXED_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, AT2,A2, AT3,A3, AT4,A4, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 5
+  THREADABLE_FUNCTION_10ARG(CG_MIXED_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, AT2,A2, AT3,A3, AT4,A4, AT5,A5, int,niter, double,residue, BASETYPE*,source)
+#endif
+  {
+    GET_THREAD_ID();
+    
+    verbosity_lv2_master_printf("\n");
+    
+    const int n=BULK_VOL*NDOUBLES_PER_SITE;
+    
+    //double precision residue and temporary
+    BASETYPE *s=nissa_malloc("s",BULK_VOL+BORD_VOL,BASETYPE);
+    BASETYPE *r=nissa_malloc("r",BULK_VOL,BASETYPE);
+    
+    //single precision vectors
+    BASETYPE_32 *x_32=nissa_malloc("x_32",BULK_VOL,BASETYPE_32);
+    BASETYPE_32 *s_32=nissa_malloc("s_32",BULK_VOL,BASETYPE_32);
+    BASETYPE_32 *p_32=nissa_malloc("p_32",BULK_VOL+BORD_VOL,BASETYPE_32);
+    BASETYPE_32 *r_32=nissa_malloc("r_32",BULK_VOL,BASETYPE_32);
+    
+    //macro to be defined externally, allocating all the required additional vectors
+    CG_ADDITIONAL_VECTORS_ALLOCATION();
+    if(guess==NULL) vector_reset(sol);
+    else vector_copy(sol,guess);
+    
+    START_TIMING(cg_inv_over_time,ncg_inv);
+    int each=VERBOSITY_LV3?1:10;
+    
+    double source_norm;
+    double_vector_glb_scalar_prod(&source_norm,(double*)source,(double*)source,n);
+    
+    //calculate r0=source-DD*sol_0 in double, and p0=r0 in single
+    APPLY_OPERATOR(s,CG_OPERATOR_PARAMETERS sol);
+    double_vector_subt((double*)r,(double*)source,(double*)s,n);
+    double delta;
+    double_vector_glb_scalar_prod(&delta,(double*)r,(double*)r,n);
+    double_vector_to_single((float*)r_32,(double*)r,n);
+    single_vector_copy((float*)p_32,(float*)r_32,n);
+    single_vector_init_to_zero((float*)x_32,n);
+    
+    verbosity_lv2_master_printf("Source norm: %lg\n",source_norm);
+    if(source_norm==0 || std::isnan(source_norm)) crash("invalid norm: %lg",source_norm);
+    verbosity_lv2_master_printf("iter 0 relative residue: %lg\n",delta/source_norm);
+    
+    //largest residue since last reliable update
+    const double reliable_delta2=CG_MIXED_RELIABLE_DELTA*CG_MIXED_RELIABLE_DELTA;
+    double max_res=delta;
+    int nreliable=0;
+    
+    int final_iter;
+    
+    //main loop
+    int iter=0;
+    double alpha,omega,gammag,lambda;
+    do
+      {
+	//this is already iter 1
+	final_iter=(++iter);
+	
+	//(r_k,r_k)/(p_k*DD*p_k)
+	STOP_TIMING(cg_inv_over_time);
+	APPLY_OPERATOR_32(s_32,CG_OPERATOR_32_PARAMETERS p_32);
+	if(IS_MASTER_THREAD) cg_inv_over_time-=take_time();
+	
+	double_accumulate_single_vector_glb_scalar_prod(&alpha,(float*)s_32,(float*)p_32,n);
+	omega=delta/alpha;
+	
+	//x_(k+1)=x_k+omega*p_k
+	single_vector_summ_single_vector_prod_single((float*)x_32,(float*)x_32,(float*)p_32,omega,n);
+	//r_(k+1)=r_k-omega*s_k
+	single_vector_summ_single_vector_prod_single((float*)r_32,(float*)r_32,(float*)s_32,-omega,n);
+	//(r_(k+1),r_(k+1))
+	double_accumulate_single_vector_glb_scalar_prod(&lambda,(float*)r_32,(float*)r_32,n);
+	if(lambda>max_res) max_res=lambda;
+	
+	//reliable update when the residue dropped enough, or when convergence is claimed
+	if(lambda<reliable_delta2*max_res || lambda<residue*source_norm)
+	  {
+	    double_vector_summassign_single_vector((double*)sol,(float*)x_32,n);
+	    single_vector_init_to_zero((float*)x_32,n);
+	    
+	    STOP_TIMING(cg_inv_over_time);
+	    APPLY_OPERATOR(s,CG_OPERATOR_PARAMETERS sol);
+	    if(IS_MASTER_THREAD) cg_inv_over_time-=take_time();
+	    
+	    double_vector_subt((double*)r,(double*)source,(double*)s,n);
+	    double_vector_glb_scalar_prod(&lambda,(double*)r,(double*)r,n);
+	    double_vector_to_single((float*)r_32,(double*)r,n);
+	    
+	    verbosity_lv3_master_printf("reliable update at iter %d, true relative residue: %lg\n",iter,lambda/source_norm);
+	    max_res=lambda;
+	    nreliable++;
+	  }
+	
+	//(r_(k+1),r_(k+1))/(r_k,r_k)
+	gammag=lambda/delta;
+	delta=lambda;
+	
+	//checks
+	if(std::isnan(gammag)) crash("nanned");
+	
+	//p_(k+1)=r_(k+1)+gammag*p_k
+	single_vector_summ_single_vector_prod_single((float*)p_32,(float*)r_32,(float*)p_32,gammag,n);
+	
+	if(iter%each==0) verbosity_lv2_master_printf("iter %d relative residue: %lg\n",iter,lambda/source_norm);
+      }
+    while(lambda>=(residue*source_norm) && iter<niter);
+    
+    //last calculation of residual, in double precision
+    APPLY_OPERATOR(s,CG_OPERATOR_PARAMETERS sol);
+    double_vector_subt((double*)r,(double*)source,(double*)s,n);
+    double_vector_glb_scalar_prod(&lambda,(double*)r,(double*)r,n);
+    
+    verbosity_lv2_master_printf("final relative residue (after %d iters, %d reliable updates): %lg where %lg was required\n",
+				final_iter,nreliable,lambda/source_norm,residue);
+    if(lambda/source_norm>=2*residue)
+      master_printf("WARNING: true residue %lg much larger than required and expected one %lg\n",
+		    lambda/source_norm,residue);
+    
+    verbosity_lv1_master_printf(" Total mixed precision cg iterations: %d\n",final_iter);
+    
+    //check if not converged
+    if(final_iter==niter) crash("exit without converging");
+    
+    if(IS_MASTER_THREAD) cg_inv_over_time+=take_time();
+    
+    nissa_free(s);
+    nissa_free(r);
+    nissa_free(x_32);
+    nissa_free(s_32);
+    nissa_free(p_32);
+    nissa_free(r_32);
+    
+    //macro to be defined externally
+    CG_ADDITIONAL_VECTORS_FREE();
+  }
+  THREADABLE_FUNCTION_END
+}
+
+#undef BASETYPE
+#undef BASETYPE_32
+#undef NDOUBLES_PER_SITE
+#undef BULK_VOL
+#undef BORD_VOL
+
+#undef APPLY_OPERATOR
+#undef APPLY_OPERATOR_32
+#undef CG_OPERATOR_PARAMETERS
+#undef CG_OPERATOR_32_PARAMETERS
+#undef CG_MIXED_INVERT
+#undef CG_ADDITIONAL_VECTORS_FREE
+#undef CG_ADDITIONAL_VECTORS_ALLOCATION
+#undef CG_NARG
@@ -0,0 +1,234 @@
+// Template to invert nrhs systems with the same operator using c.g.
+// The rhs are stored interleaved site by site, v[ivol*nrhs+irhs], so that
+// the operator can reuse the gauge links for all of them. The nrhs c.g.
+// proceed in lockstep and all the scalar products of an iteration are
+// reduced together, with a single global reduction per product. A rhs
+// which has converged is copied into the solution and removed from the
+// working vectors, so that the operator and the linear algebra are
+// applied only to the rhs still being inverted.
+// macro to be defined:
+//  -APPLY_OPERATOR, taking nrhs before the input vector
+//  -CG_OPERATOR_PARAMETERS
+//  -CG_MULTI_RHS_INVERT
+//  -BULK_VOL, BORD_VOL
+//  -BASETYPE
+//  -NDOUBLES_PER_SITE
+
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include "base/bench.hpp"
+#include "base/debug.hpp"
+#include "base/thread_macros.hpp"
+#include "communicate/communicate.hpp"
+#include "linalgs/linalgs.hpp"
+#include "routines/ios.hpp"
+#ifdef USE_THREADS
+ #include "routines/thread.hpp"
+#endif
+
+#if CG_NARG >= 6
+ #error not supported
+#endif
+
+namespace nissa
+{
+#if CG_NARG == 0
+  THREADABLE_FUNCTION_6ARG(CG_MULTI_RHS_INVERT, BASETYPE*,sol, BASETYPE*,guess, int,nrhs, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 1
+  THREADABLE_FUNCTION_7ARG(CG_MULTI_RHS_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, int,nrhs, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 2
+  THREADABLE_FUNCTION_8ARG(CG_MULTI_RHS_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, AT2,A2, int,nrhs, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 3
+  THREADABLE_FUNCTION_9ARG(CG_MULTI_RHS_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, AT2,A2, AT3,A3, int,nrhs, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 4
+  THREADABLE_FUNCTION_10ARG(CG_MULTI_RHS_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, AT2,A2, AT3,A3, AT4,A4, int,nrhs, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 5
+  THREADABLE_FUNCTION_11ARG(CG_MULTI_RHS_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, AT2,A2, AT3,A3, AT4,A4, AT5,A5, int,nrhs, int,niter, double,residue, BASETYPE*,source)
+#endif
+  {
+    GET_THREAD_ID();
+    
+    if(nrhs<1 || nrhs>NISSA_MAX_NRHS) crash("nrhs %d not in the range [1,%d]",nrhs,NISSA_MAX_NRHS);
+    
+    verbosity_lv2_master_printf("\n");
+    
+    const int n=BULK_VOL*nrhs*NDOUBLES_PER_SITE;
+    
+    BASETYPE *s=nissa_malloc("s",(BULK_VOL+BORD_VOL)*nrhs,BASETYPE);
+    BASETYPE *p=nissa_malloc("p",(BULK_VOL+BORD_VOL)*nrhs,BASETYPE);
+    BASETYPE *r=nissa_malloc("r",BULK_VOL*nrhs,BASETYPE);
+    BASETYPE *x=nissa_malloc("x",BULK_VOL*nrhs,BASETYPE);
+    
+    //macro to be defined externally, allocating all the required additional vectors
+    CG_ADDITIONAL_VECTORS_ALLOCATION();
+    if(guess==NULL) vector_reset(sol);
+    else vector_copy(sol,guess);
+    
+    START_TIMING(cg_inv_over_time,ncg_inv);
+    int each=VERBOSITY_LV3?1:10;
+    
+    //coefficients of the rhs still being inverted, ordered as in the working vectors
+    double source_norm[NISSA_MAX_NRHS],delta[NISSA_MAX_NRHS],alpha[NISSA_MAX_NRHS];
+    double omega[NISSA_MAX_NRHS],gammag[NISSA_MAX_NRHS],lambda[NISSA_MAX_NRHS];
+    int final_iter[NISSA_MAX_NRHS];
+    
+    //list of rhs still being inverted and position of the kept ones when compacting
+    int nactive=0,active[NISSA_MAX_NRHS];
+    int nkept,kept_pos[NISSA_MAX_NRHS],new_pos[NISSA_MAX_NRHS];
+    int nconv,conv_pos[NISSA_MAX_NRHS],conv_rhs[NISSA_MAX_NRHS];
+    
+    double_vector_glb_scalar_prod_interleaved(source_norm,(double*)source,(double*)source,BULK_VOL,nrhs,NDOUBLES_PER_SITE);
+    
+    //calculate p0=r0=DD*sol_0 and delta_0=(p0,p0), performing r=source-s
+    APPLY_OPERATOR(s,CG_OPERATOR_PARAMETERS nrhs,sol);
+    double_vector_subt((double*)r,(double*)source,(double*)s,n);
+    double_vector_glb_scalar_prod_interleaved(delta,(double*)r,(double*)r,BULK_VOL,nrhs,NDOUBLES_PER_SITE);
+    
+    for(int irhs=0;irhs<nrhs;irhs++)
+      {
+	verbosity_lv2_master_printf("Source %d norm: %lg\n",irhs,source_norm[irhs]);
+	if(source_norm[irhs]==0 || std::isnan(source_norm[irhs])) crash("invalid norm of source %d: %lg",irhs,source_norm[irhs]);
+	verbosity_lv2_master_printf("iter 0 relative residue of source %d: %lg\n",irhs,delta[irhs]/source_norm[irhs]);
+	
+	final_iter[irhs]=0;
+	if(delta[irhs]>=residue*source_norm[irhs])
+	  {
+	    final_iter[irhs]=-1;
+	    delta[nactive]=delta[irhs];
+	    active[nactive++]=irhs;
+	  }
+      }
+    
+    //take only the rhs to be inverted into the working vectors
+    for(int iact=0;iact<nactive;iact++) new_pos[iact]=iact;
+    double_vector_copy_interleaved((double*)x,nactive,new_pos,(double*)sol,nrhs,active,nactive,BULK_VOL,NDOUBLES_PER_SITE);
+    double_vector_copy((double*)s,(double*)r,n);
+    double_vector_copy_interleaved((double*)r,nactive,new_pos,(double*)s,nrhs,active,nactive,BULK_VOL,NDOUBLES_PER_SITE);
+    double_vector_copy((double*)p,(double*)r,BULK_VOL*nactive*NDOUBLES_PER_SITE);
+    
+    //main loop
+    int iter=0;
+    while(nactive>0 && iter<niter)
+      {
+	//this is already iter 1
+	iter++;
+	
+	const int nact=BULK_VOL*nactive*NDOUBLES_PER_SITE;
+	
+	//(r_k,r_k)/(p_k*DD*p_k)
+	STOP_TIMING(cg_inv_over_time);
+	APPLY_OPERATOR(s,CG_OPERATOR_PARAMETERS nactive,p);
+	if(IS_MASTER_THREAD) cg_inv_over_time-=take_time();
+	
+	double_vector_glb_scalar_prod_interleaved(alpha,(double*)s,(double*)p,BULK_VOL,nactive,NDOUBLES_PER_SITE);
+	for(int iact=0;iact<nactive;iact++) omega[iact]=delta[iact]/alpha[iact];
+	
+	//x_(k+1)=x_k+omega*p_k
+	double_vector_summ_double_vector_prod_double_interleaved((double*)x,(double*)x,(double*)p,omega,BULK_VOL,nactive,NDOUBLES_PER_SITE);
+	//r_(k+1)=r_k-omega*s_k
+	for(int iact=0;iact<nactive;iact++) omega[iact]=-omega[iact];
+	double_vector_summ_double_vector_prod_double_interleaved((double*)r,(double*)r,(double*)s,omega,BULK_VOL,nactive,NDOUBLES_PER_SITE);
+	//(r_(k+1),r_(k+1))
+	double_vector_glb_scalar_prod_interleaved(lambda,(double*)r,(double*)r,BULK_VOL,nactive,NDOUBLES_PER_SITE);
+	
+	nkept=nconv=0;
+	for(int iact=0;iact<nactive;iact++)
+	  {
+	    int irhs=active[iact];
+	    
+	    //(r_(k+1),r_(k+1))/(r_k,r_k)
+	    gammag[iact]=lambda[iact]/delta[iact];
+	    delta[iact]=lambda[iact];
+	    
+	    //checks
+	    if(std::isnan(gammag[iact])) crash("nanned on source %d",irhs);
+	    if(iter%each==0) verbosity_lv2_master_printf("iter %d relative residue of source %d: %lg\n",iter,irhs,lambda[iact]/source_norm[irhs]);
+	    
+	    //mark the converged rhs
+	    if(lambda[iact]<residue*source_norm[irhs])
+	      {
+		verbosity_lv2_master_printf("source %d converged at iter %d\n",irhs,iter);
+		final_iter[irhs]=iter;
+		conv_pos[nconv]=iact;
+		conv_rhs[nconv++]=irhs;
+	      }
+	    else kept_pos[nkept++]=iact;
+	  }
+	
+	//p_(k+1)=r_(k+1)+gammag*p_k
+	double_vector_summ_double_vector_prod_double_interleaved((double*)p,(double*)r,(double*)p,gammag,BULK_VOL,nactive,NDOUBLES_PER_SITE);
+	
+	//store the solution of the converged rhs and remove them from the working vectors, using s as buffer
+	if(nconv)
+	  {
+	    double_vector_copy_interleaved((double*)sol,nrhs,conv_rhs,(double*)x,nactive,conv_pos,nconv,BULK_VOL,NDOUBLES_PER_SITE);
+	    
+	    for(int ikept=0;ikept<nkept;ikept++) new_pos[ikept]=ikept;
+	    BASETYPE *work[3]={x,r,p};
+	    for(int iwork=0;iwork<3;iwork++)
+	      {
+		double_vector_copy((double*)s,(double*)(work[iwork]),nact);
+		double_vector_copy_interleaved((double*)(work[iwork]),nkept,new_pos,(double*)s,nactive,kept_pos,nkept,BULK_VOL,NDOUBLES_PER_SITE);
+	      }
+	    
+	    for(int ikept=0;ikept<nkept;ikept++)
+	      {
+		active[ikept]=active[kept_pos[ikept]];
+		delta[ikept]=delta[kept_pos[ikept]];
+	      }
+	    nactive=nkept;
+	  }
+      }
+    
+    //store the solution of the rhs which did not converge
+    if(nactive)
+      {
+	for(int iact=0;iact<nactive;iact++) new_pos[iact]=iact;
+	double_vector_copy_interleaved((double*)sol,nrhs,active,(double*)x,nactive,new_pos,nactive,BULK_VOL,NDOUBLES_PER_SITE);
+      }
+    
+    //last calculation of residual
+    APPLY_OPERATOR(s,CG_OPERATOR_PARAMETERS nrhs,sol);
+    double_vector_subt((double*)r,(double*)source,(double*)s,n);
+    double_vector_glb_scalar_prod_interleaved(lambda,(double*)r,(double*)r,BULK_VOL,nrhs,NDOUBLES_PER_SITE);
+    
+    for(int irhs=0;irhs<nrhs;irhs++)
+      {
+	verbosity_lv2_master_printf("final relative residue of source %d (after %d iters): %lg where %lg was required\n",
+				    irhs,final_iter[irhs],lambda[irhs]/source_norm[irhs],residue);
+	if(lambda[irhs]/source_norm[irhs]>=2*residue)
+	  master_printf("WARNING: true residue of source %d, %lg, much larger than required and expected one %lg\n",
+			irhs,lambda[irhs]/source_norm[irhs],residue);
+      }
+    
+    verbosity_lv1_master_printf(" Total multi rhs cg iterations: %d for %d sources\n",iter,nrhs);
+    
+    //check if not converged
+    if(nactive) crash("exit without converging %d sources",nactive);
+    
+    if(IS_MASTER_THREAD) cg_inv_over_time+=take_time();
+    
+    nissa_free(s);
+    nissa_free(p);
+    nissa_free(r);
+    nissa_free(x);
+    
+    //macro to be defined externally
+    CG_ADDITIONAL_VECTORS_FREE();
+  }
+  THREADABLE_FUNCTION_END
+}
+
+#undef BASETYPE
+#undef NDOUBLES_PER_SITE
+#undef BULK_VOL
+#undef BORD_VOL
+
+#undef APPLY_OPERATOR
+#undef CG_OPERATOR_PARAMETERS
+#undef CG_MULTI_RHS_INVERT
+#undef CG_ADDITIONAL_VECTORS_FREE
+#undef CG_ADDITIONAL_VECTORS_ALLOCATION
+#undef CG_NARG
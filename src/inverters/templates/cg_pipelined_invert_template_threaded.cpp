@@ -0,0 +1,205 @@
+// Template to invert using pipelined c.g. (Ghysels-Vanroose)
+// The two scalar products of each iteration are computed in a single
+// pass and reduced with a single non-blocking reduction, which is
+// overlapped with the application of the operator. Every
+// pipelined_cg_replace_each iterations the recursive residue and the
+// auxiliary vectors are replaced with the true ones, keeping the search
+// direction. When the recursive residue claims convergence the true one
+// is computed, and the iteration is restarted from it if it is not yet
+// small enough.
+// macro to be defined:
+//  -APPLY_OPERATOR
+//  -CG_OPERATOR_PARAMETERS
+//  -CG_PIPELINED_INVERT
+//  -BULK_VOL, BORD_VOL
+//  -BASETYPE
+//  -NDOUBLES_PER_SITE
+
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include <mpi.h>
+
+#include "base/bench.hpp"
+#include "base/thread_macros.hpp"
+#include "linalgs/linalgs.hpp"
+#include "routines/ios.hpp"
+#ifdef USE_THREADS
+ #include "routines/thread.hpp"
+#endif
+
+#if CG_NARG >= 6
+ #error not supported
+#endif
+
+namespace nissa
+{
+#if CG_NARG == 0
+  THREADABLE_FUNCTION_5ARG(CG_PIPELINED_INVERT, BASETYPE*,sol, BASETYPE*,guess, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 1
+  THREADABLE_FUNCTION_6ARG(CG_PIPELINED_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 2
+  THREADABLE_FUNCTION_7ARG(CG_PIPELINED_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, AT2,A2, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 3
+  THREADABLE_FUNCTION_8ARG(CG_PIPELINED_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, AT2,A2, AT3,A3, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 4
+  THREADABLE_FUNCTION_9ARG(CG_PIPELINED_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, AT2,A2, AT3,A3, AT4,A4, int,niter, double,residue, BASETYPE*,source)
+#elif CG_NARG == 5
+  THREADABLE_FUNCTION_10ARG(CG_PIPELINED_INVERT, BASETYPE*,sol, BASETYPE*,guess, AT1,A1, AT2,A2, AT3,A3, AT4,A4, AT5,A5, int,niter, double,residue, BASETYPE*,source)
+#endif
+  {
+    GET_THREAD_ID();
+    
+    verbosity_lv2_master_printf("\n");
+    
+    const int n=BULK_VOL*NDOUBLES_PER_SITE;
+    
+    BASETYPE *r=nissa_malloc("r",BULK_VOL+BORD_VOL,BASETYPE);
+    BASETYPE *w=nissa_malloc("w",BULK_VOL+BORD_VOL,BASETYPE);
+    BASETYPE *q=nissa_malloc("q",BULK_VOL,BASETYPE);
+    BASETYPE *z=nissa_malloc("z",BULK_VOL,BASETYPE);
+    BASETYPE *s=nissa_malloc("s",BULK_VOL+BORD_VOL,BASETYPE);
+    BASETYPE *p=nissa_malloc("p",BULK_VOL+BORD_VOL,BASETYPE);
+    
+    //shared buffer for the non-blocking reduction of (r,r) and (w,r)
+    double *red=nissa_malloc("red",2,double);
+    MPI_Request req;
+    
+    //macro to be defined externally, allocating all the required additional vectors
+    CG_ADDITIONAL_VECTORS_ALLOCATION();
+    if(guess==NULL) vector_reset(sol);
+    else vector_copy(sol,guess);
+    
+    START_TIMING(cg_inv_over_time,ncg_inv);
+    int each=VERBOSITY_LV3?1:10;
+    
+    double source_norm;
+    double_vector_glb_scalar_prod(&source_norm,(double*)source,(double*)source,n);
+    verbosity_lv2_master_printf("Source norm: %lg\n",source_norm);
+    if(source_norm==0 || std::isnan(source_norm)) crash("invalid norm: %lg",source_norm);
+    
+    int final_iter=0,nrestart=0,nreplace=0;
+    double lambda;
+    bool converged=false;
+    do
+      {
+	//compute r=source-DD*sol and w=DD*r
+	APPLY_OPERATOR(s,CG_OPERATOR_PARAMETERS sol);
+	double_vector_subt((double*)r,(double*)source,(double*)s,n);
+	APPLY_OPERATOR(w,CG_OPERATOR_PARAMETERS r);
+	
+	double_vector_glb_scalar_prod(&lambda,(double*)r,(double*)r,n);
+	verbosity_lv2_master_printf("iter %d relative residue: %lg\n",final_iter,lambda/source_norm);
+	if(lambda<residue*source_norm) converged=true;
+	
+	//main loop
+	double alpha=0,gammag=0,gammag_old=0;
+	int iter=0;
+	while(!converged && final_iter<niter)
+	  {
+	    //(r_k,r_k) and (w_k,r_k), reduced while computing q_k=DD*w_k
+	    double_vector_glb_scalar_prods_start(red,&req,(double*)r,(double*)r,(double*)w,(double*)r,n);
+	    STOP_TIMING(cg_inv_over_time);
+	    APPLY_OPERATOR(q,CG_OPERATOR_PARAMETERS w);
+	    if(IS_MASTER_THREAD) cg_inv_over_time-=take_time();
+	    double_vector_glb_scalar_prods_wait(&req);
+	    
+	    gammag=red[0];
+	    const double delta=red[1];
+	    
+	    if(iter%each==0 && iter) verbosity_lv2_master_printf("iter %d relative residue: %lg\n",final_iter,gammag/source_norm);
+	    
+	    //checks
+	    if(std::isnan(gammag) || std::isnan(delta)) crash("nanned");
+	    
+	    //stop when the recursive residue claims convergence, doing at least one iteration after each restart
+	    if(iter>0 && gammag<residue*source_norm) break;
+	    
+	    double beta;
+	    if(iter==0)
+	      {
+		beta=0;
+		alpha=gammag/delta;
+	      }
+	    else
+	      {
+		beta=gammag/gammag_old;
+		alpha=gammag/(delta-beta*gammag/alpha);
+	      }
+	    gammag_old=gammag;
+	    
+	    //z=q+beta*z, s=w+beta*s, p=r+beta*p, sol+=alpha*p, r-=alpha*s, w-=alpha*z
+	    double_vector_pipelined_cg_update((double*)sol,(double*)r,(double*)w,(double*)p,(double*)s,(double*)z,(double*)q,alpha,beta,n);
+	    
+	    iter++;
+	    final_iter++;
+	    
+	    //replace r, w, s and z with the true ones, using q as temporary
+	    if(pipelined_cg_replace_each>0 && iter%pipelined_cg_replace_each==0)
+	      {
+		APPLY_OPERATOR(q,CG_OPERATOR_PARAMETERS sol);
+		double_vector_subt((double*)r,(double*)source,(double*)q,n);
+		APPLY_OPERATOR(w,CG_OPERATOR_PARAMETERS r);
+		APPLY_OPERATOR(s,CG_OPERATOR_PARAMETERS p);
+		APPLY_OPERATOR(z,CG_OPERATOR_PARAMETERS s);
+		nreplace++;
+	      }
+	  }
+	
+	//check the true residue, and restart if needed
+	if(!converged)
+	  {
+	    APPLY_OPERATOR(s,CG_OPERATOR_PARAMETERS sol);
+	    double_vector_subt((double*)r,(double*)source,(double*)s,n);
+	    double_vector_glb_scalar_prod(&lambda,(double*)r,(double*)r,n);
+	    if(lambda<residue*source_norm) converged=true;
+	    else
+	      if(final_iter<niter)
+		{
+		  verbosity_lv2_master_printf("restarting pipelined cg at iter %d, true relative residue: %lg\n",final_iter,lambda/source_norm);
+		  nrestart++;
+		}
+	  }
+      }
+    while(!converged && final_iter<niter);
+    
+    //the residue has been computed after the last iteration
+    verbosity_lv2_master_printf("final relative residue (after %d iters, %d restarts, %d residue replacements): %lg where %lg was required\n",
+				final_iter,nrestart,nreplace,lambda/source_norm,residue);
+    if(lambda/source_norm>=2*residue)
+      master_printf("WARNING: true residue %lg much larger than required and expected one %lg\n",
+		    lambda/source_norm,residue);
+    
+    verbosity_lv1_master_printf(" Total pipelined cg iterations: %d\n",final_iter);
+    
+    //check if not converged
+    if(!converged) crash("exit without converging");
+    
+    if(IS_MASTER_THREAD) cg_inv_over_time+=take_time();
+    
+    nissa_free(r);
+    nissa_free(w);
+    nissa_free(q);
+    nissa_free(z);
+    nissa_free(s);
+    nissa_free(p);
+    nissa_free(red);
+    
+    //macro to be defined externally
+    CG_ADDITIONAL_VECTORS_FREE();
+  }
+  THREADABLE_FUNCTION_END
+}
+
+#undef BASETYPE
+#undef NDOUBLES_PER_SITE
+#undef BULK_VOL
+#undef BORD_VOL
+
+#undef APPLY_OPERATOR
+#undef CG_OPERATOR_PARAMETERS
+#undef CG_PIPELINED_INVERT
+#undef CG_ADDITIONAL_VECTORS_FREE
+#undef CG_ADDITIONAL_VECTORS_ALLOCATION
+#undef CG_NARG
@@ -182,16 +182,15 @@ namespace nissa
 					    "zfs: %16.16lg, betas: %16.16lg\n",
 					    ishift,shift[ishift],zas[ishift],zps[ishift],zfs[ishift],betas[ishift]);
 #endif
-		double_vector_summ_double_vector_prod_double((double*)(sol[ishift]),(double*)(sol[ishift]),(double*)(ps[ishift]),-betas[ishift],BULK_VOL*NDOUBLES_PER_SITE,DO_NOT_SET_FLAGS);
 	      }
-	    THREAD_BARRIER();
 	  }
 	
 	//     calculate
+	//     -x=x-betas*ps
 	//     -r'=r+betaa*s=r+beta*Ap
 	//     -rfrf=(r',r')
-	double_vector_summ_double_vector_prod_double((double*)r,(double*)r,(double*)s,betaa,BULK_VOL*NDOUBLES_PER_SITE);
-	double_vector_glb_scalar_prod(&rfrf,(double*)r,(double*)r,BULK_VOL*NDOUBLES_PER_SITE);
+	double_vector_cgm_update_sol_and_residue_glb_norm2(&rfrf,(double**)sol,(double**)ps,betas,run_flag,nshift,
+							   (double*)r,(double*)s,betaa,BULK_VOL*NDOUBLES_PER_SITE);
 #ifdef CGM_DEBUG
 	verbosity_lv3_master_printf("rfrf: %16.16lg\n",rfrf);
 #endif
@@ -199,31 +198,32 @@ namespace nissa
 	//     calculate alpha=rfrf/rr=(r',r')/(r,r)
 	alpha=rfrf/rr;
 	
-	//     calculate p'=r'+p*alpha
-	double_vector_summ_double_vector_prod_double((double*)p,(double*)r,(double*)p,alpha,BULK_VOL*NDOUBLES_PER_SITE);
-	
-	//start the communications of the border
-	if(use_async_communications)  CGM_START_COMMUNICATING_BORDERS(p);
-	
 	//     calculate 
 	//     -alphas=alpha*zfs*betas/zas*beta
-	//     -ps'=r'+alpha*ps
 	for(int ishift=0;ishift<nshift;ishift++)
-	  {
-	    if(run_flag[ishift]==1)
-	      {
-		alphas[ishift]=alpha*zfs[ishift]*betas[ishift]/(zas[ishift]*betaa);
+	  if(run_flag[ishift]==1)
+	    {
+	      alphas[ishift]=alpha*zfs[ishift]*betas[ishift]/(zas[ishift]*betaa);
 #ifdef CGM_DEBUG
-		verbosity_lv3_master_printf("ishift %d alpha: %16.16lg\n",ishift,alphas[ishift]);
+	      verbosity_lv3_master_printf("ishift %d alpha: %16.16lg\n",ishift,alphas[ishift]);
 #endif
-		double_vector_linear_comb((double*)(ps[ishift]),(double*)r,zfs[ishift],(double*)(ps[ishift]),alphas[ishift],BULK_VOL*NDOUBLES_PER_SITE,DO_NOT_SET_FLAGS);
-		
-		// shift z
-		zps[ishift]=zas[ishift];
-		zas[ishift]=zfs[ishift];
-	      }
-	    THREAD_BARRIER();
-	  }
+	    }
+	
+	//     calculate
+	//     -p'=r'+p*alpha
+	//     -ps'=r'+alpha*ps
+	double_vector_cgm_update_dirs((double*)p,(double**)ps,(double*)r,alpha,zfs,alphas,run_flag,nshift,BULK_VOL*NDOUBLES_PER_SITE);
+	
+	//start the communications of the border
+	if(use_async_communications)  CGM_START_COMMUNICATING_BORDERS(p);
+	
+	// shift z
+	for(int ishift=0;ishift<nshift;ishift++)
+	  if(run_flag[ishift]==1)
+	    {
+	      zps[ishift]=zas[ishift];
+	      zas[ishift]=zfs[ishift];
+	    }
 	
 	//shift rr
 	rr=rfrf;
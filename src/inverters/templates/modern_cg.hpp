@@ -4,12 +4,114 @@
 #include "base/vectors.hpp"
 #include "linalgs/linalgs.hpp"
 #include "new_types/complex.hpp"
+#include "new_types/float_128.hpp"
 
 namespace nissa
 {
+  //solve using pipelined conjugate gradient algorithm, with a single non-blocking reduction per iteration
+  //every pipelined_cg_replace_each iterations, and when convergence is claimed, the recursive residue and the
+  //auxiliary vectors are replaced with the true ones, to prevent their drift
+  template <class Fmat> void pipelined_cg_solve(complex *x,const Fmat& mat_impl,complex *b,int mat_size,int mat_size_to_allocate,double target_residue,int nmax_iters,int print_each)
+  {
+    master_printf("Starting pipelined cg, target_residue: %lg, niter_max: %d\n",target_residue,nmax_iters);
+    
+    complex *r=nissa_malloc("r",mat_size_to_allocate,complex);
+    complex *w=nissa_malloc("w",mat_size_to_allocate,complex);
+    complex *q=nissa_malloc("q",mat_size_to_allocate,complex);
+    complex *z=nissa_malloc("z",mat_size_to_allocate,complex);
+    complex *s=nissa_malloc("s",mat_size_to_allocate,complex);
+    complex *p=nissa_malloc("p",mat_size_to_allocate,complex);
+    double *red=nissa_malloc("red",2,double);
+    MPI_Request req;
+    vector_copy(r,b);
+    vector_reset(x);
+    vector_reset(p);
+    vector_reset(s);
+    vector_reset(z);
+    mat_impl(w,r);
+    
+    double source_norm=sqrt(double_vector_glb_norm2(b,mat_size));
+    if(source_norm==0) crash("invalid norm");
+    
+    //recompute r=b-A*x, w=A*r, s=A*p and z=A*s, returning the true relative residue
+    auto replace_residue=[&]()
+      {
+	mat_impl(q,x);
+	double_vector_subt((double*)r,(double*)b,(double*)q,2*mat_size);
+	mat_impl(w,r);
+	mat_impl(s,p);
+	mat_impl(z,s);
+	return sqrt(double_vector_glb_norm2(r,mat_size))/source_norm;
+      };
+    
+    //count iterations
+    int iter=0,nreplace=0;
+    double rel_res,alpha=0,rr_old=0;
+    bool converged=false;
+    while(not converged and iter<nmax_iters)
+      {
+	//compute (r,r) and (w,r) while computing q=A*w
+	double_vector_glb_scalar_prods_start(red,&req,(double*)r,(double*)r,(double*)w,(double*)r,2*mat_size);
+	mat_impl(q,w);
+	double_vector_glb_scalar_prods_wait(&req);
+	double rr=red[0],wr=red[1];
+	
+	//compute relative residue
+	rel_res=sqrt(rr)/source_norm;
+	if(iter%print_each==0) master_printf("it: %d, res: %.16lg\n",iter,rel_res);
+	
+	//check the true residue when the recursive one claims convergence
+	if(rel_res<=target_residue)
+	  {
+	    rel_res=replace_residue();
+	    nreplace++;
+	    if(rel_res<=target_residue) converged=true;
+	    else master_printf("it: %d, recursive residue converged but true one is %.16lg, going on\n",iter,rel_res);
+	    continue;
+	  }
+	
+	//compute alpha and beta
+	double beta=(iter==0)?0:rr/rr_old;
+	alpha=(iter==0)?(rr/wr):(rr/(wr-beta*rr/alpha));
+	rr_old=rr;
+	
+	//adjust all vectors in a single pass
+	double_vector_pipelined_cg_update((double*)x,(double*)r,(double*)w,(double*)p,(double*)s,(double*)z,(double*)q,alpha,beta,2*mat_size);
+	
+	iter++;
+	
+	//periodically replace the recursive residue
+	if(pipelined_cg_replace_each>0 and iter%pipelined_cg_replace_each==0)
+	  {
+	    replace_residue();
+	    nreplace++;
+	  }
+      }
+    
+    //compute the final true residue, unless just done
+    if(not converged) rel_res=replace_residue();
+    master_printf("Final true relative residue after %d iterations (%d residue replacements): %.16lg, target: %lg\n",iter,nreplace,rel_res,target_residue);
+    if(rel_res>=2*target_residue) master_printf("WARNING: true residue %lg much larger than required and expected one %lg\n",rel_res,target_residue);
+    if(not converged) crash("exit without converging after %d iterations",iter);
+    
+    nissa_free(red);
+    nissa_free(p);
+    nissa_free(s);
+    nissa_free(z);
+    nissa_free(q);
+    nissa_free(w);
+    nissa_free(r);
+  }
+  
   //solve using conjugate gradient algorithm
   template <class Fmat> void cg_solve(complex *x,const Fmat& mat_impl,complex *b,int mat_size,int mat_size_to_allocate,double target_residue,int nmax_iters,int print_each)
   {
+    if(use_pipelined_cg)
+      {
+	pipelined_cg_solve(x,mat_impl,b,mat_size,mat_size_to_allocate,target_residue,nmax_iters,print_each);
+	return;
+      }
+    
     master_printf("Starting cg, target_residue: %lg, niter_max: %d\n",target_residue,nmax_iters);
     
     complex *p=nissa_malloc("p",mat_size_to_allocate,complex);
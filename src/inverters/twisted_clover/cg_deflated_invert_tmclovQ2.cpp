@@ -0,0 +1,48 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include "base/random.hpp"
+#include "base/vectors.hpp"
+#include "dirac_operators/tmclovQ2/dirac_operator_tmclovQ2.hpp"
+#include "geometry/geometry_lx.hpp"
+
+#include "cg_deflated_invert_tmclovQ2.hpp"
+#include "cg_invert_tmclovQ2.hpp"
+
+namespace nissa
+{
+  //compute the low modes of Q2, to be done once per configuration
+  void find_deflation_subspace_tmclovQ2(deflation_subspace_t &def,int neig,quad_su3 *conf,double kappa,clover_term_t *Cl,double m,double residue)
+  {
+    spincolor *temp=nissa_malloc("temp",loc_vol+bord_vol,spincolor);
+    
+    const auto imp_mat=[conf,kappa,Cl,m,temp](complex *out,complex *in)
+      {
+	apply_tmclovQ2((spincolor*)out,conf,kappa,Cl,temp,m,(spincolor*)in);
+      };
+    
+    const auto filler=[](complex *out)
+      {
+	generate_undiluted_source((spincolor*)out,RND_GAUSS,-1);
+      };
+    
+    const int vect_size=loc_vol*sizeof(spincolor)/sizeof(complex);
+    const int vect_size_to_allocate=(loc_vol+bord_vol)*sizeof(spincolor)/sizeof(complex);
+    find_deflation_subspace(def,neig,vect_size,vect_size_to_allocate,m*m,imp_mat,filler,residue);
+    
+    nissa_free(temp);
+  }
+  
+  //solve starting from the guess obtained projecting the source on the low modes
+  void inv_tmclovQ2_cg_deflated(spincolor *sol,deflation_subspace_t &def,quad_su3 *conf,double kappa,clover_term_t *Cl,double m,int niter,double residue,spincolor *source)
+  {
+    if(def.vect_size!=(int)(loc_vol*sizeof(spincolor)/sizeof(complex))) crash("deflation subspace of size %d not matching",def.vect_size);
+    
+    spincolor *guess=nissa_malloc("guess",loc_vol+bord_vol,spincolor);
+    def.get_guess((complex*)guess,m*m,(complex*)source);
+    inv_tmclovQ2_cg(sol,guess,conf,kappa,Cl,m,niter,residue,source);
+    
+    nissa_free(guess);
+  }
+}
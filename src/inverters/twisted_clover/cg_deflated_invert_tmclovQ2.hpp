@@ -0,0 +1,13 @@
+#ifndef _CG_DEFLATED_INVERT_TMCLOVQ2_HPP
+#define _CG_DEFLATED_INVERT_TMCLOVQ2_HPP
+
+#include "eigenvalues/eigenvalues_deflation.hpp"
+#include "new_types/su3.hpp"
+
+namespace nissa
+{
+  void find_deflation_subspace_tmclovQ2(deflation_subspace_t &def,int neig,quad_su3 *conf,double kappa,clover_term_t *Cl,double m,double residue);
+  void inv_tmclovQ2_cg_deflated(spincolor *sol,deflation_subspace_t &def,quad_su3 *conf,double kappa,clover_term_t *Cl,double m,int niter,double residue,spincolor *source);
+}
+
+#endif
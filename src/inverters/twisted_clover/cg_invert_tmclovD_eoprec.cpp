@@ -18,6 +18,7 @@
 #include "dirac_operators/tmD_eoprec/dirac_operator_tmD_eoprec.hpp"
 #include "geometry/geometry_eo.hpp"
 #include "geometry/geometry_mix.hpp"
+#include "inverters/multigrid/multigrid.hpp"
 #include "inverters/twisted_mass/cg_invert_tmD_eoprec.hpp"
 #include "new_types/su3_op.hpp"
 #include "operations/su3_paths/clover_term.hpp"
@@ -25,6 +26,9 @@
 
 #include "cg_64_invert_tmclovD_eoprec.hpp"
 #include "cg_128_invert_tmclovD_eoprec.hpp"
+#include "cg_mixed_invert_tmclovD_eoprec.hpp"
+#include "cg_pipelined_invert_tmclovD_eoprec.hpp"
+#include "mg_invert_tmclovD.hpp"
 
 #include "dirac_operators/tmQ/dirac_operator_tmQ.hpp"
 
@@ -36,6 +40,8 @@ namespace nissa
   void inv_tmclovDkern_eoprec_square_eos_cg(spincolor *sol,spincolor *guess,quad_su3 **conf,double kappa,clover_term_t *Cl_odd,inv_clover_term_t *invCl_evn,double mass,int nitermax,double residue,spincolor *source)
   {
     if(use_128_bit_precision) inv_tmclovDkern_eoprec_square_eos_cg_128(sol,guess,conf,kappa,Cl_odd,invCl_evn,mass,nitermax,residue,source);
+    else if(use_mixed_precision) inv_tmclovDkern_eoprec_square_eos_cg_mixed(sol,guess,conf,kappa,Cl_odd,invCl_evn,mass,nitermax,residue,source);
+    else if(use_pipelined_cg) inv_tmclovDkern_eoprec_square_eos_cg_pipelined(sol,guess,conf,kappa,Cl_odd,invCl_evn,mass,nitermax,residue,source);
     else inv_tmclovDkern_eoprec_square_eos_cg_64(sol,guess,conf,kappa,Cl_odd,invCl_evn,mass,nitermax,residue,source);
   }
   
@@ -138,6 +144,56 @@ namespace nissa
   }
   THREADABLE_FUNCTION_END
   
+  //reconstruct the full solution from the solution of Koo, following equations (10) and (11)
+  THREADABLE_FUNCTION_8ARG(tmclovD_eoprec_reconstruct_sol_from_Koo, spincolor*,solution_lx, spincolor*,sol_Koo, quad_su3*,conf_lx, double,kappa, clover_term_t*,Cl_lx, inv_clover_term_t*,ext_invCl_lx, double,mass, spincolor*,source_lx)
+  {
+    inv_clover_term_t *invCl_lx;
+    if(ext_invCl_lx) invCl_lx=ext_invCl_lx;
+    else
+      {
+	invCl_lx=nissa_malloc("invCl",loc_vol,inv_clover_term_t);
+	invert_twisted_clover_term(invCl_lx,mass,kappa,Cl_lx);
+      }
+    
+    //prepare the e/o split version of the conf, of the clover term and of the source
+    quad_su3 *conf_eos[2];
+    conf_eos[0]=nissa_malloc("conf_eos_0",loc_volh+bord_volh,quad_su3);
+    conf_eos[1]=nissa_malloc("conf_eos_1",loc_volh+bord_volh,quad_su3);
+    split_lx_vector_into_eo_parts(conf_eos,conf_lx);
+    clover_term_t *Cl_odd=nissa_malloc("Cl_odd",loc_volh,clover_term_t);
+    get_evn_or_odd_part_of_lx_vector(Cl_odd,Cl_lx,ODD);
+    inv_clover_term_t *invCl_evn=nissa_malloc("invCl_evn",loc_volh,inv_clover_term_t);
+    get_evn_or_odd_part_of_lx_vector(invCl_evn,invCl_lx,EVN);
+    spincolor *source_evn=nissa_malloc("source_evn",loc_volh+bord_volh,spincolor);
+    get_evn_or_odd_part_of_lx_vector(source_evn,source_lx,EVN);
+    
+    spincolor *solution_eos[2];
+    solution_eos[0]=nissa_malloc("solution_eos_0",loc_volh+bord_volh,spincolor);
+    solution_eos[1]=nissa_malloc("solution_eos_1",loc_volh+bord_volh,spincolor);
+    
+    //Equation (10) using solution_eos[EVN] as temporary vector
+    tmclovDkern_eoprec_eos(solution_eos[ODD],solution_eos[EVN],conf_eos,kappa,Cl_odd,invCl_evn,true,mass,sol_Koo);
+    
+    //Equation (11)
+    spincolor *varphi=nissa_malloc("varphi",loc_volh+bord_volh,spincolor);
+    inv_tmD_cg_eoprec_almost_reco_sol(varphi,conf_eos,solution_eos[ODD],source_evn);
+    inv_tmclovDee_or_oo_eos(solution_eos[EVN],invCl_evn,false,varphi);
+    nissa_free(varphi);
+    
+    paste_eo_parts_into_lx_vector(solution_lx,solution_eos);
+    
+    for(int par=0;par<2;par++)
+      {
+	nissa_free(conf_eos[par]);
+	nissa_free(solution_eos[par]);
+      }
+    nissa_free(source_evn);
+    nissa_free(invCl_evn);
+    nissa_free(Cl_odd);
+    if(ext_invCl_lx==NULL) nissa_free(invCl_lx);
+  }
+  THREADABLE_FUNCTION_END
+  
   void inv_tmclovD_cg_eoprec(spincolor *solution_lx,spincolor *guess_Koo,quad_su3 *conf_lx,double kappa,clover_term_t *Cl_lx,inv_clover_term_t *ext_invCl_lx,double cSW,double mass,int nitermax,double residue,spincolor *source_lx)
   {
     
@@ -232,7 +288,23 @@ namespace nissa
 	}
       else
 #endif
-	
+	//native multigrid
+	if(mg::use_multigrid and fabs(mass)<=mg::max_mass)
+	  {
+	    //start from the guess, if passed; this is not updated, as the multigrid does not solve Koo
+	    spincolor *guess_lx=NULL;
+	    if(guess_Koo!=NULL)
+	      {
+		guess_lx=nissa_malloc("guess_lx",loc_vol+bord_vol,spincolor);
+		tmclovD_eoprec_reconstruct_sol_from_Koo(guess_lx,guess_Koo,conf_lx,kappa,Cl_lx,ext_invCl_lx,mass,source_lx);
+	      }
+	    
+	    inv_tmclovD_mg(solution_lx,guess_lx,conf_lx,kappa,Cl_lx,mass,nitermax,residue,source_lx);
+	    
+	    if(guess_lx!=NULL) nissa_free(guess_lx);
+	  }
+	else
+	  
 	//fallback to naive implementation
 	inv_tmclovD_cg_eoprec_native(solution_lx,guess_Koo,conf_lx,kappa,Cl_lx,ext_invCl_lx,mass,nitermax,residue,source_lx);
   }
@@ -0,0 +1,50 @@
+#include <math.h>
+
+#include "base/bench.hpp"
+#include "base/debug.hpp"
+#include "base/vectors.hpp"
+#include "dirac_operators/tmclovQ2/dirac_operator_tmclovQ2.hpp"
+#include "dirac_operators/tmclovQ2/dirac_operator_tmclovQ2_32.hpp"
+#include "geometry/geometry_lx.hpp"
+#include "linalgs/linalgs.hpp"
+
+#define BASETYPE spincolor
+#define BASETYPE_32 single_spincolor
+
+#define NDOUBLES_PER_SITE 24
+#define BULK_VOL loc_vol
+#define BORD_VOL bord_vol
+
+#define APPLY_OPERATOR apply_tmclovQ2
+#define CG_OPERATOR_PARAMETERS conf,kappa,Cl,temp,mu,
+#define APPLY_OPERATOR_32 apply_tmclovQ2_32
+#define CG_OPERATOR_32_PARAMETERS conf_32,kappa,Cl_32,temp_32,mu,
+
+#define CG_MIXED_INVERT inv_tmclovQ2_cg_mixed
+
+#define CG_ADDITIONAL_VECTORS_ALLOCATION()				\
+  BASETYPE *temp=nissa_malloc("temp",BULK_VOL+BORD_VOL,BASETYPE);	\
+  BASETYPE_32 *temp_32=nissa_malloc("temp_32",BULK_VOL+BORD_VOL,BASETYPE_32); \
+  single_quad_su3 *conf_32=nissa_malloc("conf_32",loc_vol+bord_vol+edge_vol,single_quad_su3); \
+  double_vector_to_single((float*)conf_32,(double*)conf,loc_vol*sizeof(quad_su3)/sizeof(double)); \
+  single_clover_term_t *Cl_32=nissa_malloc("Cl_32",loc_vol,single_clover_term_t); \
+  double_vector_to_single((float*)Cl_32,(double*)Cl,loc_vol*sizeof(clover_term_t)/sizeof(double));
+
+#define CG_ADDITIONAL_VECTORS_FREE()		\
+  nissa_free(temp);				\
+  nissa_free(temp_32);				\
+  nissa_free(conf_32);				\
+  nissa_free(Cl_32);
+
+//additional parameters
+#define CG_NARG 4
+#define AT1 quad_su3*
+#define A1 conf
+#define AT2 double
+#define A2 kappa
+#define AT3 clover_term_t*
+#define A3 Cl
+#define AT4 double
+#define A4 mu
+
+#include "inverters/templates/cg_mixed_invert_template_threaded.cpp"
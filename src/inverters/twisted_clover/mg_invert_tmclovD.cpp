@@ -0,0 +1,317 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include <string.h>
+
+#include "base/debug.hpp"
+#include "base/random.hpp"
+#include "base/thread_macros.hpp"
+#include "base/vectors.hpp"
+#include "communicate/borders.hpp"
+#include "dirac_operators/tmclovQ/dirac_operator_tmclovQ.hpp"
+#include "geometry/geometry_lx.hpp"
+#include "inverters/multigrid/multigrid.hpp"
+#include "linalgs/linalgs.hpp"
+#include "new_types/dirac.hpp"
+#include "new_types/su3_op.hpp"
+#include "operations/su3_paths/clover_term.hpp"
+#ifdef USE_THREADS
+ #include "routines/thread.hpp"
+#endif
+
+#include "mg_invert_tmclovD.hpp"
+
+namespace nissa
+{
+  namespace mg
+  {
+    //setup of the twisted clover operator
+    setup_t tmclov_setup;
+    
+    //size of fine vectors, in terms of complex
+    int fine_vect_size()
+    {return loc_vol*sizeof(spincolor)/sizeof(complex);}
+    int fine_vect_size_to_allocate()
+    {return (loc_vol+bord_vol)*sizeof(spincolor)/sizeof(complex);}
+    
+    //apply D=g5*Q
+    void apply_tmclovD(spincolor *out,quad_su3 *conf,double kappa,clover_term_t *Cl,double mu,spincolor *in)
+    {
+      GET_THREAD_ID();
+      
+      apply_tmclovQ(out,conf,kappa,Cl,mu,in);
+      NISSA_PARALLEL_LOOP(ivol,0,loc_vol)
+	for(int id=NDIRAC/2;id<NDIRAC;id++)
+	  color_prod_double(out[ivol][id],out[ivol][id],-1);
+      set_borders_invalid(out);
+    }
+    
+    //accumulate the projection of a fine site on the near-null vectors of each chirality
+    inline void summ_the_site_projection(complex *row,setup_t &s,int ivol,spincolor in)
+    {
+      for(int chir=0;chir<2;chir++)
+	for(int ivec=0;ivec<s.nvec;ivec++)
+	  for(int id=chir*NDIRAC/2;id<(chir+1)*NDIRAC/2;id++)
+	    {
+	      complex t;
+	      color_scalar_prod(t,s.nullv[ivec][ivol][id],in[id]);
+	      complex_summassign(row[(chir*s.nvec+ivec)*s.ncdof],t);
+	    }
+    }
+    
+    //take the part of a fine site of given chirality
+    inline void get_chiral_part(spincolor out,spincolor in,int chir)
+    {
+      spincolor_put_to_zero(out);
+      for(int id=chir*NDIRAC/2;id<(chir+1)*NDIRAC/2;id++) color_copy(out[id],in[id]);
+    }
+    
+    //compute the coarse operator P^+ D P, without twisted mass
+    void build_coarse_operator(setup_t &s,quad_su3 *conf,double kappa,clover_term_t *Cl)
+    {
+      GET_THREAD_ID();
+      
+      communicate_lx_quad_su3_borders(conf);
+      for(int ivec=0;ivec<s.nvec;ivec++) communicate_lx_spincolor_borders(s.nullv[ivec]);
+      
+      const double kcf=1/(2*kappa);
+      const int nc=s.ncdof;
+      const coarse_geom_t &geom=s.geom;
+      
+      NISSA_PARALLEL_LOOP(icg,0,geom.loc_vol)
+	{
+	  complex *self=s.self+icg*nc*nc;
+	  complex *hop=s.hop+icg*2*NDIM*nc*nc;
+	  memset(self,0,sizeof(complex)*nc*nc);
+	  memset(hop,0,sizeof(complex)*2*NDIM*nc*nc);
+	  
+	  for(int iblk=0;iblk<geom.block_vol;iblk++)
+	    {
+	      const int ivol=geom.loclx_of_block[icg*geom.block_vol+iblk];
+	      for(int jc=0;jc<nc;jc++)
+		{
+		  const int jchir=jc/s.nvec,jvec=jc%s.nvec;
+		  spincolor in,temp,out;
+		  
+		  //diagonal and clover term
+		  get_chiral_part(in,s.nullv[jvec][ivol],jchir);
+		  unsafe_apply_point_chromo_operator_to_spincolor(out,Cl[ivol],in);
+		  for(int id=0;id<NDIRAC;id++) color_summ_the_prod_double(out[id],in[id],kcf);
+		  summ_the_site_projection(self+jc,s,ivol,out);
+		  
+		  //hopping terms: -1/2 (1-gmu) U_mu(x) in(x+mu) and -1/2 (1+gmu) U^+_mu(x-mu) in(x-mu)
+		  for(int mu=0;mu<NDIM;mu++)
+		    {
+		      const dirac_matr *gmu=base_gamma+igamma_of_mu[mu];
+		      
+		      const int iup=loclx_neighup[ivol][mu];
+		      get_chiral_part(in,s.nullv[jvec][iup],jchir);
+		      spincolor_copy(temp,in);
+		      dirac_subt_the_prod_spincolor(temp,gmu,in);
+		      unsafe_su3_prod_spincolor(out,conf[ivol][mu],temp);
+		      spincolor_prodassign_double(out,-0.5);
+		      const bool up_inside=(iup<loc_vol and geom.block_of_loclx[iup]==icg);
+		      summ_the_site_projection((up_inside?self:hop+mu*nc*nc)+jc,s,ivol,out);
+		      
+		      const int idw=loclx_neighdw[ivol][mu];
+		      get_chiral_part(in,s.nullv[jvec][idw],jchir);
+		      spincolor_copy(temp,in);
+		      dirac_summ_the_prod_spincolor(temp,gmu,in);
+		      unsafe_su3_dag_prod_spincolor(out,conf[idw][mu],temp);
+		      spincolor_prodassign_double(out,-0.5);
+		      const bool dw_inside=(idw<loc_vol and geom.block_of_loclx[idw]==icg);
+		      summ_the_site_projection((dw_inside?self:hop+(NDIM+mu)*nc*nc)+jc,s,ivol,out);
+		    }
+		}
+	    }
+	}
+      THREAD_BARRIER();
+    }
+    
+    //minimal residual iterations on D x=b, starting from x
+    void mr_smooth(spincolor *x,quad_su3 *conf,double kappa,clover_term_t *Cl,double mu,spincolor *b,int niter)
+    {
+      const int n=fine_vect_size();
+      spincolor *r=nissa_malloc("r",loc_vol+bord_vol,spincolor);
+      spincolor *Dr=nissa_malloc("Dr",loc_vol+bord_vol,spincolor);
+      
+      apply_tmclovD(Dr,conf,kappa,Cl,mu,x);
+      double_vector_subt((double*)r,(double*)b,(double*)Dr,2*n);
+      for(int iter=0;iter<niter;iter++)
+	{
+	  apply_tmclovD(Dr,conf,kappa,Cl,mu,r);
+	  complex alpha;
+	  complex_vector_glb_scalar_prod(alpha,(complex*)Dr,(complex*)r,n);
+	  complex_prodassign_double(alpha,1/double_vector_glb_norm2(Dr,loc_vol));
+	  complex_vector_summassign_complex_vector_prod_complex((complex*)x,(complex*)r,alpha,n);
+	  complex_vector_subtassign_complex_vector_prod_complex((complex*)r,(complex*)Dr,alpha,n);
+	}
+      
+      nissa_free(r);
+      nissa_free(Dr);
+    }
+    
+    //two-level preconditioner: coarse grid correction followed by smoothing
+    void apply_tmclovD_preconditioner(spincolor *out,setup_t &s,quad_su3 *conf,double kappa,clover_term_t *Cl,double mu,spincolor *in)
+    {
+      const int cn=s.coarse_vect_size(),cn_alloc=s.coarse_vect_size_to_allocate();
+      complex *coarse_in=nissa_malloc("coarse_in",cn_alloc,complex);
+      complex *coarse_out=nissa_malloc("coarse_out",cn_alloc,complex);
+      
+      //solve on the coarse grid
+      restrict_to_coarse(coarse_in,s,in);
+      vector_reset(coarse_out);
+      const auto coarse_op=[&s,mu](complex *o,complex *i){apply_coarse_operator(o,s,mu,i);};
+      fgmres(coarse_out,coarse_in,cn,cn_alloc,coarse_op,coarse_op,false,restart,coarse_niter_max,coarse_residue,false);
+      prolongate_to_fine(out,s,coarse_out);
+      
+      //smooth
+      mr_smooth(out,conf,kappa,Cl,mu,in,nsmooth);
+      
+      nissa_free(coarse_in);
+      nissa_free(coarse_out);
+    }
+    
+    //orthonormalize the near-null vectors among themselves, to avoid them collapsing on the lowest mode
+    void orthonormalize_globally(setup_t &s)
+    {
+      const int n=fine_vect_size();
+      for(int ivec=0;ivec<s.nvec;ivec++)
+	{
+	  complex *v=(complex*)(s.nullv[ivec]);
+	  for(int jvec=0;jvec<ivec;jvec++)
+	    {
+	      complex p;
+	      complex_vector_glb_scalar_prod(p,(complex*)(s.nullv[jvec]),v,n);
+	      complex_vector_subtassign_complex_vector_prod_complex(v,(complex*)(s.nullv[jvec]),p,n);
+	    }
+	  double_vector_prod_double((double*)v,(double*)v,1/sqrt(double_vector_glb_norm2(v,n)),2*n);
+	}
+    }
+    
+    //compute the near-null vectors and the coarse operator
+    THREADABLE_FUNCTION_6ARG(compute_tmclovD_setup, setup_t*,s, quad_su3*,conf, double,kappa, clover_term_t*,Cl, double,mu, int,nadaptive)
+    {
+      const int n=fine_vect_size(),n_alloc=fine_vect_size_to_allocate();
+      spincolor *temp=nissa_malloc("temp",loc_vol+bord_vol,spincolor);
+      
+      //inverse iterations, starting from random vectors
+      const auto fine_op=[conf,kappa,Cl,mu](complex *o,complex *i){apply_tmclovD((spincolor*)o,conf,kappa,Cl,mu,(spincolor*)i);};
+      for(int ivec=0;ivec<s->nvec;ivec++) generate_undiluted_source(s->nullv[ivec],RND_GAUSS,-1);
+      for(int iter=0;iter<nsetup_iters;iter++)
+	{
+	  verbosity_lv2_master_printf("MG: setup iteration %d/%d\n",iter+1,nsetup_iters);
+	  for(int ivec=0;ivec<s->nvec;ivec++)
+	    {
+	      vector_reset(temp);
+	      fgmres((complex*)temp,(complex*)(s->nullv[ivec]),n,n_alloc,fine_op,fine_op,false,restart,restart,0,false);
+	      vector_copy(s->nullv[ivec],temp);
+	    }
+	  orthonormalize_globally(*s);
+	}
+      orthonormalize_near_null_vectors(*s);
+      build_coarse_operator(*s,conf,kappa,Cl);
+      
+      //improve using the two-level method itself
+      for(int iter=0;iter<nadaptive;iter++)
+	{
+	  verbosity_lv2_master_printf("MG: adaptive setup iteration %d/%d\n",iter+1,nadaptive);
+	  for(int ivec=0;ivec<s->nvec;ivec++)
+	    {
+	      vector_reset(temp);
+	      apply_tmclovD_preconditioner(temp,*s,conf,kappa,Cl,mu,s->nullv[ivec]);
+	      vector_copy(s->nullv[ivec],temp);
+	    }
+	  orthonormalize_globally(*s);
+	  orthonormalize_near_null_vectors(*s);
+	  build_coarse_operator(*s,conf,kappa,Cl);
+	}
+      
+      nissa_free(temp);
+    }
+    THREADABLE_FUNCTION_END
+    
+    //recompute the setup if the conf or the parameters changed
+    void update_tmclovD_setup(quad_su3 *conf,double kappa,clover_term_t *Cl,double mu)
+    {
+      setup_t &s=tmclov_setup;
+      
+      //choose the block size, if not specified
+      coords bs;
+      for(int mu=0;mu<NDIM;mu++)
+	if(block_size[mu]) bs[mu]=block_size[mu];
+	else bs[mu]=(loc_size[mu]%4==0)?4:((loc_size[mu]%2==0)?2:1);
+      
+      bool realloc=(not s.inited or s.nvec!=nvec);
+      if(s.inited) for(int mu=0;mu<NDIM;mu++) realloc|=(s.geom.block_size[mu]!=bs[mu]);
+      if(realloc)
+	{
+	  master_printf("MG: allocating the setup with %d near-null vectors, block size %d %d %d %d\n",nvec,bs[0],bs[1],bs[2],bs[3]);
+	  free_setup(s);
+	  alloc_setup(s,bs,nvec);
+	}
+      
+      //check if the setup was invalidated or kappa changed
+      if(not s.valid or s.kappa!=kappa)
+	{
+	  master_printf("MG: computing a new setup\n");
+	  double setup_time=-take_time();
+	  compute_tmclovD_setup(&s,conf,kappa,Cl,mu,nsetup_adaptive_iters);
+	  setup_time+=take_time();
+	  master_printf("MG: setup computed in %lg s\n",setup_time);
+	  
+	  s.valid=true;
+	  s.kappa=kappa;
+	}
+      else verbosity_lv2_master_printf("MG: reusing the setup\n");
+    }
+    
+    //solve with flexible GMRES, preconditioned with the two-level method, starting from the guess if passed
+    THREADABLE_FUNCTION_9ARG(inv_tmclovD_mg_internal, spincolor*,sol, spincolor*,guess, quad_su3*,conf, double,kappa, clover_term_t*,Cl, double,mu, int,niter_max, double,residue, spincolor*,source)
+    {
+      setup_t &s=tmclov_setup;
+      
+      const auto fine_op=[conf,kappa,Cl,mu](complex *o,complex *i){apply_tmclovD((spincolor*)o,conf,kappa,Cl,mu,(spincolor*)i);};
+      const auto prec=[&s,conf,kappa,Cl,mu](complex *o,complex *i){apply_tmclovD_preconditioner((spincolor*)o,s,conf,kappa,Cl,mu,(spincolor*)i);};
+      
+      if(guess==NULL) vector_reset(sol);
+      else vector_copy(sol,guess);
+      const int n=fine_vect_size();
+      int final_iter=fgmres((complex*)sol,(complex*)source,n,fine_vect_size_to_allocate(),fine_op,prec,true,restart,niter_max,residue,true);
+      
+      //check the true residue
+      spincolor *check_res=nissa_malloc("check_res",loc_vol+bord_vol,spincolor);
+      apply_tmclovD(check_res,conf,kappa,Cl,mu,sol);
+      double_vector_subt((double*)check_res,(double*)check_res,(double*)source,2*n);
+      double real_residue=double_vector_glb_norm2(check_res,loc_vol)/double_vector_glb_norm2(source,loc_vol);
+      nissa_free(check_res);
+      
+      if(real_residue>=2*residue)
+	master_printf("WARNING: true residue %lg much larger than required and expected one %lg\n",real_residue,residue);
+      
+      //check if not converged
+      if(final_iter>=niter_max and real_residue>residue) crash("exit without converging");
+    }
+    THREADABLE_FUNCTION_END
+    
+    //mark the setup as to be recomputed, to be called when the conf changes
+    void invalidate_setup()
+    {tmclov_setup.valid=false;}
+    
+    //free the setup
+    void finalize()
+    {free_setup(tmclov_setup);}
+  }
+  
+  //solve D sol=source using the native multigrid
+  void inv_tmclovD_mg(spincolor *sol,spincolor *guess,quad_su3 *conf,double kappa,clover_term_t *Cl,double mu,int niter_max,double residue,spincolor *source)
+  {
+    mg::update_tmclovD_setup(conf,kappa,Cl,mu);
+    
+    double solve_time=-take_time();
+    mg::inv_tmclovD_mg_internal(sol,guess,conf,kappa,Cl,mu,niter_max,residue,source);
+    solve_time+=take_time();
+    master_printf("MG: solving time %lg s\n",solve_time);
+  }
+}
@@ -0,0 +1,17 @@
+#ifndef _MG_INVERT_TMCLOVD_HPP
+#define _MG_INVERT_TMCLOVD_HPP
+
+#include "new_types/su3.hpp"
+
+namespace nissa
+{
+  namespace mg
+  {
+    void invalidate_setup();
+    void finalize();
+  }
+  
+  void inv_tmclovD_mg(spincolor *sol,spincolor *guess,quad_su3 *conf,double kappa,clover_term_t *Cl,double mu,int niter_max,double residue,spincolor *source);
+}
+
+#endif
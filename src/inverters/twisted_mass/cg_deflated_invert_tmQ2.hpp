@@ -0,0 +1,13 @@
+#ifndef _CG_DEFLATED_INVERT_TMQ2_HPP
+#define _CG_DEFLATED_INVERT_TMQ2_HPP
+
+#include "eigenvalues/eigenvalues_deflation.hpp"
+#include "new_types/su3.hpp"
+
+namespace nissa
+{
+  void find_deflation_subspace_tmQ2(deflation_subspace_t &def,int neig,quad_su3 *conf,double kappa,double m,double residue);
+  void inv_tmQ2_cg_deflated(spincolor *sol,deflation_subspace_t &def,quad_su3 *conf,double kappa,double m,int niter,double residue,spincolor *source);
+}
+
+#endif
@@ -4,6 +4,7 @@
 
 #include <string.h>
 
+#include "base/random.hpp"
 #include "base/thread_macros.hpp"
 #ifdef USE_TMLQCD
  #include "base/tmLQCD_bridge.hpp"
@@ -21,6 +22,9 @@
 
 #include "cg_64_invert_tmD_eoprec.hpp"
 #include "cg_128_invert_tmD_eoprec.hpp"
+#include "cg_mixed_invert_tmD_eoprec.hpp"
+#include "cg_pipelined_invert_tmD_eoprec.hpp"
+#include "cg_invert_tmD_eoprec.hpp"
 
 namespace nissa
 {
@@ -30,6 +34,8 @@ namespace nissa
   void inv_tmDkern_eoprec_square_eos_cg(spincolor *sol,spincolor *guess,quad_su3 **conf,double kappa,double mass,int nitermax,double residue,spincolor *source)
   {
     if(use_128_bit_precision) inv_tmDkern_eoprec_square_eos_cg_128(sol,guess,conf,kappa,mass,nitermax,residue,source);
+    else if(use_mixed_precision) inv_tmDkern_eoprec_square_eos_cg_mixed(sol,guess,conf,kappa,mass,nitermax,residue,source);
+    else if(use_pipelined_cg) inv_tmDkern_eoprec_square_eos_cg_pipelined(sol,guess,conf,kappa,mass,nitermax,residue,source);
     else inv_tmDkern_eoprec_square_eos_cg_64(sol,guess,conf,kappa,mass,nitermax,residue,source);
   }
   
@@ -65,7 +71,8 @@ namespace nissa
   }
   
   //Invert twisted mass operator using e/o preconditioning.
-  THREADABLE_FUNCTION_8ARG(inv_tmD_cg_eoprec_native, spincolor*,solution_lx, spincolor*,guess_Koo, quad_su3*,conf_lx, double,kappa, double,mass, int,nitermax, double,residue, spincolor*,source_lx)
+  //If no guess is passed but the low modes of Koo are, the guess is obtained by projecting on them
+  THREADABLE_FUNCTION_9ARG(inv_tmD_cg_eoprec_native, spincolor*,solution_lx, spincolor*,guess_Koo, quad_su3*,conf_lx, double,kappa, double,mass, int,nitermax, double,residue, spincolor*,source_lx, deflation_subspace_t*,def)
   {
     if(!use_eo_geom) crash("eo geometry needed to use cg_eoprec");
     
@@ -96,9 +103,18 @@ namespace nissa
     spincolor *varphi=nissa_malloc("varphi",loc_volh+bord_volh,spincolor);
     inv_tmD_cg_eoprec_prepare_source(varphi,conf_eos,temp,source_eos[ODD]);
     
+    //deflated guess
+    spincolor *def_guess=NULL;
+    if(guess_Koo==NULL and def!=NULL)
+      {
+	def_guess=nissa_malloc("def_guess",loc_volh+bord_volh,spincolor);
+	def->get_guess((complex*)def_guess,mass*mass,(complex*)varphi);
+      }
+    
     //Equation (9) using solution_eos[EVN] as temporary vector
-    inv_tmDkern_eoprec_square_eos_cg(temp,guess_Koo,conf_eos,kappa,mass,nitermax,residue,varphi);
+    inv_tmDkern_eoprec_square_eos_cg(temp,(def_guess!=NULL)?def_guess:guess_Koo,conf_eos,kappa,mass,nitermax,residue,varphi);
     if(guess_Koo!=NULL) vector_copy(guess_Koo,temp); //if a guess was passed, return new one
+    if(def_guess!=NULL) nissa_free(def_guess);
     
     //Equation (10)
     tmDkern_eoprec_eos(solution_eos[ODD],solution_eos[EVN],conf_eos,kappa,-mass,temp);
@@ -166,7 +182,45 @@ namespace nissa
 #endif
 	
 	//fallback to naive implementation
-	inv_tmD_cg_eoprec_native(solution_lx,guess_Koo,conf_lx,kappa,mass,nitermax,residue,source_lx);
+	inv_tmD_cg_eoprec_native(solution_lx,guess_Koo,conf_lx,kappa,mass,nitermax,residue,source_lx,NULL);
+  }
+  
+  //compute the low modes of Koo^+Koo, to be done once per configuration and mass
+  //the subspace depends also on the sign of mass: if used with the opposite one, only the guess is spoiled
+  void find_deflation_subspace_tmD_eoprec(deflation_subspace_t &def,int neig,quad_su3 *conf_lx,double kappa,double mass,double residue)
+  {
+    quad_su3 *conf_eos[2];
+    for(int par=0;par<2;par++) conf_eos[par]=nissa_malloc("conf_eos",loc_volh+bord_volh,quad_su3);
+    split_lx_vector_into_eo_parts(conf_eos,conf_lx);
+    spincolor *temp1=nissa_malloc("temp1",loc_volh+bord_volh,spincolor);
+    spincolor *temp2=nissa_malloc("temp2",loc_volh+bord_volh,spincolor);
+    
+    const auto imp_mat=[&conf_eos,kappa,mass,temp1,temp2](complex *out,complex *in)
+      {
+	tmDkern_eoprec_square_eos((spincolor*)out,temp1,temp2,conf_eos,kappa,mass,(spincolor*)in);
+      };
+    
+    const auto filler=[](complex *out)
+      {
+	generate_fully_undiluted_eo_source((spincolor*)out,RND_GAUSS,-1,ODD);
+      };
+    
+    const int vect_size=loc_volh*sizeof(spincolor)/sizeof(complex);
+    const int vect_size_to_allocate=(loc_volh+bord_volh)*sizeof(spincolor)/sizeof(complex);
+    find_deflation_subspace(def,neig,vect_size,vect_size_to_allocate,mass*mass,imp_mat,filler,residue);
+    
+    nissa_free(temp2);
+    nissa_free(temp1);
+    for(int par=0;par<2;par++) nissa_free(conf_eos[par]);
+  }
+  
+  //invert using e/o preconditioning, starting the inversion of Koo from its low modes
+  void inv_tmD_cg_eoprec_deflated(spincolor *solution_lx,deflation_subspace_t &def,quad_su3 *conf_lx,double kappa,double mass,int nitermax,double residue,spincolor *source_lx)
+  {
+    if(def.vect_size!=(int)(loc_volh*sizeof(spincolor)/sizeof(complex))) crash("deflation subspace of size %d not matching",def.vect_size);
+    if(def.mass2!=mass*mass) crash("deflation subspace computed with mass2 %lg, asked %lg",def.mass2,mass*mass);
+    
+    inv_tmD_cg_eoprec_native(solution_lx,NULL,conf_lx,kappa,mass,nitermax,residue,source_lx,&def);
   }
 }
 
@@ -1,6 +1,7 @@
 #ifndef _CG_INVERT_TMD_EOPREC_HPP
 #define _CG_INVERT_TMD_EOPREC_HPP
 
+#include "eigenvalues/eigenvalues_deflation.hpp"
 #include "new_types/su3.hpp"
 
 namespace nissa
@@ -9,6 +10,8 @@ namespace nissa
   void inv_tmD_cg_eoprec(spincolor *solution_lx,spincolor *guess_Koo,quad_su3 *conf_lx,double kappa,double mu,int nitermax,double residue,spincolor *source_lx);
   void inv_tmDkern_eoprec_square_eos(spincolor *sol,spincolor *guess,quad_su3 **conf,double kappa,double mu,int nitermax,double residue,spincolor *source);
   void inv_tmD_cg_eoprec_almost_reco_sol(spincolor *varphi,quad_su3 **conf_eos,spincolor *sol_odd,spincolor *source_evn);
+  void find_deflation_subspace_tmD_eoprec(deflation_subspace_t &def,int neig,quad_su3 *conf_lx,double kappa,double mass,double residue);
+  void inv_tmD_cg_eoprec_deflated(spincolor *solution_lx,deflation_subspace_t &def,quad_su3 *conf_lx,double kappa,double mass,int nitermax,double residue,spincolor *source_lx);
 }
 
 #endif
@@ -5,13 +5,17 @@
 #include "new_types/float_128.hpp"
 #include "cg_64_invert_tmQ2.hpp"
 #include "cg_128_invert_tmQ2.hpp"
+#include "cg_mixed_invert_tmQ2.hpp"
+#include "cg_pipelined_invert_tmQ2.hpp"
 
 namespace nissa
 {
-  //switch 64 and 128
+  //switch 64, 128, mixed 32/64 and pipelined 64
   void inv_tmQ2_RL_cg(spincolor *sol,spincolor *guess,quad_su3 *conf,double kappa,int RL,double m,int niter,double residue,spincolor *source)
   {
     if(use_128_bit_precision) inv_tmQ2_RL_cg_128(sol,guess,conf,kappa,RL,m,niter,residue,source);
+    else if(use_mixed_precision && RL==0) inv_tmQ2_RL_cg_mixed(sol,guess,conf,kappa,RL,m,niter,residue,source);
+    else if(use_pipelined_cg) inv_tmQ2_RL_cg_pipelined(sol,guess,conf,kappa,RL,m,niter,residue,source);
     else inv_tmQ2_RL_cg_64(sol,guess,conf,kappa,RL,m,niter,residue,source);
   }
 }
@@ -0,0 +1,53 @@
+#include <math.h>
+
+#include "base/bench.hpp"
+#include "base/debug.hpp"
+#include "base/vectors.hpp"
+#include "communicate/communicate.hpp"
+#include "dirac_operators/tmD_eoprec/dirac_operator_tmD_eoprec.hpp"
+#include "dirac_operators/tmD_eoprec/dirac_operator_tmD_eoprec_32.hpp"
+#include "geometry/geometry_eo.hpp"
+#include "linalgs/linalgs.hpp"
+#include "routines/ios.hpp"
+
+#define BASETYPE spincolor
+#define BASETYPE_32 single_spincolor
+#define NDOUBLES_PER_SITE 24
+#define BULK_VOL loc_volh
+#define BORD_VOL bord_volh
+
+#define APPLY_OPERATOR tmDkern_eoprec_square_eos
+#define CG_OPERATOR_PARAMETERS temp1,temp2,eo_conf,kappa,mu,
+#define APPLY_OPERATOR_32 tmDkern_eoprec_square_eos_32
+#define CG_OPERATOR_32_PARAMETERS temp1_32,temp2_32,eo_conf_32,kappa,mu,
+
+#define CG_MIXED_INVERT inv_tmDkern_eoprec_square_eos_cg_mixed
+
+#define CG_ADDITIONAL_VECTORS_ALLOCATION()                              \
+  BASETYPE *temp1=nissa_malloc("temp1",BULK_VOL+BORD_VOL,BASETYPE);	\
+  BASETYPE *temp2=nissa_malloc("temp2",BULK_VOL+BORD_VOL,BASETYPE);	\
+  BASETYPE_32 *temp1_32=nissa_malloc("temp1_32",BULK_VOL+BORD_VOL,BASETYPE_32); \
+  BASETYPE_32 *temp2_32=nissa_malloc("temp2_32",BULK_VOL+BORD_VOL,BASETYPE_32); \
+  single_quad_su3 *eo_conf_32[2];					\
+  for(int par=0;par<2;par++)						\
+    {									\
+      eo_conf_32[par]=nissa_malloc("eo_conf_32",loc_volh+bord_volh+edge_volh,single_quad_su3); \
+      double_vector_to_single((float*)(eo_conf_32[par]),(double*)(eo_conf[par]),loc_volh*sizeof(quad_su3)/sizeof(double)); \
+    }
+#define CG_ADDITIONAL_VECTORS_FREE()            \
+  nissa_free(temp1);				\
+  nissa_free(temp2);				\
+  nissa_free(temp1_32);				\
+  nissa_free(temp2_32);				\
+  for(int par=0;par<2;par++) nissa_free(eo_conf_32[par]);
+
+//additional parameters
+#define CG_NARG 3
+#define AT1 quad_su3**
+#define A1 eo_conf
+#define AT2 double
+#define A2 kappa
+#define AT3 double
+#define A3 mu
+
+#include "inverters/templates/cg_mixed_invert_template_threaded.cpp"
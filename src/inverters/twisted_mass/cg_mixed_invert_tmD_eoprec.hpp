@@ -0,0 +1,11 @@
+#ifndef _CG_MIXED_INVERT_TMD_EOPREC_HPP
+#define _CG_MIXED_INVERT_TMD_EOPREC_HPP
+
+#include "new_types/su3.hpp"
+
+namespace nissa
+{
+  void inv_tmDkern_eoprec_square_eos_cg_mixed(spincolor *sol,spincolor *guess,quad_su3 **eo_conf,double kappa,double mu,int niter,double residue,spincolor *source);
+}
+
+#endif
@@ -0,0 +1,48 @@
+#include <math.h>
+
+#include "base/bench.hpp"
+#include "base/debug.hpp"
+#include "base/vectors.hpp"
+#include "communicate/communicate.hpp"
+#include "dirac_operators/tmQ2/dirac_operator_tmQ2.hpp"
+#include "dirac_operators/tmQ2/dirac_operator_tmQ2_32.hpp"
+#include "geometry/geometry_lx.hpp"
+#include "linalgs/linalgs.hpp"
+#include "routines/ios.hpp"
+
+#define BASETYPE spincolor
+#define BASETYPE_32 single_spincolor
+#define NDOUBLES_PER_SITE 24
+#define BULK_VOL loc_vol
+#define BORD_VOL bord_vol
+
+#define APPLY_OPERATOR apply_tmQ2_RL
+#define CG_OPERATOR_PARAMETERS conf,kappa,t,RL,m,
+#define APPLY_OPERATOR_32 apply_tmQ2_RL_32
+#define CG_OPERATOR_32_PARAMETERS conf_32,kappa,t_32,RL,m,
+
+#define CG_MIXED_INVERT inv_tmQ2_RL_cg_mixed
+
+#define CG_ADDITIONAL_VECTORS_ALLOCATION()                              \
+  if(RL==1) crash("left not implmented");				\
+  BASETYPE *t=nissa_malloc("DD_temp",loc_vol+bord_vol,BASETYPE);	\
+  BASETYPE_32 *t_32=nissa_malloc("DD_temp_32",loc_vol+bord_vol,BASETYPE_32); \
+  single_quad_su3 *conf_32=nissa_malloc("conf_32",loc_vol+bord_vol+edge_vol,single_quad_su3); \
+  double_vector_to_single((float*)conf_32,(double*)conf,loc_vol*sizeof(quad_su3)/sizeof(double));
+#define CG_ADDITIONAL_VECTORS_FREE()            \
+  nissa_free(t);				\
+  nissa_free(t_32);				\
+  nissa_free(conf_32);
+
+//additional parameters
+#define CG_NARG 4
+#define AT1 quad_su3*
+#define A1 conf
+#define AT2 double
+#define A2 kappa
+#define AT3 int
+#define A3 RL
+#define AT4 double
+#define A4 m
+
+#include "inverters/templates/cg_mixed_invert_template_threaded.cpp"
@@ -0,0 +1,11 @@
+#ifndef _CG_MIXED_INVERT_TMQ2_HPP
+#define _CG_MIXED_INVERT_TMQ2_HPP
+
+#include "new_types/su3.hpp"
+
+namespace nissa
+{
+  void inv_tmQ2_RL_cg_mixed(spincolor *sol,spincolor *guess,quad_su3 *conf,double kappa,int RL,double m,int niter,double residue,spincolor *source);
+}
+
+#endif
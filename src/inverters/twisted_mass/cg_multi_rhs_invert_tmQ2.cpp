@@ -0,0 +1,36 @@
+#include <math.h>
+
+#include "base/bench.hpp"
+#include "base/debug.hpp"
+#include "base/vectors.hpp"
+#include "communicate/communicate.hpp"
+#include "dirac_operators/tmQ2/dirac_operator_tmQ2_multi.hpp"
+#include "geometry/geometry_lx.hpp"
+#include "linalgs/linalgs.hpp"
+#include "routines/ios.hpp"
+
+#define BASETYPE spincolor
+#define NDOUBLES_PER_SITE 24
+#define BULK_VOL loc_vol
+#define BORD_VOL bord_vol
+
+#define APPLY_OPERATOR apply_tmQ2_multi
+#define CG_OPERATOR_PARAMETERS conf,kappa,t,m,
+
+#define CG_MULTI_RHS_INVERT inv_tmQ2_cg_multi_rhs
+
+#define CG_ADDITIONAL_VECTORS_ALLOCATION()				\
+  BASETYPE *t=nissa_malloc("DD_temp",(loc_vol+bord_vol)*nrhs,BASETYPE);
+#define CG_ADDITIONAL_VECTORS_FREE()		\
+  nissa_free(t);
+
+//additional parameters
+#define CG_NARG 3
+#define AT1 quad_su3*
+#define A1 conf
+#define AT2 double
+#define A2 kappa
+#define AT3 double
+#define A3 m
+
+#include "inverters/templates/cg_multi_rhs_invert_template_threaded.cpp"
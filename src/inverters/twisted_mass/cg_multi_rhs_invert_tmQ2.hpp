@@ -0,0 +1,11 @@
+#ifndef _CG_MULTI_RHS_INVERT_TMQ2_HPP
+#define _CG_MULTI_RHS_INVERT_TMQ2_HPP
+
+#include "new_types/su3.hpp"
+
+namespace nissa
+{
+  void inv_tmQ2_cg_multi_rhs(spincolor *sol,spincolor *guess,quad_su3 *conf,double kappa,double m,int nrhs,int niter,double residue,spincolor *source);
+}
+
+#endif
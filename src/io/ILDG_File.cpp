@@ -5,7 +5,10 @@
  #include "config.hpp"
 #endif
 
+#include <algorithm>
+#include <errno.h>
 #include <mpi.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -444,7 +447,8 @@ namespace nissa
     header.data_length=data_length;
     header.version=1;
     header.magic_no=ILDG_MAGIC_NO;
-    strncpy(header.type,type,128); //max 128 chars
+    memset(header.type,0,sizeof(header.type));
+    memcpy(header.type,type,std::min(strlen(type),sizeof(header.type)-1)); //max 127 chars, null terminated
     
     //return the header
     return header;
@@ -592,6 +596,66 @@ namespace nissa
       }
   }
   
+#ifdef USE_MPI_IO
+  //remap from ildg
+  THREADABLE_FUNCTION_3ARG(remap_from_read_ildg_data, char*,data, char*,buf, int,nbytes_per_site)
+  {
+    GET_THREAD_ID();
+    
+    NISSA_PARALLEL_LOOP(idest,0,loc_vol)
+      {
+	int64_t isour=0;
+	for(int mu=0;mu<NDIM;mu++)
+	  {
+	    int nu=scidac_mapping[mu];
+	    isour=isour*loc_size[nu]+loc_coord_of_loclx[idest][nu];
+	  }
+	memcpy(data+nbytes_per_site*idest,buf+nbytes_per_site*isour,nbytes_per_site);
+      }
+    THREAD_BARRIER();
+  }
+  THREADABLE_FUNCTION_END
+  
+  //start reading in background the data in the ILDG order located at the given position
+  //the file is taken over by the pending read, and is closed when this is finished
+  void ILDG_File_start_async_read_ildg_data_all(ILDG_async_read_t &r,ILDG_File &file,ILDG_Offset pos,uint64_t data_length)
+  {
+    r.file=file;
+    file=MPI_FILE_NULL;
+    r.data_length=data_length;
+    r.buf=nissa_malloc("async_buf",data_length/nranks,char);
+    
+    //create scidac view starting from the data position and set it
+    ILDG_File_set_position(r.file,pos,MPI_SEEK_SET);
+    r.view=ILDG_File_create_scidac_mapped_view(r.file,data_length/glb_vol);
+    ILDG_File_set_view(r.file,r.view);
+    
+    //start reading
+    r.start_time=take_time();
+    decript_MPI_error(MPI_File_iread_at(r.file,0,r.buf,loc_vol,r.view.etype,&r.request),"while starting to read");
+  }
+  
+  //wait for the read to be finished, close the file and reorder the data
+  void ILDG_File_finish_async_read_ildg_data_all(void *data,ILDG_async_read_t &r)
+  {
+    decript_MPI_error(MPI_Wait(&r.request,&r.status),"while waiting read");
+    
+    //count read bytes
+    size_t nbytes_read=MPI_Get_count_size_t(r.status);
+    if((uint64_t)nbytes_read!=r.data_length/nranks) crash("read %u bytes instead than %u",nbytes_read,r.data_length/nranks);
+    
+    //close
+    unset_mapped_types(r.view.etype,r.view.ftype);
+    ILDG_File_close(r.file);
+    
+    //reorder and free the staging buffer
+    remap_from_read_ildg_data((char*)data,r.buf,r.data_length/glb_vol);
+    nissa_free(r.buf);
+    
+    verbosity_lv2_master_printf("ildg data record read in background: %lld bytes, %lg s since start\n",r.data_length,take_time()-r.start_time);
+  }
+#endif
+  
   ////////////////////////////////////// external writing interfaces //////////////////////////////////////
   
   //remap to ildg
@@ -695,6 +759,95 @@ namespace nissa
       }
   }
   
+  //write the header of a binary data record and skip its content, which will be written later at the returned position
+  ILDG_Offset ILDG_File_reserve_ildg_data_all(ILDG_File &file,ILDG_Offset nbytes_per_site,const char *type)
+  {
+    //prepare the header and write it
+    const uint64_t data_length=nbytes_per_site*glb_vol;
+    ILDG_header header=ILDG_File_build_record_header(0,0,type,data_length);
+    ILDG_File_write_record_header(file,header);
+    
+    //skip the data
+    ILDG_Offset pos=ILDG_File_get_position(file);
+    ILDG_File_skip_nbytes(file,data_length);
+    
+    //pad if necessary
+    size_t pad_diff=header.data_length%8;
+    if(pad_diff!=0)
+      {
+	char buf[8];
+	memset(buf,0,8);
+	ILDG_File_master_write(file,(void*)buf,8-pad_diff);
+      }
+    
+    return pos;
+  }
+  
+#ifdef USE_MPI_IO
+  //start writing in background the data in the ILDG order at the given position
+  //the file is taken over by the pending write, and is closed when this is finished
+  void ILDG_File_start_async_write_ildg_data_all_raw(ILDG_async_write_t &w,ILDG_File &file,ILDG_Offset pos,void *data,uint64_t data_length)
+  {
+    w.file=file;
+    file=MPI_FILE_NULL;
+    w.data_length=data_length;
+    w.completed=false;
+    
+    //reorder into the staging buffer, so that data can be changed as soon as this function returns
+    w.buf=nissa_malloc("async_buf",data_length/nranks,char);
+    remap_to_write_ildg_data(w.buf,(char*)data,data_length/glb_vol);
+    
+    //create scidac view starting from the data position and set it
+    ILDG_File_set_position(w.file,pos,MPI_SEEK_SET);
+    w.view=ILDG_File_create_scidac_mapped_view(w.file,data_length/glb_vol);
+    ILDG_File_set_view(w.file,w.view);
+    
+    //start writing
+    w.start_time=take_time();
+    decript_MPI_error(MPI_File_iwrite_at(w.file,0,w.buf,loc_vol,w.view.etype,&w.request),"while starting to write");
+  }
+  
+  //check if the write has been completed on all ranks, letting it progress
+  bool ILDG_File_async_write_completed(ILDG_async_write_t &w)
+  {
+    if(not w.completed) decript_MPI_error(MPI_Test(&w.request,&w.completed,&w.status),"while testing write");
+    
+    int all_completed=w.completed;
+    MPI_Allreduce(MPI_IN_PLACE,&all_completed,1,MPI_INT,MPI_LAND,MPI_COMM_WORLD);
+    
+    return all_completed;
+  }
+  
+  //wait for the write to be finished, close the file, move it to its final path and free the staging buffer
+  void ILDG_File_finish_async_write(ILDG_async_write_t &w)
+  {
+    if(not w.completed) decript_MPI_error(MPI_Wait(&w.request,&w.status),"while waiting write");
+    w.completed=true;
+    
+    //count wrote bytes
+    size_t nbytes_written=MPI_Get_count_size_t(w.status);
+    if((uint64_t)nbytes_written!=w.data_length/nranks) crash("written %u bytes instead than %u",nbytes_written,w.data_length/nranks);
+    
+    //sync and close
+    MPI_File_sync(w.file);
+    unset_mapped_types(w.view.etype,w.view.ftype);
+    ILDG_File_close(w.file);
+    nissa_free(w.buf);
+    
+    //the file is complete, so it can replace the previous one
+    if(rank==0 and rename(w.temp_path.c_str(),w.path.c_str()))
+      crash("renaming '%s' into '%s': %s",w.temp_path.c_str(),w.path.c_str(),strerror(errno));
+    MPI_Barrier(MPI_COMM_WORLD);
+    
+    //compute the bandwidth, which includes the time passed before noticing the completion
+    double time=take_time()-w.start_time;
+    nbytes_written_async+=w.data_length;
+    time_writing_async+=time;
+    verbosity_lv1_master_printf("Finished writing in background file '%s': %lg MB in %lg s, %lg MB/s\n",
+				w.path.c_str(),w.data_length*1e-6,time,w.data_length*1e-6/time);
+  }
+#endif
+  
   //write a record
   void ILDG_File_write_record(ILDG_File &file,const char *type,const char *ext_buf,uint64_t ext_len)
   {
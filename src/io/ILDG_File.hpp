@@ -76,6 +76,39 @@ namespace nissa
     char format[100];
   };
   
+#ifdef USE_MPI_IO
+  //write of the binary data of a record proceeding in background
+  struct ILDG_async_write_t
+  {
+    std::string path;
+    std::string temp_path;
+    ILDG_File file;
+    ILDG_File_view view;
+    MPI_Request request;
+    MPI_Status status;
+    int completed;
+    char *buf;
+    uint64_t data_length;
+    double start_time;
+  };
+  
+  //read of the binary data of a record proceeding in background
+  struct ILDG_async_read_t
+  {
+    ILDG_File file;
+    ILDG_File_view view;
+    MPI_Request request;
+    MPI_Status status;
+    char *buf;
+    uint64_t data_length;
+    double start_time;
+  };
+#endif
+  
+  //statistics of background writes
+  EXTERN_ILDG uint64_t nbytes_written_async INIT_TO(0);
+  EXTERN_ILDG double time_writing_async INIT_TO(0);
+  
 #ifdef USE_MPI_IO
   ILDG_File ILDG_File_open(const std::string &path,int amode);
 #else
@@ -104,6 +137,10 @@ namespace nissa
   void ILDG_File_read_all(void *data,ILDG_File &file,size_t nbytes_req);
   void ILDG_File_read_checksum(checksum check_read,ILDG_File &file);
   void ILDG_File_read_ildg_data_all(void *data,ILDG_File &file,ILDG_header &header);
+#ifdef USE_MPI_IO
+  void ILDG_File_start_async_read_ildg_data_all(ILDG_async_read_t &r,ILDG_File &file,ILDG_Offset pos,uint64_t data_length);
+  void ILDG_File_finish_async_read_ildg_data_all(void *data,ILDG_async_read_t &r);
+#endif
   void ILDG_File_seek_to_next_eight_multiple(ILDG_File &file);
   void ILDG_File_set_position(ILDG_File &file,ILDG_Offset pos,int amode);
   void ILDG_File_set_view(ILDG_File &file,ILDG_File_view &view);
@@ -112,6 +149,12 @@ namespace nissa
   void ILDG_File_write_checksum(ILDG_File &file,checksum check);
   void ILDG_File_write_ildg_data_all_raw(ILDG_File &file,void *data,uint64_t data_length);
   void ILDG_File_write_ildg_data_all(ILDG_File &file,void *data,ILDG_Offset nbytes_per_site,const char *type);
+  ILDG_Offset ILDG_File_reserve_ildg_data_all(ILDG_File &file,ILDG_Offset nbytes_per_site,const char *type);
+#ifdef USE_MPI_IO
+  void ILDG_File_start_async_write_ildg_data_all_raw(ILDG_async_write_t &w,ILDG_File &file,ILDG_Offset pos,void *data,uint64_t data_length);
+  bool ILDG_File_async_write_completed(ILDG_async_write_t &w);
+  void ILDG_File_finish_async_write(ILDG_async_write_t &w);
+#endif
   void ILDG_File_write_record_header(ILDG_File &file,ILDG_header &header_to_write);
   void ILDG_File_write_record(ILDG_File &file,const char *type,const char *buf,uint64_t len);
   void ILDG_File_write_text_record(ILDG_File &file,const char *type,const char *text);
@@ -3,11 +3,13 @@
 #endif
 
 #include <stdint.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "base/debug.hpp"
 #include "endianness.hpp"
 #include "geometry/geometry_lx.hpp"
+#include "routines/parallel.hpp"
 
 namespace nissa
 {
@@ -66,10 +68,20 @@ namespace nissa
     0x2d02ef8dL
   };
   
-#define DO1(buf) crc=crc_table[((int)crc^(*buf++))&0xff]^(crc>>8);
-#define DO2(buf) DO1(buf);DO1(buf);
-#define DO4(buf) DO2(buf);DO2(buf);
-#define DO8(buf) DO4(buf);DO4(buf);
+  //tables for the slicing-by-8 computation of the crc: table k gives the crc of a byte followed by k zeros
+  struct crc_slice_tables_t
+  {
+    uint32_t t[8][256];
+    
+    crc_slice_tables_t()
+    {
+      for(int i=0;i<256;i++) t[0][i]=crc_table[i];
+      for(int k=1;k<8;k++)
+	for(int i=0;i<256;i++)
+	  t[k][i]=(t[k-1][i]>>8)^crc_table[t[k-1][i]&0xff];
+    }
+  };
+  static const crc_slice_tables_t crc_slice;
   
   uint32_t ildg_crc32(uint32_t crc,const unsigned char *buf,size_t len)
   {
@@ -77,15 +89,19 @@ namespace nissa
     
     crc^=0xffffffffL;
     
+    //process 8 bytes at the time
+    const uint32_t (*t)[256]=crc_slice.t;
     while(len>=8)
       {
-	DO8(buf);
+	uint32_t one=crc^(buf[0]|(buf[1]<<8)|(buf[2]<<16)|((uint32_t)buf[3]<<24));
+	uint32_t two=buf[4]|(buf[5]<<8)|(buf[6]<<16)|((uint32_t)buf[7]<<24);
+	crc=t[7][one&0xff]^t[6][(one>>8)&0xff]^t[5][(one>>16)&0xff]^t[4][one>>24]^
+	  t[3][two&0xff]^t[2][(two>>8)&0xff]^t[1][(two>>16)&0xff]^t[0][two>>24];
+	buf+=8;
 	len-=8;
       }
     
-    if(len)
-      do {DO1(buf);}
-      while(--len);
+    while(len--) crc=crc_table[(crc^(*buf++))&0xff]^(crc>>8);
     
     return crc^0xffffffffL;
   }
@@ -114,48 +130,119 @@ namespace nissa
       return ildg_crc32(crc,buf,len);
   }
   
+  //partial checksum of a set of sites, combined through xor
+  struct checksum_partial_t
+  {
+    uint32_t c[2];
+    
+    checksum_partial_t& operator+=(const checksum_partial_t &oth)
+    {
+      c[0]^=oth.c[0];
+      c[1]^=oth.c[1];
+      return *this;
+    }
+  };
+  
+  //contribution to the checksum of a site with the given crc
+  inline checksum_partial_t checksum_site_contribution(uint32_t glb_ivol,uint32_t crc)
+  {
+    uint32_t crc_rank[2]={glb_ivol%29,glb_ivol%31};
+    checksum_partial_t out;
+    for(int i=0;i<2;i++) out.c[i]=crc<<crc_rank[i]|crc>>(32-crc_rank[i]);
+    
+    return out;
+  }
+  
+  //global index of a local site in the ildg ordering
+  inline uint32_t ildg_glb_ivol_of_loclx(int ivol)
+  {
+    int *X=glb_coord_of_loclx[ivol];
+    uint32_t glb_ivol=X[0];
+    for(int mu=NDIM-1;mu>0;mu--) glb_ivol=glb_ivol*glb_size[mu]+X[mu];
+    
+    return glb_ivol;
+  }
+  
+  //sum the partial checksum over all ranks
+  void checksum_reduce(uint32_t *check,checksum_partial_t loc_check)
+  {MPI_Allreduce(loc_check.c,check,2,MPI_UNSIGNED,MPI_BXOR,MPI_COMM_WORLD);}
+  
   //compute the checksum of ildg data (little endianness, time is slower index)
   void checksum_compute_ildg_data(uint32_t *check,void *data,size_t bps)
   {
-    uint32_t loc_check[2]={0,0};
-    
-    NISSA_LOC_VOL_LOOP(ivol)
+    const checksum_partial_t zero={{0,0}};
+    checksum_partial_t loc_check=parallel_reduce(0,loc_vol,zero,[=](int ivol)
       {
 	int *x=loc_coord_of_loclx[ivol];
-	int *X=glb_coord_of_loclx[ivol];
-	uint32_t loc_ivol=x[0],glb_ivol=X[0];
-	for(int mu=NDIM-1;mu>0;mu--)
-	  {
-	    loc_ivol=loc_ivol*loc_size[mu]+x[mu];
-	    glb_ivol=glb_ivol*glb_size[mu]+X[mu];
-	  }
-	uint32_t crc_rank[2]={glb_ivol%29,glb_ivol%31};
-	
-	uint32_t temp=ildg_crc32(0,(unsigned char*)data+bps*loc_ivol,bps);
+	uint32_t loc_ivol=x[0];
+	for(int mu=NDIM-1;mu>0;mu--) loc_ivol=loc_ivol*loc_size[mu]+x[mu];
 	
-	for(int i=0;i<2;i++) loc_check[i]^=temp<<crc_rank[i]|temp>>(32-crc_rank[i]);
-      }
+	return checksum_site_contribution(ildg_glb_ivol_of_loclx(ivol),ildg_crc32(0,(unsigned char*)data+bps*loc_ivol,bps));
+      });
     
-    MPI_Allreduce(loc_check,check,2,MPI_UNSIGNED,MPI_BXOR,MPI_COMM_WORLD);
+    checksum_reduce(check,loc_check);
   }
   
   //compute the checksum of data as used by nissa (unspecified endianness, time is faster index)
   void checksum_compute_nissa_data(uint32_t *check,void *data,size_t bps,int prec)
   {
-    uint32_t loc_check[2]={0,0};
+    const checksum_partial_t zero={{0,0}};
+    checksum_partial_t loc_check=parallel_reduce(0,loc_vol,zero,[=](int ivol)
+      {return checksum_site_contribution(ildg_glb_ivol_of_loclx(ivol),ildg_crc32_fix_endianness(0,(unsigned char*)data+bps*ivol,bps,prec));});
+    
+    checksum_reduce(check,loc_check);
+  }
+  
+  //convert data as used by nissa to big endian with the given precision, computing at the same time the checksum
+  void convert_to_big_endian_and_checksum_nissa_data(char *out,uint32_t *check,double *in,size_t nreals_per_site,int prec)
+  {
+    if(prec!=32 and prec!=64) crash("unknown precision %d",prec);
+    const size_t bps=nreals_per_site*prec/8;
     
-    NISSA_LOC_VOL_LOOP(ivol)
+    const checksum_partial_t zero={{0,0}};
+    checksum_partial_t loc_check=parallel_reduce(0,loc_vol,zero,[=](int ivol)
       {
-	int *X=glb_coord_of_loclx[ivol];
-	uint32_t ildg_ivol=X[0];
-	for(int mu=NDIM-1;mu>0;mu--) ildg_ivol=ildg_ivol*glb_size[mu]+X[mu];
-	uint32_t crc_rank[2]={ildg_ivol%29,ildg_ivol%31};
+	unsigned char *site_out=(unsigned char*)out+bps*ivol;
+	double *site_in=in+nreals_per_site*ivol;
 	
-	uint32_t temp=ildg_crc32_fix_endianness(0,(unsigned char*)data+bps*ivol,bps,prec);
+	if(prec==64)
+	  {
+	    memcpy(site_out,site_in,bps);
+	    if(little_endian) change_endianness((double*)site_out,(double*)site_out,nreals_per_site,0);
+	  }
+	else
+	  {
+	    float *f=(float*)site_out;
+	    for(size_t ireal=0;ireal<nreals_per_site;ireal++) f[ireal]=(float)site_in[ireal];
+	    if(little_endian) change_endianness(f,f,nreals_per_site,0);
+	  }
 	
-	for(int i=0;i<2;i++) loc_check[i]^=temp<<crc_rank[i]|temp>>(32-crc_rank[i]);
-      }
+	return checksum_site_contribution(ildg_glb_ivol_of_loclx(ivol),ildg_crc32(0,site_out,bps));
+      });
+    
+    checksum_reduce(check,loc_check);
+  }
+  
+  //compute the checksum of big endian data ordered as used by nissa, converting it in place to the native endianness
+  void checksum_compute_and_convert_from_big_endian_nissa_data(uint32_t *check,void *data,size_t bps,int prec)
+  {
+    if(prec!=32 and prec!=64) crash("unknown precision %d",prec);
+    
+    const checksum_partial_t zero={{0,0}};
+    checksum_partial_t loc_check=parallel_reduce(0,loc_vol,zero,[=](int ivol)
+      {
+	unsigned char *site=(unsigned char*)data+bps*ivol;
+	uint32_t crc=ildg_crc32(0,site,bps);
+	
+	if(little_endian)
+	  {
+	    if(prec==64) change_endianness((double*)site,(double*)site,bps/sizeof(double),0);
+	    else change_endianness((float*)site,(float*)site,bps/sizeof(float),0);
+	  }
+	
+	return checksum_site_contribution(ildg_glb_ivol_of_loclx(ivol),crc);
+      });
     
-    MPI_Allreduce(loc_check,check,2,MPI_UNSIGNED,MPI_BXOR,MPI_COMM_WORLD);
+    checksum_reduce(check,loc_check);
   }
 }
@@ -12,6 +12,8 @@ namespace nissa
   uint32_t ildg_crc32_fix_endianess(uint32_t crc,const unsigned char *buf,size_t len);
   void checksum_compute_ildg_data(uint32_t *check,void *data,size_t bps);
   void checksum_compute_nissa_data(uint32_t *check,void *data,size_t bps,int prec);
+  void convert_to_big_endian_and_checksum_nissa_data(char *out,uint32_t *check,double *in,size_t nreals_per_site,int prec);
+  void checksum_compute_and_convert_from_big_endian_nissa_data(uint32_t *check,void *data,size_t bps,int prec);
 }
 
 #endif
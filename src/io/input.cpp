@@ -24,9 +24,12 @@
 #include "geometry/geometry_lx.hpp"
 #include "geometry/geometry_Leb.hpp"
 #include "geometry/geometry_vir.hpp"
+#include "inverters/multigrid/multigrid.hpp"
 #include "io/ILDG_File.hpp"
+#include "measures/fermions/stag.hpp"
 #include "new_types/high_prec.hpp"
 #include "new_types/su3.hpp"
+#include "operations/fft.hpp"
 #include "routines/ios.hpp"
 
 #define EXTERN_INPUT
@@ -413,9 +416,13 @@ namespace nissa
       void write()
       {
 	if(type=="%d"){verbosity_lv1_master_printf("%d",*((int*)pointer));return;}
+	if(type=="%lg"){verbosity_lv1_master_printf("%lg",*((double*)pointer));return;}
+	if(type=="%s"){verbosity_lv1_master_printf("%s",(char*)pointer);return;}
 	crash("unkwnon how to print %s",type.c_str());
       }
       const std::string get_tag(int &a){return "%d";}
+      const std::string get_tag(double &a){return "%lg";}
+      template <size_t N> const std::string get_tag(char (&a)[N]){return "%s";}
       
       template <class T> triple_tag(std::string name,T &val) : name(name),type(get_tag(val)),size(sizeof(T)),pointer(&val) {}
     };
@@ -429,17 +436,36 @@ namespace nissa
     std::vector<triple_tag> tags;
     tags.push_back(triple_tag("verbosity_lv",                  verbosity_lv));
     tags.push_back(triple_tag("use_128_bit_precision",         use_128_bit_precision));
+    tags.push_back(triple_tag("use_mixed_precision",           use_mixed_precision));
+    tags.push_back(triple_tag("use_pipelined_cg",              use_pipelined_cg));
+    tags.push_back(triple_tag("pipelined_cg_replace_each",     pipelined_cg_replace_each));
     tags.push_back(triple_tag("use_eo_geom",		       use_eo_geom));
     tags.push_back(triple_tag("use_Leb_geom",		       use_Leb_geom));
     tags.push_back(triple_tag("use_async_communications",      use_async_communications));
+    tags.push_back(triple_tag("overlap_comm_and_comp",         overlap_comm_and_comp));
     tags.push_back(triple_tag("warn_if_not_disallocated",      warn_if_not_disallocated));
     tags.push_back(triple_tag("warn_if_not_communicated",      warn_if_not_communicated));
+    tags.push_back(triple_tag("use_vect_pool",                 use_vect_pool));
     tags.push_back(triple_tag("set_t_nranks",		       fix_nranks[0]));
     tags.push_back(triple_tag("set_x_nranks",		       fix_nranks[1]));
     tags.push_back(triple_tag("set_y_nranks",		       fix_nranks[2]));
     tags.push_back(triple_tag("set_z_nranks",		       fix_nranks[3]));
     tags.push_back(triple_tag("ignore_ILDG_magic_number",      ignore_ILDG_magic_number));
     tags.push_back(triple_tag("perform_benchmark",             perform_benchmark));
+    tags.push_back(triple_tag("use_multigrid",                 mg::use_multigrid));
+    tags.push_back(triple_tag("mg_nvec",                       mg::nvec));
+    tags.push_back(triple_tag("mg_nsetup_iters",               mg::nsetup_iters));
+    tags.push_back(triple_tag("mg_nsetup_adaptive_iters",      mg::nsetup_adaptive_iters));
+    tags.push_back(triple_tag("mg_nsmooth",                    mg::nsmooth));
+    tags.push_back(triple_tag("mg_restart",                    mg::restart));
+    tags.push_back(triple_tag("mg_coarse_niter_max",           mg::coarse_niter_max));
+    tags.push_back(triple_tag("mg_coarse_residue",             mg::coarse_residue));
+    tags.push_back(triple_tag("mg_max_mass",                   mg::max_mass));
+    tags.push_back(triple_tag("mg_block_size_t",               mg::block_size[0]));
+    tags.push_back(triple_tag("mg_block_size_x",               mg::block_size[1]));
+    tags.push_back(triple_tag("mg_block_size_y",               mg::block_size[2]));
+    tags.push_back(triple_tag("mg_block_size_z",               mg::block_size[3]));
+    tags.push_back(triple_tag("stag_ndefl_eig",                stag::ndefl_eig));
 #ifdef USE_VNODES
     tags.push_back(triple_tag("vnode_paral_dir",	       vnode_paral_dir));
 #endif
@@ -458,6 +484,10 @@ namespace nissa
 #ifdef USE_HUGEPAGES
     tags.push_back(triple_tag("use_hugepages",		       use_hugepages));
 #endif
+#if FFT_TYPE == FFTW_FFT
+    tags.push_back(triple_tag("fftw_planning_rigor",           fftw_planning_rigor));
+    tags.push_back(triple_tag("fftw_wisdom_path",              fftw_wisdom_path));
+#endif
     
     if(file_exists(path))
       {
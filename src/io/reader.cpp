@@ -26,28 +26,15 @@ namespace nissa
 {
   //////////////////////////////////////////////////////////////////////////////////////////////////////////
   
-  //read a real vector
-  void read_real_vector(double *out,ILDG_File file,ILDG_header &header,uint64_t nreals_per_site)
+  //check the precision, change endianness, verify the checksum and convert to double a read real vector
+  void finalize_read_real_vector(double *out,checksum read_check,uint64_t nbytes_per_site_read,uint64_t nreals_per_site)
   {
-    //check the size of the data block
     int loc_nreals_tot=nreals_per_site*loc_vol;
-    uint64_t nbytes=header.data_length;
-    uint64_t nbytes_per_site_read=nbytes/glb_vol;
-    if(nbytes_per_site_read>nreals_per_site*sizeof(double))
-      crash("Opsss! The file contain %d bytes per site and it is supposed to contain not more than %d!",
-	    nbytes_per_site_read,nreals_per_site*sizeof(double));
-    
-    //read
-    ILDG_File_read_ildg_data_all(out,file,header);
     
     //check read size
     uint64_t nbytes_per_site_float=nreals_per_site*sizeof(float);
     uint64_t nbytes_per_site_double=nreals_per_site*sizeof(double);
     
-    //read the checksum
-    checksum read_check={0,0};
-    ILDG_File_read_checksum(read_check,file);
-    
     //check precision
     int single_double_flag=-1;
     const char single_double_str[2][10]={"single","double"};
@@ -58,23 +45,16 @@ namespace nissa
 	    nbytes_per_site_read,nbytes_per_site_float,nbytes_per_site_double);
     verbosity_lv3_master_printf("Vector is stored in %s precision\n",single_double_str[single_double_flag]);
     
-    //change endianess
-    if(little_endian)
-      {
-	verbosity_lv1_master_printf("Needs to change endianness!\n");
-	if(single_double_flag==0) change_endianness((float*)out,(float*)out,loc_nreals_tot);
-	else change_endianness(out,out,loc_nreals_tot);
-      }
+    //compute checksum and change endianess in a single pass
+    if(little_endian) verbosity_lv1_master_printf("Needs to change endianness!\n");
+    checksum comp_check;
+    checksum_compute_and_convert_from_big_endian_nissa_data(comp_check,out,nbytes_per_site_read,(single_double_flag+1)*32);
     
     //check the checksum
     if(read_check[0]!=0||read_check[1]!=0)
       {
 	master_printf("Checksums read:      %#010x %#010x\n",read_check[0],read_check[1]);
 	
-	//compute checksum
-	checksum comp_check;
-	checksum_compute_nissa_data(comp_check,out,nbytes_per_site_read,(single_double_flag+1)*32);
-	
 	//print the comparison between checksums
 	master_printf("Checksums computed:  %#010x %#010x\n",comp_check[0],comp_check[1]);
 	if((read_check[0]!=comp_check[0])||(read_check[1]!=comp_check[1]))
@@ -88,14 +68,34 @@ namespace nissa
     set_borders_invalid(out);
   }
   
-  //read a gauge conf
-  void read_ildg_gauge_conf(quad_su3 *conf,std::string path,ILDG_message *mess)
+  //check that the record can be stored in a vector with the given number of reals per site
+  void check_real_vector_record_size(ILDG_header &header,uint64_t nreals_per_site)
+  {
+    uint64_t nbytes_per_site_read=header.data_length/glb_vol;
+    if(nbytes_per_site_read>nreals_per_site*sizeof(double))
+      crash("Opsss! The file contain %d bytes per site and it is supposed to contain not more than %d!",
+	    nbytes_per_site_read,nreals_per_site*sizeof(double));
+  }
+  
+  //read a real vector
+  void read_real_vector(double *out,ILDG_File file,ILDG_header &header,uint64_t nreals_per_site)
   {
+    //check the size of the data block
+    check_real_vector_record_size(header,nreals_per_site);
+    
     //read
-    verbosity_lv1_master_printf("\nReading configuration from file: %s\n",path.c_str());
-    read_real_vector(conf,path,"ildg-binary-data",mess);
-    verbosity_lv2_master_printf("Configuration read!\n\n");
+    ILDG_File_read_ildg_data_all(out,file,header);
     
+    //read the checksum
+    checksum read_check={0,0};
+    ILDG_File_read_checksum(read_check,file);
+    
+    finalize_read_real_vector(out,read_check,header.data_length/glb_vol,nreals_per_site);
+  }
+  
+  //reorder a read gauge conf and check it
+  void finalize_read_ildg_gauge_conf(quad_su3 *conf)
+  {
     //reorder from ILDG
     quad_su3_ildg_to_nissa_reord_in_place(conf);
     
@@ -110,6 +110,101 @@ namespace nissa
     verbosity_lv1_master_printf("Deviation from unitarity: %lg average, %lg max\n",unitarity_check_result.average_diff,unitarity_check_result.max_diff);
   }
   
+#ifdef USE_MPI_IO
+  //gauge configuration being read in background
+  struct ildg_gauge_conf_prefetch_t
+  {
+    std::string path;
+    ILDG_message mess;
+    checksum read_check;
+    ILDG_async_read_t read;
+  };
+  
+  //at most one configuration is prefetched, to bound the used memory
+  ildg_gauge_conf_prefetch_t *prefetched_conf=NULL;
+#endif
+  
+  //wait for the prefetched conf, if any, and discard it
+  void drop_prefetched_ildg_gauge_conf()
+  {
+#ifdef USE_MPI_IO
+    if(prefetched_conf!=NULL)
+      {
+	verbosity_lv2_master_printf("Dropping prefetched configuration %s\n",prefetched_conf->path.c_str());
+	char *temp=nissa_malloc("temp",prefetched_conf->read.data_length/nranks,char);
+	ILDG_File_finish_async_read_ildg_data_all(temp,prefetched_conf->read);
+	nissa_free(temp);
+	ILDG_message_free_all(&prefetched_conf->mess);
+	delete prefetched_conf;
+	prefetched_conf=NULL;
+      }
+#endif
+  }
+  
+  //start reading a gauge conf in background, to be taken by read_ildg_gauge_conf
+  void start_prefetching_ildg_gauge_conf(std::string path)
+  {
+#ifdef USE_MPI_IO
+    drop_prefetched_ildg_gauge_conf();
+    verbosity_lv1_master_printf("Prefetching configuration from file: %s\n",path.c_str());
+    
+    ildg_gauge_conf_prefetch_t *p=new ildg_gauge_conf_prefetch_t;
+    p->path=path;
+    ILDG_message_init_to_last(&p->mess);
+    
+    //search the record, collecting the messages
+    ILDG_File file=ILDG_File_open_for_read(path);
+    ILDG_header header;
+    if(not ILDG_File_search_record(header,file,"ildg-binary-data",&p->mess)) crash("Error, record ildg-binary-data not found.\n");
+    check_real_vector_record_size(header,NDIM*NCOL*NCOL*2);
+    
+    //read the checksum, placed after the data
+    ILDG_Offset pos=ILDG_File_get_position(file);
+    ILDG_File_skip_record(file,header);
+    p->read_check[0]=p->read_check[1]=0;
+    ILDG_File_read_checksum(p->read_check,file);
+    
+    //start reading the data
+    ILDG_File_start_async_read_ildg_data_all(p->read,file,pos,header.data_length);
+    prefetched_conf=p;
+#endif
+  }
+  
+  //read a gauge conf
+  void read_ildg_gauge_conf(quad_su3 *conf,std::string path,ILDG_message *mess)
+  {
+#ifdef USE_MPI_IO
+    //take the conf from the prefetched one if possible
+    if(prefetched_conf!=NULL and prefetched_conf->path==path)
+      {
+	verbosity_lv1_master_printf("\nReading configuration prefetched from file: %s\n",path.c_str());
+	ildg_gauge_conf_prefetch_t *p=prefetched_conf;
+	prefetched_conf=NULL;
+	
+	ILDG_File_finish_async_read_ildg_data_all(conf,p->read);
+	finalize_read_real_vector((double*)conf,p->read_check,p->read.data_length/glb_vol,NDIM*NCOL*NCOL*2);
+	verbosity_lv2_master_printf("Configuration read!\n\n");
+	
+	//pass the messages
+	if(mess!=NULL) *ILDG_message_find_last(mess)=p->mess;
+	else ILDG_message_free_all(&p->mess);
+	delete p;
+	
+	finalize_read_ildg_gauge_conf(conf);
+	
+	return;
+      }
+    drop_prefetched_ildg_gauge_conf();
+#endif
+    
+    //read
+    verbosity_lv1_master_printf("\nReading configuration from file: %s\n",path.c_str());
+    read_real_vector(conf,path,"ildg-binary-data",mess);
+    verbosity_lv2_master_printf("Configuration read!\n\n");
+    
+    finalize_read_ildg_gauge_conf(conf);
+  }
+  
   ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   
   //read an ildg conf and split it into e/o parts
@@ -8,6 +8,8 @@ namespace nissa
 {
   void read_ildg_gauge_conf_and_split_into_eo_parts(quad_su3 **eo_conf,std::string path,ILDG_message *mess=NULL);
   void read_ildg_gauge_conf(quad_su3 *conf,std::string path,ILDG_message *mess=NULL);
+  void start_prefetching_ildg_gauge_conf(std::string path);
+  void drop_prefetched_ildg_gauge_conf();
   void read_real_vector(double *out,ILDG_File file,ILDG_header &header,uint64_t nreals_per_site);
   template <class T> void read_real_vector(T *out,ILDG_File file,ILDG_header &header)
   {read_real_vector((double*)out,file,header,sizeof(T)/sizeof(double));}
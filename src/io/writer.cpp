@@ -20,6 +20,15 @@
 
 namespace nissa
 {
+  //convert a vector of double to 32 or 64 bits, computing the checksum and changing endianness if needed
+  void prepare_real_vector_to_write(char *buffer,checksum check,double *data,size_t nreals_per_site,size_t nbits)
+  {
+    if(nbits!=32 && nbits!=64) crash("Error, asking %u precision, use instead 32 or 64\n",nbits);
+    
+    //convert and compute the checksum in a single pass
+    convert_to_big_endian_and_checksum_nissa_data(buffer,check,data,nreals_per_site,nbits);
+  }
+  
   //Write a vector of double, in 32 or 64 bits according to the argument
   void write_real_vector(ILDG_File &file,double *data,size_t nreals_per_site,size_t nbits,const char *header_message,ILDG_message *mess=NULL)
   {
@@ -32,27 +41,13 @@ namespace nissa
     if(mess!=NULL) ILDG_File_write_all_messages(file,mess);
     
     //compute float or double site
-    size_t nreals_loc=nreals_per_site*loc_vol;
     size_t nbytes_per_real=nbits/8;
     size_t nbytes_per_site=nreals_per_site*nbytes_per_real;
     
     //buffer to reorder data in ILDG format and change endianness
-    char *buffer=nissa_malloc("buffer",nreals_loc*nbytes_per_real,char);
-    
-    //possibly reduce to 32 bit
-    if(nbits==64) parallel_memcpy(buffer,data,nreals_loc*nbytes_per_real);
-    else doubles_to_floats_same_endianness((float*)buffer,data,nreals_loc);
-    
-    //compute the checksum
+    char *buffer=nissa_malloc("buffer",nbytes_per_site*loc_vol,char);
     checksum check;
-    checksum_compute_nissa_data(check,buffer,nbytes_per_site,nbytes_per_real*8);
-    
-    //change endianness if needed
-    if(little_endian)
-      {
-	if(nbits==64) change_endianness((double*)buffer,(double*)buffer,nreals_loc);
-	else change_endianness((float*)buffer,(float*)buffer,nreals_loc);
-      }
+    prepare_real_vector_to_write(buffer,check,data,nreals_per_site,nbits);
     
     //write
     ILDG_File_write_ildg_data_all(file,buffer,nbytes_per_site,header_message);
@@ -103,14 +98,9 @@ namespace nissa
   
   ////////////////////////// gauge configuration writing /////////////////////////////
   
-  //Write the local part of the gauge configuration
-  void write_ildg_gauge_conf(std::string path,quad_su3 *in,size_t prec,ILDG_message *mess=NULL)
+  //write the record with the ildg format
+  void write_ildg_format_record(ILDG_File &file,size_t prec)
   {
-    double start_time=take_time();
-    
-    //Open the file
-    ILDG_File file=ILDG_File_open_for_write(path);
-    
 #if NDIM == 4
     //write the ildg-format field
     char ildg_format_message[1024];
@@ -129,6 +119,18 @@ namespace nissa
 	    prec,glb_size[3],glb_size[2],glb_size[1],glb_size[0]);
     ILDG_File_write_text_record(file,"ildg-format",ildg_format_message);
 #endif
+  }
+  
+  //Write the local part of the gauge configuration
+  void write_ildg_gauge_conf(std::string path,quad_su3 *in,size_t prec,ILDG_message *mess=NULL)
+  {
+    double start_time=take_time();
+    
+    //Open the file
+    ILDG_File file=ILDG_File_open_for_write(path);
+    
+    //write the ildg-format field
+    write_ildg_format_record(file,prec);
     
     //reorder in ILDG
     quad_su3_nissa_to_ildg_reord_in_place(in);
@@ -151,4 +153,45 @@ namespace nissa
     write_ildg_gauge_conf(path,lx_conf,prec,mess);
     nissa_free(lx_conf);
   }
+  
+#ifdef USE_MPI_IO
+  //paste the e/o parts and start writing the conf in background: the file is left open and closed when finishing the write
+  //data goes to a temporary file, renamed into path only when complete, so that an interrupted write does not spoil path
+  void start_async_paste_eo_parts_and_write_ildg_gauge_conf(ILDG_async_write_t &w,std::string path,quad_su3 **eo_conf,size_t prec,ILDG_message *mess=NULL)
+  {
+    double start_time=take_time();
+    
+    //Open the temporary file and write the ildg-format field
+    w.path=path;
+    w.temp_path=path+".writing";
+    ILDG_File file=ILDG_File_open_for_write(w.temp_path);
+    write_ildg_format_record(file,prec);
+    
+    //write all the messages
+    if(mess!=NULL) ILDG_File_write_all_messages(file,mess);
+    
+    //snapshot the conf and reorder in ILDG
+    quad_su3 *lx_conf=nissa_malloc("temp_conf",loc_vol,quad_su3);
+    paste_eo_parts_into_lx_vector(lx_conf,eo_conf);
+    quad_su3_nissa_to_ildg_reord_in_place(lx_conf);
+    
+    //convert into the buffer
+    size_t nreals_per_site=NDIM*NCOL*NCOL*2;
+    size_t nbytes_per_site=nreals_per_site*prec/8;
+    char *buffer=nissa_malloc("buffer",nbytes_per_site*loc_vol,char);
+    checksum check;
+    prepare_real_vector_to_write(buffer,check,(double*)lx_conf,nreals_per_site,prec);
+    nissa_free(lx_conf);
+    
+    //leave room for the data and append the checksum
+    ILDG_Offset pos=ILDG_File_reserve_ildg_data_all(file,nbytes_per_site,"ildg-binary-data");
+    ILDG_File_write_checksum(file,check);
+    
+    //start writing the data
+    ILDG_File_start_async_write_ildg_data_all_raw(w,file,pos,buffer,nbytes_per_site*glb_vol);
+    nissa_free(buffer);
+    
+    verbosity_lv2_master_printf("Time elapsed in starting to write gauge file '%s' in background: %f s\n",path.c_str(),take_time()-start_time);
+  }
+#endif
 }
@@ -33,6 +33,9 @@ namespace nissa
   }
   void write_ildg_gauge_conf(std::string path,quad_su3 *in,size_t prec,ILDG_message *mess=NULL);
   void write_spincolor(std::string path,spincolor *spinor,size_t prec);
+#ifdef USE_MPI_IO
+  void start_async_paste_eo_parts_and_write_ildg_gauge_conf(ILDG_async_write_t &w,std::string path,quad_su3 **eo_conf,size_t prec,ILDG_message *mess=NULL);
+#endif
 }
 
 #endif
@@ -2,6 +2,7 @@
  #include "config.hpp"
 #endif
 
+#include <algorithm>
 #include <string.h>
 #include <math.h>
 
@@ -15,6 +16,7 @@
 #include "new_types/su3_op.hpp"
 #include "routines/ios.hpp"
 #include "routines/mpi_routines.hpp"
+#include "routines/parallel.hpp"
 #ifdef USE_THREADS
  #include "routines/thread.hpp"
 #endif
@@ -22,13 +24,23 @@
  #include "bgq/intrinsic.hpp"
 #endif
 
+//vectorize the reductions of the fused kernels when openmp is available
+#ifdef _OPENMP
+ #define NISSA_PRAGMA(X) _Pragma(#X)
+ #define FUSED_SIMD_SUMM_REDUCTION(...) NISSA_PRAGMA(omp simd reduction(+:__VA_ARGS__))
+#else
+ #define FUSED_SIMD_SUMM_REDUCTION(...)
+#endif
+
+//number of doubles processed together by the fused kernels acting on many vectors
+#define FUSED_BLOCK_SIZE 1024
+
 namespace nissa
 {
   //set to zero
   void double_vector_init_to_zero(double *a,int n)
   {
-    GET_THREAD_ID();
-    NISSA_PARALLEL_LOOP(i,0,n) a[i]=0;
+    parallel_for(0,n,[=](int i){a[i]=0;});
     
     set_borders_invalid(a);
   }
@@ -36,8 +48,7 @@ namespace nissa
   //copy
   template <class T1,class T2> void internal_vector_copy(T1 *a,T2 *b,int n)
   {
-    GET_THREAD_ID();
-    NISSA_PARALLEL_LOOP(i,0,n) a[i]=b[i];
+    parallel_for(0,n,[=](int i){a[i]=b[i];});
     
     set_borders_invalid(a);
   }
@@ -47,6 +58,10 @@ namespace nissa
   {internal_vector_copy(a,b,n);}THREADABLE_FUNCTION_END
   THREADABLE_FUNCTION_3ARG(single_vector_to_double, double*,a, float*,b, int,n)
   {internal_vector_copy(a,b,n);}THREADABLE_FUNCTION_END
+  //a=a+b with b single
+  THREADABLE_FUNCTION_3ARG(double_vector_summassign_single_vector, double*,a, float*,b, int,n)
+  {GET_THREAD_ID();NISSA_PARALLEL_LOOP(i,0,n) a[i]+=b[i];set_borders_invalid(a);}
+  THREADABLE_FUNCTION_END
   //double to double
   THREADABLE_FUNCTION_3ARG(double_vector_copy, double*,a, double*,b, int,n)
   {internal_vector_copy(a,b,n);}THREADABLE_FUNCTION_END
@@ -54,8 +69,7 @@ namespace nissa
   //set to zero
   void single_vector_init_to_zero(float *a,int n)
   {
-    GET_THREAD_ID();
-    NISSA_PARALLEL_LOOP(i,0,n) a[i]=0;
+    parallel_for(0,n,[=](int i){a[i]=0;});
     
     set_borders_invalid(a);
   }
@@ -63,8 +77,7 @@ namespace nissa
   //copy
   void single_vector_copy(float *a,float *b,int n)
   {
-    GET_THREAD_ID();
-    NISSA_PARALLEL_LOOP(i,0,n) a[i]=b[i];
+    parallel_for(0,n,[=](int i){a[i]=b[i];});
     
     set_borders_invalid(a);
   }
@@ -191,6 +204,87 @@ namespace nissa
   }
   THREADABLE_FUNCTION_END
   
+  //scalar product of single vectors, accumulated in double
+  THREADABLE_FUNCTION_4ARG(double_accumulate_single_vector_glb_scalar_prod, double*,glb_res, float*,a, float*,b, int,n)
+  {
+    //perform thread summ
+    double loc_thread_res=0;
+    GET_THREAD_ID();
+    
+    NISSA_PARALLEL_LOOP(i,0,n)
+      loc_thread_res+=(double)a[i]*b[i];
+    
+    (*glb_res)=glb_reduce_double(loc_thread_res);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //scalar products of nvec vectors stored interleaved site by site, reduced all together
+  THREADABLE_FUNCTION_6ARG(double_vector_glb_scalar_prod_interleaved, double*,glb_res, double*,a, double*,b, int,nsites, int,nvec, int,ndoubles_per_site)
+  {
+    if(nvec>NISSA_MAX_NRHS) crash("asking to reduce %d interleaved vectors, maximum is %d",nvec,NISSA_MAX_NRHS);
+    GET_THREAD_ID();
+    
+#ifndef REPRODUCIBLE_RUN
+    //perform thread summ
+    double loc_thread_res[NISSA_MAX_NRHS];
+    for(int ivec=0;ivec<nvec;ivec++) loc_thread_res[ivec]=0;
+    
+    NISSA_PARALLEL_LOOP(isite,0,nsites)
+      for(int ivec=0;ivec<nvec;ivec++)
+	{
+	  const int off=(isite*nvec+ivec)*ndoubles_per_site;
+	  for(int i=0;i<ndoubles_per_site;i++) loc_thread_res[ivec]+=a[off+i]*b[off+i];
+	}
+    
+    //reduce among threads and then among nodes with a single call
+#ifdef USE_THREADS
+    double *thread_res=glb_threads_reduce_double_vect(loc_thread_res,nvec);
+    if(IS_MASTER_THREAD) glb_nodes_reduce_double_vect(thread_res,nvec);
+    THREAD_BARRIER();
+    for(int ivec=0;ivec<nvec;ivec++) glb_res[ivec]=thread_res[ivec];
+    THREAD_BARRIER();
+#else
+    glb_nodes_reduce_double_vect(glb_res,loc_thread_res,nvec);
+#endif
+    
+#else //reproducible run
+    
+    //perform thread summ
+    float_128 loc_thread_res[NISSA_MAX_NRHS];
+    for(int ivec=0;ivec<nvec;ivec++) float_128_put_to_zero(loc_thread_res[ivec]);
+    
+    NISSA_PARALLEL_LOOP(isite,0,nsites)
+      for(int ivec=0;ivec<nvec;ivec++)
+	{
+	  const int off=(isite*nvec+ivec)*ndoubles_per_site;
+	  for(int i=0;i<ndoubles_per_site;i++) float_128_summ_the_64_prod(loc_thread_res[ivec],a[off+i],b[off+i]);
+	}
+    
+    //drop back to double after reducing all threads and ranks
+    for(int ivec=0;ivec<nvec;ivec++)
+      {
+	float_128 temp;
+	glb_reduce_float_128(temp,loc_thread_res[ivec]);
+	glb_res[ivec]=temp[0];
+      }
+#endif
+  }
+  THREADABLE_FUNCTION_END
+  
+  //copy the vectors iin[i] of the nin stored interleaved in "in", into the vectors iout[i] of the nout interleaved in "out"
+  THREADABLE_FUNCTION_9ARG(double_vector_copy_interleaved, double*,out, int,nout, int*,iout, double*,in, int,nin, int*,iin, int,ncopy, int,nsites, int,ndoubles_per_site)
+  {
+    GET_THREAD_ID();
+    
+    NISSA_PARALLEL_LOOP(isite,0,nsites)
+      for(int icopy=0;icopy<ncopy;icopy++)
+	memcpy(out+(isite*nout+iout[icopy])*ndoubles_per_site,
+	       in+(isite*nin+iin[icopy])*ndoubles_per_site,ndoubles_per_site*sizeof(double));
+    
+    set_borders_invalid(out);
+  }
+  THREADABLE_FUNCTION_END
+  
   //summ all points
   THREADABLE_FUNCTION_3ARG(double_vector_glb_collapse, double*,glb_res, double*,a, int,n)
   {
@@ -284,6 +378,234 @@ namespace nissa
   }
   THREADABLE_FUNCTION_END
   
+  //start the global reduction of (a,b) and (c,d), computed in a single pass
+  //glb_res must be shared among threads, and is valid only after double_vector_glb_scalar_prods_wait
+  THREADABLE_FUNCTION_7ARG(double_vector_glb_scalar_prods_start, double*,glb_res, MPI_Request*,req, double*,a, double*,b, double*,c, double*,d, int,n)
+  {
+    //perform thread summ
+    double loc_thread_res[2]={0,0};
+    GET_THREAD_ID();
+    
+    NISSA_PARALLEL_LOOP(i,0,n)
+      {
+	loc_thread_res[0]+=a[i]*b[i];
+	loc_thread_res[1]+=c[i]*d[i];
+      }
+    
+#ifdef USE_THREADS
+    double *thread_res=glb_threads_reduce_double_vect(loc_thread_res,2);
+#else
+    double *thread_res=loc_thread_res;
+#endif
+    
+    //the master thread starts the reduction among nodes
+    if(IS_MASTER_THREAD)
+      {
+	glb_res[0]=thread_res[0];
+	glb_res[1]=thread_res[1];
+	glb_nodes_reduce_double_vect_start(req,glb_res,2);
+      }
+  }
+  THREADABLE_FUNCTION_END
+  
+  //wait for the reduction started with double_vector_glb_scalar_prods_start
+  THREADABLE_FUNCTION_1ARG(double_vector_glb_scalar_prods_wait, MPI_Request*,req)
+  {
+    GET_THREAD_ID();
+    if(IS_MASTER_THREAD)
+      {
+	glb_nodes_reduce_wait(req);
+	cache_flush();
+      }
+    THREAD_BARRIER();
+  }
+  THREADABLE_FUNCTION_END
+  
+  //update all the vectors of the pipelined cg in a single pass:
+  //z=q+beta*z, s=w+beta*s, p=r+beta*p, x+=alpha*p, r-=alpha*s, w-=alpha*z
+  THREADABLE_FUNCTION_10ARG(double_vector_pipelined_cg_update, double*,x, double*,r, double*,w, double*,p, double*,s, double*,z, double*,q, double,alpha, double,beta, int,n)
+  {
+    GET_THREAD_ID();
+    NISSA_PARALLEL_LOOP(i,0,n)
+      {
+	z[i]=q[i]+beta*z[i];
+	s[i]=w[i]+beta*s[i];
+	p[i]=r[i]+beta*p[i];
+	x[i]+=alpha*p[i];
+	r[i]-=alpha*s[i];
+	w[i]-=alpha*z[i];
+      }
+    
+    set_borders_invalid(x);
+    set_borders_invalid(r);
+    set_borders_invalid(w);
+    set_borders_invalid(p);
+    set_borders_invalid(s);
+    set_borders_invalid(z);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //a[]=b[]+c[]*d, computing (a,a) and, if e is not NULL, (a,e) in the same pass
+  THREADABLE_FUNCTION_7ARG(double_vector_summ_double_vector_prod_double_glb_scalar_prods, double*,glb_res, double*,a, double*,b, double*,c, double,d, double*,e, int,n)
+  {
+    GET_THREAD_ID();
+#ifndef REPRODUCIBLE_RUN
+    NISSA_CHUNK_WORKLOAD(start,chunk_load,end,0,n,THREAD_ID,NACTIVE_THREADS);
+    
+    double loc_norm2=0,loc_prod=0;
+    if(e==NULL)
+      {
+	FUSED_SIMD_SUMM_REDUCTION(loc_norm2)
+	for(int i=start;i<end;i++)
+	  {
+	    const double t=b[i]+c[i]*d;
+	    a[i]=t;
+	    loc_norm2+=t*t;
+	  }
+      }
+    else
+      {
+	FUSED_SIMD_SUMM_REDUCTION(loc_norm2,loc_prod)
+	for(int i=start;i<end;i++)
+	  {
+	    const double t=b[i]+c[i]*d;
+	    a[i]=t;
+	    loc_norm2+=t*t;
+	    loc_prod+=t*e[i];
+	  }
+      }
+    
+    glb_res[0]=glb_reduce_double(loc_norm2);
+    if(e!=NULL) glb_res[1]=glb_reduce_double(loc_prod);
+#else
+    //reductions must go through quadruple precision
+    NISSA_PARALLEL_LOOP(i,0,n) a[i]=b[i]+c[i]*d;
+    THREAD_BARRIER();
+    double_vector_glb_scalar_prod(glb_res,a,a,n);
+    if(e!=NULL) double_vector_glb_scalar_prod(glb_res+1,a,e,n);
+#endif
+    
+    set_borders_invalid(a);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //x[]+=omega*p[], r[]-=omega*s[], computing (r,r) in the same pass
+  THREADABLE_FUNCTION_7ARG(double_vector_cg_update_glb_norm2, double*,glb_norm2, double*,x, double*,r, double*,p, double*,s, double,omega, int,n)
+  {
+    GET_THREAD_ID();
+#ifndef REPRODUCIBLE_RUN
+    NISSA_CHUNK_WORKLOAD(start,chunk_load,end,0,n,THREAD_ID,NACTIVE_THREADS);
+    
+    double loc_norm2=0;
+    FUSED_SIMD_SUMM_REDUCTION(loc_norm2)
+    for(int i=start;i<end;i++)
+      {
+	x[i]+=omega*p[i];
+	const double t=r[i]-omega*s[i];
+	r[i]=t;
+	loc_norm2+=t*t;
+      }
+    
+    (*glb_norm2)=glb_reduce_double(loc_norm2);
+#else
+    NISSA_PARALLEL_LOOP(i,0,n)
+      {
+	x[i]+=omega*p[i];
+	r[i]-=omega*s[i];
+      }
+    THREAD_BARRIER();
+    double_vector_glb_scalar_prod(glb_norm2,r,r,n);
+#endif
+    
+    set_borders_invalid(x);
+    set_borders_invalid(r);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //sol[ishift][]-=betas[ishift]*ps[ishift][] for all running shifts, then r[]+=betaa*s[], computing (r,r)
+  //the range is processed in blocks, so that the vectors are read from memory once
+  THREADABLE_FUNCTION_10ARG(double_vector_cgm_update_sol_and_residue_glb_norm2, double*,glb_norm2, double**,sol, double**,ps, double*,betas, int*,run_flag, int,nshift, double*,r, double*,s, double,betaa, int,n)
+  {
+    GET_THREAD_ID();
+    NISSA_CHUNK_WORKLOAD(start,chunk_load,end,0,n,THREAD_ID,NACTIVE_THREADS);
+    
+    double loc_norm2=0;
+    for(int ibl=start;ibl<end;ibl+=FUSED_BLOCK_SIZE)
+      {
+	const int ebl=std::min(ibl+FUSED_BLOCK_SIZE,end);
+	
+	for(int ishift=0;ishift<nshift;ishift++)
+	  if(run_flag[ishift])
+	    {
+	      double *x=sol[ishift],*y=ps[ishift];
+	      const double c=-betas[ishift];
+	      for(int i=ibl;i<ebl;i++) x[i]+=c*y[i];
+	    }
+	
+#ifndef REPRODUCIBLE_RUN
+	FUSED_SIMD_SUMM_REDUCTION(loc_norm2)
+	for(int i=ibl;i<ebl;i++)
+	  {
+	    const double t=r[i]+betaa*s[i];
+	    r[i]=t;
+	    loc_norm2+=t*t;
+	  }
+#else
+	for(int i=ibl;i<ebl;i++) r[i]+=betaa*s[i];
+#endif
+      }
+    
+#ifndef REPRODUCIBLE_RUN
+    (*glb_norm2)=glb_reduce_double(loc_norm2);
+#else
+    THREAD_BARRIER();
+    double_vector_glb_scalar_prod(glb_norm2,r,r,n);
+#endif
+    
+    set_borders_invalid(r);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //p[]=r[]+alpha*p[] and ps[ishift][]=zfs[ishift]*r[]+alphas[ishift]*ps[ishift][] for all running shifts
+  //the range is processed in blocks, so that r is read from memory once
+  THREADABLE_FUNCTION_9ARG(double_vector_cgm_update_dirs, double*,p, double**,ps, double*,r, double,alpha, double*,zfs, double*,alphas, int*,run_flag, int,nshift, int,n)
+  {
+    GET_THREAD_ID();
+    NISSA_CHUNK_WORKLOAD(start,chunk_load,end,0,n,THREAD_ID,NACTIVE_THREADS);
+    
+    for(int ibl=start;ibl<end;ibl+=FUSED_BLOCK_SIZE)
+      {
+	const int ebl=std::min(ibl+FUSED_BLOCK_SIZE,end);
+	
+	for(int i=ibl;i<ebl;i++) p[i]=r[i]+alpha*p[i];
+	for(int ishift=0;ishift<nshift;ishift++)
+	  if(run_flag[ishift])
+	    {
+	      double *y=ps[ishift];
+	      const double c=zfs[ishift],e=alphas[ishift];
+	      for(int i=ibl;i<ebl;i++) y[i]=c*r[i]+e*y[i];
+	    }
+      }
+    
+    set_borders_invalid(p);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //a[]=b[]+c[]*d[ivec], for nvec vectors stored interleaved site by site
+  THREADABLE_FUNCTION_7ARG(double_vector_summ_double_vector_prod_double_interleaved, double*,a, double*,b, double*,c, double*,d, int,nsites, int,nvec, int,ndoubles_per_site)
+  {
+    GET_THREAD_ID();
+    NISSA_PARALLEL_LOOP(isite,0,nsites)
+      for(int ivec=0;ivec<nvec;ivec++)
+	{
+	  const int off=(isite*nvec+ivec)*ndoubles_per_site;
+	  for(int i=0;i<ndoubles_per_site;i++) a[off+i]=b[off+i]+c[off+i]*d[ivec];
+	}
+    
+    set_borders_invalid(a);
+  }
+  THREADABLE_FUNCTION_END
+  
   //a[]=b[]+c[]*d
   THREADABLE_FUNCTION_6ARG(double_vector_summ_double_vector_prod_double, double*,a, double*,b, double*,c, double,d, int,n, int,OPT)
   {
@@ -533,6 +855,23 @@ namespace nissa
   }
   THREADABLE_FUNCTION_END
   
+  //extract or insert the spincolor irhs of a vector with nrhs interleaved spincolor per site
+  THREADABLE_FUNCTION_4ARG(get_spincolor_from_multi_spincolor, spincolor*,out, spincolor*,in, int,irhs, int,nrhs)
+  {
+    GET_THREAD_ID();
+    NISSA_PARALLEL_LOOP(ivol,0,loc_vol) spincolor_copy(out[ivol],in[ivol*nrhs+irhs]);
+    set_borders_invalid(out);
+  }
+  THREADABLE_FUNCTION_END
+  
+  THREADABLE_FUNCTION_4ARG(put_spincolor_into_multi_spincolor, spincolor*,out, spincolor*,in, int,irhs, int,nrhs)
+  {
+    GET_THREAD_ID();
+    NISSA_PARALLEL_LOOP(ivol,0,loc_vol) spincolor_copy(out[ivol*nrhs+irhs],in[ivol]);
+    set_borders_invalid(out);
+  }
+  THREADABLE_FUNCTION_END
+  
   ////////////////// spincolor algebra/////////////////////
   
   THREADABLE_FUNCTION_3ARG(safe_dirac_prod_spincolor, spincolor*,out, dirac_matr*,m, spincolor*,in)
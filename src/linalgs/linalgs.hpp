@@ -1,6 +1,8 @@
 #ifndef _LINALGS_HPP
 #define _LINALGS_HPP
 
+#include <mpi.h>
+
 #include "base/thread_macros.hpp"
 #include "new_types/dirac.hpp"
 #include "new_types/float_128.hpp"
@@ -64,10 +66,17 @@ namespace nissa
   }
   
   void single_vector_glb_scalar_prod(float *res,float *a,float *b,int n);
+  void double_accumulate_single_vector_glb_scalar_prod(double *res,float *a,float *b,int n);
+  void double_vector_glb_scalar_prod_interleaved(double *res,double *a,double *b,int nsites,int nvec,int ndoubles_per_site);
+  void double_vector_copy_interleaved(double *out,int nout,int *iout,double *in,int nin,int *iin,int ncopy,int nsites,int ndoubles_per_site);
+  void double_vector_glb_scalar_prods_start(double *glb_res,MPI_Request *req,double *a,double *b,double *c,double *d,int n);
+  void double_vector_glb_scalar_prods_wait(MPI_Request *req);
+  void double_vector_pipelined_cg_update(double *x,double *r,double *w,double *p,double *s,double *z,double *q,double alpha,double beta,int n);
   void double_vector_glb_collapse(double *res,double *a,int n);
   void double_vector_copy(double *a,double *b,int n);
   void double_vector_to_single(float *a,double *b,int n);
   void single_vector_to_double(double *a,float *b,int n);
+  void double_vector_summassign_single_vector(double *a,float *b,int n);
   void double_vector_from_quadruple_vector(double *a,float_128 *b,int n);
   void quadruple_vector_from_double_vector(float_128 *a,double *b,int n);
   void double_vector_init_to_zero(double *a,int n);
@@ -85,6 +94,13 @@ namespace nissa
   void double_vector_summ_double_vector_prod_double(double *a,double *b,double *c,double d,int n,int OPT=0);
   inline void double_vector_summassign_double_vector_prod_double(double *a,double *b,double c,int n,int OPT=0)
   {double_vector_summ_double_vector_prod_double(a,a,b,c,n,OPT);}
+  void double_vector_summ_double_vector_prod_double_glb_scalar_prods(double *glb_res,double *a,double *b,double *c,double d,double *e,int n);
+  inline void double_vector_summ_double_vector_prod_double_glb_norm2(double *glb_norm2,double *a,double *b,double *c,double d,int n)
+  {double_vector_summ_double_vector_prod_double_glb_scalar_prods(glb_norm2,a,b,c,d,NULL,n);}
+  void double_vector_cg_update_glb_norm2(double *glb_norm2,double *x,double *r,double *p,double *s,double omega,int n);
+  void double_vector_cgm_update_sol_and_residue_glb_norm2(double *glb_norm2,double **sol,double **ps,double *betas,int *run_flag,int nshift,double *r,double *s,double betaa,int n);
+  void double_vector_cgm_update_dirs(double *p,double **ps,double *r,double alpha,double *zfs,double *alphas,int *run_flag,int nshift,int n);
+  void double_vector_summ_double_vector_prod_double_interleaved(double *a,double *b,double *c,double *d,int nsites,int nvec,int ndoubles_per_site);
   void float_128_vector_prod_double(float_128 *out,float_128 *in,double r,int n);
   void single_vector_summ_single_vector_prod_single(float *a,float *b,float *c,float d,int n,int OPT=0);
   void get_color_from_colorspinspin(color *out,colorspinspin *in,int id1,int id2);
@@ -92,12 +108,14 @@ namespace nissa
   void get_color_from_su3(color **out,su3 **in,int ic);
   void get_spincolor_from_colorspinspin(spincolor *out,colorspinspin *in,int id);
   void get_spincolor_from_su3spinspin(spincolor *out,su3spinspin *in,int id,int ic);
+  void get_spincolor_from_multi_spincolor(spincolor *out,spincolor *in,int irhs,int nrhs);
   void parallel_memcpy(void *out,void *in,int n);
   void put_color_into_su3(su3 **out,color **in,int ic);
   void put_color_into_colorspinspin(colorspinspin *out,color *in,int id1,int id2);
   void put_color_into_spincolor(spincolor *out,color *in,int id);
   void put_spincolor_into_colorspinspin(colorspinspin *out,spincolor *in,int id);
   void put_spincolor_into_su3spinspin(su3spinspin *out,spincolor *in,int id,int ic);
+  void put_spincolor_into_multi_spincolor(spincolor *out,spincolor *in,int irhs,int nrhs);
   void quadruple_accumulate_double_vector_glb_scalar_prod(float_128 a,double *b,double *c,int n);
   void quadruple_vector_glb_scalar_prod(float_128 a,float_128 *b,float_128 *c,int n);
   void quadruple_vector_subt_from_double_vector(float_128 *a,double *b,float_128 *c,int n);
@@ -8,11 +8,13 @@
 #include "geometry/geometry_eo.hpp"
 #include "hmc/backfield.hpp"
 #include "hmc/theory_pars.hpp"
+#include "inverters/staggered/cg_deflated_invert_stD2ee_m2.hpp"
 #include "inverters/staggered/cg_invert_stD.hpp"
 #include "linalgs/linalgs.hpp"
 #include "new_types/su3.hpp"
 #include "measures/fermions/fermionic_meas.hpp"
 
+#define EXTERN_STAG
 #include "stag.hpp"
 
 #ifdef USE_THREADS
@@ -169,11 +171,53 @@ namespace nissa
     }
     THREADABLE_FUNCTION_END
     
+    //low modes of D2ee on the current conf, one subspace per backfield, shared by all hits and masses
+    deflation_subspace_t defl_subspace[STAG_MAX_DEFL_SUBSPACES];
+    quad_u1 **defl_u1b[STAG_MAX_DEFL_SUBSPACES];
+    int ndefl_subspaces=0;
+    
+    //drop the low modes, to be called when the conf changes
+    void invalidate_deflation()
+    {
+      GET_THREAD_ID();
+      
+      for(int isub=0;isub<ndefl_subspaces;isub++) defl_subspace[isub].destroy();
+      THREAD_BARRIER();
+      if(IS_MASTER_THREAD) ndefl_subspaces=0;
+      THREAD_BARRIER();
+    }
+    
+    //return the low modes for the passed backfield, computing them if not yet available
+    deflation_subspace_t &get_deflation_subspace(quad_su3 **conf,quad_u1 **u1b,double m,double residue)
+    {
+      GET_THREAD_ID();
+      
+      int isub=0;
+      while(isub<ndefl_subspaces and defl_u1b[isub]!=u1b) isub++;
+      
+      if(isub==ndefl_subspaces)
+	{
+	  if(isub==STAG_MAX_DEFL_SUBSPACES) crash("too many backfields to deflate, maximum is %d",STAG_MAX_DEFL_SUBSPACES);
+	  
+	  find_deflation_subspace_stD2ee_m2(defl_subspace[isub],ndefl_eig,conf,m*m,residue);
+	  THREAD_BARRIER();
+	  if(IS_MASTER_THREAD)
+	    {
+	      defl_u1b[isub]=u1b;
+	      ndefl_subspaces++;
+	    }
+	  THREAD_BARRIER();
+	}
+      
+      return defl_subspace[isub];
+    }
+    
     //multiply by M^-1
     THREADABLE_FUNCTION_6ARG(mult_Minv, color**,prop, quad_su3**,conf, quad_u1**,u1b, double,m, double,residue, color**,source)
     {
       add_backfield_with_stagphases_to_conf(conf,u1b);
-      inv_stD_cg(prop,conf,m,100000,residue,source);
+      if(ndefl_eig==0) inv_stD_cg(prop,conf,m,100000,residue,source);
+      else inv_stD_cg_deflated(prop,get_deflation_subspace(conf,u1b,m,residue),conf,m,100000,residue,source);
       rem_backfield_with_stagphases_from_conf(conf,u1b);
     }
     THREADABLE_FUNCTION_END
@@ -5,6 +5,16 @@
 #include "base/vectors.hpp"
 #include "hmc/theory_pars.hpp"
 
+#ifndef EXTERN_STAG
+ #define EXTERN_STAG extern
+ #define INIT_STAG_TO(var)
+#else
+ #define INIT_STAG_TO(var) =var
+#endif
+
+//maximal number of backfields for which the low modes are kept at the same time
+#define STAG_MAX_DEFL_SUBSPACES 8
+
 namespace nissa
 {
   //form the mask for x (-1)^[x*(s^<+n^>)]
@@ -33,6 +43,9 @@ namespace nissa
   
   namespace stag
   {
+    //number of low modes of D2ee to deflate in mult_Minv, which can be changed from the input file
+    EXTERN_STAG int ndefl_eig INIT_STAG_TO(0);
+    
     typedef color* field_t[2];
 #define NEW_FIELD_T(A)					\
     field_t A;						\
@@ -67,6 +80,7 @@ namespace nissa
     void compute_fw_bw_der_mel(complex *res_fw_bw,color **left,quad_su3 **conf,int mu,color **right,complex *point_result);
     void mult_Minv(color **prop,quad_su3 **conf,quad_u1 **u1b,double m,double residue,color **source);
     void mult_Minv(color **prop,quad_su3 **conf,theory_pars_t *pars,int iflav,double residue,color **source);
+    void invalidate_deflation();
     void mult_dMdmu(color **out,theory_pars_t *theory_pars,quad_su3 **conf,int iflav,int ord,color **in);
     void insert_external_source_handle(complex out,spin1field **aux,int par,int ieo,int mu,void *pars);
     void insert_vector_vertex(color **out,quad_su3 **conf,theory_pars_t *theory_pars,int iflav,spin1field **curr,color **in,complex fact_fw,complex fact_bw,void(*get_curr)(complex out,spin1field **curr,int par,int ieo,int mu,void *pars),int t,void *pars=NULL);
@@ -110,4 +124,7 @@ namespace nissa
   }
 }
 
+#undef EXTERN_STAG
+#undef INIT_STAG_TO
+
 #endif
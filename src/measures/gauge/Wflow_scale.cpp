@@ -0,0 +1,49 @@
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include "base/vectors.hpp"
+#include "geometry/geometry_mix.hpp"
+#include "operations/smearing/Wflow.hpp"
+#include "routines/ios.hpp"
+
+#include "Wflow_scale.hpp"
+
+namespace nissa
+{
+  //flow adaptively until t0 and w0 are reached, and print them
+  void measure_Wflow_scale(Wflow_scale_meas_pars_t &pars,quad_su3 **conf_eo,int iconf,bool conf_created)
+  {
+    double time=-take_time();
+    
+    quad_su3 *conf=nissa_malloc("conf",loc_vol+bord_vol+edge_vol,quad_su3);
+    paste_eo_parts_into_lx_vector(conf,conf_eo);
+    
+    double t0,w0;
+    int nevals=0;
+    Wflow_lx_conf_find_scales(&t0,&w0,conf,pars.Wflow.dt,pars.Wflow.tol,pars.F_ref,pars.max_flow_time,&nevals);
+    nissa_free(conf);
+    
+    FILE *file=open_file(pars.path,conf_created?"w":"a");
+    master_fprintf(file,"%d %16.16lg %16.16lg\n",iconf,t0,w0);
+    close_file(file);
+    
+    time+=take_time();
+    verbosity_lv1_master_printf("t0=%lg, w0=%lg, obtained with %d force evaluations in %lg s\n",t0,w0,nevals,time);
+  }
+  
+  std::string Wflow_scale_meas_pars_t::get_str(bool full)
+  {
+    std::ostringstream os;
+    
+    os<<"MeasWflowScale\n";
+    if(each!=def_each() or full) os<<" Each\t\t=\t"<<each<<"\n";
+    if(after!=def_after() or full) os<<" After\t\t=\t"<<after<<"\n";
+    if(path!=def_path() or full) os<<" Path\t\t=\t\""<<path.c_str()<<"\"\n";
+    if(F_ref!=def_F_ref() or full) os<<" FRef\t\t=\t"<<F_ref<<"\n";
+    if(max_flow_time!=def_max_flow_time() or full) os<<" MaxFlowTime\t=\t"<<max_flow_time<<"\n";
+    if(Wflow.is_nonstandard() or full) os<<" "<<Wflow.get_str(full);
+    
+    return os.str();
+  }
+}
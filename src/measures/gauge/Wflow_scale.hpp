@@ -0,0 +1,50 @@
+#ifndef _WFLOW_SCALE_HPP
+#define _WFLOW_SCALE_HPP
+
+#include "operations/smearing/Wflow.hpp"
+
+namespace nissa
+{
+  //parameters to set the scale through t0 and w0
+  struct Wflow_scale_meas_pars_t
+  {
+    int each;
+    int after;
+    std::string path;
+    Wflow_pars_t Wflow;
+    double F_ref;
+    double max_flow_time;
+    
+    int def_each(){return 1;}
+    int def_after(){return 0;}
+    std::string def_path(){return "Wflow_scale";}
+    double def_F_ref(){return 0.3;}
+    double def_max_flow_time(){return 20;}
+    
+    int is_nonstandard()
+    {
+      return
+	each!=def_each() or
+	after!=def_after() or
+	path!=def_path() or
+	F_ref!=def_F_ref() or
+	max_flow_time!=def_max_flow_time() or
+	Wflow.is_nonstandard();
+    }
+    
+    int master_fprintf(FILE *fout,bool full) {return nissa::master_fprintf(fout,"%s",get_str().c_str());}
+    std::string get_str(bool full=false);
+    
+    Wflow_scale_meas_pars_t() :
+      each(def_each()),
+      after(def_after()),
+      path(def_path()),
+      F_ref(def_F_ref()),
+      max_flow_time(def_max_flow_time())
+    {}
+  };
+  
+  void measure_Wflow_scale(Wflow_scale_meas_pars_t &pars,quad_su3 **conf_eo,int iconf,bool conf_created);
+}
+
+#endif
@@ -110,48 +110,120 @@ namespace nissa
   }
   THREADABLE_FUNCTION_END
   
-  //measure the topological charge site by site
-  THREADABLE_FUNCTION_2ARG(local_topological_charge, double*,charge, quad_su3*,conf)
+  //e/o version: X has parity par, A, B, D and F have the opposite one, C, E and G the same
+  void four_leaves_point(as2t_su3 leaves_summ,quad_su3 **conf,int par,int X)
   {
-    double norm_fact=1/(128*M_PI*M_PI);
-    
-    as2t_su3 *leaves=nissa_malloc("leaves",loc_vol,as2t_su3);
-    
-    vector_reset(charge);
+    if(!check_edges_valid(conf[EVN]) or !check_edges_valid(conf[ODD])) crash("communicate edges externally");
     
-    //compute the clover-shape paths
-    four_leaves(leaves,conf);
+    int opar=!par;
+    int munu=0;
+    for(int mu=0;mu<NDIM;mu++)
+      {
+	int A=loceo_neighup[par][X][mu];
+	int D=loceo_neighdw[par][X][mu];
+        
+	for(int nu=mu+1;nu<NDIM;nu++)
+	  {
+	    int B=loceo_neighup[par][X][nu];
+	    int F=loceo_neighdw[par][X][nu];
+            
+	    int C=loceo_neighup[opar][D][nu];
+	    int E=loceo_neighdw[opar][D][nu];
+            
+	    int G=loceo_neighdw[opar][A][nu];
+            
+	    su3 temp1,temp2;
+	    
+	    //Leaf 1
+	    unsafe_su3_prod_su3(temp1,conf[par][X][mu],conf[opar][A][nu]);
+	    unsafe_su3_prod_su3_dag(temp2,temp1,conf[opar][B][mu]);
+	    unsafe_su3_prod_su3_dag(leaves_summ[munu],temp2,conf[par][X][nu]);
+            
+	    //Leaf 2
+	    unsafe_su3_prod_su3_dag(temp1,conf[par][X][nu],conf[par][C][mu]);
+	    unsafe_su3_prod_su3_dag(temp2,temp1,conf[opar][D][nu]);
+	    unsafe_su3_prod_su3(temp1,temp2,conf[opar][D][mu]);
+	    su3_summ(leaves_summ[munu],leaves_summ[munu],temp1);
+            
+	    //Leaf 3
+	    unsafe_su3_dag_prod_su3_dag(temp1,conf[opar][D][mu],conf[par][E][nu]);
+	    unsafe_su3_prod_su3(temp2,temp1,conf[par][E][mu]);
+	    unsafe_su3_prod_su3(temp1,temp2,conf[opar][F][nu]);
+	    su3_summ(leaves_summ[munu],leaves_summ[munu],temp1);
+            
+	    //Leaf 4
+	    unsafe_su3_dag_prod_su3(temp1,conf[opar][F][nu],conf[opar][F][mu]);
+	    unsafe_su3_prod_su3(temp2,temp1,conf[par][G][nu]);
+	    unsafe_su3_prod_su3_dag(temp1,temp2,conf[par][X][mu]);
+	    su3_summ(leaves_summ[munu],leaves_summ[munu],temp1);
+            
+	    munu++;
+	  }
+      }
+  }
+  THREADABLE_FUNCTION_2ARG(four_leaves, as2t_su3**,leaves_summ, quad_su3**,conf)
+  {
+    GET_THREAD_ID();
+    communicate_eo_quad_su3_edges(conf);
+    for(int par=0;par<2;par++)
+      {
+	NISSA_PARALLEL_LOOP(ieo,0,loc_volh) four_leaves_point(leaves_summ[par][ieo],conf,par,ieo);
+	set_borders_invalid(leaves_summ[par]);
+      }
+  }
+  THREADABLE_FUNCTION_END
+  
+  //measure the topological charge of a single site, out of the clover-shape paths
+  double topological_charge_from_leaves_point(as2t_su3 leaves)
+  {
+    double norm_fact=1/(128*M_PI*M_PI);
     
     //list the three combinations of plans
-    int plan_id[3][2]={{0,5},{1,4},{2,3}};
-    int sign[3]={1,-1,1};
+    const int plan_id[3][2]={{0,5},{1,4},{2,3}};
+    const int sign[3]={1,-1,1};
     
     //loop on the three different combinations of plans
-    GET_THREAD_ID();
+    double charge=0;
     for(int iperm=0;iperm<3;iperm++)
       {
 	//take the index of the two plans
 	int ip0=plan_id[iperm][0];
 	int ip1=plan_id[iperm][1];
 	
-	NISSA_PARALLEL_LOOP(ivol,0,loc_vol)
-	  {
-	    //products
-	    su3 clock,aclock;
-	    unsafe_su3_prod_su3_dag(clock,leaves[ivol][ip0],leaves[ivol][ip1]);
-	    unsafe_su3_prod_su3(aclock,leaves[ivol][ip0],leaves[ivol][ip1]);
-	    
-	    //take the trace
-	    complex tclock,taclock;
-	    su3_trace(tclock,clock);
-	    su3_trace(taclock,aclock);
-	    
-	    //takes the combination with appropriate sign
-	    charge[ivol]+=sign[iperm]*(tclock[RE]-taclock[RE])*norm_fact;
-	  }
+	//products
+	su3 clock,aclock;
+	unsafe_su3_prod_su3_dag(clock,leaves[ip0],leaves[ip1]);
+	unsafe_su3_prod_su3(aclock,leaves[ip0],leaves[ip1]);
+	
+	//take the trace
+	complex tclock,taclock;
+	su3_trace(tclock,clock);
+	su3_trace(taclock,aclock);
+	
+	//takes the combination with appropriate sign
+	charge+=sign[iperm]*(tclock[RE]-taclock[RE])*norm_fact;
       }
     
+    return charge;
+  }
+  
+  //measure the topological charge site by site, out of the clover-shape paths
+  THREADABLE_FUNCTION_2ARG(local_topological_charge_from_leaves, double*,charge, as2t_su3*,leaves)
+  {
+    GET_THREAD_ID();
+    NISSA_PARALLEL_LOOP(ivol,0,loc_vol) charge[ivol]=topological_charge_from_leaves_point(leaves[ivol]);
     set_borders_invalid(charge);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //measure the topological charge site by site
+  THREADABLE_FUNCTION_2ARG(local_topological_charge, double*,charge, quad_su3*,conf)
+  {
+    as2t_su3 *leaves=nissa_malloc("leaves",loc_vol,as2t_su3);
+    
+    //compute the clover-shape paths
+    four_leaves(leaves,conf);
+    local_topological_charge_from_leaves(charge,leaves);
     
     nissa_free(leaves);
   }
@@ -167,16 +239,32 @@ namespace nissa
   }
   THREADABLE_FUNCTION_END
   
-  //wrapper for eos case
+  //e/o case starting from the leaves: the local charge is stored in lx order in the charge buffer (loc_vol), so
+  //that the sum is carried out as in the lx case
+  THREADABLE_FUNCTION_3ARG(total_topological_charge_from_leaves, double*,tot_charge, as2t_su3**,leaves, double*,charge)
+  {
+    GET_THREAD_ID();
+    
+    for(int par=0;par<2;par++)
+      NISSA_PARALLEL_LOOP(ieo,0,loc_volh)
+	charge[loclx_of_loceo[par][ieo]]=topological_charge_from_leaves_point(leaves[par][ieo]);
+    THREAD_BARRIER();
+    double_vector_glb_collapse(tot_charge,charge,loc_vol);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //e/o case
   THREADABLE_FUNCTION_2ARG(total_topological_charge_eo_conf, double*,tot_charge, quad_su3**,eo_conf)
   {
-    //convert to lx
-    quad_su3 *lx_conf=nissa_malloc("lx_conf",loc_vol+bord_vol+edge_vol,quad_su3);
-    paste_eo_parts_into_lx_vector(lx_conf,eo_conf);
+    as2t_su3 *leaves[2];
+    for(int par=0;par<2;par++) leaves[par]=nissa_malloc("leaves",loc_volh,as2t_su3);
+    double *charge=nissa_malloc("charge",loc_vol,double);
     
-    total_topological_charge_lx_conf(tot_charge,lx_conf);
+    four_leaves(leaves,eo_conf);
+    total_topological_charge_from_leaves(tot_charge,leaves,charge);
     
-    nissa_free(lx_conf);
+    nissa_free(charge);
+    for(int par=0;par<2;par++) nissa_free(leaves[par]);
   }
   THREADABLE_FUNCTION_END
   
@@ -314,12 +402,10 @@ namespace nissa
     fseek(file,ori+tot_data*sizeof(double),SEEK_SET);
   }
   
-  //measure the topological charge
-  void measure_topology_lx_conf(top_meas_pars_t &pars,quad_su3 *unsmoothed_conf,int iconf,bool conf_created,bool preserve_unsmoothed)
+  //open the files and allocate the remapper
+  topology_meas_t::topology_meas_t(top_meas_pars_t &pars,int iconf,bool conf_created) : pars(pars),iconf(iconf),corr_file(NULL),topo_corr_rem(NULL)
   {
-    //open the file and allocate remapper
-    FILE *file=open_file(pars.path,conf_created?"w":"a"),*corr_file=NULL;
-    vector_remap_t *topo_corr_rem=NULL;
+    file=open_file(pars.path,conf_created?"w":"a");
     if(pars.meas_corr)
       {
 	corr_file=fopen(pars.corr_path.c_str(),(conf_created or !file_exists(pars.corr_path))?"w":"r+");
@@ -327,9 +413,45 @@ namespace nissa
 	if(fseek(corr_file,0,SEEK_END)) crash("seeking to the end");
 	topo_corr_rem=new vector_remap_t(loc_vol,index_to_topo_corr_remapping,NULL);
       }
+    charge=nissa_malloc("charge",loc_vol,double);
+  }
+  
+  //measure the charge out of the clover-shape paths of the smoothed conf, with the given plaquette
+  void topology_meas_t::measure(as2t_su3 *leaves,int nsmooth,double plaq)
+  {
+    //local and total charge
+    local_topological_charge_from_leaves(charge,leaves);
+    double tot_charge;
+    double_vector_glb_collapse(&tot_charge,charge,loc_vol);
+    master_fprintf(file,"%d %d %+16.16lg %16.16lg\n",iconf,nsmooth,tot_charge,plaq);
+    
+    //correlators if asked
+    if(pars.meas_corr)
+      {
+	compute_topo_corr(charge);
+	store_topo_corr(corr_file,charge,iconf,tot_charge,topo_corr_rem);
+      }
+  }
+  
+  //close the files
+  topology_meas_t::~topology_meas_t()
+  {
+    nissa_free(charge);
+    close_file(file);
+    if(pars.meas_corr)
+      {
+	fclose(corr_file);
+	delete topo_corr_rem;
+      }
+  }
+  
+  //measure the topological charge
+  void measure_topology_lx_conf(top_meas_pars_t &pars,quad_su3 *unsmoothed_conf,int iconf,bool conf_created,bool preserve_unsmoothed)
+  {
+    topology_meas_t meas(pars,iconf,conf_created);
     
     //allocate a temorary conf to be smoothed
-    double *charge=nissa_malloc("charge",loc_vol,double);
+    as2t_su3 *leaves=nissa_malloc("leaves",loc_vol,as2t_su3);
     quad_su3 *smoothed_conf;
     if(preserve_unsmoothed)
       {
@@ -342,35 +464,18 @@ namespace nissa
     bool finished;
     do
       {
-	//plaquette and local charge
+	//plaquette and charge
 	double plaq=global_plaquette_lx_conf(smoothed_conf);
-	local_topological_charge(charge,smoothed_conf);
-	//total charge
-	double tot_charge;
-	double_vector_glb_collapse(&tot_charge,charge,loc_vol);
-	total_topological_charge_lx_conf(&tot_charge,smoothed_conf);
-	master_fprintf(file,"%d %d %+16.16lg %16.16lg\n",iconf,nsmooth,tot_charge,plaq);
-	finished=smooth_lx_conf_until_next_meas(smoothed_conf,pars.smooth_pars,nsmooth);
+	four_leaves(leaves,smoothed_conf);
+	meas.measure(leaves,nsmooth,plaq);
 	
-	//correlators if asked
-	if(pars.meas_corr)
-	  {
-	    compute_topo_corr(charge);
-	    store_topo_corr(corr_file,charge,iconf,tot_charge,topo_corr_rem);
-	  }
+	finished=smooth_lx_conf_until_next_meas(smoothed_conf,pars.smooth_pars,nsmooth);
       }
     while(!finished);
     
     //discard smoothed conf
     if(preserve_unsmoothed) nissa_free(smoothed_conf);
-    nissa_free(charge);
-    
-    close_file(file);
-    if(pars.meas_corr)
-      {
-	fclose(corr_file);
-	delete topo_corr_rem;
-      }
+    nissa_free(leaves);
   }
   
   void measure_topology_eo_conf(top_meas_pars_t &pars,quad_su3 **unsmoothed_conf_eo,int iconf,bool conf_created)
@@ -469,6 +574,93 @@ namespace nissa
   }
   THREADABLE_FUNCTION_END
   
+  //e/o version: leaves must be allocated by the caller with edges, and filled with four_leaves of conf, so that
+  //they can be kept across calls and used also to compute the charge; they are overwritten
+  THREADABLE_FUNCTION_3ARG(topological_staples_from_leaves, quad_su3**,staples, quad_su3**,conf, as2t_su3**,leaves)
+  {
+    GET_THREAD_ID();
+    
+    //takes the anti-symmetric part of the clover-shape paths (apart from a factor 2), as in the lx case
+    for(int par=0;par<2;par++)
+      NISSA_PARALLEL_LOOP(ieo,0,loc_volh)
+	for(int imunu=0;imunu<6;imunu++)
+	  {
+	    color *u=leaves[par][ieo][imunu];
+	    for(int ic1=0;ic1<NCOL;ic1++)
+	      for(int ic2=ic1;ic2<NCOL;ic2++)
+		{
+		  u[ic2][ic1][0]=-(u[ic1][ic2][0]=u[ic1][ic2][0]-u[ic2][ic1][0]);
+		  u[ic2][ic1][1]=+(u[ic1][ic2][1]=u[ic1][ic2][1]+u[ic2][ic1][1]);
+		}
+	  }
+    THREAD_BARRIER();
+    for(int par=0;par<2;par++) set_borders_invalid(leaves[par]);
+    communicate_eo_as2t_su3_edges(leaves);
+    
+    //list the plan and coefficients for each staples
+    int plan_perp[4][3]={{ 5, 4, 3},{ 5, 2, 1},{ 4, 2, 0},{ 3, 1, 0}};
+    int plan_sign[4][3]={{+1,-1,+1},{-1,+1,-1},{+1,-1,+1},{-1,+1,-1}};
+    
+    //A, C and E have parity p, B, D and F the opposite one
+    for(int p=0;p<2;p++)
+      {
+	int op=!p;
+	vector_reset(staples[p]);
+	NISSA_PARALLEL_LOOP(A,0,loc_volh)
+	  for(int mu=0;mu<NDIM;mu++) //link direction
+	    for(int inu=0;inu<NDIM-1;inu++)              //  E---F---C
+	      {                                          //  |   |   | mu
+		int nu=perp_dir[mu][inu];                //  D---A---B
+		//this gives the other pair element      //        nu
+		int iplan=plan_perp[mu][inu];
+		
+		//takes neighbours
+		int B=loceo_neighup[p][A][nu];
+		int C=loceo_neighup[op][B][mu];
+		int D=loceo_neighdw[p][A][nu];
+		int E=loceo_neighup[op][D][mu];
+		int F=loceo_neighup[p][A][mu];
+		
+		//compute ABC, BCF and the full SU(3) staple, ABCF
+		su3 ABC,BCF,ABCF;
+		unsafe_su3_prod_su3(ABC,conf[p][A][nu],conf[op][B][mu]);
+		unsafe_su3_prod_su3_dag(BCF,conf[op][B][mu],conf[op][F][nu]);
+		unsafe_su3_prod_su3_dag(ABCF,ABC,conf[op][F][nu]);
+		
+		//compute ADE, DEF and the full SU(3) staple, ADEF
+		su3 ADE,DEF,ADEF;
+		unsafe_su3_dag_prod_su3(ADE,conf[op][D][nu],conf[op][D][mu]);
+		unsafe_su3_prod_su3(DEF,conf[op][D][mu],conf[p][E][nu]);
+		unsafe_su3_prod_su3(ADEF,ADE,conf[p][E][nu]);
+		
+		//local summ and temp
+		su3 loc_staples,temp;
+		
+		//insert the leave in the four possible forward positions
+		unsafe_su3_prod_su3(loc_staples,leaves[p][A][iplan],ABCF);     //insertion on A
+		unsafe_su3_prod_su3(temp,conf[p][A][nu],leaves[op][B][iplan]);
+		su3_summ_the_prod_su3(loc_staples,temp,BCF);                   //insertion on B
+		unsafe_su3_prod_su3(temp,ABC,leaves[p][C][iplan]);
+		su3_summ_the_prod_su3_dag(loc_staples,temp,conf[op][F][nu]);   //insertion on C
+		su3_summ_the_prod_su3(loc_staples,ABCF,leaves[op][F][iplan]);  //insertion on F
+		
+		//insert the leave in the four possible backward positions
+		su3_summ_the_dag_prod_su3(loc_staples,leaves[p][A][iplan],ADEF);    //insertion on A
+		unsafe_su3_dag_prod_su3_dag(temp,conf[op][D][nu],leaves[op][D][iplan]);
+		su3_summ_the_prod_su3(loc_staples,temp,DEF);                        //insertion on D
+		unsafe_su3_prod_su3_dag(temp,ADE,leaves[p][E][iplan]);
+		su3_summ_the_prod_su3(loc_staples,temp,conf[p][E][nu]);             //insertion on E
+		su3_summ_the_prod_su3_dag(loc_staples,ADEF,leaves[op][F][iplan]);   //insertion on F
+		
+		//summ or subtract, according to the coefficient
+		if(plan_sign[mu][inu]==+1) su3_summassign(staples[p][A][mu],loc_staples);
+		else                       su3_subtassign(staples[p][A][mu],loc_staples);
+	      }
+	set_borders_invalid(staples[p]);
+      }
+  }
+  THREADABLE_FUNCTION_END
+  
   //store the topological charge if needed
   void topotential_pars_t::store_if_needed(quad_su3 **ext_conf,int iconf)
   {
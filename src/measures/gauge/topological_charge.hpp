@@ -1,6 +1,7 @@
 #ifndef _TOPOLOGICAL_CHARGE_HPP
 #define _TOPOLOGICAL_CHARGE_HPP
 
+#include "operations/remap_vector.hpp"
 #include "operations/smearing/smooth.hpp"
 
 #include "hmc/gauge/topological_action.hpp"
@@ -45,13 +46,34 @@ namespace nissa
     {}
   };
   
+  //files and buffers to measure the topology at successive smoothing levels of a conf
+  struct topology_meas_t
+  {
+    top_meas_pars_t &pars;
+    int iconf;
+    FILE *file,*corr_file;
+    vector_remap_t *topo_corr_rem;
+    double *charge;
+    
+    topology_meas_t(top_meas_pars_t &pars,int iconf,bool conf_created);
+    void measure(as2t_su3 *leaves,int nsmooth,double plaq);
+    ~topology_meas_t();
+  };
+  
   void four_leaves_point(as2t_su3 leaves_summ,quad_su3 *conf,int X);
+  void four_leaves(as2t_su3 *leaves_summ,quad_su3 *conf);
+  void four_leaves_point(as2t_su3 leaves_summ,quad_su3 **conf,int par,int X);
+  void four_leaves(as2t_su3 **leaves_summ,quad_su3 **conf);
   void measure_topology_eo_conf(top_meas_pars_t &pars,quad_su3 **unsmoothed_conf_eo,int iconf,bool conf_created);
   void measure_topology_lx_conf(top_meas_pars_t &pars,quad_su3 *unsmoothed_conf,int iconf,bool conf_created,bool preserve_unsmoothed);
   void local_topological_charge(double *charge,quad_su3 *conf);
+  double topological_charge_from_leaves_point(as2t_su3 leaves);
+  void local_topological_charge_from_leaves(double *charge,as2t_su3 *leaves);
+  void total_topological_charge_from_leaves(double *tot_charge,as2t_su3 **leaves,double *charge);
   void total_topological_charge_eo_conf(double *tot_charge,quad_su3 **eo_conf);
   void total_topological_charge_lx_conf(double *tot_charge,quad_su3 *lx_conf);
   void topological_staples(quad_su3 *staples,quad_su3 *conf);
+  void topological_staples_from_leaves(quad_su3 **staples,quad_su3 **conf,as2t_su3 **leaves);
 }
 
 #endif
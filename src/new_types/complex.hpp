@@ -104,6 +104,26 @@ namespace nissa
   }
   inline void complex_isubtassign(complex a,const complex b)
   {complex_isubt(a,a,b);}
+  inline void single_complex_summ(single_complex a,const single_complex b,const single_complex c)
+  {
+    a[0]=b[0]+c[0];
+    a[1]=b[1]+c[1];
+  }
+  inline void single_complex_isumm(single_complex a,const single_complex b,const single_complex c)
+  {
+    a[0]=b[0]-c[1];
+    a[1]=b[1]+c[0];
+  }
+  inline void single_complex_subt(single_complex a,const single_complex b,const single_complex c)
+  {
+    a[0]=b[0]-c[0];
+    a[1]=b[1]-c[1];
+  }
+  inline void single_complex_isubt(single_complex a,const single_complex b,const single_complex c)
+  {
+    a[0]=b[0]+c[1];
+    a[1]=b[1]-c[0];
+  }
   inline void complex_subt_conj2(complex a,const complex b,const complex c)
   {
     a[0]=b[0]-c[0];
@@ -181,6 +201,12 @@ namespace nissa
     a[1]-=b[0]*c[1]+b[1]*c[0];
     a[0]-=t;
   }
+  inline void single_complex_subt_the_prod(single_complex a,const single_complex b,const single_complex c)
+  {
+    const double t=b[0]*c[0]-b[1]*c[1];
+    a[1]-=b[0]*c[1]+b[1]*c[0];
+    a[0]-=t;
+  }
   inline void complex_summ_the_conj2_prod(complex a,const complex b,const complex c)
   {
     const double t=+b[0]*c[0]+b[1]*c[1];
@@ -267,6 +293,11 @@ namespace nissa
   //Swapped order
   inline void unsafe_complex_conj1_prod(complex a,const complex b,const complex c)
   {unsafe_complex_conj2_prod(a,c,b);}
+  inline void unsafe_single_complex_conj1_prod(single_complex a,const single_complex b,const single_complex c)
+  {
+    a[0]=+b[0]*c[0]+b[1]*c[1];
+    a[1]=+b[0]*c[1]-b[1]*c[0];
+  }
   inline void unsafe_complex_conj1_prod_minus(complex a,const complex b,const complex c)
   {unsafe_complex_conj2_prod_minus(a,c,b);}
   
@@ -11,6 +11,9 @@
 #include "complex.hpp"
 
 #define NISSA_DEFAULT_USE_128_BIT_PRECISION 0
+#define NISSA_DEFAULT_USE_MIXED_PRECISION 0
+#define NISSA_DEFAULT_USE_PIPELINED_CG 0
+#define NISSA_DEFAULT_PIPELINED_CG_REPLACE_EACH 50
 
 #if defined(__ICC)
 #pragma optimize("", off)
@@ -19,6 +22,9 @@
 namespace nissa
 {
   EXTERN_FLOAT_128 int use_128_bit_precision;
+  EXTERN_FLOAT_128 int use_mixed_precision;
+  EXTERN_FLOAT_128 int use_pipelined_cg;
+  EXTERN_FLOAT_128 int pipelined_cg_replace_each;
   
   //quadruple precision float
   typedef double float_128[2];
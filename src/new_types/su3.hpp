@@ -45,6 +45,10 @@ namespace nissa
   typedef single_color single_halfspincolor[2];
   typedef single_color single_spincolor[NDIRAC];
   typedef single_su3 single_quad_su3[NDIRAC];
+  typedef single_halfspincolor single_color_halfspincolor[NCOL];
+  typedef single_color_halfspincolor single_halfspincolor_halfspincolor[NDIRAC/2];
+  typedef single_su3 single_clover_term_t[4];
+  typedef single_halfspincolor_halfspincolor single_inv_clover_term_t[2];
   
   typedef vir_complex vir_color[NCOL];
   typedef vir_color vir_su3[NCOL];
@@ -0,0 +1,309 @@
+#ifndef _SU3_BATCH_HPP
+#define _SU3_BATCH_HPP
+
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include <math.h>
+
+#include "su3.hpp"
+#include "su3_op.hpp"
+
+//number of matrices processed together, one per vector lane
+#if defined USE_AVX512
+ #define SU3_BATCH_NLANES 8
+#else
+ #define SU3_BATCH_NLANES 4
+#endif
+
+//loop over the lanes of a batch
+#define BATCH_LANE_LOOP(l) for(int l=0;l<SU3_BATCH_NLANES;l++)
+
+namespace nissa
+{
+  //structure of arrays: each component is stored contiguously for all the lanes, so that the operations below are
+  //performed lane-wise in vector registers; the arithmetic is the same of the scalar routines of su3_op.hpp, lane by lane
+  typedef double batch_double[SU3_BATCH_NLANES];
+  typedef batch_double batch_complex[2];
+  typedef batch_complex batch_color[NCOL];
+  typedef batch_color batch_su3[NCOL];
+  
+  /////////////////////////////////////// complex ///////////////////////////////////////
+  
+  inline void unsafe_batch_complex_prod(batch_complex a,const batch_complex b,const batch_complex c)
+  {
+    BATCH_LANE_LOOP(l)
+      {
+	a[0][l]=b[0][l]*c[0][l]-b[1][l]*c[1][l];
+	a[1][l]=b[0][l]*c[1][l]+b[1][l]*c[0][l];
+      }
+  }
+  inline void batch_complex_summ_the_prod(batch_complex a,const batch_complex b,const batch_complex c)
+  {
+    BATCH_LANE_LOOP(l)
+      {
+	const double t=b[0][l]*c[0][l]-b[1][l]*c[1][l];
+	a[1][l]+=b[0][l]*c[1][l]+b[1][l]*c[0][l];
+	a[0][l]+=t;
+      }
+  }
+  inline void unsafe_batch_complex_conj2_prod(batch_complex a,const batch_complex b,const batch_complex c)
+  {
+    BATCH_LANE_LOOP(l)
+      {
+	a[0][l]=+b[0][l]*c[0][l]+b[1][l]*c[1][l];
+	a[1][l]=-b[0][l]*c[1][l]+b[1][l]*c[0][l];
+      }
+  }
+  inline void batch_complex_summ_the_conj2_prod(batch_complex a,const batch_complex b,const batch_complex c)
+  {
+    BATCH_LANE_LOOP(l)
+      {
+	const double t=+b[0][l]*c[0][l]+b[1][l]*c[1][l];
+	a[1][l]+=-b[0][l]*c[1][l]+b[1][l]*c[0][l];
+	a[0][l]+=t;
+      }
+  }
+  inline void unsafe_batch_complex_conj1_prod(batch_complex a,const batch_complex b,const batch_complex c)
+  {unsafe_batch_complex_conj2_prod(a,c,b);}
+  inline void batch_complex_summ_the_conj1_prod(batch_complex a,const batch_complex b,const batch_complex c)
+  {batch_complex_summ_the_conj2_prod(a,c,b);}
+  inline void unsafe_batch_complex_conj_conj_prod(batch_complex a,const batch_complex b,const batch_complex c)
+  {
+    BATCH_LANE_LOOP(l)
+      {
+	a[0][l]=+b[0][l]*c[0][l]-b[1][l]*c[1][l];
+	a[1][l]=-b[0][l]*c[1][l]-b[1][l]*c[0][l];
+      }
+  }
+  inline void batch_complex_summ_the_conj_conj_prod(batch_complex a,const batch_complex b,const batch_complex c)
+  {
+    BATCH_LANE_LOOP(l)
+      {
+	const double t=+b[0][l]*c[0][l]-b[1][l]*c[1][l];
+	a[1][l]+=-b[0][l]*c[1][l]-b[1][l]*c[0][l];
+	a[0][l]+=t;
+      }
+  }
+  inline void batch_complex_subt_the_conj_conj_prod(batch_complex a,const batch_complex b,const batch_complex c)
+  {
+    BATCH_LANE_LOOP(l)
+      {
+	const double t=+b[0][l]*c[0][l]-b[1][l]*c[1][l];
+	a[1][l]-=-b[0][l]*c[1][l]-b[1][l]*c[0][l];
+	a[0][l]-=t;
+      }
+  }
+  
+  /////////////////////////////////////// su3 ///////////////////////////////////////
+  
+  //move a single matrix in and out of a lane
+  inline void batch_su3_get_lane(su3 out,const batch_su3 in,int l)
+  {
+    for(size_t ic1=0;ic1<NCOL;ic1++)
+      for(size_t ic2=0;ic2<NCOL;ic2++)
+	for(int ri=0;ri<2;ri++)
+	  out[ic1][ic2][ri]=in[ic1][ic2][ri][l];
+  }
+  inline void batch_su3_set_lane(batch_su3 out,const su3 in,int l)
+  {
+    for(size_t ic1=0;ic1<NCOL;ic1++)
+      for(size_t ic2=0;ic2<NCOL;ic2++)
+	for(int ri=0;ri<2;ri++)
+	  out[ic1][ic2][ri][l]=in[ic1][ic2][ri];
+  }
+  
+  inline void batch_su3_put_to_zero(batch_su3 a)
+  {
+    for(size_t ic1=0;ic1<NCOL;ic1++)
+      for(size_t ic2=0;ic2<NCOL;ic2++)
+	for(int ri=0;ri<2;ri++)
+	  BATCH_LANE_LOOP(l)
+	    a[ic1][ic2][ri][l]=0;
+  }
+  
+  inline void batch_su3_copy(batch_su3 a,const batch_su3 b)
+  {
+    for(size_t ic1=0;ic1<NCOL;ic1++)
+      for(size_t ic2=0;ic2<NCOL;ic2++)
+	for(int ri=0;ri<2;ri++)
+	  BATCH_LANE_LOOP(l)
+	    a[ic1][ic2][ri][l]=b[ic1][ic2][ri][l];
+  }
+  
+  //a=b*cb+c*cc
+  inline void batch_su3_linear_comb(batch_su3 a,const batch_su3 b,const double cb,const batch_su3 c,const double cc)
+  {
+    for(size_t ic1=0;ic1<NCOL;ic1++)
+      for(size_t ic2=0;ic2<NCOL;ic2++)
+	for(int ri=0;ri<2;ri++)
+	  BATCH_LANE_LOOP(l)
+	    a[ic1][ic2][ri][l]=b[ic1][ic2][ri][l]*cb+c[ic1][ic2][ri][l]*cc;
+  }
+  
+  //compute third row according to other 2
+  inline void batch_su3_build_third_row(batch_su3 o)
+  {
+    unsafe_batch_complex_conj_conj_prod(o[2][0],o[0][1],o[1][2]);
+    batch_complex_subt_the_conj_conj_prod(o[2][0],o[0][2],o[1][1]);
+    unsafe_batch_complex_conj_conj_prod(o[2][1],o[0][2],o[1][0]);
+    batch_complex_subt_the_conj_conj_prod(o[2][1],o[0][0],o[1][2]);
+    unsafe_batch_complex_conj_conj_prod(o[2][2],o[0][0],o[1][1]);
+    batch_complex_subt_the_conj_conj_prod(o[2][2],o[0][1],o[1][0]);
+  }
+  
+  //products, possibly computing only the first nr_max rows
+  inline void unsafe_batch_su3_prod_batch_su3(batch_su3 a,const batch_su3 b,const batch_su3 c,const size_t nr_max=NCOL)
+  {
+    for(size_t ir_out=0;ir_out<nr_max;ir_out++)
+      for(size_t ic_out=0;ic_out<NCOL;ic_out++)
+	{
+	  unsafe_batch_complex_prod(a[ir_out][ic_out],b[ir_out][0],c[0][ic_out]);
+	  for(size_t itemp=1;itemp<NCOL;itemp++)
+	    batch_complex_summ_the_prod(a[ir_out][ic_out],b[ir_out][itemp],c[itemp][ic_out]);
+	}
+  }
+  inline void unsafe_batch_su3_dag_prod_batch_su3(batch_su3 a,const batch_su3 b,const batch_su3 c,const size_t nr_max=NCOL)
+  {
+    for(size_t ir_out=0;ir_out<nr_max;ir_out++)
+      for(size_t ic_out=0;ic_out<NCOL;ic_out++)
+	{
+	  unsafe_batch_complex_conj1_prod(a[ir_out][ic_out],b[0][ir_out],c[0][ic_out]);
+	  for(size_t itemp=1;itemp<NCOL;itemp++)
+	    batch_complex_summ_the_conj1_prod(a[ir_out][ic_out],b[itemp][ir_out],c[itemp][ic_out]);
+	}
+  }
+  inline void unsafe_batch_su3_prod_batch_su3_dag(batch_su3 a,const batch_su3 b,const batch_su3 c,const size_t nr_max=NCOL)
+  {
+    for(size_t ir_out=0;ir_out<nr_max;ir_out++)
+      for(size_t ic_out=0;ic_out<NCOL;ic_out++)
+	{
+	  unsafe_batch_complex_conj2_prod(a[ir_out][ic_out],b[ir_out][0],c[ic_out][0]);
+	  for(size_t jc=1;jc<NCOL;jc++) batch_complex_summ_the_conj2_prod(a[ir_out][ic_out],b[ir_out][jc],c[ic_out][jc]);
+	}
+  }
+  inline void unsafe_batch_su3_dag_prod_batch_su3_dag(batch_su3 a,const batch_su3 b,const batch_su3 c,const size_t nr_max=NCOL)
+  {
+    for(size_t ir_out=0;ir_out<nr_max;ir_out++)
+      for(size_t ic_out=0;ic_out<NCOL;ic_out++)
+	{
+	  unsafe_batch_complex_conj_conj_prod(a[ir_out][ic_out],b[0][ir_out],c[ic_out][0]);
+	  for(size_t itemp=1;itemp<NCOL;itemp++)
+	    batch_complex_summ_the_conj_conj_prod(a[ir_out][ic_out],b[itemp][ir_out],c[ic_out][itemp]);
+	}
+  }
+  inline void batch_su3_summ_the_prod_batch_su3(batch_su3 a,const batch_su3 b,const batch_su3 c)
+  {
+    for(size_t ir_out=0;ir_out<NCOL;ir_out++)
+      for(size_t ic_out=0;ic_out<NCOL;ic_out++)
+	for(size_t itemp=0;itemp<NCOL;itemp++)
+	  batch_complex_summ_the_prod(a[ir_out][ic_out],b[ir_out][itemp],c[itemp][ic_out]);
+  }
+  inline void batch_su3_summ_the_prod_batch_su3_dag(batch_su3 a,const batch_su3 b,const batch_su3 c)
+  {
+    for(size_t ir_out=0;ir_out<NCOL;ir_out++)
+      for(size_t ic_out=0;ic_out<NCOL;ic_out++)
+	for(size_t itemp=0;itemp<NCOL;itemp++)
+	  batch_complex_summ_the_conj2_prod(a[ir_out][ic_out],b[ir_out][itemp],c[ic_out][itemp]);
+  }
+  inline void batch_su3_summ_the_dag_prod_batch_su3(batch_su3 a,const batch_su3 b,const batch_su3 c)
+  {
+    for(size_t ir_out=0;ir_out<NCOL;ir_out++)
+      for(size_t ic_out=0;ic_out<NCOL;ic_out++)
+	for(size_t itemp=0;itemp<NCOL;itemp++)
+	  batch_complex_summ_the_conj1_prod(a[ir_out][ic_out],b[itemp][ir_out],c[itemp][ic_out]);
+  }
+  
+  /////////////////////////////////////// su2 subgroups ///////////////////////////////////////
+  
+  //take projection of the su2 matrix over an su3 matrix
+  //return the inverse modulo of the part parallel in the original matrix
+  inline void batch_su2_part_of_su3(batch_double N,batch_double A,batch_double B,batch_double C,batch_double D,const batch_su3 in,const int isub_gr)
+  {
+    //take indices of the subgroup
+    int a=su3_sub_gr_indices[isub_gr][0];
+    int b=su3_sub_gr_indices[isub_gr][1];
+    
+    BATCH_LANE_LOOP(l)
+      {
+	//extract part parallel to sigmas
+	A[l]=in[a][a][RE][l]+in[b][b][RE][l];
+	B[l]=in[a][b][IM][l]+in[b][a][IM][l];
+	C[l]=in[a][b][RE][l]-in[b][a][RE][l];
+	D[l]=in[a][a][IM][l]-in[b][b][IM][l];
+	
+	//normalize
+	N[l]=sqrt(A[l]*A[l]+B[l]*B[l]+C[l]*C[l]+D[l]*D[l]);
+	if(fabs(N[l])==0) N[l]=A[l]=1;
+	else
+	  {
+	    N[l]=1/N[l];
+	    A[l]*=N[l];
+	    B[l]*=N[l];
+	    C[l]*=N[l];
+	    D[l]*=N[l];
+	  }
+      }
+  }
+  
+  //multiply an su2 matrix in the form A+B*i*sigma1+... and an su3, and assign to last
+  inline void batch_su2_prodassign_su3(const batch_double A,const batch_double B,const batch_double C,const batch_double D,const int isub_gr,batch_su3 in)
+  {
+    int ic1=su3_sub_gr_indices[isub_gr][0];
+    int ic2=su3_sub_gr_indices[isub_gr][1];
+    
+    for(size_t ic=0;ic<NCOL;ic++)
+      BATCH_LANE_LOOP(l)
+	{
+	  const double x0=in[ic1][ic][RE][l],x1=in[ic1][ic][IM][l];
+	  const double y0=in[ic2][ic][RE][l],y1=in[ic2][ic][IM][l];
+	  
+	  //first row: (A,D)*x+(C,B)*y
+	  double r0=A[l]*x0-D[l]*x1,r1=A[l]*x1+D[l]*x0;
+	  {const double t=C[l]*y0-B[l]*y1;r1+=C[l]*y1+B[l]*y0;r0+=t;}
+	  //second row: (-C,B)*x+(A,-D)*y
+	  double s0=-C[l]*x0-B[l]*x1,s1=-C[l]*x1+B[l]*x0;
+	  {const double t=A[l]*y0+D[l]*y1;s1+=A[l]*y1-D[l]*y0;s0+=t;}
+	  
+	  in[ic1][ic][RE][l]=r0;
+	  in[ic1][ic][IM][l]=r1;
+	  in[ic2][ic][RE][l]=s0;
+	  in[ic2][ic][IM][l]=s1;
+	}
+  }
+  
+  //return a batch of links after the overrelaxation procedure
+  inline void batch_su3_find_overrelaxed(batch_su3 out,const batch_su3 staple,int nov_hits)
+  {
+    //compute the original contribution to the action due to the given link
+    batch_su3 prod;
+    unsafe_batch_su3_prod_batch_su3_dag(prod,out,staple);
+    
+    //iterate over overrelax hits
+    for(int ihit=0;ihit<nov_hits;ihit++)
+      //scan all the three possible subgroups
+      for(int isub_gr=0;isub_gr<NCOL;isub_gr++)
+	{
+	  //take the part of the su3 matrix
+	  batch_double N,r0,r1,r2,r3;
+	  batch_su2_part_of_su3(N,r0,r1,r2,r3,prod,isub_gr);
+	  
+	  //build the changing matrix
+	  batch_double x0,x1,x2,x3;
+	  BATCH_LANE_LOOP(l)
+	    {
+	      x0[l]=2*r0[l]*r0[l]-1;
+	      x1[l]=-2*r0[l]*r1[l];
+	      x2[l]=-2*r0[l]*r2[l];
+	      x3[l]=-2*r0[l]*r3[l];
+	    }
+	  
+	  //change the link and optate the product
+	  batch_su2_prodassign_su3(x0,x1,x2,x3,isub_gr,prod);
+	  batch_su2_prodassign_su3(x0,x1,x2,x3,isub_gr,out);
+	}
+  }
+}
+
+#endif
@@ -117,6 +117,16 @@ namespace nissa
   inline void color_isummassign(color a,const color b) {color_isumm(a,a,b);}
   inline void color_isubtassign(color a,const color b) {color_isubt(a,a,b);}
   
+  inline void single_color_copy(single_color b,const single_color a) {for(size_t ic=0;ic<NCOL;ic++) for(int ri=0;ri<2;ri++) b[ic][ri]=a[ic][ri];}
+  inline void single_color_summ(single_color a,const single_color b,const single_color c) {for(size_t ic=0;ic<NCOL;ic++) single_complex_summ(a[ic],b[ic],c[ic]);}
+  inline void single_color_isumm(single_color a,const single_color b,const single_color c) {for(size_t ic=0;ic<NCOL;ic++) single_complex_isumm(a[ic],b[ic],c[ic]);}
+  inline void single_color_subt(single_color a,const single_color b,const single_color c) {for(size_t ic=0;ic<NCOL;ic++) single_complex_subt(a[ic],b[ic],c[ic]);}
+  inline void single_color_isubt(single_color a,const single_color b,const single_color c) {for(size_t ic=0;ic<NCOL;ic++) single_complex_isubt(a[ic],b[ic],c[ic]);}
+  inline void single_color_summassign(single_color a,const single_color b) {single_color_summ(a,a,b);}
+  inline void single_color_subtassign(single_color a,const single_color b) {single_color_subt(a,a,b);}
+  inline void single_color_isummassign(single_color a,const single_color b) {single_color_isumm(a,a,b);}
+  inline void single_color_isubtassign(single_color a,const single_color b) {single_color_isubt(a,a,b);}
+  
   inline void color_prod_double(color a,const color b,const double c) {for(size_t ic=0;ic<NCOL;ic++) complex_prod_double(a[ic],b[ic],c);}
   inline void color_prod_idouble(color a,const color b,const double c) {for(size_t ic=0;ic<NCOL;ic++) complex_prod_idouble(a[ic],b[ic],c);}
   
@@ -951,6 +961,8 @@ namespace nissa
   {for(size_t c1=0;c1<NCOL;c1++) for(size_t c2=0;c2<NCOL;c2++) complex_summ_the_prod(a[c1],b[c1][c2],c[c2]);}
   inline void single_su3_summ_the_prod_single_color(single_color a,const single_su3 b,const single_color c)
   {for(size_t c1=0;c1<NCOL;c1++) for(size_t c2=0;c2<NCOL;c2++) single_complex_summ_the_prod(a[c1],b[c1][c2],c[c2]);}
+  inline void single_su3_subt_the_prod_single_color(single_color a,const single_su3 b,const single_color c)
+  {for(size_t c1=0;c1<NCOL;c1++) for(size_t c2=0;c2<NCOL;c2++) single_complex_subt_the_prod(a[c1],b[c1][c2],c[c2]);}
   //subt
   inline void su3_subt_the_prod_color(color a,const su3 b,const color c)
   {for(size_t c1=0;c1<NCOL;c1++) for(size_t c2=0;c2<NCOL;c2++) complex_subt_the_prod(a[c1],b[c1][c2],c[c2]);}
@@ -965,6 +977,15 @@ namespace nissa
       }
   }
   
+  inline void unsafe_single_su3_dag_prod_single_color(single_color a,const single_su3 b,const single_color c)
+  {
+    for(size_t c1=0;c1<NCOL;c1++)
+      {
+	unsafe_single_complex_conj1_prod(a[c1],b[0][c1],c[0]);
+	for(size_t c2=1;c2<NCOL;c2++) single_complex_summ_the_conj1_prod(a[c1],b[c2][c1],c[c2]);
+      }
+  }
+  
   //safe dag prod
   inline void safe_su3_dag_prod_color(color a,const su3 b,const color c)
   {color t;unsafe_su3_dag_prod_color(t,b,c);color_copy(a,t);}
@@ -1060,6 +1081,30 @@ namespace nissa
 	}
   }
   
+  inline void unsafe_single_halfspincolor_halfspincolor_times_single_halfspincolor(single_halfspincolor a,const single_halfspincolor_halfspincolor b,const single_halfspincolor c)
+  {
+    for(int id_out=0;id_out<NDIRAC/2;id_out++)
+      for(int ic_out=0;ic_out<NCOL;ic_out++)
+	{
+	  a[id_out][ic_out][RE]=a[id_out][ic_out][IM]=0;
+	  for(int id_in=0;id_in<NDIRAC/2;id_in++)
+	    for(int ic_in=0;ic_in<NCOL;ic_in++)
+	      single_complex_summ_the_prod(a[id_out][ic_out],b[id_out][ic_out][id_in][ic_in],c[id_in][ic_in]);
+	}
+  }
+  
+  inline void unsafe_single_halfspincolor_halfspincolor_dag_times_single_halfspincolor(single_halfspincolor a,const single_halfspincolor_halfspincolor b,const single_halfspincolor c)
+  {
+    for(int id_out=0;id_out<NDIRAC/2;id_out++)
+      for(int ic_out=0;ic_out<NCOL;ic_out++)
+	{
+	  a[id_out][ic_out][RE]=a[id_out][ic_out][IM]=0;
+	  for(int id_in=0;id_in<NDIRAC/2;id_in++)
+	    for(int ic_in=0;ic_in<NCOL;ic_in++)
+	      single_complex_summ_the_conj1_prod(a[id_out][ic_out],b[id_in][ic_in][id_out][ic_out],c[id_in][ic_in]);
+	}
+  }
+  
   ////////////////////////////////// Operations between spincolor ////////////////////////
   
   //just print a spincolor
@@ -46,9 +46,11 @@
 #include "dirac_operators/tmD_eoprec/dirac_operator_tmD_eoprec.hpp"
 #include "dirac_operators/tmQ/dirac_operator_tmQ.hpp"
 #include "dirac_operators/tmQ/dirac_operator_tmQ_128.hpp"
+#include "dirac_operators/tmQ/dirac_operator_tmQ_multi.hpp"
 #include "dirac_operators/tmQ/reconstruct_tm_doublet.hpp"
 #include "dirac_operators/tmQ2/dirac_operator_tmQ2.hpp"
 #include "dirac_operators/tmQ2/dirac_operator_tmQ2_128.hpp"
+#include "dirac_operators/tmQ2/dirac_operator_tmQ2_multi.hpp"
 #include "dirac_operators/tmQ_left/dirac_operator_tmQ_left.hpp"
 #include "dirac_operators/overlap/dirac_operator_overlap_kernel_portable.hpp"
 #include "dirac_operators/overlap/dirac_operator_overlap_kernel2.hpp"
@@ -58,10 +60,13 @@
 #include "dirac_operators/WclovQ2/dirac_operator_WclovQ2.hpp"
 #include "dirac_operators/tmclovD_eoprec/dirac_operator_tmclovD_eoprec.hpp"
 #include "dirac_operators/tmclovQ/dirac_operator_tmclovQ.hpp"
+#include "dirac_operators/tmclovQ/dirac_operator_tmclovQ_multi.hpp"
 #include "dirac_operators/tmclovQ/reconstruct_tmclov_doublet.hpp"
 #include "dirac_operators/tmclovQ2/dirac_operator_tmclovQ2.hpp"
+#include "dirac_operators/tmclovQ2/dirac_operator_tmclovQ2_multi.hpp"
 
 #include "eigenvalues/eigenvalues.hpp"
+#include "eigenvalues/eigenvalues_deflation.hpp"
 
 #include "free_theory/cg_eoprec_twisted_free_operator.hpp"
 #include "free_theory/free_theory_types.hpp"
@@ -76,6 +81,7 @@
 #include "geometry/geometry_mix.hpp"
 
 #include "hmc/backfield.hpp"
+#include "hmc/fermions/chrono_guess.hpp"
 #include "hmc/fermions/rootst_eoimpr_quark_force.hpp"
 #include "hmc/fermions/pseudofermions_generation.hpp"
 #include "hmc/gauge/gluonic_action.hpp"
@@ -90,6 +96,7 @@
 #include "hmc/gauge/Wilson_action.hpp"
 #include "hmc/gauge/Wilson_force.hpp"
 #include "hmc/hmc.hpp"
+#include "hmc/md_scheme.hpp"
 #include "hmc/momenta/momenta_action.hpp"
 #include "hmc/momenta/momenta_evolve.hpp"
 #include "hmc/momenta/momenta_generation.hpp"
@@ -98,10 +105,14 @@
 #include "hmc/multipseudo/theory_action.hpp"
 #include "hmc/multipseudo/multipseudo_rhmc_step.hpp"
 
+#include "inverters/multigrid/multigrid.hpp"
 #include "inverters/staggered/cg_invert_stD.hpp"
+#include "inverters/staggered/cg_deflated_invert_stD2ee_m2.hpp"
 #include "inverters/twisted_mass/cg_128_invert_tmQ2.hpp"
 #include "inverters/twisted_mass/cg_invert_tmD_eoprec.hpp"
 #include "inverters/twisted_mass/cg_invert_tmQ2.hpp"
+#include "inverters/twisted_mass/cg_deflated_invert_tmQ2.hpp"
+#include "inverters/twisted_mass/cg_multi_rhs_invert_tmQ2.hpp"
 #include "inverters/twisted_mass/cgm_invert_tmQ2.hpp"
 #include "inverters/twisted_mass/tm_frontends.hpp"
 #include "inverters/overlap/cgm_invert_overlap_kernel2.hpp"
@@ -109,6 +120,9 @@
 #include "inverters/Wclov/cg_invert_WclovQ.hpp"
 #include "inverters/twisted_clover//cg_invert_tmclovD_eoprec.hpp"
 #include "inverters/twisted_clover/cg_invert_tmclovQ2.hpp"
+#include "inverters/twisted_clover/cg_deflated_invert_tmclovQ2.hpp"
+#include "inverters/twisted_clover/mg_invert_tmclovD.hpp"
+#include "inverters/twisted_clover/cg_multi_rhs_invert_tmclovQ2.hpp"
 #include "inverters/twisted_clover/cg_invert_tmclovQ.hpp"
 #include "inverters/twisted_clover/cgm_invert_tmclovQ2.hpp"
 #include "inverters/twisted_clover/tmclov_frontends.hpp"
@@ -144,6 +158,7 @@
 #include "measures/gauge/pline.hpp"
 #include "measures/gauge/topological_charge.hpp"
 #include "measures/gauge/watusso.hpp"
+#include "measures/gauge/Wflow_scale.hpp"
 
 #include "new_types/complex.hpp"
 #include "new_types/dirac.hpp"
@@ -156,6 +171,7 @@
 #include "new_types/read_new_types.hpp"
 #include "new_types/spin.hpp"
 #include "new_types/su3.hpp"
+#include "new_types/su3_batch.hpp"
 
 #include "operations/covariant_derivative.hpp"
 #include "operations/fft.hpp"
@@ -187,6 +203,7 @@
 #include "routines/ios.hpp"
 #include "routines/math_routines.hpp"
 #include "routines/mpi_routines.hpp"
+#include "routines/parallel.hpp"
 #ifdef USE_THREADS
  #include "routines/thread.hpp"
 #endif
@@ -2,16 +2,20 @@
  #include "config.hpp"
 #endif
 
+#include <algorithm>
 #include <math.h>
 #include <string.h>
 #if FFT_TYPE == FFTW_FFT
  #include <fftw3.h>
+ #include <map>
+ #include <tuple>
 #endif
 
 #include "base/debug.hpp"
 #include "base/thread_macros.hpp"
 #include "base/vectors.hpp"
 #include "geometry/geometry_lx.hpp"
+#include "io/input.hpp"
 #include "linalgs/linalgs.hpp"
 #include "operations/remap_vector.hpp"
 #include "routines/ios.hpp"
@@ -22,313 +26,215 @@
  #include "routines/thread.hpp"
 #endif
 
+#define EXTERN_FFT
+ #include "fft.hpp"
+
 namespace nissa
 {
-#if FFT_TYPE != FFTW_FFT
+#if FFT_TYPE == FFTW_FFT
+  //number of lines whose alignment is checked: lines are made of complex, so their alignment has a smaller period
+#define NISSA_FFTW_NALIGN_LINES 8
+  
+  //plans cached across calls, indexed by line length, number of complex per point, sign and alignment
+  //all plans act in place on ncpp interleaved lines, as in the locd layout
+  typedef std::tuple<int,int,int,int> fftw_plan_key_t;
+  std::map<fftw_plan_key_t,fftw_plan> fftw_plan_cache;
   
-  //transpose the data shifting coordinate order by 1
-  //if normal ordering TXYZ is present and you pass mu0=0,
-  //it will put data in XYZT order. Than if called with mu0=1
-  //it will put data in YZTX order, etc
-  void data_coordinate_order_shift(complex *data,int ncpp,int mu0)
+  //get the plan from the cache, creating it if needed
+  fftw_plan get_fftw_plan(int n,int ncpp,int sign,int alignment)
   {
-    int *pos=nissa_malloc("Pos",loc_vol,int);
+    fftw_plan_key_t key(n,ncpp,sign,alignment);
+    std::map<fftw_plan_key_t,fftw_plan>::iterator it=fftw_plan_cache.find(key);
+    if(it!=fftw_plan_cache.end()) return it->second;
     
-    //order of directions
-    int in_mu[4] ={mu0,(mu0+1)%4,(mu0+2)%4,(mu0+3)%4};
-    int out_mu[4]={(mu0+1)%4,(mu0+2)%4,(mu0+3)%4,mu0};
+    const unsigned rigor_flags[3]={FFTW_ESTIMATE,FFTW_MEASURE,FFTW_PATIENT};
+    if(fftw_planning_rigor<0 or fftw_planning_rigor>2) crash("unknown fftw planning rigor %d",fftw_planning_rigor);
     
-    //loop over all sites
-    int x[4];
-    for(x[0]=0;x[0]<loc_size[0];x[0]++)
-      for(x[1]=0;x[1]<loc_size[1];x[1]++)
-	for(x[2]=0;x[2]<loc_size[2];x[2]++)
-	  for(x[3]=0;x[3]<loc_size[3];x[3]++)
-	    {
-	      //find in and out position
-	      int in=0,out=0;
-	      for(int mu=0;mu<4;mu++)
-		{
-		  in=in*loc_size[in_mu[mu]]+x[in_mu[mu]];
-		  out=out*loc_size[out_mu[mu]]+x[out_mu[mu]];
-		}
-	      
-	      //mark its final order
-	      pos[in]=out;
-	    }
+    //plan on a scratch buffer with the same alignment, as measuring overwrites the data
+    char *scratch_base=(char*)fftw_malloc(n*ncpp*sizeof(complex)+alignment);
+    fftw_complex *scratch=(fftw_complex*)(scratch_base+alignment);
+    double time=-take_time();
+    fftw_plan plan=fftw_plan_many_dft(1,&n,ncpp,scratch,NULL,ncpp,1,scratch,NULL,ncpp,1,sign,rigor_flags[fftw_planning_rigor]);
+    time+=take_time();
+    fftw_free(scratch_base);
+    if(plan==NULL) crash("unable to create the fftw plan for %d points and %d complex per point",n,ncpp);
     
-    //apply reordering
-    reorder_vector((char*)data,pos,loc_vol,sizeof(complex)*ncpp);
+    verbosity_lv2_master_printf("Created fftw plan for %d points, %d complex per point, sign %d, alignment %d in %lg s\n",n,ncpp,sign,alignment,time);
+    fftw_plan_cache[key]=plan;
     
-    nissa_free(pos);
+    return plan;
   }
+#endif
   
-  // Perform the 1d transform (mu is used to choose the communicator and n)
-  // The fft consist of four step:
-  //  1) data of is rearranged across the ranks
-  //  2) ft is done on the odd length blocks (not needed if data length is a power of 2)
-  //  3) Lanczos lemma is implemented on the local data
-  //  4) Lanczos lemma is applied on non-local data (if needed)
-  void fft1d(complex *out,complex *in,int ncpp,int mu,double sign,int normalize)
+  //load the fftw wisdom, if asked
+  void init_fft_plans()
   {
-    GET_THREAD_ID();
-    
-    //allocate the buffer to send data
-    complex *buf=nissa_malloc("buf",loc_size[mu]*ncpp,complex);
-    
-    if(IS_MASTER_THREAD)
+#if FFT_TYPE == FFTW_FFT
+    if(strlen(fftw_wisdom_path) and file_exists(fftw_wisdom_path))
       {
-	int log2glb_nblk=find_max_pow2(glb_size[mu]); //number of powers of 2 contained in n
-	int glb_nblk=1<<log2glb_nblk;                 //remaining odd block
-	int blk_size=glb_size[mu]/glb_nblk;           //block size
-	int loc_nblk=glb_nblk/nrank_dir[mu];          //number of local blocks
-	
-	//check if the loc_size is a multiple of block_size
-	int r=nrank_dir[mu];
-	while(r>1)
+	//read on master rank and broadcast
+	char *wisdom=NULL;
+	int length=0;
+	if(rank==0)
 	  {
-	    if(r%2!=0) crash("Error, FFT implemented only for power of 2 grids! Ask sunpho to adapt it to a more general case if you really need!");
-	    r/=2;
-	  }
-	
-	////////////////////////////// first part /////////////////////////////////
-	
-	//reorder data across the various rank: glb_iel_in=iel_blk_out*glb_nblk+glb_iblk_out_rev
-	int nrequest0=0,nexp_request0=loc_size[mu]*2;
-	MPI_Request request0[nexp_request0];
-	for(int loc_iblk_in=0;loc_iblk_in<loc_nblk;loc_iblk_in++)
-	  for(int iel_blk_in=0;iel_blk_in<blk_size;iel_blk_in++)
-	    {
-	      //find the full index
-	      int loc_iel_in=loc_iblk_in*blk_size+iel_blk_in;
-	      int glb_iel_in=glb_coord_of_loclx[0][mu]+loc_iel_in;
-	      int glb_iblk_in=rank_coord[mu]*loc_nblk+loc_iblk_in;
-	      
-	      //look at the output
-	      int iel_blk_out=glb_iel_in/glb_nblk;
-	      int glb_iblk_out=bitrev(glb_iel_in-iel_blk_out*glb_nblk,log2glb_nblk);
-	      int rank_coord_out=glb_iblk_out/loc_nblk;
-	      int loc_iblk_out=glb_iblk_out-rank_coord_out*loc_nblk;
-	      int loc_iel_out=loc_iblk_out*blk_size+iel_blk_out;
-	      
-	      //now, if the destination is local, put it on place
-	      if(rank_coord_out==rank_coord[mu]) memcpy(buf+ncpp*loc_iel_out,in+ncpp*loc_iel_in,sizeof(complex)*ncpp);
-	      else //send the data to the destination
-		MPI_Isend((void*)(in+loc_iel_in*ncpp),ncpp*2,MPI_DOUBLE,rank_coord_out,1241+loc_iel_out,
-			  line_comm[mu],&request0[nrequest0++]);
-	      
-	      //if necessary receive data: glb_iel_send=iel_blk_in*glb_nblk+glb_iblk_in_rev
-	      int glb_iel_send=iel_blk_in*glb_nblk+bitrev(glb_iblk_in,log2glb_nblk);
-	      int rank_coord_send=glb_iel_send/loc_size[mu];
-	      if(rank_coord_send!=line_rank[mu])
-		MPI_Irecv((void*)(buf+loc_iel_in*ncpp),ncpp*2,MPI_DOUBLE,rank_coord_send,1241+loc_iel_in,
-			  line_comm[mu],&request0[nrequest0++]);
-	    }
-	
-	//wait for scramble to finish
-	MPI_Status status0[nexp_request0];
-	if(nrequest0>0) MPI_Waitall(nrequest0,request0,status0);
-	
-	/////////////////////////// second part ////////////////////////////////////
-	
-	//perform the block fourier transform if needed
-	if(blk_size==1) memcpy(out,buf,loc_size[mu]*ncpp*sizeof(complex));
-	else
-	  {
-	    //initialize the output
-	    memset(out,0,loc_size[mu]*ncpp*sizeof(complex));
-	    
-	    //loop over local blocks
-	    for(int loc_iblk=0;loc_iblk<loc_nblk;loc_iblk++)
+	    if(fftw_import_wisdom_from_filename(fftw_wisdom_path))
 	      {
-		//take initial position of the output and input block
-		complex *in_blk=buf+loc_iblk*blk_size*ncpp;
-		complex *out_blk=out+loc_iblk*blk_size*ncpp;
-		
-		//loop over out elements of out block
-		for(int iel_out=0;iel_out<blk_size;iel_out++)
-		  {
-		    //take initial position of out local elements
-		    complex *out_pad=out_blk+iel_out*ncpp;
-		    
-		    //incrementing factor
-		    double theta=iel_out*sign*2*M_PI/blk_size;
-		    double wtemp=sin(0.5*theta);
-		    double wpr=-2*wtemp*wtemp;
-		    double wpi=sin(theta);
-		    
-		    //fourier factor
-		    double wr=1;
-		    double wi=0;
-		    
-		    //loop over elements of in blocks
-		    for(int iel_in=0;iel_in<blk_size;iel_in++)
-		      {
-			//take initial position of in local elements
-			complex *in_pad=in_blk+iel_in*ncpp;
-			
-			//loop over local elements
-			for(int ic=0;ic<ncpp;ic++)
-			  {
-			    out_pad[ic][0]+=wr*in_pad[ic][0]-wi*in_pad[ic][1];
-			    out_pad[ic][1]+=wr*in_pad[ic][1]+wi*in_pad[ic][0];
-			  }
-			
-			//increment the twiddle
-			wtemp=wr;
-			wr+=wr*wpr-   wi*wpi;
-			wi+=wi*wpr+wtemp*wpi;
-		      }
-		  }
+		wisdom=fftw_export_wisdom_to_string();
+		length=strlen(wisdom)+1;
 	      }
+	    else printf("WARNING: unable to import fftw wisdom from '%s'\n",fftw_wisdom_path);
 	  }
+	MPI_Bcast(&length,1,MPI_INT,0,MPI_COMM_WORLD);
 	
-	/////////////////////////////  third part ////////////////////////////
+	if(length)
+	  {
+	    if(rank!=0) wisdom=(char*)malloc(length);
+	    MPI_Bcast(wisdom,length,MPI_CHAR,0,MPI_COMM_WORLD);
+	    if(rank!=0 and not fftw_import_wisdom_from_string(wisdom)) crash("unable to import fftw wisdom");
+	    free(wisdom);
+	    master_printf("Loaded fftw wisdom from '%s'\n",fftw_wisdom_path);
+	  }
+      }
+#endif
+  }
+  
+  //save the fftw wisdom, if asked, and destroy all plans
+  void destroy_fft_plans()
+  {
+#if FFT_TYPE == FFTW_FFT
+    if(strlen(fftw_wisdom_path) and fftw_plan_cache.size())
+      {
+	if(rank==0 and not fftw_export_wisdom_to_filename(fftw_wisdom_path))
+	  printf("WARNING: unable to export fftw wisdom to '%s'\n",fftw_wisdom_path);
+	master_printf("Saved fftw wisdom to '%s'\n",fftw_wisdom_path);
+      }
+    
+    for(std::map<fftw_plan_key_t,fftw_plan>::iterator it=fftw_plan_cache.begin();it!=fftw_plan_cache.end();it++)
+      fftw_destroy_plan(it->second);
+    fftw_plan_cache.clear();
+#endif
+  }
+  
+#if FFT_TYPE != FFTW_FFT
+  //perform in place the 1d transform of a line of n elements, each made of ncpp complex, using buf as workspace
+  // The fft consist of three steps:
+  //  1) data is rearranged in bit-reversed order of the blocks of odd length
+  //  2) ft is done on the odd length blocks (not needed if data length is a power of 2)
+  //  3) Lanczos lemma is implemented on the blocks
+  void fft1d_local(complex *data,complex *buf,int n,int ncpp,double sign)
+  {
+    int log2nblk=find_max_pow2(n); //number of powers of 2 contained in n
+    int nblk=1<<log2nblk;          //number of blocks
+    int blk_size=n/nblk;           //remaining odd block size
+    
+    ////////////////////////////// first part /////////////////////////////////
+    
+    //reorder data: iel_in=iel_blk*nblk+iblk_rev
+    for(int iblk=0;iblk<nblk;iblk++)
+      for(int iel_blk=0;iel_blk<blk_size;iel_blk++)
+	memcpy(buf+ncpp*(iblk*blk_size+iel_blk),data+ncpp*(iel_blk*nblk+bitrev(iblk,log2nblk)),sizeof(complex)*ncpp);
+    
+    /////////////////////////// second part ////////////////////////////////////
+    
+    //perform the block fourier transform if needed
+    if(blk_size==1) memcpy(data,buf,n*ncpp*sizeof(complex));
+    else
+      {
+	//initialize the output
+	memset(data,0,n*ncpp*sizeof(complex));
 	
-	//now perform the lanczos procedure up to when it does not need communications
-	for(int delta=blk_size;delta<loc_size[mu];delta*=2)
+	//loop over blocks
+	for(int iblk=0;iblk<nblk;iblk++)
 	  {
-	    //incrementing factor
-	    double theta=sign*2*M_PI/(2*delta);
-	    double wtemp=sin(0.5*theta);
-	    double wpr=-2*wtemp*wtemp;
-	    double wpi=sin(theta);
+	    //take initial position of the output and input block
+	    complex *in_blk=buf+iblk*blk_size*ncpp;
+	    complex *out_blk=data+iblk*blk_size*ncpp;
 	    
-	    //fourier coefficient
-	    double wr=1;
-	    double wi=0;
-	    
-	    //loop over the delta length (each m will correspond to increasing twiddle)
-	    for(int m=0;m<delta;m++)
+	    //loop over out elements of out block
+	    for(int iel_out=0;iel_out<blk_size;iel_out++)
 	      {
-		//loop on the first addend
-		for(int i=m;i<loc_size[mu];i+=2*delta)
+		//take initial position of out local elements
+		complex *out_pad=out_blk+iel_out*ncpp;
+		
+		//incrementing factor
+		double theta=iel_out*sign*2*M_PI/blk_size;
+		double wtemp=sin(0.5*theta);
+		double wpr=-2*wtemp*wtemp;
+		double wpi=sin(theta);
+		
+		//fourier factor
+		double wr=1;
+		double wi=0;
+		
+		//loop over elements of in blocks
+		for(int iel_in=0;iel_in<blk_size;iel_in++)
 		  {
-		    //second addend
-		    int j=i+delta;
+		    //take initial position of in local elements
+		    complex *in_pad=in_blk+iel_in*ncpp;
 		    
-		    //site data multiplication
+		    //loop over local elements
 		    for(int ic=0;ic<ncpp;ic++)
 		      {
-			double tempr=wr*out[j*ncpp+ic][0]-wi*out[j*ncpp+ic][1];
-			double tempi=wr*out[j*ncpp+ic][1]+wi*out[j*ncpp+ic][0];
-			
-			out[j*ncpp+ic][0]=out[i*ncpp+ic][0]-tempr;
-			out[j*ncpp+ic][1]=out[i*ncpp+ic][1]-tempi;
-			
-			out[i*ncpp+ic][0]+=tempr;
-			out[i*ncpp+ic][1]+=tempi;
+			out_pad[ic][0]+=wr*in_pad[ic][0]-wi*in_pad[ic][1];
+			out_pad[ic][1]+=wr*in_pad[ic][1]+wi*in_pad[ic][0];
 		      }
+		    
+		    //increment the twiddle
+		    wtemp=wr;
+		    wr+=wr*wpr-   wi*wpi;
+		    wi+=wi*wpr+wtemp*wpi;
 		  }
-		wtemp=wr;
-		wr+=wr*wpr-   wi*wpi;
-		wi+=wi*wpr+wtemp*wpi;
 	      }
 	  }
+      }
+    
+    /////////////////////////////  third part ////////////////////////////
+    
+    //now perform the lanczos procedure
+    for(int delta=blk_size;delta<n;delta*=2)
+      {
+	//incrementing factor
+	double theta=sign*2*M_PI/(2*delta);
+	double wtemp=sin(0.5*theta);
+	double wpr=-2*wtemp*wtemp;
+	double wpi=sin(theta);
 	
-	///////////////////////////////////// fourth part //////////////////////////////
+	//fourier coefficient
+	double wr=1;
+	double wi=0;
 	
-	//now perform the lanczos procedure up to the end
-	for(int delta_rank=1;delta_rank<nrank_dir[mu];delta_rank*=2) //this is rank width of delta
+	//loop over the delta length (each m will correspond to increasing twiddle)
+	for(int m=0;m<delta;m++)
 	  {
-	    int delta=delta_rank*loc_size[mu];    //block extent
-	    int idelta=rank_coord[mu]/delta_rank; //identify the delta of the current rank
-	    
-	    //find if the current rank holding the first or second block
-	    complex *first,*second;
-	    MPI_Request request2[2];
-	    MPI_Status status2[2];
-	    
-	    if(idelta%2==0) //first: so it has to receive second block and send first
-	      {
-		first=out;
-		second=buf;
-		
-		MPI_Irecv((void*)buf,2*ncpp*loc_size[mu],MPI_DOUBLE,line_rank[mu]+delta_rank,113+line_rank[mu],
-			  line_comm[mu],&(request2[0]));
-		MPI_Isend((void*)out,2*ncpp*loc_size[mu],MPI_DOUBLE,line_rank[mu]+delta_rank,113+line_rank[mu]+delta_rank,
-			  line_comm[mu],&(request2[1]));
-	      }
-	    else           //second: so it has to receive first block and send second
+	    //loop on the first addend
+	    for(int i=m;i<n;i+=2*delta)
 	      {
-		first=buf;
-		second=out;
+		//second addend
+		int j=i+delta;
 		
-		MPI_Irecv((void*)buf,2*ncpp*loc_size[mu],MPI_DOUBLE,line_rank[mu]-delta_rank,113+line_rank[mu],
-			  line_comm[mu],&(request2[0]));
-		MPI_Isend((void*)out,2*ncpp*loc_size[mu],MPI_DOUBLE,line_rank[mu]-delta_rank,113+line_rank[mu]-delta_rank,
-			  line_comm[mu],&(request2[1]));
-	      }
-	    
-	    //incrementing factor
-	    double theta=sign*2*M_PI/(2*delta);
-	    double wtemp=sin(0.5*theta);
-	    double wpr=-2*wtemp*wtemp;
-	    double wpi=sin(theta);
-	    
-	    int rank_pos_delta=rank_coord[mu]%delta_rank;  //position of the rank inside the delta
-	    int pos_delta=rank_pos_delta*loc_size[mu];     //starting coord of local delta inside the delta
-	    
-	    //fourier coefficient
-	    double wr=cos(pos_delta*theta);
-	    double wi=sin(pos_delta*theta);
-	    
-	    //wait for communications to finish
-	    MPI_Waitall(2,request2,status2);
-	    
-	    //loop over the delta length (each m will correspond to increasing twiddle)
-	    for(int loc_m=0;loc_m<loc_size[mu];loc_m++)
-	      {
 		//site data multiplication
 		for(int ic=0;ic<ncpp;ic++)
 		  {
-		    double tempr=wr*second[loc_m*ncpp+ic][0]-wi*second[loc_m*ncpp+ic][1];
-		    double tempi=wr*second[loc_m*ncpp+ic][1]+wi*second[loc_m*ncpp+ic][0];
+		    double tempr=wr*data[j*ncpp+ic][0]-wi*data[j*ncpp+ic][1];
+		    double tempi=wr*data[j*ncpp+ic][1]+wi*data[j*ncpp+ic][0];
 		    
-		    if(idelta%2==0)
-		      {
-			first[loc_m*ncpp+ic][0]+=tempr;
-			first[loc_m*ncpp+ic][1]+=tempi;
-		      }
-		    else
-		      {
-			second[loc_m*ncpp+ic][0]=first[loc_m*ncpp+ic][0]-tempr;
-			second[loc_m*ncpp+ic][1]=first[loc_m*ncpp+ic][1]-tempi;
-		      }
+		    data[j*ncpp+ic][0]=data[i*ncpp+ic][0]-tempr;
+		    data[j*ncpp+ic][1]=data[i*ncpp+ic][1]-tempi;
+		    
+		    data[i*ncpp+ic][0]+=tempr;
+		    data[i*ncpp+ic][1]+=tempi;
 		  }
-		wtemp=wr;
-		wr+=wr*wpr-   wi*wpi;
-		wi+=wi*wpr+wtemp*wpi;
 	      }
+	    wtemp=wr;
+	    wr+=wr*wpr-   wi*wpi;
+	    wi+=wi*wpr+wtemp*wpi;
 	  }
-	
-	if(normalize==1)
-	  for(int i=0;i<loc_size[mu]*ncpp;i++)
-	    for(int ri=0;ri<2;ri++) out[i][ri]/=glb_size[mu];
       }
-    
-    nissa_free(buf);
   }
+#endif
   
-  //perform the fft in all directions
-  void fft4d(complex *out,complex *in,bool *dirs,int ncpp,double sign,int normalize)
-  {
-    //copy input in the output (if they differ!)
-    if(out!=in) vector_copy(out,in);
-    
-    //perform the fft in each direction
-    for(int mu=0;mu<NDIM;mu++)
-      {
-	//perform the 1d fft (slower dir)
-	if(dirs[mu]) fft1d(out,out,ncpp*loc_vol/loc_size[mu],mu,sign,normalize);
-	
-	//for the time being we stick to transpose the data
-	data_coordinate_order_shift(out,ncpp,mu);
-      }
-  }
-  
-#else
-  
+  //perform the fft in all the requested directions
+  //each direction is made local in turn, distributing the perpendicular lines among all ranks, so that any rank grid is supported
   THREADABLE_FUNCTION_6ARG(fft4d, complex*,out, complex*,in, bool*,ext_dirs, int,ncpp, double,sign, int,normalize)
   {
     GET_THREAD_ID();
@@ -346,12 +252,23 @@ namespace nissa
 	//allocate buffer
 	complex *buf=nissa_malloc("buf",max_locd_size*ncpp,complex);
 	
-	//allocate plans
-	fftw_plan *plans=nissa_malloc("plans",ndirs,fftw_plan);
+#if FFT_TYPE == FFTW_FFT
+	//take the plans from the cache, according to the alignment of each line
+	fftw_plan *plans=nissa_malloc("plans",ndirs*NISSA_FFTW_NALIGN_LINES,fftw_plan);
 	if(IS_MASTER_THREAD)
 	  for(int idir=0;idir<ndirs;idir++)
-	    plans[idir]=fftw_plan_many_dft(1,glb_size+list_dirs[idir],ncpp,buf,NULL,ncpp,1,buf,NULL,ncpp,1,sign,FFTW_ESTIMATE);
+	    {
+	      int n=glb_size[list_dirs[idir]];
+	      for(int iline=0;iline<NISSA_FFTW_NALIGN_LINES;iline++)
+		plans[idir*NISSA_FFTW_NALIGN_LINES+iline]=get_fftw_plan(n,ncpp,sign,fftw_alignment_of((double*)(buf+iline*n*ncpp)));
+	    }
 	THREAD_BARRIER();
+#else
+	//allocate the workspace of each thread
+	int max_line_size=0;
+	for(int idir=0;idir<ndirs;idir++) max_line_size=std::max(max_line_size,glb_size[list_dirs[idir]]);
+	complex *line_buf=nissa_malloc("line_buf",NACTIVE_THREADS*max_line_size*ncpp,complex);
+#endif
 	
 	//transpose each dir in turn and take fft
 	for(int idir=0;idir<ndirs;idir++)
@@ -362,27 +279,33 @@ namespace nissa
 	    
 	    //makes all the fourier transform
 	    NISSA_PARALLEL_LOOP(ioff,0,locd_perp_size_per_dir[mu])
-	      fftw_execute_dft(plans[idir],buf+ioff*glb_size[mu]*ncpp,buf+ioff*glb_size[mu]*ncpp);
+#if FFT_TYPE == FFTW_FFT
+	      fftw_execute_dft(plans[idir*NISSA_FFTW_NALIGN_LINES+ioff%NISSA_FFTW_NALIGN_LINES],buf+ioff*glb_size[mu]*ncpp,buf+ioff*glb_size[mu]*ncpp);
+#else
+	      fft1d_local(buf+ioff*glb_size[mu]*ncpp,line_buf+THREAD_ID*max_line_size*ncpp,glb_size[mu],ncpp,sign);
+#endif
 	    THREAD_BARRIER();
 	    
 	    remap_locd_vector_to_lx(out,buf,ncpp*sizeof(complex),mu);
 	  }
 	
-	//destroy plans
-	if(IS_MASTER_THREAD) for(int idir=0;idir<ndirs;idir++) fftw_destroy_plan(plans[idir]);
+#if FFT_TYPE == FFTW_FFT
+	//plans are kept in the cache
+	nissa_free(plans);
+#else
+	nissa_free(line_buf);
+#endif
 	
 	//put normaliisation
 	if(normalize)
 	  {
 	    double norm=glb_size[list_dirs[0]];
-	    for(int idir=1;idir<ndirs;idir++) norm*=glb_size[idir];
+	    for(int idir=1;idir<ndirs;idir++) norm*=glb_size[list_dirs[idir]];
 	    double_vector_prod_double((double*)out,(double*)out,1/norm,2*ncpp*loc_vol);
 	  }
 	
 	nissa_free(buf);
-	nissa_free(plans);
       }
   }
   THREADABLE_FUNCTION_END
-#endif
 }
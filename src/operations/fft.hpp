@@ -4,15 +4,29 @@
 #include "geometry/geometry_lx.hpp"
 #include "new_types/complex.hpp"
 
+#ifndef EXTERN_FFT
+ #define EXTERN_FFT extern
+#endif
+
+#define NISSA_DEFAULT_FFTW_PLANNING_RIGOR 0
+
 namespace nissa
 {
   enum{FFT_NO_NORMALIZE=0,FFT_NORMALIZE=1};
 #define FFT_PLUS +1.0
 #define FFT_MINUS -1.0
   
+#if FFT_TYPE == FFTW_FFT
+  //rigor of fftw planning: 0=estimate, 1=measure, 2=patient
+  EXTERN_FFT int fftw_planning_rigor;
+  //file from which wisdom is loaded at init and where it is saved at close, not used if empty
+  EXTERN_FFT char fftw_wisdom_path[1024];
+#endif
+  
+  void init_fft_plans();
+  void destroy_fft_plans();
   int bitrev(int in,int l2n);
   int find_max_pow2(int a);
-  void data_coordinate_order_shift(complex *data,int ncpp,int mu0);
   void fft4d(complex *out,complex *in,bool *dirs,int ncpp,double sign,int normalize);
   inline void fft4d(complex *out,complex *in,int ncpp,double sign,int normalize)
   {fft4d(out,in,all_dirs,ncpp,sign,normalize);}
@@ -26,4 +40,6 @@ namespace nissa
   {fft4d(x,x,sign,normalize);}
 }
 
+#undef EXTERN_FFT
+
 #endif
@@ -298,35 +298,77 @@ namespace nissa
   THREADABLE_FUNCTION_END
   
   //overrelax an lx configuration
-  void overrelax_lx_conf_handle(su3 out,su3 staple,int ivol,int mu,void *pars)
-  {su3_find_overrelaxed(out,out,staple,((int*)pars)[0]);}
+  struct overrelax_lx_conf_kernel_t
+  {
+    int nhits;
+    void operator()(batch_su3 links,const batch_su3 staples,const int *ivol,int mu,int nlanes)
+    {batch_su3_find_overrelaxed(links,staples,nhits);}
+  };
   THREADABLE_FUNCTION_3ARG(overrelax_lx_conf, quad_su3*,conf, gauge_sweeper_t*,sweeper, int,nhits)
-  {sweeper->sweep_conf(conf,overrelax_lx_conf_handle,(void*)&nhits);}
+  {
+    overrelax_lx_conf_kernel_t kernel={nhits};
+    sweeper->sweep_conf(conf,kernel);
+  }
   THREADABLE_FUNCTION_END
   
-  //same for heatbath
-  namespace heatbath_lx_conf_ns
+  //same for heatbath, each link using the generator of its site
+  struct heatbath_lx_conf_kernel_t
   {
-    struct pars_t
+    double beta;
+    int nhits;
+    void operator()(batch_su3 links,const batch_su3 staples,const int *ivol,int mu,int nlanes)
     {
-      double beta;
-      int nhits;
-      pars_t(double beta,int nhits) : beta(beta),nhits(nhits){}
-    };
-    void handle(su3 out,su3 staple,int ivol,int mu,void *pars)
-    {su3_find_heatbath(out,out,staple,((pars_t*)pars)->beta,((pars_t*)pars)->nhits,loc_rnd_gen+ivol);}
-  }
+      philox_rnd_gen *gen[SU3_BATCH_NLANES];
+      BATCH_LANE_LOOP(l) gen[l]=loc_rnd_gen+ivol[l];
+      batch_su3_find_heatbath(links,staples,beta,nhits,gen,nlanes);
+    }
+  };
   THREADABLE_FUNCTION_4ARG(heatbath_lx_conf, quad_su3*,conf, gauge_sweeper_t*,sweeper, double,beta, int,nhits)
-  {heatbath_lx_conf_ns::pars_t pars(beta,nhits);sweeper->sweep_conf(conf,heatbath_lx_conf_ns::handle,&pars);}
+  {
+    heatbath_lx_conf_kernel_t kernel={beta,nhits};
+    sweeper->sweep_conf(conf,kernel);
+  }
   THREADABLE_FUNCTION_END
   
-  //same for cooling
-  void cool_lx_conf_handle(su3 out,su3 staple,int ivol,int mu,void *pars)
-  {su3_unitarize_maximal_trace_projecting_iteration(out,staple);}
+  //same for cooling, which is done link by link
+  struct cool_lx_conf_kernel_t
+  {
+    void operator()(batch_su3 links,const batch_su3 staples,const int *ivol,int mu,int nlanes)
+    {
+      for(int l=0;l<nlanes;l++)
+	{
+	  su3 link,staple;
+	  batch_su3_get_lane(link,links,l);
+	  batch_su3_get_lane(staple,staples,l);
+	  su3_unitarize_maximal_trace_projecting_iteration(link,staple);
+	  batch_su3_set_lane(links,link,l);
+	}
+    }
+  };
   THREADABLE_FUNCTION_2ARG(cool_lx_conf, quad_su3*,conf, gauge_sweeper_t*,sweeper)
-  {sweeper->sweep_conf(conf,cool_lx_conf_handle,NULL);}
+  {
+    cool_lx_conf_kernel_t kernel;
+    sweeper->sweep_conf(conf,kernel);
+  }
   THREADABLE_FUNCTION_END
   
+  //gauge energy of a site, out of the clover-shape paths
+  inline double gauge_energy_point(as2t_su3 leaves)
+  {
+    double energy=0.0;
+    for(int i=0;i<NDIM*(NDIM-1)/2;i++)
+      {
+	su3 A;
+	unsafe_su3_subt_su3_dag(A,leaves[i],leaves[i]);
+	su3_prodassign_double(A,1.0/8.0); //factor 1/2 for the antihermitian, 1/4 for average leave
+	complex temp;
+	trace_su3_prod_su3(temp,A,A);
+	energy-=temp[RE];
+      }
+    
+    return energy;
+  }
+  
   //measure the average gauge energy
   THREADABLE_FUNCTION_2ARG(average_gauge_energy, double*,energy, quad_su3*,conf)
   {
@@ -340,17 +382,7 @@ namespace nissa
 	as2t_su3 leaves;
 	four_leaves_point(leaves,conf,ivol);
 	
-	loc_energy[ivol]=0.0;
-	for(int i=0;i<NDIM*(NDIM-1)/2;i++)
-	  {
-	    su3 A;
-	    unsafe_su3_subt_su3_dag(A,leaves[i],leaves[i]);
-	    su3_prodassign_double(A,1.0/8.0); //factor 1/2 for the antihermitian, 1/4 for average leave
-	    complex temp;
-	    trace_su3_prod_su3(temp,A,A);
-	    loc_energy[ivol]-=temp[RE];
-	  }
-	loc_energy[ivol]/=glb_vol;
+	loc_energy[ivol]=gauge_energy_point(leaves)/glb_vol;
       }
     THREAD_BARRIER();
     
@@ -360,6 +392,22 @@ namespace nissa
   }
   THREADABLE_FUNCTION_END
   
+  //measure the average gauge energy out of the already computed clover-shape paths
+  THREADABLE_FUNCTION_2ARG(average_gauge_energy_from_leaves, double*,energy, as2t_su3*,leaves)
+  {
+    double *loc_energy=nissa_malloc("energy",loc_vol,double);
+    
+    GET_THREAD_ID();
+    NISSA_PARALLEL_LOOP(ivol,0,loc_vol)
+      loc_energy[ivol]=gauge_energy_point(leaves[ivol])/glb_vol;
+    THREAD_BARRIER();
+    
+    double_vector_glb_collapse(energy,loc_energy,loc_vol);
+    
+    nissa_free(loc_energy);
+  }
+  THREADABLE_FUNCTION_END
+  
   std::string gauge_obs_meas_pars_t::get_str(bool full)
   {
     std::ostringstream os;
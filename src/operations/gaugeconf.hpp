@@ -74,6 +74,7 @@ namespace nissa
   /////////////////////////////////////////////////////////////
   
   void average_gauge_energy(double *energy,quad_su3 *conf);
+  void average_gauge_energy_from_leaves(double *energy,as2t_su3 *leaves);
   inline double average_gauge_energy(quad_su3 *conf)
   {
     double energy;
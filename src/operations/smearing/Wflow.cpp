@@ -2,10 +2,14 @@
  #include "config.hpp"
 #endif
 
+#include <math.h>
+#include <vector>
+
 #include "base/thread_macros.hpp"
 #include "base/vectors.hpp"
 #include "communicate/edges.hpp"
 #include "new_types/su3_op.hpp"
+#include "operations/gaugeconf.hpp"
 #include "operations/su3_paths/plaquette.hpp"
 #include "routines/mpi_routines.hpp"
 #ifdef USE_THREADS
@@ -79,6 +83,96 @@ namespace nissa
 	    }
       set_borders_invalid(conf);
     }
+    
+    //apply the embedded second order step exp(9/4*arg1-3/4*arg0) to the conf after the first substep, see 1301.4388
+    void embedded_second_order_step(quad_su3 *conf1,quad_su3 *arg0,quad_su3 *arg1,bool *dirs)
+    {
+      GET_THREAD_ID();
+      
+      NISSA_PARALLEL_LOOP(ivol,0,loc_vol)
+	for(int mu=0;mu<NDIM;mu++)
+	  if(dirs[mu])
+	    {
+	      su3 arg,expiQ;
+	      su3_linear_comb(arg,arg1[ivol][mu],9.0/4,arg0[ivol][mu],-3.0/4);
+	      safe_hermitian_exact_i_exponentiate(expiQ,arg);
+	      safe_su3_prod_su3(conf1[ivol][mu],expiQ,conf1[ivol][mu]);
+	    }
+      THREAD_BARRIER();
+    }
+    
+    //maximal distance between the links of two confs, normalized to the number of entries
+    double max_links_distance(quad_su3 *a,quad_su3 *b,bool *dirs)
+    {
+      GET_THREAD_ID();
+      THREAD_BARRIER();
+      
+      double loc_max=0;
+      NISSA_PARALLEL_LOOP(ivol,0,loc_vol)
+	for(int mu=0;mu<NDIM;mu++)
+	  if(dirs[mu])
+	    {
+	      double d=0;
+	      for(int ic1=0;ic1<NCOL;ic1++)
+		for(int ic2=0;ic2<NCOL;ic2++)
+		  d+=sqrt(sqr(a[ivol][mu][ic1][ic2][RE]-b[ivol][mu][ic1][ic2][RE])+sqr(a[ivol][mu][ic1][ic2][IM]-b[ivol][mu][ic1][ic2][IM]));
+	      loc_max=std::max(loc_max,d/(NCOL*NCOL));
+	    }
+      
+      return glb_max_double(loc_max);
+    }
+    
+    //perform a step of the third order integrator, saving the starting conf in conf0
+    //returns the distance from the embedded second order step, estimating the integration error
+    double step_with_error(quad_su3 *conf,double dt,bool *dirs,quad_su3 *arg,quad_su3 *arg0,quad_su3 *conf0,quad_su3 *conf1)
+    {
+      vector_copy(conf0,conf);
+      vector_reset(arg);
+      
+      //first substep, saving the argument and the conf
+      update_arg(arg,conf,dt,dirs,0);
+      vector_copy(arg0,arg);
+      update_conf(arg,conf,dirs);
+      vector_copy(conf1,conf);
+      
+      //second substep, using the argument also for the embedded step
+      update_arg(arg,conf,dt,dirs,1);
+      embedded_second_order_step(conf1,arg0,arg,dirs);
+      update_conf(arg,conf,dirs);
+      
+      //last substep
+      update_arg(arg,conf,dt,dirs,2);
+      update_conf(arg,conf,dirs);
+      
+      return max_links_distance(conf,conf1,dirs);
+    }
+    
+    //plain step of the third order integrator
+    void step(quad_su3 *conf,double dt,bool *dirs,quad_su3 *arg)
+    {
+      vector_reset(arg);
+      for(int iter=0;iter<3;iter++)
+	{
+	  update_arg(arg,conf,dt,dirs,iter);
+	  update_conf(arg,conf,dirs);
+	}
+    }
+    
+    //step size for the next attempt, given the error of the last one: the local error scales as dt^3
+    double next_step_size(double dt,double err,double tol)
+    {
+      const double safety=0.95,max_growth=2;
+      if(err*max_growth*max_growth*max_growth<=tol) return dt*max_growth;
+      return dt*safety*cbrt(tol/err);
+    }
+    
+    //flow energy density times t^2
+    double t2E(quad_su3 *conf,double t)
+    {
+      double E;
+      average_gauge_energy(&E,conf);
+      return t*t*E;
+    }
   }
   
   //flow for the given time for a dt using 1006.4518 appendix C
@@ -86,16 +180,173 @@ namespace nissa
   {
     //storage for staples
     quad_su3 *arg=nissa_malloc("arg",loc_vol,quad_su3);
-    vector_reset(arg);
     
     //we write the 4 terms of the Runge Kutta scheme iteratively
-    for(int iter=0;iter<3;iter++)
+    Wflow::step(conf,dt,dirs,arg);
+    
+    nissa_free(arg);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //flow for exactly the given time, adapting the step so that the error stays below tol, as in 1301.4388
+  //dt is used as first step and returns the one to be used next, nevals is incremented by the number of force evaluations
+  THREADABLE_FUNCTION_6ARG(Wflow_lx_conf_adaptive, quad_su3*,conf, double,flow_time, double*,dt, double,tol, bool*,dirs, int*,nevals)
+  {
+    GET_THREAD_ID();
+    
+    quad_su3 *arg=nissa_malloc("arg",loc_vol,quad_su3);
+    quad_su3 *arg0=nissa_malloc("arg0",loc_vol,quad_su3);
+    quad_su3 *conf0=nissa_malloc("conf0",loc_vol+bord_vol+edge_vol,quad_su3);
+    quad_su3 *conf1=nissa_malloc("conf1",loc_vol+bord_vol+edge_vol,quad_su3);
+    
+    double t=0,eps=*dt;
+    int n=0,nrej=0;
+    while(t<flow_time)
+      {
+	//do not overshoot the requested time
+	bool last=(flow_time-t<=eps);
+	double h=last?(flow_time-t):eps;
+	
+	double err=Wflow::step_with_error(conf,h,dirs,arg,arg0,conf0,conf1);
+	n+=3;
+	
+	if(err<=tol)
+	  {
+	    t=last?flow_time:(t+h);
+	    if(not last) eps=Wflow::next_step_size(h,err,tol);
+	  }
+	else
+	  {
+	    vector_copy(conf,conf0);
+	    set_borders_invalid(conf);
+	    eps=Wflow::next_step_size(h,err,tol);
+	    nrej++;
+	  }
+	verbosity_lv3_master_printf("Wflow adaptive step %lg, error %lg, t=%lg\n",h,err,t);
+      }
+    verbosity_lv2_master_printf("Flown for %lg with %d force evaluations, %d rejected steps\n",flow_time,n,nrej);
+    
+    if(IS_MASTER_THREAD)
+      {
+	*dt=eps;
+	if(nevals) *nevals+=n;
+      }
+    THREAD_BARRIER();
+    
+    nissa_free(arg);
+    nissa_free(arg0);
+    nissa_free(conf0);
+    nissa_free(conf1);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //flow adaptively until t^2<E> and t d(t^2<E>)/dt cross F_ref, returning t0 and w0 in lattice units
+  //the flow stops exactly at t0, found refining the last step; w0 is obtained from the three points derivative of t^2<E>
+  //the conf is left flown up to w0^2, scales not found up to max_flow_time are returned as -1
+  THREADABLE_FUNCTION_8ARG(Wflow_lx_conf_find_scales, double*,t0, double*,w0, quad_su3*,conf, double,dt, double,tol, double,F_ref, double,max_flow_time, int*,nevals)
+  {
+    GET_THREAD_ID();
+    
+    quad_su3 *arg=nissa_malloc("arg",loc_vol,quad_su3);
+    quad_su3 *arg0=nissa_malloc("arg0",loc_vol,quad_su3);
+    quad_su3 *conf0=nissa_malloc("conf0",loc_vol+bord_vol+edge_vol,quad_su3);
+    quad_su3 *conf1=nissa_malloc("conf1",loc_vol+bord_vol+edge_vol,quad_su3);
+    
+    //history of flow time, t^2<E> and t d(t^2<E>)/dt
+    std::vector<double> t(1,0.0),F(1,0.0),W(1,0.0);
+    
+    double T0=-1,W0sq=-1,eps=dt;
+    int n=0;
+    while((T0<0 or W0sq<0) and t.back()<max_flow_time)
+      {
+	double ta=t.back(),Fa=F.back();
+	double h=std::min(eps,max_flow_time-ta);
+	double err=Wflow::step_with_error(conf,h,all_dirs,arg,arg0,conf0,conf1);
+	n+=3;
+	
+	if(err>tol)
+	  {
+	    vector_copy(conf,conf0);
+	    set_borders_invalid(conf);
+	    eps=Wflow::next_step_size(h,err,tol);
+	  }
+	else
+	  {
+	    eps=Wflow::next_step_size(h,err,tol);
+	    double tb=ta+h,Fb=Wflow::t2E(conf,tb);
+	    
+	    //refine t0 by regula falsi, flowing from the last point below the reference
+	    if(T0<0 and Fb>=F_ref)
+	      {
+		const int nmax_iters=20;
+		double ts=tb,Fs=Fb;
+		int iter=0;
+		do
+		  {
+		    double ts_old=ts;
+		    ts=ta+(F_ref-Fa)*(tb-ta)/(Fb-Fa);
+		    
+		    vector_copy(conf,conf0);
+		    Wflow::step(conf,ts-ta,all_dirs,arg);
+		    n+=3;
+		    Fs=Wflow::t2E(conf,ts);
+		    
+		    if(Fs<F_ref)
+		      {
+			vector_copy(conf0,conf);
+			ta=ts;
+			Fa=Fs;
+		      }
+		    else
+		      {
+			tb=ts;
+			Fb=Fs;
+		      }
+		    iter++;
+		    if(fabs(ts-ts_old)<=1e-10*ts) break;
+		  }
+		while(fabs(Fs-F_ref)>1e-10*F_ref and iter<nmax_iters);
+		
+		T0=ts;
+		tb=ts;
+		Fb=Fs;
+		verbosity_lv2_master_printf("Found t0=%.16lg with %d refinement iterations\n",T0,iter);
+	      }
+	    
+	    t.push_back(tb);
+	    F.push_back(Fb);
+	    
+	    //derivative in the previous point, taking the neighbours
+	    int i=t.size()-2;
+	    if(i>=1)
+	      {
+		double h1=t[i]-t[i-1],h2=t[i+1]-t[i];
+		double dF=(h1*h1*(F[i+1]-F[i])+h2*h2*(F[i]-F[i-1]))/(h1*h2*(h1+h2));
+		W.push_back(t[i]*dF);
+		
+		//interpolate linearly w0^2 if crossed
+		if(W0sq<0 and i>=2 and W[i]>=F_ref)
+		  W0sq=t[i-1]+(F_ref-W[i-1])*(t[i]-t[i-1])/(W[i]-W[i-1]);
+	      }
+	  }
+      }
+    
+    if(T0<0) master_printf("WARNING: t0 not reached up to flow time %lg\n",max_flow_time);
+    if(W0sq<0) master_printf("WARNING: w0 not reached up to flow time %lg\n",max_flow_time);
+    verbosity_lv2_master_printf("Scale setting done with %d force evaluations\n",n);
+    
+    if(IS_MASTER_THREAD)
       {
-	Wflow::update_arg(arg,conf,dt,dirs,iter);
-	Wflow::update_conf(arg,conf,dirs);
+	*t0=T0;
+	*w0=(W0sq<0)?-1:sqrt(W0sq);
+	if(nevals) *nevals+=n;
       }
+    THREAD_BARRIER();
     
     nissa_free(arg);
+    nissa_free(arg0);
+    nissa_free(conf0);
+    nissa_free(conf1);
   }
   THREADABLE_FUNCTION_END
 }
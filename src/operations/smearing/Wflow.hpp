@@ -26,9 +26,13 @@ namespace nissa
     int nflows;
     double dt;
     int nrecu;
+    int adaptive;
+    double tol;
     double def_nflows(){return 50;}
     double def_dt(){return 0.2;}
     int def_nrecu(){return 5;}
+    int def_adaptive(){return 0;}
+    double def_tol(){return 1e-5;}
     
     int master_fprintf(FILE *fout,bool full) {return nissa::master_fprintf(fout,"%s",get_str().c_str());}
     std::string get_str(bool full=false)
@@ -41,6 +45,8 @@ namespace nissa
 	  if(full or nflows!=def_nflows()) os<<" NFlows\t=\t"<<nflows<<"\n";
 	  if(full or dt!=def_dt()) os<<" FlowStep\t=\t"<<dt<<"\n";
 	  if(full or nrecu!=def_nrecu()) os<<" NRecu\t=\t"<<nrecu<<"\n";
+	  if(full or adaptive!=def_adaptive()) os<<" Adaptive\t=\t"<<adaptive<<"\n";
+	  if(full or tol!=def_tol()) os<<" Tolerance\t=\t"<<tol<<"\n";
 	}
       
       return os.str();
@@ -51,13 +57,17 @@ namespace nissa
       return
 	nflows!=def_nflows() or
 	dt!=def_dt() or
-	nrecu!=def_nrecu();
+	nrecu!=def_nrecu() or
+	adaptive!=def_adaptive() or
+	tol!=def_tol();
     }
     
     Wflow_pars_t() :
       nflows(def_nflows()),
       dt(def_dt()),
-      nrecu(def_nrecu()) {}
+      nrecu(def_nrecu()),
+      adaptive(def_adaptive()),
+      tol(def_tol()) {}
   };
   
   /////////////////////////////////////////////////// fermions /////////////////////////////////////////////////////////
@@ -224,6 +234,8 @@ namespace nissa
   };
   
   void Wflow_lx_conf(quad_su3 *conf,double dt,bool *dirs=all_dirs);
+  void Wflow_lx_conf_adaptive(quad_su3 *conf,double flow_time,double *dt,double tol,bool *dirs=all_dirs,int *nevals=NULL);
+  void Wflow_lx_conf_find_scales(double *t0,double *w0,quad_su3 *conf,double dt,double tol,double F_ref,double max_flow_time,int *nevals=NULL);
   void Wflow_fermion_fields(quad_su3 *ori_conf,double dt,bool *dirs,int nfields,color **ferm,bool stag);
   void Wflow_fermion_fields_adjoint(quad_su3 *ori_conf,double dt,bool *dirs,int nfields,color **ferm,bool stag);
 }
@@ -2,9 +2,13 @@
  #include "config.hpp"
 #endif
 
+#include <algorithm>
+
+#include "base/debug.hpp"
 #include "base/thread_macros.hpp"
 #include "base/vectors.hpp"
 #include "communicate/borders.hpp"
+#include "communicate/communicate.hpp"
 #include "geometry/geometry_lx.hpp"
 #include "linalgs/linalgs.hpp"
 #include "new_types/su3_op.hpp"
@@ -98,6 +102,75 @@ namespace nissa
   DEFINE_GAUSSIAN_SMEARING_APPLY_KAPPA_H(color)
   DEFINE_GAUSSIAN_SMEARING(color)
     
+  //apply kappa*H to nrhs spincolor stored interleaved, in[ivol*nrhs+irhs], loading the links once for all of them
+  THREADABLE_FUNCTION_5ARG(gaussian_smearing_apply_kappa_H_multi_spincolor, spincolor*,H, double,kappa, quad_su3*,conf, int,nrhs, spincolor*,in)
+  {
+    GET_THREAD_ID();
+    
+    communicate_lx_multi_spincolor_borders(in,nrhs);
+    communicate_lx_quad_su3_borders(conf);
+    
+    NISSA_PARALLEL_LOOP(ivol,0,loc_vol)
+      {
+	for(int irhs=0;irhs<nrhs;irhs++) spincolor_put_to_zero(H[ivol*nrhs+irhs]);
+	
+	for(int mu=1;mu<NDIM;mu++)
+	  {
+	    int ivup=loclx_neighup[ivol][mu];
+	    int ivdw=loclx_neighdw[ivol][mu];
+	    
+	    for(int irhs=0;irhs<nrhs;irhs++)
+	      {
+		su3_summ_the_prod_spincolor(H[ivol*nrhs+irhs],conf[ivol][mu],in[ivup*nrhs+irhs]);
+		su3_dag_summ_the_prod_spincolor(H[ivol*nrhs+irhs],conf[ivdw][mu],in[ivdw*nrhs+irhs]);
+	      }
+	  }
+	
+	for(int irhs=0;irhs<nrhs;irhs++) spincolor_prod_double(H[ivol*nrhs+irhs],H[ivol*nrhs+irhs],kappa);
+      }
+    
+    set_borders_invalid(H);
+  }
+  THREADABLE_FUNCTION_END
+  
+  //smear nvec spincolor at once, up to NISSA_MAX_NRHS together, so that the links are streamed and the borders
+  //exchanged once per iteration for all of them
+  void gaussian_smearing(spincolor **smear_sc,spincolor **origi_sc,int nvec,quad_su3 *conf,double kappa,int niter)
+  {
+    if(niter<1)
+      {
+	verbosity_lv2_master_printf("Skipping smearing (0 iter required)\n");
+	for(int ivec=0;ivec<nvec;ivec++) if(smear_sc[ivec]!=origi_sc[ivec]) vector_copy(smear_sc[ivec],origi_sc[ivec]);
+	return;
+      }
+    
+    int nrhs_max=std::min(nvec,NISSA_MAX_NRHS);
+    spincolor *temp=nissa_malloc("temp",(loc_vol+bord_vol)*nrhs_max,spincolor);
+    spincolor *H=nissa_malloc("H",(loc_vol+bord_vol)*nrhs_max,spincolor);
+    
+    double norm_fact=1/(1+6*kappa);
+    
+    for(int ivec_base=0;ivec_base<nvec;ivec_base+=nrhs_max)
+      {
+	int nrhs=std::min(nrhs_max,nvec-ivec_base);
+	for(int irhs=0;irhs<nrhs;irhs++) put_spincolor_into_multi_spincolor(temp,origi_sc[ivec_base+irhs],irhs,nrhs);
+	
+	verbosity_lv2_master_printf("GAUSSIAN smearing with kappa=%g of %d vectors, %d iterations\n",kappa,nrhs,niter);
+	
+	for(int iter=0;iter<niter;iter++)
+	  {
+	    //apply kappa*H, add it and dynamic normalize
+	    gaussian_smearing_apply_kappa_H_multi_spincolor(H,kappa,conf,nrhs,temp);
+	    double_vector_prod_the_summ_double((double*)temp,norm_fact,(double*)temp,(double*)H,sizeof(spincolor)/sizeof(double)*loc_vol*nrhs);
+	  }
+	
+	for(int irhs=0;irhs<nrhs;irhs++) get_spincolor_from_multi_spincolor(smear_sc[ivec_base+irhs],temp,irhs,nrhs);
+      }
+    
+    nissa_free(H);
+    nissa_free(temp);
+  }
+  
   //smear with a polynomial of H
   template <class TYPE> void gaussian_smearing(TYPE *smear_sc,TYPE *origi_sc,quad_su3 *conf,double kappa,int nterm,double *coeff,int *exponent)
   {
@@ -11,8 +11,10 @@ namespace nissa
   void gaussian_smearing(spincolor *smear_sc,spincolor *origi_sc,quad_su3 *conf,double kappa,int niter,spincolor *ext_temp=NULL,spincolor *ext_H=NULL);
   void gaussian_smearing(spincolor *smear_sc,spincolor *origi_sc,quad_su3 *conf,double kappa,int nterm,double *coeff,int *exponent);
   void gaussian_smearing(colorspinspin *smear_css,colorspinspin *origi_css,quad_su3 *conf,double kappa,int nterm,double *coeff,int *exponent);
+  void gaussian_smearing(spincolor **smear_sc,spincolor **origi_sc,int nvec,quad_su3 *conf,double kappa,int niter);
   void gaussian_smearing_apply_kappa_H_color(color *H,double kappa,quad_su3 *conf,color *smear_c);
   void gaussian_smearing_apply_kappa_H_spincolor(spincolor *H,double kappa,quad_su3 *conf,spincolor *smear_sc);
+  void gaussian_smearing_apply_kappa_H_multi_spincolor(spincolor *H,double kappa,quad_su3 *conf,int nrhs,spincolor *smear_sc);
 }
 
 #endif
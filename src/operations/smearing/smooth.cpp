@@ -2,6 +2,8 @@
  #include "config.hpp"
 #endif
 
+#include <algorithm>
+
 #include "smooth.hpp"
 #include "operations/gaugeconf.hpp"
 #include "operations/su3_paths/gauge_sweeper.hpp"
@@ -16,12 +18,40 @@ namespace nissa
       {
       case smooth_pars_t::COOLING: cool_lx_conf(smoothed_conf,get_sweeper(sp.cool.gauge_action));break;
       case smooth_pars_t::STOUT: stout_smear_single_level(smoothed_conf,smoothed_conf,sp.stout.rho,dirs);;break;
-      case smooth_pars_t::WFLOW: Wflow_lx_conf(smoothed_conf,sp.Wflow.dt,dirs);break;
+      case smooth_pars_t::WFLOW:
+	if(sp.Wflow.adaptive)
+	  {
+	    double dt=sp.Wflow.dt;
+	    Wflow_lx_conf_adaptive(smoothed_conf,sp.Wflow.dt,&dt,sp.Wflow.tol,dirs);
+	  }
+	else Wflow_lx_conf(smoothed_conf,sp.Wflow.dt,dirs);
+	break;
       case smooth_pars_t::HYP: hyp_smear_conf(smoothed_conf,smoothed_conf,sp.hyp.alpha0,sp.hyp.alpha1,sp.hyp.alpha2,dirs);break;
       case smooth_pars_t::APE: ape_smear_conf(smoothed_conf,smoothed_conf,sp.ape.alpha,1,dirs,staple_min_dir);break;
       }
   }
   
+  //smooth a configuration from nsmooth up to target
+  void smooth_lx_conf_until(quad_su3 *smoothed_conf,smooth_pars_t &sp,int &nsmooth,int target,bool *dirs,int staple_min_dir)
+  {
+    if(sp.method==smooth_pars_t::COOLING and dirs!=all_dirs) crash("not implemented");
+    
+    //adaptive flow reaches the target in a single go
+    if(sp.method==smooth_pars_t::WFLOW and sp.Wflow.adaptive)
+      {
+	double dt=sp.Wflow.dt;
+	verbosity_lv3_master_printf("flowing adaptively from %d to %d\n",nsmooth,target);
+	if(target>nsmooth) Wflow_lx_conf_adaptive(smoothed_conf,(target-nsmooth)*sp.Wflow.dt,&dt,sp.Wflow.tol,dirs);
+	nsmooth=std::max(nsmooth,target);
+      }
+    else
+      while(nsmooth<target)
+	{
+	  smooth_lx_conf_one_step(smoothed_conf,sp,dirs,staple_min_dir);
+	  nsmooth++;
+	}
+  }
+  
   //smooth a configuration until measure is due
   bool smooth_lx_conf_until_next_meas(quad_su3 *smoothed_conf,smooth_pars_t &sp,int &nsmooth,bool *dirs,int staple_min_dir)
   {
@@ -29,6 +59,14 @@ namespace nissa
     
     bool finished=false;
     int next_nsmooth_meas=sp.next_nsmooth_meas(nsmooth);
+    
+    //adaptive flow reaches the time of next measure in a single go
+    if(sp.method==smooth_pars_t::WFLOW and sp.Wflow.adaptive)
+      {
+	smooth_lx_conf_until(smoothed_conf,sp,nsmooth,std::min(next_nsmooth_meas,sp.nsmooth()+1),dirs,staple_min_dir);
+	return (nsmooth>sp.nsmooth());
+      }
+    
     while(nsmooth<next_nsmooth_meas and not finished)
       {
 	verbosity_lv3_master_printf("smoothing %d to %d %d\n",nsmooth,next_nsmooth_meas,(int)(nsmooth>sp.nsmooth()));
@@ -43,6 +81,13 @@ namespace nissa
   //smooth a configuration as imposed
   void smooth_lx_conf(quad_su3 *smoothed_conf,smooth_pars_t &sp,bool *dirs,int staple_min_dir)
   {
+    if(sp.method==smooth_pars_t::WFLOW and sp.Wflow.adaptive)
+      {
+	double dt=sp.Wflow.dt;
+	Wflow_lx_conf_adaptive(smoothed_conf,sp.nsmooth()*sp.Wflow.dt,&dt,sp.Wflow.tol,dirs);
+	return;
+      }
+    
     for(int ismooth=0;ismooth<sp.nsmooth();ismooth++)
       smooth_lx_conf_one_step(smoothed_conf,sp,dirs,staple_min_dir);
   }
@@ -123,6 +123,20 @@ namespace nissa
 	}
     }
     
+    //sets the number of smooth
+    void set_nsmooth(int n)
+    {
+      switch(method)
+	{
+	case COOLING:cool.nsteps=n;break;
+	case STOUT:stout.nlevels=n;break;
+	case WFLOW:Wflow.nflows=n;break;
+	case APE:ape.nlevels=n;break;
+	case HYP:hyp.nlevels=n;break;
+	default:crash("not meant to be reached");
+	}
+    }
+    
     //returns the number of measurement, without 0
     int nmeas_nonzero()
     {return nsmooth()/meas_each_nsmooth;}
@@ -146,6 +160,7 @@ namespace nissa
   };
   
   void smooth_lx_conf_one_step(quad_su3 *smoothed_conf,smooth_pars_t &sp,bool *dirs=all_dirs,int staple_min_dir=0);
+  void smooth_lx_conf_until(quad_su3 *smoothed_conf,smooth_pars_t &sp,int &nsmooth,int target,bool *dirs=all_dirs,int staple_min_dir=0);
   bool smooth_lx_conf_until_next_meas(quad_su3 *smoothed_conf,smooth_pars_t &sp,int &nsmooth,bool *dirs=all_dirs,int staple_min_dir=0);
   void smooth_lx_conf(quad_su3 *smoothed_conf,smooth_pars_t &sp,bool *dirs=all_dirs,int staple_min_dir=0);
 }
@@ -158,6 +158,20 @@ namespace nissa
   }
   THREADABLE_FUNCTION_END
   
+  //32 bit case
+  void unsafe_apply_point_chromo_operator_to_single_spincolor(single_spincolor out,single_clover_term_t Cl,single_spincolor in)
+  {
+    unsafe_single_su3_prod_single_color(out[0],Cl[0],in[0]);
+    single_su3_dag_summ_the_prod_single_color(out[0],Cl[1],in[1]);
+    unsafe_single_su3_prod_single_color(out[1],Cl[1],in[0]);
+    single_su3_subt_the_prod_single_color(out[1],Cl[0],in[1]);
+    
+    unsafe_single_su3_prod_single_color(out[2],Cl[2],in[2]);
+    single_su3_dag_summ_the_prod_single_color(out[2],Cl[3],in[3]);
+    unsafe_single_su3_prod_single_color(out[3],Cl[3],in[2]);
+    single_su3_subt_the_prod_single_color(out[3],Cl[2],in[3]);
+  }
+  
   //apply the chromo operator to the passed colorspinspin
   //normalization as in ape next
   THREADABLE_FUNCTION_3ARG(unsafe_apply_chromo_operator_to_colorspinspin, colorspinspin*,out, clover_term_t*,Cl, colorspinspin*,in)
@@ -230,6 +244,16 @@ namespace nissa
     su3_summ_the_prod_color_128(out[1],Cl[1],in[0]);
     su3_subt_the_prod_color_128(out[1],Cl[0],in[1]);
   }
+  void apply_point_diag_plus_clover_term_to_single_halfspincolor(single_halfspincolor out,single_complex diag,single_clover_term_t Cl,single_halfspincolor in)
+  {
+    for(int ic=0;ic<NCOL;ic++) unsafe_single_complex_prod(out[0][ic],in[0][ic],diag);
+    single_su3_summ_the_prod_single_color(out[0],Cl[0],in[0]);
+    single_su3_dag_summ_the_prod_single_color(out[0],Cl[1],in[1]);
+    
+    for(int ic=0;ic<NCOL;ic++) unsafe_single_complex_prod(out[1][ic],in[1][ic],diag);
+    single_su3_summ_the_prod_single_color(out[1],Cl[1],in[0]);
+    single_su3_subt_the_prod_single_color(out[1],Cl[0],in[1]);
+  }
   
   void apply_point_squared_twisted_clover_term_to_halfspincolor(halfspincolor out,double mass,double kappa,clover_term_t Cl,halfspincolor in)
   {
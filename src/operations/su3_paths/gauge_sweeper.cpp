@@ -223,14 +223,21 @@ namespace nissa
 	delete gl[ibox];
       }
     
-    //compute the maximum number of links to send and receive and allocate buffers
+    //compute the maximum number of links to send and receive and allocate buffers, separated per box so that the
+    //communications of different boxes can be in flight at the same time
+    int tot_sending_link=0,tot_cached_link=0;
     for(int ibox=0;ibox<(1<<NDIM);ibox++)
       {
 	max_cached_link=std::max(max_cached_link,box_comm[ibox]->nel_in);
 	max_sending_link=std::max(max_sending_link,box_comm[ibox]->nel_out);
+	box_buf_out_off[ibox]=tot_sending_link;
+	box_buf_in_off[ibox]=tot_cached_link;
+	tot_sending_link+=box_comm[ibox]->nel_out;
+	tot_cached_link+=box_comm[ibox]->nel_in;
       }
-    buf_out=nissa_malloc("buf_out",max_sending_link,su3);
-    buf_in=nissa_malloc("buf_in",max_cached_link,su3);
+    buf_out=nissa_malloc("buf_out",tot_sending_link,su3);
+    buf_in=nissa_malloc("buf_in",tot_cached_link,su3);
+    find_box_comm_post_after();
     
     //check cached
     verbosity_lv3_master_printf("Max cached links: %d\n",max_cached_link);
@@ -241,6 +248,42 @@ namespace nissa
     check_hit_in_the_exact_order();
   }
   
+  //find the last box which must be updated before sending the links needed by each box: the links are sent as
+  //soon as possible, so that the communication overlaps with the update of the boxes in between
+  void gauge_sweeper_t::find_box_comm_post_after()
+  {
+    //box of each local site
+    int *box_of_loclx=nissa_malloc("box_of_loclx",loc_vol,int);
+    int ibase=0;
+    for(int ibox=0;ibox<(1<<NDIM);ibox++)
+      for(int dir=0;dir<NDIM;dir++)
+	for(int par=0;par<gpar;par++)
+	  {
+	    int box_dir_par_size=nsite_per_box_dir_par[par+gpar*(dir+NDIM*ibox)];
+	    for(int ibox_dir_par=ibase;ibox_dir_par<ibase+box_dir_par_size;ibox_dir_par++)
+	      box_of_loclx[ivol_of_box_dir_par[ibox_dir_par]]=ibox;
+	    ibase+=box_dir_par_size;
+	  }
+    
+    //links sent are updated in the boxes preceding the receiving one, or in the previous sweep
+    for(int ibox=0;ibox<(1<<NDIM);ibox++)
+      {
+	box_comm_post_after[ibox]=-1;
+	for(int iel_out=0;iel_out<box_comm[ibox]->nel_out;iel_out++)
+	  {
+	    int jbox=box_of_loclx[box_comm[ibox]->out_buf_source[iel_out]/NDIM];
+	    if(jbox<ibox) box_comm_post_after[ibox]=std::max(box_comm_post_after[ibox],jbox);
+	  }
+      }
+    nissa_free(box_of_loclx);
+    
+    //all ranks must agree
+    MPI_Allreduce(MPI_IN_PLACE,box_comm_post_after,1<<NDIM,MPI_INT,MPI_MAX,MPI_COMM_WORLD);
+    
+    for(int ibox=0;ibox<(1<<NDIM);ibox++)
+      verbosity_lv3_master_printf("Links needed by box %d sent after updating box %d\n",ibox,box_comm_post_after[ibox]);
+  }
+  
   //ordering for link_source_dest
   int compare_link_source_dest(const void *a,const void *b)
   {return ((int*)a)[0]-((int*)b)[0];}
@@ -284,9 +327,15 @@ namespace nissa
 	    for(int par=0;par<gpar;par++)
 	      {
 		//find the packing size
-		int ns=nsite_per_box_dir_par[par+gpar*(dir+NDIM*ibox)],nsh=ns/2; //only for bg/q
+		int ns=nsite_per_box_dir_par[par+gpar*(dir+NDIM*ibox)];
+#ifdef BGQ
+		int nsh=ns/2;
 		if(nsh*2!=ns) nsh++;
 		max_packing_link_nel=std::max(max_packing_link_nel,nlinks_per_staples_of_link*2*nsh);
+#else
+		int nbatch=(ns+SU3_BATCH_NLANES-1)/SU3_BATCH_NLANES;
+		max_packing_link_nel=std::max(max_packing_link_nel,nlinks_per_staples_of_link*SU3_BATCH_NLANES*nbatch);
+#endif
 		
 		//scan the destination
 		for(int ibox_dir_par=0;ibox_dir_par<ns;ibox_dir_par++)
@@ -300,7 +349,9 @@ namespace nissa
 			((ilink+nlinks_per_staples_of_link*(ibox_dir_par%nsh))<<1)+
 			 (ibox_dir_par>=nsh) //vnode bit
 #else
-			ilink+nlinks_per_staples_of_link*ibox_dir_par
+			//otherwise each link goes in the lane of its site, inside the batch
+			(ilink+nlinks_per_staples_of_link*(ibox_dir_par/SU3_BATCH_NLANES))*SU3_BATCH_NLANES+
+			 ibox_dir_par%SU3_BATCH_NLANES
 #endif
 			;
 		    }
@@ -313,9 +364,7 @@ namespace nissa
 	
 	//allocate packing link and deallocate ilink_per_staples
 	packing_link_buf=nissa_malloc("packing_link_buf",max_packing_link_nel,su3);
-#ifdef BGQ
 	vector_reset(packing_link_buf); //might be used when not initialized
-#endif
 	nissa_free(ilink_per_staples);
       }
   }
@@ -385,7 +434,7 @@ namespace nissa
 	//copy
 	SU3_TO_VIR_SU3(((vir_su3*)packing_link_buf)[true_dest],((su3*)conf)[isource],vnode);
 #else
-	su3_copy(packing_link_buf[idest],((su3*)conf)[isource]);
+	batch_su3_set_lane(((batch_su3*)packing_link_buf)[idest/SU3_BATCH_NLANES],((su3*)conf)[isource],idest%SU3_BATCH_NLANES);
 #endif
       }
     THREAD_BARRIER();
@@ -750,10 +799,11 @@ namespace nissa
 	const int nlinks_per_Symanzik_staples_of_link=(NDIM-1)*2*(3+5*3)-(NDIM-1)*8+2;
 	Symanzik_sweeper->init_box_dir_par_geometry(4,Symanzik_par);
 	Symanzik_sweeper->init_staples(nlinks_per_Symanzik_staples_of_link,add_Symanzik_staples,compute_Symanzik_staples);
+	Symanzik_sweeper->staples_kind=SYMANZIK_SWEEPER_STAPLES;
 #ifdef BGQ
 	Symanzik_sweeper->compute_staples_packed_bgq=compute_Symanzik_staples_packed_bgq;
-	Symanzik_sweeper->find_packing_index(compute_Symanzik_staples_packed);
 #endif
+	Symanzik_sweeper->find_packing_index(compute_Symanzik_staples_packed);
       }
   }
   
@@ -900,10 +950,11 @@ namespace nissa
 	Wilson_sweeper->init_box_dir_par_geometry(2,Wilson_par);
 	const int nlinks_per_Wilson_staples_of_link=6*(NDIM-1);
 	Wilson_sweeper->init_staples(nlinks_per_Wilson_staples_of_link,add_Wilson_staples,compute_Wilson_staples);
+	Wilson_sweeper->staples_kind=WILSON_SWEEPER_STAPLES;
 #ifdef BGQ
 	Wilson_sweeper->compute_staples_packed_bgq=compute_Wilson_staples_packed_bgq;
-	Wilson_sweeper->find_packing_index(compute_Wilson_staples_packed);
 #endif
+	Wilson_sweeper->find_packing_index(compute_Wilson_staples_packed);
       }
   }
   
@@ -9,7 +9,9 @@
 #include "base/vectors.hpp"
 #include "communicate/all_to_all.hpp"
 #include "hmc/gauge/gluonic_action.hpp"
+#include "hmc/gauge/Symanzik_action.hpp"
 #include "new_types/su3.hpp"
+#include "new_types/su3_batch.hpp"
 #include "new_types/su3_op.hpp"
 #ifdef USE_THREADS
  #include "routines/thread.hpp"
@@ -25,6 +27,98 @@ namespace nissa
   void compute_Symanzik_staples_packed_bgq(su3 staples1,su3 staples2,vir_su3 *links);
 #endif
   
+  //kind of staples computed by the sweeper
+  enum sweeper_staples_t{WILSON_SWEEPER_STAPLES,SYMANZIK_SWEEPER_STAPLES};
+  
+  //compute the staples of a batch of links out of the packed links, with the same sequence of the scalar routines
+  struct Wilson_batch_staples_t
+  {
+    static void compute(batch_su3 staples,batch_su3 *links,double C1)
+    {
+      batch_su3_put_to_zero(staples);
+      
+      for(int inu=0;inu<NDIM-1;inu++)
+	{
+	  batch_su3 hb;
+	  //backward square staple
+	  unsafe_batch_su3_dag_prod_batch_su3(hb,links[ 0],links[ 1]);
+	  batch_su3_summ_the_prod_batch_su3(staples,hb,links[ 2]);
+	  //forward square staple
+	  batch_su3 hf;
+	  unsafe_batch_su3_prod_batch_su3(hf,links[ 3],links[ 4]);
+	  batch_su3_summ_the_prod_batch_su3_dag(staples,hf,links[ 5]);
+	  
+	  links+=6;
+	}
+    }
+  };
+  
+  struct Symanzik_batch_staples_t
+  {
+    static void compute(batch_su3 staples,batch_su3 *links,double C1)
+    {
+      double C0=get_C0(C1);
+      
+      batch_su3 squares,rectangles,up_rectangles,dw_rectangles;
+      batch_su3_put_to_zero(squares);
+      batch_su3_put_to_zero(rectangles);
+      batch_su3_put_to_zero(up_rectangles);
+      batch_su3_put_to_zero(dw_rectangles);
+      
+      const int PARTIAL=2;
+      for(int inu=0;inu<NDIM-1;inu++)
+	{
+	  batch_su3 hb;
+	  //backward square staple
+	  unsafe_batch_su3_dag_prod_batch_su3(hb,links[ 0],links[ 1]);
+	  batch_su3_summ_the_prod_batch_su3(squares,hb,links[ 2]);
+	  //forward square staple
+	  batch_su3 hf;
+	  unsafe_batch_su3_prod_batch_su3(hf,links[ 3],links[ 4]);
+	  batch_su3_summ_the_prod_batch_su3_dag(squares,hf,links[ 5]);
+	  
+	  batch_su3 temp1,temp2;
+	  //backward dw rectangle
+	  unsafe_batch_su3_dag_prod_batch_su3(temp2,links[ 6],links[ 7],PARTIAL);
+	  unsafe_batch_su3_prod_batch_su3(temp1,temp2,links[ 8],PARTIAL);
+	  batch_su3_build_third_row(temp1);
+	  batch_su3_summ_the_prod_batch_su3(dw_rectangles,temp1,links[9]);
+	  //backward backward rectangle
+	  unsafe_batch_su3_dag_prod_batch_su3_dag(temp1,links[10],links[11],PARTIAL);
+	  unsafe_batch_su3_prod_batch_su3(temp2,temp1,links[12],PARTIAL);
+	  unsafe_batch_su3_prod_batch_su3(temp1,temp2,links[13],PARTIAL);
+	  batch_su3_build_third_row(temp1);
+	  batch_su3_summ_the_prod_batch_su3(rectangles,temp1,links[14]);
+	  //backward up rectangle
+	  unsafe_batch_su3_prod_batch_su3(temp2,hb,links[15]);
+	  batch_su3_summ_the_prod_batch_su3(up_rectangles,temp2,links[16]);
+	  //forward dw rectangle
+	  unsafe_batch_su3_prod_batch_su3(temp2,links[17],links[18],PARTIAL);
+	  unsafe_batch_su3_prod_batch_su3(temp1,temp2,links[19],PARTIAL);
+	  batch_su3_build_third_row(temp1);
+	  batch_su3_summ_the_prod_batch_su3_dag(dw_rectangles,temp1,links[20]);
+	  //forward forward rectangle
+	  unsafe_batch_su3_prod_batch_su3(temp1,links[21],links[22],PARTIAL);
+	  unsafe_batch_su3_prod_batch_su3(temp2,temp1,links[23],PARTIAL);
+	  unsafe_batch_su3_prod_batch_su3_dag(temp1,temp2,links[24],PARTIAL);
+	  batch_su3_build_third_row(temp1);
+	  batch_su3_summ_the_prod_batch_su3_dag(rectangles,temp1,links[25]);
+	  //forward up rectangle
+	  unsafe_batch_su3_prod_batch_su3(temp2,hf,links[26]);
+	  batch_su3_summ_the_prod_batch_su3_dag(up_rectangles,temp2,links[27]);
+	  
+	  links+=28;
+	}
+      
+      //close the two partial rectangles
+      batch_su3_summ_the_prod_batch_su3_dag(rectangles,up_rectangles,links[ 0]);
+      batch_su3_summ_the_dag_prod_batch_su3(rectangles,links[ 1],dw_rectangles);
+      
+      //compute the summed staples
+      batch_su3_linear_comb(staples,squares,C0,rectangles,C1);
+    }
+  };
+  
   //sweep a configuration, possibly using subboxes, each divided in checkboard so to avoid communication problem
   struct gauge_sweeper_t
   {
@@ -35,6 +129,9 @@ namespace nissa
     //this is fixed when asking a sweeper
     double C1;
     
+    //staples of the action, selecting the specialization of the sweep
+    sweeper_staples_t staples_kind;
+    
     //benchmarks and checks
     double comm_init_time,comp_time,comm_time;
     int max_cached_link,max_sending_link;
@@ -53,6 +150,9 @@ namespace nissa
     //communicators
     all_to_all_comm_t *box_comm[16];
     su3 *buf_out,*buf_in;
+    int box_buf_out_off[16],box_buf_in_off[16];
+    //box after whose update the links needed by each box can be sent (-1 means at the beginning of the sweep)
+    int box_comm_post_after[16];
     
     ///////////////////////////////// methods ///////////////////////
     
@@ -62,6 +162,7 @@ namespace nissa
                       (int *ilink_to_be_used,all_to_all_gathering_list_t &gat,int ivol,int mu),
                       void (*ext_compute_staples)(su3 staples,su3 *links,int *ilinks,double C1));
     void add_staples_required_links(all_to_all_gathering_list_t **gl);
+    void find_box_comm_post_after();
     
     //find the order in which to scan the links to compute the staple sequentially
     void find_packing_index(void (*ext_compute_staples_packed)(su3 staples,su3 *links,double C1));
@@ -77,12 +178,18 @@ namespace nissa
     //inits the parity checkboard according to an external parity
     void init_box_dir_par_geometry(int ext_gpar,int(*par_comp)(coords ivol_coord,int dir));
     
-    //sweep the conf
-    void sweep_conf(quad_su3 *conf,void (*update_fun)(su3 out,su3 staples,int ivol,int mu,void *pars),void *pars)
+    //start sending the links needed to update a box
+    void post_box_comm(quad_su3 *conf,int ibox)
+    {box_comm[ibox]->start_communication(conf,sizeof(su3),buf_out+box_buf_out_off[ibox],buf_in+box_buf_in_off[ibox],ibox+100);}
+    
+    //sweep the conf, overlapping the communication of the links needed by each box with the update of the previous
+    //ones, as long as they are not modified in between; the links of each box-dir-par subset are updated in batches
+    //of SU3_BATCH_NLANES, calling kernel(links,staples,ivol,mu,nlanes) which must update the first nlanes lanes
+    template <class S,class K> void sweep_conf_internal(quad_su3 *conf,K &kernel)
     {
       MANDATORY_PARALLEL;
       GET_THREAD_ID();
-    
+      
 #ifdef BGQ
       su3 *staples_list;
       if(packing_inited)
@@ -96,12 +203,18 @@ namespace nissa
 	}
 #endif
       
+      //post the communications of the links not modified along the sweep
+      if(IS_MASTER_THREAD) comm_time-=take_time();
+      for(int jbox=0;jbox<(1<<NDIM);jbox++)
+	if(box_comm_post_after[jbox]==-1) post_box_comm(conf,jbox);
+      if(IS_MASTER_THREAD) comm_time+=take_time();
+      
       int ibase=0;
       for(int ibox=0;ibox<(1<<NDIM);ibox++)
 	{
-	  //communicate needed links
+	  //wait for the needed links
 	  if(IS_MASTER_THREAD) comm_time-=take_time();
-	  box_comm[ibox]->communicate(conf,conf,sizeof(su3),NULL,NULL,ibox+100);
+	  box_comm[ibox]->finish_communication(conf);
 	  if(IS_MASTER_THREAD)
 	    {
 	      comm_time+=take_time();
@@ -126,32 +239,66 @@ namespace nissa
 		THREAD_BARRIER();
 #endif
 		
-		//scan the whole box
-		NISSA_PARALLEL_LOOP(ibox_dir_par,ibase,ibase+box_dir_par_size)
+		//scan the whole box, a batch at a time
+		int nbatch=(box_dir_par_size+SU3_BATCH_NLANES-1)/SU3_BATCH_NLANES;
+		NISSA_PARALLEL_LOOP(ibatch,0,nbatch)
 		  {
-		    //compute the staples
-		    su3 staples;
+		    //the last batch might be incomplete: the missing lanes are filled with the last link
+		    int ifirst=ibase+ibatch*SU3_BATCH_NLANES;
+		    int nlanes=std::min(SU3_BATCH_NLANES,ibase+box_dir_par_size-ifirst);
+		    int ivol[SU3_BATCH_NLANES];
+		    BATCH_LANE_LOOP(l) ivol[l]=ivol_of_box_dir_par[ifirst+std::min(l,nlanes-1)];
 		    
+		    //compute the staples
+		    batch_su3 staples;
+#ifndef BGQ
 		    if(packing_inited)
 		      {
+			S::compute(staples,((batch_su3*)packing_link_buf)+ibatch*nlinks_per_staples_of_link,C1);
+			for(int l=nlanes;l<SU3_BATCH_NLANES;l++)
+			  for(int ic1=0;ic1<NCOL;ic1++)
+			    for(int ic2=0;ic2<NCOL;ic2++)
+			      for(int ri=0;ri<2;ri++)
+				staples[ic1][ic2][ri][l]=staples[ic1][ic2][ri][nlanes-1];
+		      }
+		    else
+#endif
+		      BATCH_LANE_LOOP(l)
+			{
+			  int ibox_dir_par=ifirst+std::min(l,nlanes-1);
+			  su3 lane_staples;
 #ifdef BGQ
-			su3_copy(staples,staples_list[ibox_dir_par-ibase]);
-#else
-			compute_staples_packed(staples,packing_link_buf+(ibox_dir_par-ibase)*nlinks_per_staples_of_link,C1);
+			  if(packing_inited) su3_copy(lane_staples,staples_list[ibox_dir_par-ibase]);
+			  else
 #endif
-		      }
-		    else compute_staples(staples,(su3*)conf,ilink_per_staples+nlinks_per_staples_of_link*ibox_dir_par,C1);
+			    compute_staples(lane_staples,(su3*)conf,ilink_per_staples+nlinks_per_staples_of_link*ibox_dir_par,C1);
+			  batch_su3_set_lane(staples,lane_staples,l);
+			}
 		    
-		    //find new link
-		    int ivol=ivol_of_box_dir_par[ibox_dir_par];
-		    update_fun(conf[ivol][dir],staples,ivol,dir,pars);
+		    //find new links
+		    batch_su3 links;
+		    BATCH_LANE_LOOP(l) batch_su3_set_lane(links,conf[ivol[l]][dir],l);
+		    kernel(links,staples,ivol,dir,nlanes);
+		    for(int l=0;l<nlanes;l++) batch_su3_get_lane(conf[ivol[l]][dir],links,l);
 		  }
 		THREAD_BARRIER();
 		
+		//let the communications in flight progress
+		for(int jbox=ibox+1;jbox<(1<<NDIM);jbox++) box_comm[jbox]->test_communication();
+		
 		//increment the box-dir-par subset
 		ibase+=box_dir_par_size;
 	      }
-	  if(IS_MASTER_THREAD) comp_time+=take_time();
+	  if(IS_MASTER_THREAD)
+	    {
+	      comp_time+=take_time();
+	      comm_time-=take_time();
+	    }
+	  
+	  //post the communications waiting for this box to be updated
+	  for(int jbox=ibox+1;jbox<(1<<NDIM);jbox++)
+	    if(box_comm_post_after[jbox]==ibox) post_box_comm(conf,jbox);
+	  if(IS_MASTER_THREAD) comm_time+=take_time();
 	}
       
       set_borders_invalid(conf);
@@ -159,7 +306,17 @@ namespace nissa
       if(packing_inited) nissa_free(staples_list);
 #endif
     }
-  
+    
+    //dispatch to the sweep specialized for the staples of the action
+    template <class K> void sweep_conf(quad_su3 *conf,K &kernel)
+    {
+      switch(staples_kind)
+	{
+	case WILSON_SWEEPER_STAPLES:sweep_conf_internal<Wilson_batch_staples_t>(conf,kernel);break;
+	case SYMANZIK_SWEEPER_STAPLES:sweep_conf_internal<Symanzik_batch_staples_t>(conf,kernel);break;
+	}
+    }
+    
     //checkers
     void check_hit_in_the_exact_order();
     void check_hit_exactly_once();
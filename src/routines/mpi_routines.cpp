@@ -287,7 +287,7 @@ namespace nissa
       }
     else
 #endif
-      MPI_Allreduce(&in_loc,&out_glb,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+      MPI_Allreduce(&in_loc,&out_glb,1,MPI_DOUBLE,mpi_op,MPI_COMM_WORLD);
     
     return out_glb;
   }
@@ -376,4 +376,17 @@ namespace nissa
   //reduce a double vector
   void glb_nodes_reduce_double_vect(double *out_glb,double *in_loc,int nel)
   {MPI_Allreduce(in_loc,out_glb,nel,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);}
+  
+  //start a non-blocking reduction in place, to be completed with glb_nodes_reduce_wait
+  void glb_nodes_reduce_double_vect_start(MPI_Request *req,double *vect,int nel)
+  {
+#if MPI_VERSION >= 3
+    MPI_Iallreduce(MPI_IN_PLACE,vect,nel,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD,req);
+#else
+    MPI_Allreduce(MPI_IN_PLACE,vect,nel,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+    (*req)=MPI_REQUEST_NULL;
+#endif
+  }
+  void glb_nodes_reduce_wait(MPI_Request *req)
+  {MPI_Wait(req,MPI_STATUS_IGNORE);}
 }
@@ -33,6 +33,7 @@ namespace nissa
   EXTERN_MPI MPI_Datatype MPI_LX_AS2T_SU3_EDGES_SEND[NDIM*(NDIM-1)/2],MPI_LX_AS2T_SU3_EDGES_RECE[NDIM*(NDIM-1)/2];
   EXTERN_MPI MPI_Datatype MPI_LX_QUAD_SU3_EDGES_SEND[NDIM*(NDIM-1)/2],MPI_LX_QUAD_SU3_EDGES_RECE[NDIM*(NDIM-1)/2];
   EXTERN_MPI MPI_Datatype MPI_EO_QUAD_SU3_EDGES_SEND[96],MPI_EO_QUAD_SU3_EDGES_RECE[NDIM*(NDIM-1)/2];
+  EXTERN_MPI MPI_Datatype MPI_EO_AS2T_SU3_EDGES_SEND[96],MPI_EO_AS2T_SU3_EDGES_RECE[NDIM*(NDIM-1)/2];
   
   //volume, plan and line communicator
   EXTERN_MPI MPI_Comm cart_comm;
@@ -68,6 +69,8 @@ namespace nissa
   void glb_nodes_reduce_double_vect(double *out_glb,double *in_loc,int nel);
   inline void glb_nodes_reduce_double_vect(double *vect,int nel)
   {glb_nodes_reduce_double_vect(vect,(double*)MPI_IN_PLACE,nel);}
+  void glb_nodes_reduce_double_vect_start(MPI_Request *req,double *vect,int nel);
+  void glb_nodes_reduce_wait(MPI_Request *req);
   inline void glb_nodes_reduce_complex_vect(complex *out_glb,complex *in_loc,int nel)
   {glb_nodes_reduce_double_vect(out_glb[0],in_loc[0],2*nel);}
   inline void glb_nodes_reduce_complex_vect(complex *vect,int nel)
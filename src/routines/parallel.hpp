@@ -0,0 +1,116 @@
+#ifndef _PARALLEL_HPP
+#define _PARALLEL_HPP
+
+#ifdef HAVE_CONFIG_H
+ #include "config.hpp"
+#endif
+
+#include <algorithm>
+#include <vector>
+
+#include "base/thread_macros.hpp"
+#ifdef USE_THREADS
+ #include "routines/thread.hpp"
+#endif
+
+//fork/join primitives executed by a work-stealing scheduler
+//
+//the body is passed as a functor (typically a lambda capturing by reference), so no global variable is needed
+//to carry the arguments. The range is split in chunks: each thread splits the chunks it owns in halves, leaving
+//the upper ones in its own queue, from which idle threads steal. The calls can be issued from anywhere:
+// -from the master thread with the pool locked, the pool is woken up and all threads take part
+// -from inside a threaded function, all threads must call it (as for NISSA_PARALLEL_LOOP), the body of the
+//  master thread is executed by all of them, then a barrier is issued
+// -from inside the body of another parallel_for or parallel_reduce, the range is forked on the queue of the
+//  calling thread, which executes pending work until the nested range is completed
+//inside the body each thread acts as a team of one: NISSA_PARALLEL_LOOP covers the whole range, barriers are
+//skipped and threaded functions are executed directly. The body must not contain collective calls
+//(nissa_malloc, communications, global reductions, etc)
+
+namespace nissa
+{
+  //number of chunks per thread used to balance the load
+#define NISSA_PARALLEL_NCHUNKS_PER_THREAD 8
+
+#ifdef USE_THREADS
+  //compute the chunk size for a given range
+  inline int parallel_grain(int start,int end)
+  {
+    const int nchunks=nthreads*NISSA_PARALLEL_NCHUNKS_PER_THREAD;
+    return std::max(1,(end-start+nchunks-1)/nchunks);
+  }
+  
+  //execute the body of a parallel_for on a chunk
+  template <class F> void parallel_for_chunk(const void *body,int ichunk,int start,int end)
+  {
+    const F &f=*(const F*)body;
+    for(int i=start;i<end;i++) f(i);
+  }
+  
+  //body of a parallel_reduce: functor and storage for the partial result of each chunk
+  template <class T,class F> struct parallel_reduce_body_t
+  {
+    const F *f;
+    T *partial;
+  };
+  
+  //execute the body of a parallel_reduce on a chunk, storing the partial result
+  template <class T,class F> void parallel_reduce_chunk(const void *body,int ichunk,int start,int end)
+  {
+    const parallel_reduce_body_t<T,F> &b=*(const parallel_reduce_body_t<T,F>*)body;
+    T &partial=b.partial[ichunk];
+    for(int i=start;i<end;i++) partial+=(*b.f)(i);
+  }
+#endif
+  
+  //execute f(i) for i in [start,end)
+  template <class F> void parallel_for(int start,int end,const F &f)
+  {
+#ifdef USE_THREADS
+    parallel_task_t task;
+    task.exec=parallel_for_chunk<F>;
+    task.body=&f;
+    task.start=start;
+    task.end=end;
+    task.grain=parallel_grain(start,end);
+    parallel_fork_join(task);
+#else
+    for(int i=start;i<end;i++) f(i);
+#endif
+  }
+  
+  //return the sum of f(i) for i in [start,end), starting from zero
+  //the result is local to the rank, and is returned to all threads
+  //partial results are summed in a fixed order, so that the result does not depend on the scheduling
+  template <class T,class F> T parallel_reduce(int start,int end,const T &zero,const F &f)
+  {
+    T res=zero;
+    
+#ifdef USE_THREADS
+    //one partial result per chunk
+    const int grain=parallel_grain(start,end);
+    const int nchunks=std::max(0,(end-start+grain-1)/grain);
+    std::vector<T> partial(nchunks,zero);
+    
+    parallel_reduce_body_t<T,F> body={&f,partial.data()};
+    parallel_task_t task;
+    task.exec=parallel_reduce_chunk<T,F>;
+    task.body=&body;
+    task.start=start;
+    task.end=end;
+    task.grain=grain;
+    const parallel_task_t &done=parallel_fork_join(task);
+    
+    //sum the partial results of the task actually executed, before it goes out of scope
+    const T *done_partial=((const parallel_reduce_body_t<T,F>*)done.body)->partial;
+    for(int ichunk=0;ichunk<nchunks;ichunk++) res+=done_partial[ichunk];
+    THREAD_BARRIER();
+#else
+    for(int i=start;i<end;i++) res+=f(i);
+#endif
+    
+    return res;
+  }
+}
+
+#endif
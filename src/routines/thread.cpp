@@ -2,6 +2,7 @@
  #include "config.hpp"
 #endif
 
+#include <algorithm>
 #include <omp.h>
 #include <stdlib.h>
 
@@ -189,7 +190,7 @@ namespace nissa
 	thread_pool_unlock();
 	
 	//exec order or mark to exit in other case
-	if(threaded_function_ptr!=NULL) threaded_function_ptr();
+	if(threaded_function_ptr!=NULL) threaded_function_ptr(threaded_function_arg);
 	else stay_working=false;
 	
 	thread_pool_lock();
@@ -206,7 +207,7 @@ namespace nissa
   }
   
   //execute a function using all threads
-  void start_threaded_function(void(*function)(void),const char *name)
+  void start_threaded_function(void(*function)(const void *arg),const void *arg,const char *name)
   {
 #ifdef THREAD_DEBUG
     if(rank==0 && VERBOSITY_LV3)
@@ -215,12 +216,13 @@ namespace nissa
 	fflush(stdout);
       }
 #endif
-    //set external function pointer and unlock pool threads
+    //set external function pointer and its argument, and unlock pool threads
     threaded_function_ptr=function;
+    threaded_function_arg=arg;
     thread_pool_unlock();
     
     //execute the function and relock the pool, so we are sure that they are not reading the work-to-do
-    if(threaded_function_ptr!=NULL) threaded_function_ptr();
+    if(threaded_function_ptr!=NULL) threaded_function_ptr(threaded_function_arg);
     thread_pool_lock();
     
 #ifdef THREAD_DEBUG
@@ -232,6 +234,178 @@ namespace nissa
 #endif
   }
   
+  namespace
+  {
+    //piece of a fork/join region: chunks [ichunk_beg,ichunk_end) of a task
+    struct parallel_work_t
+    {
+      parallel_task_t *task;
+      int ichunk_beg;
+      int ichunk_end;
+    };
+    
+    //queue of each thread: the owner pushes and pops at the bottom, the other threads steal from the top
+    struct parallel_deque_t
+    {
+      volatile int lock;
+      volatile int top;
+      volatile int bottom;
+      parallel_work_t work[NISSA_PARALLEL_DEQUE_SIZE];
+    };
+    parallel_deque_t *parallel_deque;
+    
+    void parallel_deque_lock(parallel_deque_t &d)
+    {while(__sync_lock_test_and_set(&d.lock,1)) while(d.lock);}
+    
+    void parallel_deque_unlock(parallel_deque_t &d)
+    {__sync_lock_release(&d.lock);}
+    
+    //put a piece of work at the bottom of the queue of the thread
+    void parallel_deque_push(const parallel_work_t &w)
+    {
+      parallel_deque_t &d=parallel_deque[omp_get_thread_num()];
+      
+      parallel_deque_lock(d);
+      if(d.bottom==NISSA_PARALLEL_DEQUE_SIZE)
+	{
+	  if(d.top==0) crash("parallel deque full, increase NISSA_PARALLEL_DEQUE_SIZE");
+	  std::copy(d.work+d.top,d.work+d.bottom,d.work);
+	  d.bottom-=d.top;
+	  d.top=0;
+	}
+      d.work[d.bottom++]=w;
+      parallel_deque_unlock(d);
+    }
+    
+    //take a piece of work from the bottom (own queue) or from the top (other threads queue)
+    bool parallel_deque_take(parallel_work_t &w,int ithread,bool from_bottom)
+    {
+      parallel_deque_t &d=parallel_deque[ithread];
+      
+      //check without locking, to avoid contention on empty queues
+      if(d.top==d.bottom) return false;
+      
+      parallel_deque_lock(d);
+      bool found=(d.top<d.bottom);
+      if(found) w=from_bottom?d.work[--d.bottom]:d.work[d.top++];
+      if(d.top==d.bottom) d.top=d.bottom=0;
+      parallel_deque_unlock(d);
+      
+      return found;
+    }
+    
+    //look for work in the own queue, then try to steal it from the other threads
+    bool parallel_find_work(parallel_work_t &w)
+    {
+      const int ithread=omp_get_thread_num();
+      if(parallel_deque_take(w,ithread,true)) return true;
+      for(unsigned int i=1;i<nthreads;i++)
+	if(parallel_deque_take(w,(ithread+i)%nthreads,false)) return true;
+      
+      return false;
+    }
+    
+    //split the work in halves, leaving the upper ones in the queue, and execute the first chunk
+    void parallel_execute_work(parallel_work_t w)
+    {
+      while(w.ichunk_end-w.ichunk_beg>1)
+	{
+	  const int ichunk_mid=(w.ichunk_beg+w.ichunk_end)/2;
+	  parallel_deque_push(parallel_work_t{w.task,ichunk_mid,w.ichunk_end});
+	  w.ichunk_end=ichunk_mid;
+	}
+      
+      parallel_task_t *task=w.task;
+      const int start=task->start+w.ichunk_beg*task->grain;
+      const int end=std::min(start+task->grain,task->end);
+      
+      const bool was_executing=executing_parallel_task;
+      executing_parallel_task=true;
+      task->exec(task->body,w.ichunk_beg,start,end);
+      executing_parallel_task=was_executing;
+      
+      __sync_fetch_and_sub(&task->npending,1);
+    }
+    
+    //execute pending work, from any task, until the passed one is completed
+    void parallel_join(parallel_task_t &task)
+    {
+      parallel_work_t w;
+      while(task.npending)
+	if(parallel_find_work(w))
+	  parallel_execute_work(w);
+      
+      //make the result of other threads visible
+      __sync_synchronize();
+    }
+    
+    //fork the whole task from the calling thread and join it
+    void parallel_fork_and_join(parallel_task_t &task)
+    {
+      if(task.npending) parallel_execute_work(parallel_work_t{&task,0,task.npending});
+      parallel_join(task);
+    }
+    
+    //execute all the chunks of the task in order on the calling thread
+    void parallel_execute_serially(parallel_task_t &task)
+    {
+      const bool was_executing=executing_parallel_task;
+      executing_parallel_task=true;
+      for(int ichunk=0;ichunk<task.npending;ichunk++)
+	{
+	  const int start=task.start+ichunk*task.grain;
+	  task.exec(task.body,ichunk,start,std::min(start+task.grain,task.end));
+	}
+      executing_parallel_task=was_executing;
+      
+      task.npending=0;
+    }
+    
+    //the master of the team forks the task, the other threads steal from it
+    void parallel_team_work(parallel_task_t &task)
+    {
+      if(omp_get_thread_num()==0) parallel_fork_and_join(task);
+      else parallel_join(task);
+    }
+  }
+  
+  //execute a task using all available threads, returning the task actually executed
+  //-with a single thread, the chunks are executed in order
+  //-from inside a fork/join region, the task is forked on the queue of the calling thread
+  //-from the master with the pool locked, the pool is woken up
+  //-from threaded code, all threads must call it, and the task of the master is executed
+  const parallel_task_t &parallel_fork_join(parallel_task_t &task)
+  {
+    task.npending=std::max(0,(task.end-task.start+task.grain-1)/task.grain);
+    
+    //no other thread to share the work with
+    if(nthreads==1)
+      {
+	parallel_execute_serially(task);
+	return task;
+      }
+    
+    if(inside_parallel_task())
+      {
+	parallel_fork_and_join(task);
+	return task;
+      }
+    
+    if(nthreads>1 && thread_pool_locked)
+      {
+	start_threaded_functor([&task](){parallel_team_work(task);},"parallel_fork_join");
+	return task;
+      }
+    
+    GET_THREAD_ID();
+    parallel_task_t *master_task;
+    THREAD_BROADCAST_PTR(master_task,&task);
+    parallel_team_work(*master_task);
+    THREAD_BARRIER();
+    
+    return *master_task;
+  }
+  
   //delete the thread pool
   void thread_pool_stop()
   {
@@ -241,7 +415,7 @@ namespace nissa
     if(thread_id!=0) crash("only thread 0 can stop the pool");
     
     //pass a NULL order
-    start_threaded_function(NULL,"");
+    start_threaded_function(NULL,NULL,"");
   }
   
   //make all threads update a single counter in turn, checking previous state
@@ -281,6 +455,14 @@ namespace nissa
     glb_double_reduction_buf=(double*)malloc(nthreads*sizeof(double));
     glb_quadruple_reduction_buf=(float_128*)malloc(nthreads*sizeof(float_128));
     
+    //initialize the queues of the scheduler
+    parallel_deque=(parallel_deque_t*)malloc(nthreads*sizeof(parallel_deque_t));
+    for(unsigned int ithread=0;ithread<nthreads;ithread++)
+      {
+	parallel_deque[ithread].lock=0;
+	parallel_deque[ithread].top=parallel_deque[ithread].bottom=0;
+      }
+    
     //lock the pool
     thread_pool_locked=true;
     cache_flush();
@@ -295,6 +477,7 @@ namespace nissa
     free(glb_single_reduction_buf);
     free(glb_double_reduction_buf);
     free(glb_quadruple_reduction_buf);
+    free(parallel_deque);
     
     //exit the thread pool
     thread_pool_stop();
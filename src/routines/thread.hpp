@@ -17,6 +17,9 @@
 #define INIT_TO(A) =A
 #endif
 
+//maximal number of pieces of work waiting in the queue of each thread
+#define NISSA_PARALLEL_DEQUE_SIZE 1024
+
 namespace nissa
 {
 #ifdef THREAD_DEBUG
@@ -36,7 +39,23 @@ namespace nissa
   EXTERN_THREAD double *glb_double_reduction_buf;
   EXTERN_THREAD float_128 *glb_quadruple_reduction_buf;
   
-  EXTERN_THREAD void(*threaded_function_ptr)();
+  //function executed by the pool, and the functor passed to it
+  EXTERN_THREAD void(*threaded_function_ptr)(const void *arg);
+  EXTERN_THREAD const void *threaded_function_arg;
+  
+  //mark the threads executing the body of a fork/join region
+  EXTERN_THREAD thread_local bool executing_parallel_task INIT_TO(false);
+  
+  //range of work forked among the threads, split in chunks of grain size
+  struct parallel_task_t
+  {
+    void(*exec)(const void *body,int ichunk,int start,int end);
+    const void *body;
+    int start;
+    int end;
+    int grain;
+    volatile int npending;
+  };
   
 #ifdef THREAD_DEBUG
   void thread_barrier_with_check(const char*file,int line);
@@ -44,13 +63,22 @@ namespace nissa
   void thread_barrier_without_check();
 #endif
   
-  void start_threaded_function(void(*function)(void),const char *name);
+  void start_threaded_function(void(*function)(const void *arg),const void *arg,const char *name);
   void thread_master_start(int narg,char **arg,void(*main_function)(int narg,char **arg));
   void thread_pool();
   void thread_pool_stop();
+  const parallel_task_t &parallel_fork_join(parallel_task_t &task);
+  inline bool inside_parallel_task()
+  {return executing_parallel_task;}
   double *glb_threads_reduce_double_vect(double *vect,int nel);
   inline complex *glb_threads_reduce_complex_vect(complex *vect,int nel)
   {return (complex*)glb_threads_reduce_double_vect((double*)vect,2*nel);}
+  
+  //execute a functor using all threads, passing it through the pool
+  template <class F> void threaded_functor_summoner(const void *f)
+  {(*(const F*)f)();}
+  template <class F> void start_threaded_functor(const F &f,const char *name)
+  {start_threaded_function(threaded_functor_summoner<F>,&f,name);}
 }
 
 #undef INIT_TO
@@ -0,0 +1,13 @@
+#include "src/common.cpp"
+#include "src/crc32.cpp"
+
+int main(int narg,char **arg)
+{
+  init_test(narg,arg);
+  
+  test(test_crc32(),"CRC32 and checksum");
+  
+  close_nissa();
+  
+  return 0;
+}
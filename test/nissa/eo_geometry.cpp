@@ -1,9 +1,9 @@
 #include "src/common.cpp"
 #include "src/eo_geometry.cpp"
 
-int main()
+int main(int narg,char **arg)
 {
-  init_test();
+  init_test(narg,arg);
   
   test(test_eo_geometry(),"E/O geometry");
   
@@ -0,0 +1,14 @@
+#include "src/common.cpp"
+#include "src/fft.cpp"
+
+int main(int narg,char **arg)
+{
+  //sizes not power of 2, to be run on a number of ranks not power of 2 as well
+  init_test(narg,arg,12,6);
+  
+  test(test_fft(),"FFT");
+  
+  close_nissa();
+  
+  return 0;
+}
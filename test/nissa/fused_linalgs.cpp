@@ -0,0 +1,13 @@
+#include "src/common.cpp"
+#include "src/fused_linalgs.cpp"
+
+int main(int narg,char **arg)
+{
+  init_test(narg,arg);
+  
+  test(test_fused_linalgs(),"Fused CG and CGM kernels");
+  
+  close_nissa();
+  
+  return 0;
+}
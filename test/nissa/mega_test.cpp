@@ -3,15 +3,27 @@
 #include "src/random_source_generation.cpp"
 #include "src/spincolor_writing_and_reading.cpp"
 #include "src/Q2tm_cg_inversion.cpp"
+#include "src/mg_invert_tmclovD.cpp"
+#include "src/fft.cpp"
+#include "src/philox.cpp"
+#include "src/crc32.cpp"
+#include "src/fused_linalgs.cpp"
+#include "src/parallel.cpp"
 
-int main()
+int main(int narg,char **arg)
 {
-  init_test();
+  init_test(narg,arg);
   
   test(test_plaquette_computation(),"plaquete computation");
   test(test_random_source_generation(),"random source generation");
   test(test_spincolor_writing_and_reading(),"writing and reading random spinor");
   test(test_Q2tm_inversion(),"Q2tm inversion");
+  test(test_mg_invert_tmclovD(),"Multigrid twisted clover inversion");
+  test(test_fft(),"FFT");
+  test(test_philox(),"Philox random generator");
+  test(test_crc32(),"CRC32 and checksum");
+  test(test_fused_linalgs(),"Fused CG and CGM kernels");
+  test(test_parallel(),"Fork/join parallel_for and parallel_reduce");
   
   close_nissa();
   
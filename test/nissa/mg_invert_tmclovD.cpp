@@ -0,0 +1,13 @@
+#include "src/common.cpp"
+#include "src/mg_invert_tmclovD.cpp"
+
+int main(int narg,char **arg)
+{
+  init_test(narg,arg);
+  
+  test(test_mg_invert_tmclovD(),"Multigrid twisted clover inversion");
+  
+  close_nissa();
+  
+  return 0;
+}
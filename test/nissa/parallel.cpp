@@ -0,0 +1,17 @@
+#include "src/common.cpp"
+#include "src/parallel.cpp"
+
+//run with the thread pool, so that the work is actually shared among threads
+void in_main(int narg,char **arg)
+{
+  test(test_parallel(),"Fork/join parallel_for and parallel_reduce");
+  
+  close_nissa();
+}
+
+int main(int narg,char **arg)
+{
+  init_nissa_threaded(narg,arg,in_main);
+  
+  return 0;
+}
@@ -0,0 +1,13 @@
+#include "src/common.cpp"
+#include "src/philox.cpp"
+
+int main(int narg,char **arg)
+{
+  init_test(narg,arg);
+  
+  test(test_philox(),"Philox random generator");
+  
+  close_nissa();
+  
+  return 0;
+}
@@ -1,9 +1,9 @@
 #include "src/common.cpp"
 #include "src/plaquette_computation.cpp"
 
-int main()
+int main(int narg,char **arg)
 {
-  init_test();
+  init_test(narg,arg);
   
   test(test_plaquette_computation(),"Configuration loading");
   
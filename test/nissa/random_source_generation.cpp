@@ -1,9 +1,9 @@
 #include "src/common.cpp"
 #include "src/random_source_generation.cpp"
 
-int main()
+int main(int narg,char **arg)
 {
-  init_test();
+  init_test(narg,arg);
   
   test(test_random_source_generation(),"Random source generation");
   
@@ -1,13 +1,15 @@
 #pragma once
 
-#include "nissa.h"
+#include "nissa.hpp"
 
-void init_test()
+using namespace nissa;
+
+void init_test(int narg,char **arg,int T=8,int L=4)
 {
-  init_nissa();
+  init_nissa(narg,arg);
   
   //init the grid
-  init_grid(8,4);
+  init_grid(T,L);
 }
 
 void test(int passed,const char *test_name)
@@ -17,4 +19,3 @@ void test(int passed,const char *test_name)
   
   master_printf("################ %s test finished ###############\n",test_name);
 }
-
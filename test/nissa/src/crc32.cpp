@@ -0,0 +1,93 @@
+#pragma once
+
+//bit by bit crc32, as zlib
+uint32_t bitwise_crc32(uint32_t crc,const unsigned char *buf,size_t len)
+{
+  crc^=0xffffffff;
+  for(size_t i=0;i<len;i++)
+    {
+      crc^=buf[i];
+      for(int ibit=0;ibit<8;ibit++) crc=(crc>>1)^(0xedb88320&(-(crc&1)));
+    }
+  
+  return crc^0xffffffff;
+}
+
+//check the crc32 and the checksums computed together with the endianness conversion
+int test_crc32()
+{
+  int passed=1;
+  
+  //standard check value
+  uint32_t check_value=ildg_crc32(0,(const unsigned char*)"123456789",9);
+  if(check_value!=0xcbf43926)
+    {
+      master_printf("crc32 of \"123456789\": %08x, expected cbf43926\n",check_value);
+      passed=0;
+    }
+  
+  //compare with the bit by bit computation for all lengths and alignments, chaining the crc
+  unsigned char buf[256];
+  for(int i=0;i<256;i++) buf[i]=(unsigned char)(i*167+13);
+  uint32_t crc=0,ref_crc=0;
+  for(int off=0;off<8;off++)
+    for(int len=0;len<=200;len++)
+      {
+	crc=ildg_crc32(crc,buf+off,len);
+	ref_crc=bitwise_crc32(ref_crc,buf+off,len);
+	if(crc!=ref_crc)
+	  {
+	    master_printf("crc32 with offset %d and length %d: %08x, expected %08x\n",off,len,crc,ref_crc);
+	    passed=0;
+	  }
+      }
+  
+  //fill data as used by nissa
+  const int nreals_per_site=18;
+  double *data=nissa_malloc("data",loc_vol*nreals_per_site,double);
+  float *data_single=nissa_malloc("data_single",loc_vol*nreals_per_site,float);
+  NISSA_LOC_VOL_LOOP(ivol)
+    for(int ireal=0;ireal<nreals_per_site;ireal++)
+      {
+	data[ivol*nreals_per_site+ireal]=sin(glblx_of_loclx[ivol]*nreals_per_site+ireal);
+	data_single[ivol*nreals_per_site+ireal]=data[ivol*nreals_per_site+ireal];
+      }
+  char *buffer=nissa_malloc("buffer",loc_vol*nreals_per_site*sizeof(double),char);
+  
+  //checksums obtained with the byte by byte crc32, on a 8x4 lattice
+  const uint32_t old_check[2][2]={{0x7c6898ab,0xefd9bce5},{0x10223227,0x10a6d1c7}};
+  
+  for(int prec=32;prec<=64;prec+=32)
+    {
+      size_t bps=nreals_per_site*prec/8;
+      void *ref_data=(prec==64)?(void*)data:(void*)data_single;
+      
+      //checksum computed separately
+      checksum ref_check;
+      checksum_compute_nissa_data(ref_check,ref_data,bps,prec);
+      
+      //as when writing
+      checksum write_check;
+      convert_to_big_endian_and_checksum_nissa_data(buffer,write_check,data,nreals_per_site,prec);
+      
+      //as when reading
+      checksum read_check;
+      checksum_compute_and_convert_from_big_endian_nissa_data(read_check,buffer,bps,prec);
+      
+      master_printf("Precision %d, checksum: %08x %08x, when writing: %08x %08x, when reading: %08x %08x\n",prec,
+		    ref_check[0],ref_check[1],write_check[0],write_check[1],read_check[0],read_check[1]);
+      for(int i=0;i<2;i++) passed&=(ref_check[i]==old_check[prec/64][i] and ref_check[i]==write_check[i] and ref_check[i]==read_check[i]);
+      
+      //the data must have been converted back
+      int loc_diff=(memcmp(buffer,ref_data,bps*loc_vol)!=0),diff;
+      MPI_Allreduce(&loc_diff,&diff,1,MPI_INT,MPI_MAX,MPI_COMM_WORLD);
+      if(diff) master_printf("Precision %d, the data read differ from the written\n",prec);
+      passed&=not diff;
+    }
+  
+  nissa_free(buffer);
+  nissa_free(data_single);
+  nissa_free(data);
+  
+  return passed;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+//test function, with ncpp components per site
+void fft_test_function(complex out,int glblx,int icpp)
+{
+  out[RE]=sin(0.731*glblx+icpp);
+  out[IM]=cos(1.417*glblx-icpp);
+}
+
+//compare the fft with the direct computation of the fourier transform
+int test_fft()
+{
+  const int ncpp=2;
+  double max_diff=0;
+  
+  //fill the vector
+  complex *in=nissa_malloc("in",loc_vol*ncpp,complex);
+  complex *out=nissa_malloc("out",loc_vol*ncpp,complex);
+  NISSA_LOC_VOL_LOOP(ivol)
+    for(int icpp=0;icpp<ncpp;icpp++)
+      fft_test_function(in[ivol*ncpp+icpp],glblx_of_loclx[ivol],icpp);
+  
+  //phases along each direction
+  complex *phase[NDIM];
+  for(int mu=0;mu<NDIM;mu++) phase[mu]=nissa_malloc("phase",glb_size[mu]*glb_size[mu],complex);
+  
+  for(int isign=0;isign<2;isign++)
+    {
+      double sign=(isign==0)?FFT_PLUS:FFT_MINUS;
+      master_printf("Testing the fft with sign %+lg on a grid %d %d %d %d\n",sign,glb_size[0],glb_size[1],glb_size[2],glb_size[3]);
+      
+      fft4d(out,in,ncpp,sign,FFT_NO_NORMALIZE);
+      
+      for(int mu=0;mu<NDIM;mu++)
+	for(int p=0;p<glb_size[mu];p++)
+	  for(int x=0;x<glb_size[mu];x++)
+	    {
+	      double theta=sign*2*M_PI*p*x/glb_size[mu];
+	      phase[mu][p*glb_size[mu]+x][RE]=cos(theta);
+	      phase[mu][p*glb_size[mu]+x][IM]=sin(theta);
+	    }
+      
+      //direct transform for each local momentum
+      double loc_max_diff=0;
+      NISSA_LOC_VOL_LOOP(ivol)
+	for(int icpp=0;icpp<ncpp;icpp++)
+	  {
+	    complex dft={0,0};
+	    for(int glblx=0;glblx<glb_vol;glblx++)
+	      {
+		coords x;
+		glb_coord_of_glblx(x,glblx);
+		complex f,t;
+		fft_test_function(f,glblx,icpp);
+		for(int mu=0;mu<NDIM;mu++)
+		  {
+		    unsafe_complex_prod(t,f,phase[mu][glb_coord_of_loclx[ivol][mu]*glb_size[mu]+x[mu]]);
+		    complex_copy(f,t);
+		  }
+		complex_summassign(dft,f);
+	      }
+	    
+	    for(int ri=0;ri<2;ri++) loc_max_diff=std::max(loc_max_diff,fabs(dft[ri]-out[ivol*ncpp+icpp][ri]));
+	  }
+      
+      double glb_max_diff;
+      MPI_Allreduce(&loc_max_diff,&glb_max_diff,1,MPI_DOUBLE,MPI_MAX,MPI_COMM_WORLD);
+      max_diff=std::max(max_diff,glb_max_diff);
+    }
+  
+  double tolerance=1.e-10;
+  master_printf("Maximal difference with the direct transform: %lg, tolerance: %lg\n",max_diff,tolerance);
+  
+  for(int mu=0;mu<NDIM;mu++) nissa_free(phase[mu]);
+  nissa_free(out);
+  nissa_free(in);
+  
+  return max_diff<=tolerance;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+//maximal relative difference between two vectors
+double fused_linalgs_max_rel_diff(double *a,double *b,int n)
+{
+  double loc_diff=0,glb_diff;
+  for(int i=0;i<n;i++) loc_diff=std::max(loc_diff,fabs(a[i]-b[i])/std::max(fabs(b[i]),1.0));
+  MPI_Allreduce(&loc_diff,&glb_diff,1,MPI_DOUBLE,MPI_MAX,MPI_COMM_WORLD);
+  
+  return glb_diff;
+}
+
+//relative difference between two numbers
+double fused_linalgs_rel_diff(double a,double b)
+{return fabs(a-b)/fabs(b);}
+
+//compare the fused kernels used by the CG and CGM with the sequence of the separate operations
+int test_fused_linalgs()
+{
+  const int n=loc_vol*sizeof(spincolor)/sizeof(double);
+  const int nshift=3,nvec=4+2*nshift;
+  
+  if(!loc_rnd_gen_inited) start_loc_rnd_gen(2342);
+  double *v[nvec],*ref[nvec];
+  for(int ivec=0;ivec<nvec;ivec++)
+    {
+      v[ivec]=(double*)nissa_malloc("v",loc_vol+bord_vol,spincolor);
+      ref[ivec]=(double*)nissa_malloc("ref",loc_vol+bord_vol,spincolor);
+      generate_undiluted_source((spincolor*)(v[ivec]),RND_GAUSS,-1);
+      vector_copy(ref[ivec],v[ivec]);
+    }
+  double *x=v[0],*r=v[1],*p=v[2],*s=v[3],**sol=v+4,**ps=v+4+nshift;
+  double *x_ref=ref[0],*r_ref=ref[1],*p_ref=ref[2],*s_ref=ref[3],**sol_ref=ref+4,**ps_ref=ref+4+nshift;
+  
+  double vec_diff=0,red_diff=0;
+  
+  //a=b+c*d with (a,a) and (a,e)
+  double res[2],res_ref[2];
+  double_vector_summ_double_vector_prod_double_glb_scalar_prods(res,x,r,p,0.37,s,n);
+  double_vector_summ_double_vector_prod_double(x_ref,r_ref,p_ref,0.37,n);
+  double_vector_glb_scalar_prod(res_ref+0,x_ref,x_ref,n);
+  double_vector_glb_scalar_prod(res_ref+1,x_ref,s_ref,n);
+  vec_diff=std::max(vec_diff,fused_linalgs_max_rel_diff(x,x_ref,n));
+  for(int i=0;i<2;i++) red_diff=std::max(red_diff,fused_linalgs_rel_diff(res[i],res_ref[i]));
+  
+  //cg update of solution and residue
+  double omega=-0.81,norm2,norm2_ref;
+  double_vector_cg_update_glb_norm2(&norm2,x,r,p,s,omega,n);
+  double_vector_summassign_double_vector_prod_double(x_ref,p_ref,omega,n);
+  double_vector_summassign_double_vector_prod_double(r_ref,s_ref,-omega,n);
+  double_vector_glb_scalar_prod(&norm2_ref,r_ref,r_ref,n);
+  vec_diff=std::max(vec_diff,fused_linalgs_max_rel_diff(x,x_ref,n));
+  vec_diff=std::max(vec_diff,fused_linalgs_max_rel_diff(r,r_ref,n));
+  red_diff=std::max(red_diff,fused_linalgs_rel_diff(norm2,norm2_ref));
+  
+  //cgm update of solutions and residue, the second shift is not running
+  int run_flag[nshift]={1,0,1};
+  double betas[nshift]={0.3,-1.7,2.1},betaa=-0.43;
+  double_vector_cgm_update_sol_and_residue_glb_norm2(&norm2,sol,ps,betas,run_flag,nshift,r,s,betaa,n);
+  for(int ishift=0;ishift<nshift;ishift++)
+    if(run_flag[ishift]) double_vector_summassign_double_vector_prod_double(sol_ref[ishift],ps_ref[ishift],-betas[ishift],n);
+  double_vector_summassign_double_vector_prod_double(r_ref,s_ref,betaa,n);
+  double_vector_glb_scalar_prod(&norm2_ref,r_ref,r_ref,n);
+  for(int ishift=0;ishift<nshift;ishift++) vec_diff=std::max(vec_diff,fused_linalgs_max_rel_diff(sol[ishift],sol_ref[ishift],n));
+  vec_diff=std::max(vec_diff,fused_linalgs_max_rel_diff(r,r_ref,n));
+  red_diff=std::max(red_diff,fused_linalgs_rel_diff(norm2,norm2_ref));
+  
+  //cgm update of the directions
+  double alpha=0.61,zfs[nshift]={0.9,0.5,0.2},alphas[nshift]={0.55,0.33,0.11};
+  double_vector_cgm_update_dirs(p,ps,r,alpha,zfs,alphas,run_flag,nshift,n);
+  double_vector_summ_double_vector_prod_double(p_ref,r_ref,p_ref,alpha,n);
+  for(int ishift=0;ishift<nshift;ishift++)
+    if(run_flag[ishift]) double_vector_linear_comb(ps_ref[ishift],r_ref,zfs[ishift],ps_ref[ishift],alphas[ishift],n);
+  vec_diff=std::max(vec_diff,fused_linalgs_max_rel_diff(p,p_ref,n));
+  for(int ishift=0;ishift<nshift;ishift++) vec_diff=std::max(vec_diff,fused_linalgs_max_rel_diff(ps[ishift],ps_ref[ishift],n));
+  
+  //vectors must agree to rounding, reductions to the different summation order
+  double vec_tolerance=1e-15,red_tolerance=1e-12;
+  master_printf("Maximal difference of the vectors: %lg, tolerance: %lg\n",vec_diff,vec_tolerance);
+  master_printf("Maximal difference of the reductions: %lg, tolerance: %lg\n",red_diff,red_tolerance);
+  
+  for(int ivec=0;ivec<nvec;ivec++)
+    {
+      nissa_free(v[ivec]);
+      nissa_free(ref[ivec]);
+    }
+  
+  return vec_diff<=vec_tolerance and red_diff<=red_tolerance;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+//relative difference between two spincolor
+double spincolor_rel_diff(spincolor *a,spincolor *b)
+{
+  spincolor *diff=nissa_malloc("diff",loc_vol,spincolor);
+  double_vector_subt((double*)diff,(double*)a,(double*)b,loc_vol*sizeof(spincolor)/sizeof(double));
+  double rel_diff=sqrt(double_vector_glb_norm2(diff,loc_vol)/double_vector_glb_norm2(b,loc_vol));
+  nissa_free(diff);
+  
+  return rel_diff;
+}
+
+int test_mg_invert_tmclovD()
+{
+  //generate a random conf and compute the clover term
+  master_printf("\nGenerating conf\n");
+  if(loc_rnd_gen_inited) stop_loc_rnd_gen();
+  start_loc_rnd_gen(2342);
+  quad_su3 *conf=nissa_malloc("conf",loc_vol+bord_vol+edge_vol,quad_su3);
+  generate_hot_lx_conf(conf);
+  double cSW=1.0;
+  clover_term_t *Cl=nissa_malloc("Cl",loc_vol,clover_term_t);
+  clover_term(Cl,cSW,conf);
+  
+  //generate the source
+  master_printf("Generating source\n");
+  spincolor *source=nissa_malloc("source",loc_vol+bord_vol,spincolor);
+  generate_undiluted_source(source,RND_GAUSS,-1);
+  
+  double kappa=0.125;
+  double mass=0.1;
+  double residue=1e-20;
+  
+  //invert with the e/o preconditioned CG, getting also the guess for Koo
+  master_printf("Inverting with CG\n");
+  mg::use_multigrid=0;
+  spincolor *guess_Koo=nissa_malloc("guess_Koo",loc_volh+bord_volh,spincolor);
+  vector_reset(guess_Koo);
+  spincolor *sol_cg=nissa_malloc("sol_cg",loc_vol+bord_vol,spincolor);
+  inv_tmclovD_cg_eoprec(sol_cg,guess_Koo,conf,kappa,Cl,NULL,cSW,mass,1000000,residue,source);
+  
+  //invert with the multigrid, starting from scratch and from the guess
+  master_printf("Inverting with multigrid\n");
+  mg::use_multigrid=1;
+  mg::invalidate_setup();
+  spincolor *sol_mg=nissa_malloc("sol_mg",loc_vol+bord_vol,spincolor);
+  inv_tmclovD_cg_eoprec(sol_mg,NULL,conf,kappa,Cl,NULL,cSW,mass,1000000,residue,source);
+  double rel_diff=spincolor_rel_diff(sol_mg,sol_cg);
+  
+  master_printf("Inverting with multigrid, starting from the guess\n");
+  inv_tmclovD_cg_eoprec(sol_mg,guess_Koo,conf,kappa,Cl,NULL,cSW,mass,1000000,residue,source);
+  double rel_diff_guess=spincolor_rel_diff(sol_mg,sol_cg);
+  mg::use_multigrid=0;
+  
+  double tolerance=1.e-8;
+  master_printf("Difference: %lg, starting from the guess: %lg, tolerance: %lg\n",rel_diff,rel_diff_guess,tolerance);
+  
+  nissa_free(sol_mg);
+  nissa_free(sol_cg);
+  nissa_free(guess_Koo);
+  nissa_free(source);
+  nissa_free(Cl);
+  nissa_free(conf);
+  
+  return rel_diff<=tolerance and rel_diff_guess<=tolerance;
+}
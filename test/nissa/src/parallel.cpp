@@ -0,0 +1,53 @@
+#pragma once
+
+//threaded function filling a row, called also from inside the body of a parallel_for
+THREADABLE_FUNCTION_3ARG(parallel_fill_row, double*,row, int,n, double,x)
+{
+  GET_THREAD_ID();
+  
+  NISSA_PARALLEL_LOOP(i,0,n) row[i]=x+i;
+  THREAD_BARRIER();
+}
+THREADABLE_FUNCTION_END
+
+//reduction called collectively by all threads, counting the threads which got a wrong result
+THREADABLE_FUNCTION_4ARG(parallel_collective_sum, int*,nwrong, double*,v, int,n, double,ref)
+{
+  double sum=parallel_reduce(0,n,0.0,[=](int i){return v[i];});
+  if(sum!=ref) __sync_fetch_and_add(nwrong,1);
+  THREAD_BARRIER();
+}
+THREADABLE_FUNCTION_END
+
+//check parallel_for and parallel_reduce, also nested into each other
+int test_parallel()
+{
+  const int nrow=37,ncol=1001,n=nrow*ncol;
+  double *mat=nissa_malloc("mat",n,double);
+  int nwrong=0;
+  
+  //fill each row with a threaded function called inside the body
+  parallel_for(0,nrow,[=](int irow){parallel_fill_row(mat+irow*ncol,ncol,irow*ncol);});
+  for(int i=0;i<n;i++) if(mat[i]!=i) nwrong++;
+  master_printf("Filling rows, %d wrong\n",nwrong);
+  
+  //sum each row with a nested reduction, then the rows
+  const double ref_sum=(double)n*(n-1)/2;
+  double sum=parallel_reduce(0,nrow,0.0,[=](int irow)
+			     {return parallel_reduce(0,ncol,0.0,[=](int icol){return mat[irow*ncol+icol];});});
+  if(sum!=ref_sum) nwrong++;
+  master_printf("Nested reduction: %lg, expected %lg\n",sum,ref_sum);
+  
+  //reduction issued by all threads
+  parallel_collective_sum(&nwrong,mat,n,ref_sum);
+  master_printf("Collective reduction, %d wrong so far\n",nwrong);
+  
+  //change sign with a nested loop
+  parallel_for(0,nrow,[=](int irow){parallel_for(0,ncol,[=](int icol){mat[irow*ncol+icol]*=-1;});});
+  for(int i=0;i<n;i++) if(mat[i]!=-i) nwrong++;
+  master_printf("Nested loop, %d wrong\n",nwrong);
+  
+  nissa_free(mat);
+  
+  return nwrong==0;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+//check the Philox generator against the known answers of the reference implementation, and the local grid against
+//reference values, which must not depend on the rank grid
+int test_philox()
+{
+  int passed=1;
+  
+  //known answers of Philox4x32-10 from Random123
+  const uint32_t kat_key[3][2]={{0x00000000,0x00000000},{0xffffffff,0xffffffff},{0xa4093822,0x299f31d0}};
+  const uint32_t kat_ctr[3][4]={{0x00000000,0x00000000,0x00000000,0x00000000},
+				{0xffffffff,0xffffffff,0xffffffff,0xffffffff},
+				{0x243f6a88,0x85a308d3,0x13198a2e,0x03707344}};
+  const uint32_t kat_res[3][4]={{0x6627e8d5,0xe169c58d,0xbc57ac4c,0x9b00dbd8},
+				{0x408f276d,0x41c83b0e,0xa20bc7c6,0x6d5451fd},
+				{0xd16cfe09,0x94fdcceb,0x5001e420,0x24126ea1}};
+  for(int ikat=0;ikat<3;ikat++)
+    {
+      uint32_t ctr[4];
+      for(int i=0;i<4;i++) ctr[i]=kat_ctr[ikat][i];
+      philox4x32_10(ctr,kat_key[ikat]);
+      for(int i=0;i<4;i++)
+	if(ctr[i]!=kat_res[ikat][i])
+	  {
+	    master_printf("Known answer %d, word %d: obtained %08x, expected %08x\n",ikat,i,ctr[i],kat_res[ikat][i]);
+	    passed=0;
+	  }
+    }
+  
+  //the first two draws of seed 0, site 0 and stream 0 are made of the words of the first known answer
+  philox_rnd_gen gen;
+  start_rnd_gen(&gen,0,0,0);
+  for(int idraw=0;idraw<2;idraw++)
+    {
+      double ref=((((uint64_t)kat_res[0][2*idraw]<<32)|kat_res[0][2*idraw+1])>>11)*(1.0/9007199254740992.0);
+      double obt=rnd_get_unif(&gen,0,1);
+      if(obt!=ref)
+	{
+	  master_printf("Draw %d: obtained %.17lg, expected %.17lg\n",idraw,obt,ref);
+	  passed=0;
+	}
+    }
+  
+  //sum over the lattice of the first draws of each site, on a 8x4 lattice; the global generator is restarted, so
+  //that the internal seed is reproducible
+  if(loc_rnd_gen_inited) stop_loc_rnd_gen();
+  start_rnd_gen(&glb_rnd_gen,1234);
+  glb_rnd_gen_inited=1;
+  start_loc_rnd_gen(1234);
+  const int ndraws=3;
+  const double ref_summ[ndraws]={242.6848265496686,242.8915527840734,257.0228549824408};
+  for(int idraw=0;idraw<ndraws;idraw++)
+    {
+      double loc_summ=0,glb_summ;
+      NISSA_LOC_VOL_LOOP(ivol) loc_summ+=rnd_get_unif(loc_rnd_gen+ivol,0,1);
+      MPI_Allreduce(&loc_summ,&glb_summ,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+      master_printf("Summ of the draw %d over the lattice: %.16lg, expected %.16lg\n",idraw,glb_summ,ref_summ[idraw]);
+      if(fabs(glb_summ-ref_summ[idraw])>1e-10) passed=0;
+    }
+  
+  return passed;
+}
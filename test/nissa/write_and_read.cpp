@@ -1,9 +1,9 @@
 #include "src/common.cpp"
 #include "src/write_and_read.cpp"
 
-int main()
+int main(int narg,char **arg)
 {
-  init_test();
+  init_test(narg,arg);
   
   test(test_write_and_read(),"Write and read");
   